@@ -0,0 +1,120 @@
+#pragma once
+
+#include <grpcpp/support/status.h>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "log.h"
+#include "mavsdk.h"
+
+namespace mavsdk {
+namespace backend {
+
+// The metadata key a client uses to address a call to a system, with the
+// MAVLink system id as value.
+constexpr const char* system_id_metadata_key = "mavsdk-system-id";
+
+// The status of a call addressed to a system which is not (yet) connected.
+inline grpc::Status unknown_system_status()
+{
+    return grpc::Status(grpc::StatusCode::NOT_FOUND, "No system with the requested system id");
+}
+
+// Gives the plugin instance for the system a call is addressed to.
+//
+// Calls without a system id go to the first system, as they did when the
+// server only supported one system. A plugin instance for any other system
+// is created the first time a call is addressed to it, so a server connected
+// to a fleet only pays for the plugins which are actually used.
+//
+// Mavsdk and System are only template parameters so they can be faked in tests.
+template<typename Plugin, typename Mavsdk = Mavsdk, typename System = System> class LazyPlugin {
+public:
+    explicit LazyPlugin(Mavsdk& mavsdk) :
+        _mavsdk(&mavsdk),
+        _default_system(&mavsdk.system()),
+        _owned_default_plugin(std::make_unique<Plugin>(*_default_system)),
+        _default_plugin(_owned_default_plugin.get()),
+        _create_plugin(
+            [](std::shared_ptr<System> system) { return std::make_unique<Plugin>(system); })
+    {}
+
+    // Always uses the given plugin, whatever system is addressed.
+    explicit LazyPlugin(Plugin& plugin) : _default_plugin(&plugin) {}
+
+    ~LazyPlugin() = default;
+
+    // Returns the plugin for the system the call is addressed to, or nullptr
+    // if there is no such system.
+    template<typename Context> Plugin* maybe_plugin(const Context* context)
+    {
+        if (_mavsdk == nullptr || context == nullptr) {
+            return _default_plugin;
+        }
+
+        const auto& metadata = context->client_metadata();
+        const auto it = metadata.find(system_id_metadata_key);
+        if (it == metadata.end()) {
+            return _default_plugin;
+        }
+
+        const std::string value(it->second.data(), it->second.size());
+        char* end = nullptr;
+        const long system_id = std::strtol(value.c_str(), &end, 10);
+        if (value.empty() || *end != '\0' || system_id < 1 || system_id > 255) {
+            LogWarn() << "Invalid system id requested: " << value;
+            return nullptr;
+        }
+
+        return plugin_for_system(static_cast<uint8_t>(system_id));
+    }
+
+    LazyPlugin(const LazyPlugin&) = delete;
+    LazyPlugin& operator=(const LazyPlugin&) = delete;
+
+private:
+    Plugin* plugin_for_system(uint8_t system_id)
+    {
+        std::lock_guard<std::mutex> lock(_plugins_mutex);
+
+        const auto it = _plugins.find(system_id);
+        if (it != _plugins.end()) {
+            return it->second.get();
+        }
+
+        for (auto& system : _mavsdk->systems()) {
+            if (system->get_system_id() != system_id) {
+                continue;
+            }
+
+            // The first system is the one the default plugin was created for.
+            if (system.get() == _default_system) {
+                return _default_plugin;
+            }
+
+            auto plugin = _create_plugin(system);
+            auto* plugin_ptr = plugin.get();
+            _plugins.emplace(system_id, std::move(plugin));
+            return plugin_ptr;
+        }
+
+        return nullptr;
+    }
+
+    Mavsdk* _mavsdk{nullptr};
+    System* _default_system{nullptr};
+    std::unique_ptr<Plugin> _owned_default_plugin{};
+    Plugin* _default_plugin{nullptr};
+    std::function<std::unique_ptr<Plugin>(std::shared_ptr<System>)> _create_plugin{};
+
+    std::mutex _plugins_mutex{};
+    std::map<uint8_t, std::unique_ptr<Plugin>> _plugins{};
+};
+
+} // namespace backend
+} // namespace mavsdk
@@ -5,6 +5,7 @@
 #include "action/action.grpc.pb.h"
 #include "plugins/action/action.h"
 
+#include "lazy_plugin.h"
 #include "log.h"
 #include <atomic>
 #include <cmath>
@@ -20,7 +21,9 @@ namespace backend {
 template<typename Action = Action>
 class ActionServiceImpl final : public rpc::action::ActionService::Service {
 public:
-    ActionServiceImpl(Action& action) : _action(action) {}
+    ActionServiceImpl(Action& action) : _lazy_action(action) {}
+
+    ActionServiceImpl(Mavsdk& mavsdk) : _lazy_action(mavsdk) {}
 
     template<typename ResponseType>
     void fillResponseWithResult(ResponseType* response, mavsdk::Action::Result& result) const
@@ -105,11 +108,16 @@ public:
     }
 
     grpc::Status
-    Arm(grpc::ServerContext* /* context */,
+    Arm(grpc::ServerContext* context,
         const rpc::action::ArmRequest* /* request */,
         rpc::action::ArmResponse* response) override
     {
-        auto result = _action.arm();
+        auto* plugin = _lazy_action.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->arm();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -119,11 +127,16 @@ public:
     }
 
     grpc::Status Disarm(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::DisarmRequest* /* request */,
         rpc::action::DisarmResponse* response) override
     {
-        auto result = _action.disarm();
+        auto* plugin = _lazy_action.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->disarm();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -133,11 +146,16 @@ public:
     }
 
     grpc::Status Takeoff(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::TakeoffRequest* /* request */,
         rpc::action::TakeoffResponse* response) override
     {
-        auto result = _action.takeoff();
+        auto* plugin = _lazy_action.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->takeoff();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -147,11 +165,16 @@ public:
     }
 
     grpc::Status Land(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::LandRequest* /* request */,
         rpc::action::LandResponse* response) override
     {
-        auto result = _action.land();
+        auto* plugin = _lazy_action.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->land();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -161,11 +184,16 @@ public:
     }
 
     grpc::Status Reboot(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::RebootRequest* /* request */,
         rpc::action::RebootResponse* response) override
     {
-        auto result = _action.reboot();
+        auto* plugin = _lazy_action.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->reboot();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -175,11 +203,16 @@ public:
     }
 
     grpc::Status Shutdown(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::ShutdownRequest* /* request */,
         rpc::action::ShutdownResponse* response) override
     {
-        auto result = _action.shutdown();
+        auto* plugin = _lazy_action.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->shutdown();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -189,11 +222,16 @@ public:
     }
 
     grpc::Status Terminate(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::TerminateRequest* /* request */,
         rpc::action::TerminateResponse* response) override
     {
-        auto result = _action.terminate();
+        auto* plugin = _lazy_action.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->terminate();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -203,11 +241,16 @@ public:
     }
 
     grpc::Status Kill(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::KillRequest* /* request */,
         rpc::action::KillResponse* response) override
     {
-        auto result = _action.kill();
+        auto* plugin = _lazy_action.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->kill();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -217,11 +260,16 @@ public:
     }
 
     grpc::Status ReturnToLaunch(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::ReturnToLaunchRequest* /* request */,
         rpc::action::ReturnToLaunchResponse* response) override
     {
-        auto result = _action.return_to_launch();
+        auto* plugin = _lazy_action.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->return_to_launch();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -231,16 +279,21 @@ public:
     }
 
     grpc::Status GotoLocation(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::GotoLocationRequest* request,
         rpc::action::GotoLocationResponse* response) override
     {
+        auto* plugin = _lazy_action.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "GotoLocation sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _action.goto_location(
+        auto result = plugin->goto_location(
             request->latitude_deg(),
             request->longitude_deg(),
             request->absolute_altitude_m(),
@@ -254,11 +307,16 @@ public:
     }
 
     grpc::Status TransitionToFixedwing(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::TransitionToFixedwingRequest* /* request */,
         rpc::action::TransitionToFixedwingResponse* response) override
     {
-        auto result = _action.transition_to_fixedwing();
+        auto* plugin = _lazy_action.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->transition_to_fixedwing();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -268,11 +326,16 @@ public:
     }
 
     grpc::Status TransitionToMulticopter(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::TransitionToMulticopterRequest* /* request */,
         rpc::action::TransitionToMulticopterResponse* response) override
     {
-        auto result = _action.transition_to_multicopter();
+        auto* plugin = _lazy_action.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->transition_to_multicopter();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -282,11 +345,16 @@ public:
     }
 
     grpc::Status GetTakeoffAltitude(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::GetTakeoffAltitudeRequest* /* request */,
         rpc::action::GetTakeoffAltitudeResponse* response) override
     {
-        auto result = _action.get_takeoff_altitude();
+        auto* plugin = _lazy_action.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->get_takeoff_altitude();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
@@ -298,16 +366,21 @@ public:
     }
 
     grpc::Status SetTakeoffAltitude(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::SetTakeoffAltitudeRequest* request,
         rpc::action::SetTakeoffAltitudeResponse* response) override
     {
+        auto* plugin = _lazy_action.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetTakeoffAltitude sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _action.set_takeoff_altitude(request->altitude());
+        auto result = plugin->set_takeoff_altitude(request->altitude());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -317,11 +390,16 @@ public:
     }
 
     grpc::Status GetMaximumSpeed(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::GetMaximumSpeedRequest* /* request */,
         rpc::action::GetMaximumSpeedResponse* response) override
     {
-        auto result = _action.get_maximum_speed();
+        auto* plugin = _lazy_action.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->get_maximum_speed();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
@@ -333,16 +411,21 @@ public:
     }
 
     grpc::Status SetMaximumSpeed(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::SetMaximumSpeedRequest* request,
         rpc::action::SetMaximumSpeedResponse* response) override
     {
+        auto* plugin = _lazy_action.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetMaximumSpeed sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _action.set_maximum_speed(request->speed());
+        auto result = plugin->set_maximum_speed(request->speed());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -352,11 +435,16 @@ public:
     }
 
     grpc::Status GetReturnToLaunchAltitude(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::GetReturnToLaunchAltitudeRequest* /* request */,
         rpc::action::GetReturnToLaunchAltitudeResponse* response) override
     {
-        auto result = _action.get_return_to_launch_altitude();
+        auto* plugin = _lazy_action.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->get_return_to_launch_altitude();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
@@ -368,16 +456,21 @@ public:
     }
 
     grpc::Status SetReturnToLaunchAltitude(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::action::SetReturnToLaunchAltitudeRequest* request,
         rpc::action::SetReturnToLaunchAltitudeResponse* response) override
     {
+        auto* plugin = _lazy_action.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetReturnToLaunchAltitude sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _action.set_return_to_launch_altitude(request->relative_altitude_m());
+        auto result = plugin->set_return_to_launch_altitude(request->relative_altitude_m());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -421,7 +514,7 @@ private:
         }
     }
 
-    Action& _action;
+    LazyPlugin<Action> _lazy_action;
     std::atomic<bool> _stopped{false};
     std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
 };
@@ -5,6 +5,7 @@
 #include "calibration/calibration.grpc.pb.h"
 #include "plugins/calibration/calibration.h"
 
+#include "lazy_plugin.h"
 #include "log.h"
 #include <atomic>
 #include <cmath>
@@ -20,7 +21,9 @@ namespace backend {
 template<typename Calibration = Calibration>
 class CalibrationServiceImpl final : public rpc::calibration::CalibrationService::Service {
 public:
-    CalibrationServiceImpl(Calibration& calibration) : _calibration(calibration) {}
+    CalibrationServiceImpl(Calibration& calibration) : _lazy_calibration(calibration) {}
+
+    CalibrationServiceImpl(Mavsdk& mavsdk) : _lazy_calibration(mavsdk) {}
 
     template<typename ResponseType>
     void fillResponseWithResult(ResponseType* response, mavsdk::Calibration::Result& result) const
@@ -104,7 +107,14 @@ public:
     translateToRpcProgressData(const mavsdk::Calibration::ProgressData& progress_data)
     {
         auto rpc_obj = std::make_unique<rpc::calibration::ProgressData>();
+        translateToRpcProgressData(progress_data, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcProgressData(
+        const mavsdk::Calibration::ProgressData& progress_data,
+        rpc::calibration::ProgressData* rpc_obj)
+    {
         rpc_obj->set_has_progress(progress_data.has_progress);
 
         rpc_obj->set_progress(progress_data.progress);
@@ -112,8 +122,6 @@ public:
         rpc_obj->set_has_status_text(progress_data.has_status_text);
 
         rpc_obj->set_status_text(progress_data.status_text);
-
-        return rpc_obj;
     }
 
     static mavsdk::Calibration::ProgressData
@@ -133,10 +141,15 @@ public:
     }
 
     grpc::Status SubscribeCalibrateGyro(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const mavsdk::rpc::calibration::SubscribeCalibrateGyroRequest* /* request */,
         grpc::ServerWriter<rpc::calibration::CalibrateGyroResponse>* writer) override
     {
+        auto* plugin = _lazy_calibration.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         auto stream_closed_promise = std::make_shared<std::promise<void>>();
         auto stream_closed_future = stream_closed_promise->get_future();
         register_stream_stop_promise(stream_closed_promise);
@@ -145,7 +158,7 @@ public:
 
         std::mutex subscribe_mutex{};
 
-        _calibration.calibrate_gyro_async(
+        plugin->calibrate_gyro_async(
             [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
                 mavsdk::Calibration::Result result,
                 const mavsdk::Calibration::ProgressData calibrate_gyro) {
@@ -176,10 +189,15 @@ public:
     }
 
     grpc::Status SubscribeCalibrateAccelerometer(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const mavsdk::rpc::calibration::SubscribeCalibrateAccelerometerRequest* /* request */,
         grpc::ServerWriter<rpc::calibration::CalibrateAccelerometerResponse>* writer) override
     {
+        auto* plugin = _lazy_calibration.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         auto stream_closed_promise = std::make_shared<std::promise<void>>();
         auto stream_closed_future = stream_closed_promise->get_future();
         register_stream_stop_promise(stream_closed_promise);
@@ -188,7 +206,7 @@ public:
 
         std::mutex subscribe_mutex{};
 
-        _calibration.calibrate_accelerometer_async(
+        plugin->calibrate_accelerometer_async(
             [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
                 mavsdk::Calibration::Result result,
                 const mavsdk::Calibration::ProgressData calibrate_accelerometer) {
@@ -219,10 +237,15 @@ public:
     }
 
     grpc::Status SubscribeCalibrateMagnetometer(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const mavsdk::rpc::calibration::SubscribeCalibrateMagnetometerRequest* /* request */,
         grpc::ServerWriter<rpc::calibration::CalibrateMagnetometerResponse>* writer) override
     {
+        auto* plugin = _lazy_calibration.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         auto stream_closed_promise = std::make_shared<std::promise<void>>();
         auto stream_closed_future = stream_closed_promise->get_future();
         register_stream_stop_promise(stream_closed_promise);
@@ -231,7 +254,7 @@ public:
 
         std::mutex subscribe_mutex{};
 
-        _calibration.calibrate_magnetometer_async(
+        plugin->calibrate_magnetometer_async(
             [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
                 mavsdk::Calibration::Result result,
                 const mavsdk::Calibration::ProgressData calibrate_magnetometer) {
@@ -262,10 +285,15 @@ public:
     }
 
     grpc::Status SubscribeCalibrateLevelHorizon(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const mavsdk::rpc::calibration::SubscribeCalibrateLevelHorizonRequest* /* request */,
         grpc::ServerWriter<rpc::calibration::CalibrateLevelHorizonResponse>* writer) override
     {
+        auto* plugin = _lazy_calibration.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         auto stream_closed_promise = std::make_shared<std::promise<void>>();
         auto stream_closed_future = stream_closed_promise->get_future();
         register_stream_stop_promise(stream_closed_promise);
@@ -274,7 +302,7 @@ public:
 
         std::mutex subscribe_mutex{};
 
-        _calibration.calibrate_level_horizon_async(
+        plugin->calibrate_level_horizon_async(
             [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
                 mavsdk::Calibration::Result result,
                 const mavsdk::Calibration::ProgressData calibrate_level_horizon) {
@@ -305,10 +333,15 @@ public:
     }
 
     grpc::Status SubscribeCalibrateGimbalAccelerometer(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const mavsdk::rpc::calibration::SubscribeCalibrateGimbalAccelerometerRequest* /* request */,
         grpc::ServerWriter<rpc::calibration::CalibrateGimbalAccelerometerResponse>* writer) override
     {
+        auto* plugin = _lazy_calibration.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         auto stream_closed_promise = std::make_shared<std::promise<void>>();
         auto stream_closed_future = stream_closed_promise->get_future();
         register_stream_stop_promise(stream_closed_promise);
@@ -317,7 +350,7 @@ public:
 
         std::mutex subscribe_mutex{};
 
-        _calibration.calibrate_gimbal_accelerometer_async(
+        plugin->calibrate_gimbal_accelerometer_async(
             [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
                 mavsdk::Calibration::Result result,
                 const mavsdk::Calibration::ProgressData calibrate_gimbal_accelerometer) {
@@ -348,11 +381,16 @@ public:
     }
 
     grpc::Status Cancel(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::calibration::CancelRequest* /* request */,
         rpc::calibration::CancelResponse* /* response */) override
     {
-        _calibration.cancel();
+        auto* plugin = _lazy_calibration.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        plugin->cancel();
 
         return grpc::Status::OK;
     }
@@ -392,7 +430,7 @@ private:
         }
     }
 
-    Calibration& _calibration;
+    LazyPlugin<Calibration> _lazy_calibration;
     std::atomic<bool> _stopped{false};
     std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
 };
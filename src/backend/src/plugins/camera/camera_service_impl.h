@@ -5,6 +5,7 @@
 #include "camera/camera.grpc.pb.h"
 #include "plugins/camera/camera.h"
 
+#include "lazy_plugin.h"
 #include "log.h"
 #include <atomic>
 #include <cmath>
@@ -20,7 +21,9 @@ namespace backend {
 template<typename Camera = Camera>
 class CameraServiceImpl final : public rpc::camera::CameraService::Service {
 public:
-    CameraServiceImpl(Camera& camera) : _camera(camera) {}
+    CameraServiceImpl(Camera& camera) : _lazy_camera(camera) {}
+
+    CameraServiceImpl(Mavsdk& mavsdk) : _lazy_camera(mavsdk) {}
 
     template<typename ResponseType>
     void fillResponseWithResult(ResponseType* response, mavsdk::Camera::Result& result) const
@@ -122,7 +125,13 @@ public:
     translateToRpcPosition(const mavsdk::Camera::Position& position)
     {
         auto rpc_obj = std::make_unique<rpc::camera::Position>();
+        translateToRpcPosition(position, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcPosition(
+        const mavsdk::Camera::Position& position, rpc::camera::Position* rpc_obj)
+    {
         rpc_obj->set_latitude_deg(position.latitude_deg);
 
         rpc_obj->set_longitude_deg(position.longitude_deg);
@@ -130,8 +139,6 @@ public:
         rpc_obj->set_absolute_altitude_m(position.absolute_altitude_m);
 
         rpc_obj->set_relative_altitude_m(position.relative_altitude_m);
-
-        return rpc_obj;
     }
 
     static mavsdk::Camera::Position translateFromRpcPosition(const rpc::camera::Position& position)
@@ -153,7 +160,13 @@ public:
     translateToRpcQuaternion(const mavsdk::Camera::Quaternion& quaternion)
     {
         auto rpc_obj = std::make_unique<rpc::camera::Quaternion>();
+        translateToRpcQuaternion(quaternion, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcQuaternion(
+        const mavsdk::Camera::Quaternion& quaternion, rpc::camera::Quaternion* rpc_obj)
+    {
         rpc_obj->set_w(quaternion.w);
 
         rpc_obj->set_x(quaternion.x);
@@ -161,8 +174,6 @@ public:
         rpc_obj->set_y(quaternion.y);
 
         rpc_obj->set_z(quaternion.z);
-
-        return rpc_obj;
     }
 
     static mavsdk::Camera::Quaternion
@@ -185,14 +196,18 @@ public:
     translateToRpcEulerAngle(const mavsdk::Camera::EulerAngle& euler_angle)
     {
         auto rpc_obj = std::make_unique<rpc::camera::EulerAngle>();
+        translateToRpcEulerAngle(euler_angle, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcEulerAngle(
+        const mavsdk::Camera::EulerAngle& euler_angle, rpc::camera::EulerAngle* rpc_obj)
+    {
         rpc_obj->set_roll_deg(euler_angle.roll_deg);
 
         rpc_obj->set_pitch_deg(euler_angle.pitch_deg);
 
         rpc_obj->set_yaw_deg(euler_angle.yaw_deg);
-
-        return rpc_obj;
     }
 
     static mavsdk::Camera::EulerAngle
@@ -213,14 +228,20 @@ public:
     translateToRpcCaptureInfo(const mavsdk::Camera::CaptureInfo& capture_info)
     {
         auto rpc_obj = std::make_unique<rpc::camera::CaptureInfo>();
+        translateToRpcCaptureInfo(capture_info, rpc_obj.get());
+        return rpc_obj;
+    }
 
-        rpc_obj->set_allocated_position(translateToRpcPosition(capture_info.position).release());
+    static void translateToRpcCaptureInfo(
+        const mavsdk::Camera::CaptureInfo& capture_info, rpc::camera::CaptureInfo* rpc_obj)
+    {
+        translateToRpcPosition(capture_info.position, rpc_obj->mutable_position());
 
-        rpc_obj->set_allocated_attitude_quaternion(
-            translateToRpcQuaternion(capture_info.attitude_quaternion).release());
+        translateToRpcQuaternion(
+            capture_info.attitude_quaternion, rpc_obj->mutable_attitude_quaternion());
 
-        rpc_obj->set_allocated_attitude_euler_angle(
-            translateToRpcEulerAngle(capture_info.attitude_euler_angle).release());
+        translateToRpcEulerAngle(
+            capture_info.attitude_euler_angle, rpc_obj->mutable_attitude_euler_angle());
 
         rpc_obj->set_time_utc_us(capture_info.time_utc_us);
 
@@ -229,8 +250,6 @@ public:
         rpc_obj->set_index(capture_info.index);
 
         rpc_obj->set_file_url(capture_info.file_url);
-
-        return rpc_obj;
     }
 
     static mavsdk::Camera::CaptureInfo
@@ -259,7 +278,14 @@ public:
         const mavsdk::Camera::VideoStreamSettings& video_stream_settings)
     {
         auto rpc_obj = std::make_unique<rpc::camera::VideoStreamSettings>();
+        translateToRpcVideoStreamSettings(video_stream_settings, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcVideoStreamSettings(
+        const mavsdk::Camera::VideoStreamSettings& video_stream_settings,
+        rpc::camera::VideoStreamSettings* rpc_obj)
+    {
         rpc_obj->set_frame_rate_hz(video_stream_settings.frame_rate_hz);
 
         rpc_obj->set_horizontal_resolution_pix(video_stream_settings.horizontal_resolution_pix);
@@ -271,8 +297,6 @@ public:
         rpc_obj->set_rotation_deg(video_stream_settings.rotation_deg);
 
         rpc_obj->set_uri(video_stream_settings.uri);
-
-        return rpc_obj;
     }
 
     static mavsdk::Camera::VideoStreamSettings translateFromRpcVideoStreamSettings(
@@ -327,13 +351,17 @@ public:
     translateToRpcVideoStreamInfo(const mavsdk::Camera::VideoStreamInfo& video_stream_info)
     {
         auto rpc_obj = std::make_unique<rpc::camera::VideoStreamInfo>();
+        translateToRpcVideoStreamInfo(video_stream_info, rpc_obj.get());
+        return rpc_obj;
+    }
 
-        rpc_obj->set_allocated_settings(
-            translateToRpcVideoStreamSettings(video_stream_info.settings).release());
+    static void translateToRpcVideoStreamInfo(
+        const mavsdk::Camera::VideoStreamInfo& video_stream_info,
+        rpc::camera::VideoStreamInfo* rpc_obj)
+    {
+        translateToRpcVideoStreamSettings(video_stream_info.settings, rpc_obj->mutable_settings());
 
         rpc_obj->set_status(translateToRpcStatus(video_stream_info.status));
-
-        return rpc_obj;
     }
 
     static mavsdk::Camera::VideoStreamInfo
@@ -386,7 +414,13 @@ public:
     translateToRpcStatus(const mavsdk::Camera::Status& status)
     {
         auto rpc_obj = std::make_unique<rpc::camera::Status>();
+        translateToRpcStatus(status, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcStatus(
+        const mavsdk::Camera::Status& status, rpc::camera::Status* rpc_obj)
+    {
         rpc_obj->set_video_on(status.video_on);
 
         rpc_obj->set_photo_interval_on(status.photo_interval_on);
@@ -402,8 +436,6 @@ public:
         rpc_obj->set_media_folder_name(status.media_folder_name);
 
         rpc_obj->set_storage_status(translateToRpcStorageStatus(status.storage_status));
-
-        return rpc_obj;
     }
 
     static mavsdk::Camera::Status translateFromRpcStatus(const rpc::camera::Status& status)
@@ -433,12 +465,16 @@ public:
     translateToRpcOption(const mavsdk::Camera::Option& option)
     {
         auto rpc_obj = std::make_unique<rpc::camera::Option>();
+        translateToRpcOption(option, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcOption(
+        const mavsdk::Camera::Option& option, rpc::camera::Option* rpc_obj)
+    {
         rpc_obj->set_option_id(option.option_id);
 
         rpc_obj->set_option_description(option.option_description);
-
-        return rpc_obj;
     }
 
     static mavsdk::Camera::Option translateFromRpcOption(const rpc::camera::Option& option)
@@ -456,16 +492,20 @@ public:
     translateToRpcSetting(const mavsdk::Camera::Setting& setting)
     {
         auto rpc_obj = std::make_unique<rpc::camera::Setting>();
+        translateToRpcSetting(setting, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcSetting(
+        const mavsdk::Camera::Setting& setting, rpc::camera::Setting* rpc_obj)
+    {
         rpc_obj->set_setting_id(setting.setting_id);
 
         rpc_obj->set_setting_description(setting.setting_description);
 
-        rpc_obj->set_allocated_option(translateToRpcOption(setting.option).release());
+        translateToRpcOption(setting.option, rpc_obj->mutable_option());
 
         rpc_obj->set_is_range(setting.is_range);
-
-        return rpc_obj;
     }
 
     static mavsdk::Camera::Setting translateFromRpcSetting(const rpc::camera::Setting& setting)
@@ -487,19 +527,23 @@ public:
     translateToRpcSettingOptions(const mavsdk::Camera::SettingOptions& setting_options)
     {
         auto rpc_obj = std::make_unique<rpc::camera::SettingOptions>();
+        translateToRpcSettingOptions(setting_options, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcSettingOptions(
+        const mavsdk::Camera::SettingOptions& setting_options, rpc::camera::SettingOptions* rpc_obj)
+    {
         rpc_obj->set_setting_id(setting_options.setting_id);
 
         rpc_obj->set_setting_description(setting_options.setting_description);
 
+        rpc_obj->clear_options();
         for (const auto& elem : setting_options.options) {
-            auto* ptr = rpc_obj->add_options();
-            ptr->CopyFrom(*translateToRpcOption(elem).release());
+            translateToRpcOption(elem, rpc_obj->add_options());
         }
 
         rpc_obj->set_is_range(setting_options.is_range);
-
-        return rpc_obj;
     }
 
     static mavsdk::Camera::SettingOptions
@@ -525,12 +569,16 @@ public:
     translateToRpcInformation(const mavsdk::Camera::Information& information)
     {
         auto rpc_obj = std::make_unique<rpc::camera::Information>();
+        translateToRpcInformation(information, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcInformation(
+        const mavsdk::Camera::Information& information, rpc::camera::Information* rpc_obj)
+    {
         rpc_obj->set_vendor_name(information.vendor_name);
 
         rpc_obj->set_model_name(information.model_name);
-
-        return rpc_obj;
     }
 
     static mavsdk::Camera::Information
@@ -546,11 +594,16 @@ public:
     }
 
     grpc::Status TakePhoto(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::camera::TakePhotoRequest* /* request */,
         rpc::camera::TakePhotoResponse* response) override
     {
-        auto result = _camera.take_photo();
+        auto* plugin = _lazy_camera.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->take_photo();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -560,16 +613,21 @@ public:
     }
 
     grpc::Status StartPhotoInterval(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::camera::StartPhotoIntervalRequest* request,
         rpc::camera::StartPhotoIntervalResponse* response) override
     {
+        auto* plugin = _lazy_camera.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "StartPhotoInterval sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _camera.start_photo_interval(request->interval_s());
+        auto result = plugin->start_photo_interval(request->interval_s());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -579,11 +637,16 @@ public:
     }
 
     grpc::Status StopPhotoInterval(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::camera::StopPhotoIntervalRequest* /* request */,
         rpc::camera::StopPhotoIntervalResponse* response) override
     {
-        auto result = _camera.stop_photo_interval();
+        auto* plugin = _lazy_camera.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->stop_photo_interval();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -593,11 +656,16 @@ public:
     }
 
     grpc::Status StartVideo(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::camera::StartVideoRequest* /* request */,
         rpc::camera::StartVideoResponse* response) override
     {
-        auto result = _camera.start_video();
+        auto* plugin = _lazy_camera.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->start_video();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -607,11 +675,16 @@ public:
     }
 
     grpc::Status StopVideo(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::camera::StopVideoRequest* /* request */,
         rpc::camera::StopVideoResponse* response) override
     {
-        auto result = _camera.stop_video();
+        auto* plugin = _lazy_camera.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->stop_video();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -621,11 +694,16 @@ public:
     }
 
     grpc::Status StartVideoStreaming(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::camera::StartVideoStreamingRequest* /* request */,
         rpc::camera::StartVideoStreamingResponse* response) override
     {
-        auto result = _camera.start_video_streaming();
+        auto* plugin = _lazy_camera.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->start_video_streaming();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -635,11 +713,16 @@ public:
     }
 
     grpc::Status StopVideoStreaming(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::camera::StopVideoStreamingRequest* /* request */,
         rpc::camera::StopVideoStreamingResponse* response) override
     {
-        auto result = _camera.stop_video_streaming();
+        auto* plugin = _lazy_camera.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->stop_video_streaming();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -649,16 +732,21 @@ public:
     }
 
     grpc::Status SetMode(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::camera::SetModeRequest* request,
         rpc::camera::SetModeResponse* response) override
     {
+        auto* plugin = _lazy_camera.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetMode sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _camera.set_mode(translateFromRpcMode(request->mode()));
+        auto result = plugin->set_mode(translateFromRpcMode(request->mode()));
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -668,10 +756,15 @@ public:
     }
 
     grpc::Status SubscribeMode(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const mavsdk::rpc::camera::SubscribeModeRequest* /* request */,
         grpc::ServerWriter<rpc::camera::ModeResponse>* writer) override
     {
+        auto* plugin = _lazy_camera.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         auto stream_closed_promise = std::make_shared<std::promise<void>>();
         auto stream_closed_future = stream_closed_promise->get_future();
         register_stream_stop_promise(stream_closed_promise);
@@ -680,8 +773,8 @@ public:
 
         std::mutex subscribe_mutex{};
 
-        _camera.subscribe_mode(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
+        plugin->subscribe_mode(
+            [this, plugin, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
                 const mavsdk::Camera::Mode mode) {
                 rpc::camera::ModeResponse rpc_response;
 
@@ -689,7 +782,7 @@ public:
 
                 std::unique_lock<std::mutex> lock(subscribe_mutex);
                 if (!*is_finished && !writer->Write(rpc_response)) {
-                    _camera.subscribe_mode(nullptr);
+                    plugin->subscribe_mode(nullptr);
 
                     *is_finished = true;
                     unregister_stream_stop_promise(stream_closed_promise);
@@ -703,10 +796,15 @@ public:
     }
 
     grpc::Status SubscribeInformation(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const mavsdk::rpc::camera::SubscribeInformationRequest* /* request */,
         grpc::ServerWriter<rpc::camera::InformationResponse>* writer) override
     {
+        auto* plugin = _lazy_camera.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         auto stream_closed_promise = std::make_shared<std::promise<void>>();
         auto stream_closed_future = stream_closed_promise->get_future();
         register_stream_stop_promise(stream_closed_promise);
@@ -715,8 +813,8 @@ public:
 
         std::mutex subscribe_mutex{};
 
-        _camera.subscribe_information(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
+        plugin->subscribe_information(
+            [this, plugin, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
                 const mavsdk::Camera::Information information) {
                 rpc::camera::InformationResponse rpc_response;
 
@@ -725,7 +823,7 @@ public:
 
                 std::unique_lock<std::mutex> lock(subscribe_mutex);
                 if (!*is_finished && !writer->Write(rpc_response)) {
-                    _camera.subscribe_information(nullptr);
+                    plugin->subscribe_information(nullptr);
 
                     *is_finished = true;
                     unregister_stream_stop_promise(stream_closed_promise);
@@ -739,10 +837,15 @@ public:
     }
 
     grpc::Status SubscribeVideoStreamInfo(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const mavsdk::rpc::camera::SubscribeVideoStreamInfoRequest* /* request */,
         grpc::ServerWriter<rpc::camera::VideoStreamInfoResponse>* writer) override
     {
+        auto* plugin = _lazy_camera.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         auto stream_closed_promise = std::make_shared<std::promise<void>>();
         auto stream_closed_future = stream_closed_promise->get_future();
         register_stream_stop_promise(stream_closed_promise);
@@ -751,8 +854,8 @@ public:
 
         std::mutex subscribe_mutex{};
 
-        _camera.subscribe_video_stream_info(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
+        plugin->subscribe_video_stream_info(
+            [this, plugin, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
                 const mavsdk::Camera::VideoStreamInfo video_stream_info) {
                 rpc::camera::VideoStreamInfoResponse rpc_response;
 
@@ -761,7 +864,7 @@ public:
 
                 std::unique_lock<std::mutex> lock(subscribe_mutex);
                 if (!*is_finished && !writer->Write(rpc_response)) {
-                    _camera.subscribe_video_stream_info(nullptr);
+                    plugin->subscribe_video_stream_info(nullptr);
 
                     *is_finished = true;
                     unregister_stream_stop_promise(stream_closed_promise);
@@ -775,10 +878,15 @@ public:
     }
 
     grpc::Status SubscribeCaptureInfo(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const mavsdk::rpc::camera::SubscribeCaptureInfoRequest* /* request */,
         grpc::ServerWriter<rpc::camera::CaptureInfoResponse>* writer) override
     {
+        auto* plugin = _lazy_camera.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         auto stream_closed_promise = std::make_shared<std::promise<void>>();
         auto stream_closed_future = stream_closed_promise->get_future();
         register_stream_stop_promise(stream_closed_promise);
@@ -787,8 +895,8 @@ public:
 
         std::mutex subscribe_mutex{};
 
-        _camera.subscribe_capture_info(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
+        plugin->subscribe_capture_info(
+            [this, plugin, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
                 const mavsdk::Camera::CaptureInfo capture_info) {
                 rpc::camera::CaptureInfoResponse rpc_response;
 
@@ -797,7 +905,7 @@ public:
 
                 std::unique_lock<std::mutex> lock(subscribe_mutex);
                 if (!*is_finished && !writer->Write(rpc_response)) {
-                    _camera.subscribe_capture_info(nullptr);
+                    plugin->subscribe_capture_info(nullptr);
 
                     *is_finished = true;
                     unregister_stream_stop_promise(stream_closed_promise);
@@ -811,10 +919,15 @@ public:
     }
 
     grpc::Status SubscribeStatus(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const mavsdk::rpc::camera::SubscribeStatusRequest* /* request */,
         grpc::ServerWriter<rpc::camera::StatusResponse>* writer) override
     {
+        auto* plugin = _lazy_camera.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         auto stream_closed_promise = std::make_shared<std::promise<void>>();
         auto stream_closed_future = stream_closed_promise->get_future();
         register_stream_stop_promise(stream_closed_promise);
@@ -823,8 +936,8 @@ public:
 
         std::mutex subscribe_mutex{};
 
-        _camera.subscribe_status(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
+        plugin->subscribe_status(
+            [this, plugin, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
                 const mavsdk::Camera::Status status) {
                 rpc::camera::StatusResponse rpc_response;
 
@@ -832,7 +945,7 @@ public:
 
                 std::unique_lock<std::mutex> lock(subscribe_mutex);
                 if (!*is_finished && !writer->Write(rpc_response)) {
-                    _camera.subscribe_status(nullptr);
+                    plugin->subscribe_status(nullptr);
 
                     *is_finished = true;
                     unregister_stream_stop_promise(stream_closed_promise);
@@ -846,10 +959,15 @@ public:
     }
 
     grpc::Status SubscribeCurrentSettings(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const mavsdk::rpc::camera::SubscribeCurrentSettingsRequest* /* request */,
         grpc::ServerWriter<rpc::camera::CurrentSettingsResponse>* writer) override
     {
+        auto* plugin = _lazy_camera.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         auto stream_closed_promise = std::make_shared<std::promise<void>>();
         auto stream_closed_future = stream_closed_promise->get_future();
         register_stream_stop_promise(stream_closed_promise);
@@ -858,8 +976,8 @@ public:
 
         std::mutex subscribe_mutex{};
 
-        _camera.subscribe_current_settings(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
+        plugin->subscribe_current_settings(
+            [this, plugin, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
                 const std::vector<mavsdk::Camera::Setting> current_settings) {
                 rpc::camera::CurrentSettingsResponse rpc_response;
 
@@ -870,7 +988,7 @@ public:
 
                 std::unique_lock<std::mutex> lock(subscribe_mutex);
                 if (!*is_finished && !writer->Write(rpc_response)) {
-                    _camera.subscribe_current_settings(nullptr);
+                    plugin->subscribe_current_settings(nullptr);
 
                     *is_finished = true;
                     unregister_stream_stop_promise(stream_closed_promise);
@@ -884,10 +1002,15 @@ public:
     }
 
     grpc::Status SubscribePossibleSettingOptions(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const mavsdk::rpc::camera::SubscribePossibleSettingOptionsRequest* /* request */,
         grpc::ServerWriter<rpc::camera::PossibleSettingOptionsResponse>* writer) override
     {
+        auto* plugin = _lazy_camera.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         auto stream_closed_promise = std::make_shared<std::promise<void>>();
         auto stream_closed_future = stream_closed_promise->get_future();
         register_stream_stop_promise(stream_closed_promise);
@@ -896,8 +1019,8 @@ public:
 
         std::mutex subscribe_mutex{};
 
-        _camera.subscribe_possible_setting_options(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
+        plugin->subscribe_possible_setting_options(
+            [this, plugin, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
                 const std::vector<mavsdk::Camera::SettingOptions> possible_setting_options) {
                 rpc::camera::PossibleSettingOptionsResponse rpc_response;
 
@@ -908,7 +1031,7 @@ public:
 
                 std::unique_lock<std::mutex> lock(subscribe_mutex);
                 if (!*is_finished && !writer->Write(rpc_response)) {
-                    _camera.subscribe_possible_setting_options(nullptr);
+                    plugin->subscribe_possible_setting_options(nullptr);
 
                     *is_finished = true;
                     unregister_stream_stop_promise(stream_closed_promise);
@@ -922,16 +1045,21 @@ public:
     }
 
     grpc::Status SetSetting(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::camera::SetSettingRequest* request,
         rpc::camera::SetSettingResponse* response) override
     {
+        auto* plugin = _lazy_camera.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetSetting sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _camera.set_setting(translateFromRpcSetting(request->setting()));
+        auto result = plugin->set_setting(translateFromRpcSetting(request->setting()));
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -941,16 +1069,21 @@ public:
     }
 
     grpc::Status GetSetting(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::camera::GetSettingRequest* request,
         rpc::camera::GetSettingResponse* response) override
     {
+        auto* plugin = _lazy_camera.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "GetSetting sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _camera.get_setting(translateFromRpcSetting(request->setting()));
+        auto result = plugin->get_setting(translateFromRpcSetting(request->setting()));
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
@@ -962,11 +1095,16 @@ public:
     }
 
     grpc::Status FormatStorage(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::camera::FormatStorageRequest* /* request */,
         rpc::camera::FormatStorageResponse* response) override
     {
-        auto result = _camera.format_storage();
+        auto* plugin = _lazy_camera.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->format_storage();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -1010,7 +1148,7 @@ private:
         }
     }
 
-    Camera& _camera;
+    LazyPlugin<Camera> _lazy_camera;
     std::atomic<bool> _stopped{false};
     std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
 };
@@ -5,6 +5,7 @@
 #include "failure/failure.grpc.pb.h"
 #include "plugins/failure/failure.h"
 
+#include "lazy_plugin.h"
 #include "log.h"
 #include <atomic>
 #include <cmath>
@@ -20,7 +21,9 @@ namespace backend {
 template<typename Failure = Failure>
 class FailureServiceImpl final : public rpc::failure::FailureService::Service {
 public:
-    FailureServiceImpl(Failure& failure) : _failure(failure) {}
+    FailureServiceImpl(Failure& failure) : _lazy_failure(failure) {}
+
+    FailureServiceImpl(Mavsdk& mavsdk) : _lazy_failure(mavsdk) {}
 
     template<typename ResponseType>
     void fillResponseWithResult(ResponseType* response, mavsdk::Failure::Result& result) const
@@ -221,16 +224,21 @@ public:
     }
 
     grpc::Status Inject(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::failure::InjectRequest* request,
         rpc::failure::InjectResponse* response) override
     {
+        auto* plugin = _lazy_failure.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "Inject sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _failure.inject(
+        auto result = plugin->inject(
             translateFromRpcFailureUnit(request->failure_unit()),
             translateFromRpcFailureType(request->failure_type()),
             request->instance());
@@ -277,7 +285,7 @@ private:
         }
     }
 
-    Failure& _failure;
+    LazyPlugin<Failure> _lazy_failure;
     std::atomic<bool> _stopped{false};
     std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
 };
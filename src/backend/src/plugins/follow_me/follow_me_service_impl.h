@@ -5,6 +5,7 @@
 #include "follow_me/follow_me.grpc.pb.h"
 #include "plugins/follow_me/follow_me.h"
 
+#include "lazy_plugin.h"
 #include "log.h"
 #include <atomic>
 #include <cmath>
@@ -20,7 +21,9 @@ namespace backend {
 template<typename FollowMe = FollowMe>
 class FollowMeServiceImpl final : public rpc::follow_me::FollowMeService::Service {
 public:
-    FollowMeServiceImpl(FollowMe& follow_me) : _follow_me(follow_me) {}
+    FollowMeServiceImpl(FollowMe& follow_me) : _lazy_follow_me(follow_me) {}
+
+    FollowMeServiceImpl(Mavsdk& mavsdk) : _lazy_follow_me(mavsdk) {}
 
     template<typename ResponseType>
     void fillResponseWithResult(ResponseType* response, mavsdk::FollowMe::Result& result) const
@@ -82,7 +85,13 @@ public:
     translateToRpcConfig(const mavsdk::FollowMe::Config& config)
     {
         auto rpc_obj = std::make_unique<rpc::follow_me::Config>();
+        translateToRpcConfig(config, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcConfig(
+        const mavsdk::FollowMe::Config& config, rpc::follow_me::Config* rpc_obj)
+    {
         rpc_obj->set_min_height_m(config.min_height_m);
 
         rpc_obj->set_follow_distance_m(config.follow_distance_m);
@@ -90,8 +99,6 @@ public:
         rpc_obj->set_follow_direction(translateToRpcFollowDirection(config.follow_direction));
 
         rpc_obj->set_responsiveness(config.responsiveness);
-
-        return rpc_obj;
     }
 
     static mavsdk::FollowMe::Config translateFromRpcConfig(const rpc::follow_me::Config& config)
@@ -113,7 +120,14 @@ public:
     translateToRpcTargetLocation(const mavsdk::FollowMe::TargetLocation& target_location)
     {
         auto rpc_obj = std::make_unique<rpc::follow_me::TargetLocation>();
+        translateToRpcTargetLocation(target_location, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcTargetLocation(
+        const mavsdk::FollowMe::TargetLocation& target_location,
+        rpc::follow_me::TargetLocation* rpc_obj)
+    {
         rpc_obj->set_latitude_deg(target_location.latitude_deg);
 
         rpc_obj->set_longitude_deg(target_location.longitude_deg);
@@ -125,8 +139,6 @@ public:
         rpc_obj->set_velocity_y_m_s(target_location.velocity_y_m_s);
 
         rpc_obj->set_velocity_z_m_s(target_location.velocity_z_m_s);
-
-        return rpc_obj;
     }
 
     static mavsdk::FollowMe::TargetLocation
@@ -206,11 +218,16 @@ public:
     }
 
     grpc::Status GetConfig(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::follow_me::GetConfigRequest* /* request */,
         rpc::follow_me::GetConfigResponse* response) override
     {
-        auto result = _follow_me.get_config();
+        auto* plugin = _lazy_follow_me.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->get_config();
 
         if (response != nullptr) {
             response->set_allocated_config(translateToRpcConfig(result).release());
@@ -220,16 +237,21 @@ public:
     }
 
     grpc::Status SetConfig(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::follow_me::SetConfigRequest* request,
         rpc::follow_me::SetConfigResponse* response) override
     {
+        auto* plugin = _lazy_follow_me.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetConfig sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _follow_me.set_config(translateFromRpcConfig(request->config()));
+        auto result = plugin->set_config(translateFromRpcConfig(request->config()));
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -239,11 +261,16 @@ public:
     }
 
     grpc::Status IsActive(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::follow_me::IsActiveRequest* /* request */,
         rpc::follow_me::IsActiveResponse* response) override
     {
-        auto result = _follow_me.is_active();
+        auto* plugin = _lazy_follow_me.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->is_active();
 
         if (response != nullptr) {
             response->set_is_active(result);
@@ -253,17 +280,22 @@ public:
     }
 
     grpc::Status SetTargetLocation(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::follow_me::SetTargetLocationRequest* request,
         rpc::follow_me::SetTargetLocationResponse* response) override
     {
+        auto* plugin = _lazy_follow_me.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetTargetLocation sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
         auto result =
-            _follow_me.set_target_location(translateFromRpcTargetLocation(request->location()));
+            plugin->set_target_location(translateFromRpcTargetLocation(request->location()));
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -273,11 +305,16 @@ public:
     }
 
     grpc::Status GetLastLocation(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::follow_me::GetLastLocationRequest* /* request */,
         rpc::follow_me::GetLastLocationResponse* response) override
     {
-        auto result = _follow_me.get_last_location();
+        auto* plugin = _lazy_follow_me.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->get_last_location();
 
         if (response != nullptr) {
             response->set_allocated_location(translateToRpcTargetLocation(result).release());
@@ -287,11 +324,16 @@ public:
     }
 
     grpc::Status Start(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::follow_me::StartRequest* /* request */,
         rpc::follow_me::StartResponse* response) override
     {
-        auto result = _follow_me.start();
+        auto* plugin = _lazy_follow_me.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->start();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -301,11 +343,16 @@ public:
     }
 
     grpc::Status Stop(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::follow_me::StopRequest* /* request */,
         rpc::follow_me::StopResponse* response) override
     {
-        auto result = _follow_me.stop();
+        auto* plugin = _lazy_follow_me.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->stop();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -349,7 +396,7 @@ private:
         }
     }
 
-    FollowMe& _follow_me;
+    LazyPlugin<FollowMe> _lazy_follow_me;
     std::atomic<bool> _stopped{false};
     std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
 };
@@ -5,6 +5,7 @@
 #include "ftp/ftp.grpc.pb.h"
 #include "plugins/ftp/ftp.h"
 
+#include "lazy_plugin.h"
 #include "log.h"
 #include <atomic>
 #include <cmath>
@@ -19,7 +20,9 @@ namespace backend {
 
 template<typename Ftp = Ftp> class FtpServiceImpl final : public rpc::ftp::FtpService::Service {
 public:
-    FtpServiceImpl(Ftp& ftp) : _ftp(ftp) {}
+    FtpServiceImpl(Ftp& ftp) : _lazy_ftp(ftp) {}
+
+    FtpServiceImpl(Mavsdk& mavsdk) : _lazy_ftp(mavsdk) {}
 
     template<typename ResponseType>
     void fillResponseWithResult(ResponseType* response, mavsdk::Ftp::Result& result) const
@@ -39,12 +42,16 @@ public:
     translateToRpcProgressData(const mavsdk::Ftp::ProgressData& progress_data)
     {
         auto rpc_obj = std::make_unique<rpc::ftp::ProgressData>();
+        translateToRpcProgressData(progress_data, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcProgressData(
+        const mavsdk::Ftp::ProgressData& progress_data, rpc::ftp::ProgressData* rpc_obj)
+    {
         rpc_obj->set_bytes_transferred(progress_data.bytes_transferred);
 
         rpc_obj->set_total_bytes(progress_data.total_bytes);
-
-        return rpc_obj;
     }
 
     static mavsdk::Ftp::ProgressData
@@ -126,14 +133,19 @@ public:
     }
 
     grpc::Status Reset(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::ftp::ResetRequest* /* request */,
         rpc::ftp::ResetResponse* response) override
     {
+        auto* plugin = _lazy_ftp.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         std::promise<mavsdk::Ftp::Result> prom;
         std::future<mavsdk::Ftp::Result> fut = prom.get_future();
 
-        _ftp.reset_async([&prom](const mavsdk::Ftp::Result result) { prom.set_value(result); });
+        plugin->reset_async([&prom](const mavsdk::Ftp::Result result) { prom.set_value(result); });
         auto result = fut.get();
 
         if (response != nullptr) {
@@ -144,10 +156,15 @@ public:
     }
 
     grpc::Status SubscribeDownload(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const mavsdk::rpc::ftp::SubscribeDownloadRequest* request,
         grpc::ServerWriter<rpc::ftp::DownloadResponse>* writer) override
     {
+        auto* plugin = _lazy_ftp.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         auto stream_closed_promise = std::make_shared<std::promise<void>>();
         auto stream_closed_future = stream_closed_promise->get_future();
         register_stream_stop_promise(stream_closed_promise);
@@ -156,7 +173,7 @@ public:
 
         std::mutex subscribe_mutex{};
 
-        _ftp.download_async(
+        plugin->download_async(
             request->remote_file_path(),
             request->local_dir(),
             [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
@@ -188,10 +205,15 @@ public:
     }
 
     grpc::Status SubscribeUpload(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const mavsdk::rpc::ftp::SubscribeUploadRequest* request,
         grpc::ServerWriter<rpc::ftp::UploadResponse>* writer) override
     {
+        auto* plugin = _lazy_ftp.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         auto stream_closed_promise = std::make_shared<std::promise<void>>();
         auto stream_closed_future = stream_closed_promise->get_future();
         register_stream_stop_promise(stream_closed_promise);
@@ -200,7 +222,7 @@ public:
 
         std::mutex subscribe_mutex{};
 
-        _ftp.upload_async(
+        plugin->upload_async(
             request->local_file_path(),
             request->remote_dir(),
             [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
@@ -232,16 +254,21 @@ public:
     }
 
     grpc::Status ListDirectory(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::ftp::ListDirectoryRequest* request,
         rpc::ftp::ListDirectoryResponse* response) override
     {
+        auto* plugin = _lazy_ftp.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "ListDirectory sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _ftp.list_directory(request->remote_dir());
+        auto result = plugin->list_directory(request->remote_dir());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
@@ -255,16 +282,21 @@ public:
     }
 
     grpc::Status CreateDirectory(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::ftp::CreateDirectoryRequest* request,
         rpc::ftp::CreateDirectoryResponse* response) override
     {
+        auto* plugin = _lazy_ftp.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "CreateDirectory sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _ftp.create_directory(request->remote_dir());
+        auto result = plugin->create_directory(request->remote_dir());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -274,16 +306,21 @@ public:
     }
 
     grpc::Status RemoveDirectory(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::ftp::RemoveDirectoryRequest* request,
         rpc::ftp::RemoveDirectoryResponse* response) override
     {
+        auto* plugin = _lazy_ftp.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "RemoveDirectory sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _ftp.remove_directory(request->remote_dir());
+        auto result = plugin->remove_directory(request->remote_dir());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -293,16 +330,21 @@ public:
     }
 
     grpc::Status RemoveFile(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::ftp::RemoveFileRequest* request,
         rpc::ftp::RemoveFileResponse* response) override
     {
+        auto* plugin = _lazy_ftp.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "RemoveFile sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _ftp.remove_file(request->remote_file_path());
+        auto result = plugin->remove_file(request->remote_file_path());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -312,16 +354,21 @@ public:
     }
 
     grpc::Status Rename(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::ftp::RenameRequest* request,
         rpc::ftp::RenameResponse* response) override
     {
+        auto* plugin = _lazy_ftp.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "Rename sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _ftp.rename(request->remote_from_path(), request->remote_to_path());
+        auto result = plugin->rename(request->remote_from_path(), request->remote_to_path());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -331,17 +378,22 @@ public:
     }
 
     grpc::Status AreFilesIdentical(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::ftp::AreFilesIdenticalRequest* request,
         rpc::ftp::AreFilesIdenticalResponse* response) override
     {
+        auto* plugin = _lazy_ftp.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "AreFilesIdentical sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
         auto result =
-            _ftp.are_files_identical(request->local_file_path(), request->remote_file_path());
+            plugin->are_files_identical(request->local_file_path(), request->remote_file_path());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
@@ -353,16 +405,21 @@ public:
     }
 
     grpc::Status SetRootDirectory(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::ftp::SetRootDirectoryRequest* request,
         rpc::ftp::SetRootDirectoryResponse* response) override
     {
+        auto* plugin = _lazy_ftp.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetRootDirectory sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _ftp.set_root_directory(request->root_dir());
+        auto result = plugin->set_root_directory(request->root_dir());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -372,16 +429,21 @@ public:
     }
 
     grpc::Status SetTargetCompid(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::ftp::SetTargetCompidRequest* request,
         rpc::ftp::SetTargetCompidResponse* response) override
     {
+        auto* plugin = _lazy_ftp.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetTargetCompid sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _ftp.set_target_compid(request->compid());
+        auto result = plugin->set_target_compid(request->compid());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -391,11 +453,16 @@ public:
     }
 
     grpc::Status GetOurCompid(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::ftp::GetOurCompidRequest* /* request */,
         rpc::ftp::GetOurCompidResponse* response) override
     {
-        auto result = _ftp.get_our_compid();
+        auto* plugin = _lazy_ftp.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->get_our_compid();
 
         if (response != nullptr) {
             response->set_compid(result);
@@ -439,7 +506,7 @@ private:
         }
     }
 
-    Ftp& _ftp;
+    LazyPlugin<Ftp> _lazy_ftp;
     std::atomic<bool> _stopped{false};
     std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
 };
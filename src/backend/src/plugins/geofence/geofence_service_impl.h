@@ -5,6 +5,7 @@
 #include "geofence/geofence.grpc.pb.h"
 #include "plugins/geofence/geofence.h"
 
+#include "lazy_plugin.h"
 #include "log.h"
 #include <atomic>
 #include <cmath>
@@ -20,7 +21,9 @@ namespace backend {
 template<typename Geofence = Geofence>
 class GeofenceServiceImpl final : public rpc::geofence::GeofenceService::Service {
 public:
-    GeofenceServiceImpl(Geofence& geofence) : _geofence(geofence) {}
+    GeofenceServiceImpl(Geofence& geofence) : _lazy_geofence(geofence) {}
+
+    GeofenceServiceImpl(Mavsdk& mavsdk) : _lazy_geofence(mavsdk) {}
 
     template<typename ResponseType>
     void fillResponseWithResult(ResponseType* response, mavsdk::Geofence::Result& result) const
@@ -40,12 +43,16 @@ public:
     translateToRpcPoint(const mavsdk::Geofence::Point& point)
     {
         auto rpc_obj = std::make_unique<rpc::geofence::Point>();
+        translateToRpcPoint(point, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcPoint(
+        const mavsdk::Geofence::Point& point, rpc::geofence::Point* rpc_obj)
+    {
         rpc_obj->set_latitude_deg(point.latitude_deg);
 
         rpc_obj->set_longitude_deg(point.longitude_deg);
-
-        return rpc_obj;
     }
 
     static mavsdk::Geofence::Point translateFromRpcPoint(const rpc::geofence::Point& point)
@@ -91,15 +98,19 @@ public:
     translateToRpcPolygon(const mavsdk::Geofence::Polygon& polygon)
     {
         auto rpc_obj = std::make_unique<rpc::geofence::Polygon>();
+        translateToRpcPolygon(polygon, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcPolygon(
+        const mavsdk::Geofence::Polygon& polygon, rpc::geofence::Polygon* rpc_obj)
+    {
+        rpc_obj->clear_points();
         for (const auto& elem : polygon.points) {
-            auto* ptr = rpc_obj->add_points();
-            ptr->CopyFrom(*translateToRpcPoint(elem).release());
+            translateToRpcPoint(elem, rpc_obj->add_points());
         }
 
         rpc_obj->set_fence_type(translateToRpcFenceType(polygon.fence_type));
-
-        return rpc_obj;
     }
 
     static mavsdk::Geofence::Polygon translateFromRpcPolygon(const rpc::geofence::Polygon& polygon)
@@ -165,10 +176,15 @@ public:
     }
 
     grpc::Status UploadGeofence(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::geofence::UploadGeofenceRequest* request,
         rpc::geofence::UploadGeofenceResponse* response) override
     {
+        auto* plugin = _lazy_geofence.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "UploadGeofence sent with a null request! Ignoring...";
             return grpc::Status::OK;
@@ -179,7 +195,7 @@ public:
             polygons_vec.push_back(translateFromRpcPolygon(elem));
         }
 
-        auto result = _geofence.upload_geofence(polygons_vec);
+        auto result = plugin->upload_geofence(polygons_vec);
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -223,7 +239,7 @@ private:
         }
     }
 
-    Geofence& _geofence;
+    LazyPlugin<Geofence> _lazy_geofence;
     std::atomic<bool> _stopped{false};
     std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
 };
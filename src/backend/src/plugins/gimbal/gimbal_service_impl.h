@@ -5,6 +5,7 @@
 #include "gimbal/gimbal.grpc.pb.h"
 #include "plugins/gimbal/gimbal.h"
 
+#include "lazy_plugin.h"
 #include "log.h"
 #include <atomic>
 #include <cmath>
@@ -20,7 +21,9 @@ namespace backend {
 template<typename Gimbal = Gimbal>
 class GimbalServiceImpl final : public rpc::gimbal::GimbalService::Service {
 public:
-    GimbalServiceImpl(Gimbal& gimbal) : _gimbal(gimbal) {}
+    GimbalServiceImpl(Gimbal& gimbal) : _lazy_gimbal(gimbal) {}
+
+    GimbalServiceImpl(Mavsdk& mavsdk) : _lazy_gimbal(mavsdk) {}
 
     template<typename ResponseType>
     void fillResponseWithResult(ResponseType* response, mavsdk::Gimbal::Result& result) const
@@ -105,16 +108,21 @@ public:
     }
 
     grpc::Status SetPitchAndYaw(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::gimbal::SetPitchAndYawRequest* request,
         rpc::gimbal::SetPitchAndYawResponse* response) override
     {
+        auto* plugin = _lazy_gimbal.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetPitchAndYaw sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _gimbal.set_pitch_and_yaw(request->pitch_deg(), request->yaw_deg());
+        auto result = plugin->set_pitch_and_yaw(request->pitch_deg(), request->yaw_deg());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -124,16 +132,21 @@ public:
     }
 
     grpc::Status SetMode(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::gimbal::SetModeRequest* request,
         rpc::gimbal::SetModeResponse* response) override
     {
+        auto* plugin = _lazy_gimbal.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetMode sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _gimbal.set_mode(translateFromRpcGimbalMode(request->gimbal_mode()));
+        auto result = plugin->set_mode(translateFromRpcGimbalMode(request->gimbal_mode()));
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -143,16 +156,21 @@ public:
     }
 
     grpc::Status SetRoiLocation(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::gimbal::SetRoiLocationRequest* request,
         rpc::gimbal::SetRoiLocationResponse* response) override
     {
+        auto* plugin = _lazy_gimbal.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetRoiLocation sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _gimbal.set_roi_location(
+        auto result = plugin->set_roi_location(
             request->latitude_deg(), request->longitude_deg(), request->altitude_m());
 
         if (response != nullptr) {
@@ -197,7 +215,7 @@ private:
         }
     }
 
-    Gimbal& _gimbal;
+    LazyPlugin<Gimbal> _lazy_gimbal;
     std::atomic<bool> _stopped{false};
     std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
 };
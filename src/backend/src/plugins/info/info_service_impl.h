@@ -5,6 +5,7 @@
 #include "info/info.grpc.pb.h"
 #include "plugins/info/info.h"
 
+#include "lazy_plugin.h"
 #include "log.h"
 #include <atomic>
 #include <cmath>
@@ -20,7 +21,9 @@ namespace backend {
 template<typename Info = Info>
 class InfoServiceImpl final : public rpc::info::InfoService::Service {
 public:
-    InfoServiceImpl(Info& info) : _info(info) {}
+    InfoServiceImpl(Info& info) : _lazy_info(info) {}
+
+    InfoServiceImpl(Mavsdk& mavsdk) : _lazy_info(mavsdk) {}
 
     template<typename ResponseType>
     void fillResponseWithResult(ResponseType* response, mavsdk::Info::Result& result) const
@@ -40,12 +43,16 @@ public:
     translateToRpcFlightInfo(const mavsdk::Info::FlightInfo& flight_info)
     {
         auto rpc_obj = std::make_unique<rpc::info::FlightInfo>();
+        translateToRpcFlightInfo(flight_info, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcFlightInfo(
+        const mavsdk::Info::FlightInfo& flight_info, rpc::info::FlightInfo* rpc_obj)
+    {
         rpc_obj->set_time_boot_ms(flight_info.time_boot_ms);
 
         rpc_obj->set_flight_uid(flight_info.flight_uid);
-
-        return rpc_obj;
     }
 
     static mavsdk::Info::FlightInfo
@@ -64,10 +71,14 @@ public:
     translateToRpcIdentification(const mavsdk::Info::Identification& identification)
     {
         auto rpc_obj = std::make_unique<rpc::info::Identification>();
+        translateToRpcIdentification(identification, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcIdentification(
+        const mavsdk::Info::Identification& identification, rpc::info::Identification* rpc_obj)
+    {
         rpc_obj->set_hardware_uid(identification.hardware_uid);
-
-        return rpc_obj;
     }
 
     static mavsdk::Info::Identification
@@ -84,7 +95,13 @@ public:
     translateToRpcProduct(const mavsdk::Info::Product& product)
     {
         auto rpc_obj = std::make_unique<rpc::info::Product>();
+        translateToRpcProduct(product, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcProduct(
+        const mavsdk::Info::Product& product, rpc::info::Product* rpc_obj)
+    {
         rpc_obj->set_vendor_id(product.vendor_id);
 
         rpc_obj->set_vendor_name(product.vendor_name);
@@ -92,8 +109,6 @@ public:
         rpc_obj->set_product_id(product.product_id);
 
         rpc_obj->set_product_name(product.product_name);
-
-        return rpc_obj;
     }
 
     static mavsdk::Info::Product translateFromRpcProduct(const rpc::info::Product& product)
@@ -115,7 +130,13 @@ public:
     translateToRpcVersion(const mavsdk::Info::Version& version)
     {
         auto rpc_obj = std::make_unique<rpc::info::Version>();
+        translateToRpcVersion(version, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcVersion(
+        const mavsdk::Info::Version& version, rpc::info::Version* rpc_obj)
+    {
         rpc_obj->set_flight_sw_major(version.flight_sw_major);
 
         rpc_obj->set_flight_sw_minor(version.flight_sw_minor);
@@ -137,8 +158,6 @@ public:
         rpc_obj->set_flight_sw_git_hash(version.flight_sw_git_hash);
 
         rpc_obj->set_os_sw_git_hash(version.os_sw_git_hash);
-
-        return rpc_obj;
     }
 
     static mavsdk::Info::Version translateFromRpcVersion(const rpc::info::Version& version)
@@ -201,11 +220,16 @@ public:
     }
 
     grpc::Status GetFlightInformation(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::info::GetFlightInformationRequest* /* request */,
         rpc::info::GetFlightInformationResponse* response) override
     {
-        auto result = _info.get_flight_information();
+        auto* plugin = _lazy_info.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->get_flight_information();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
@@ -217,11 +241,16 @@ public:
     }
 
     grpc::Status GetIdentification(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::info::GetIdentificationRequest* /* request */,
         rpc::info::GetIdentificationResponse* response) override
     {
-        auto result = _info.get_identification();
+        auto* plugin = _lazy_info.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->get_identification();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
@@ -234,11 +263,16 @@ public:
     }
 
     grpc::Status GetProduct(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::info::GetProductRequest* /* request */,
         rpc::info::GetProductResponse* response) override
     {
-        auto result = _info.get_product();
+        auto* plugin = _lazy_info.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->get_product();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
@@ -250,11 +284,16 @@ public:
     }
 
     grpc::Status GetVersion(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::info::GetVersionRequest* /* request */,
         rpc::info::GetVersionResponse* response) override
     {
-        auto result = _info.get_version();
+        auto* plugin = _lazy_info.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->get_version();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
@@ -266,11 +305,16 @@ public:
     }
 
     grpc::Status GetSpeedFactor(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::info::GetSpeedFactorRequest* /* request */,
         rpc::info::GetSpeedFactorResponse* response) override
     {
-        auto result = _info.get_speed_factor();
+        auto* plugin = _lazy_info.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->get_speed_factor();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
@@ -316,7 +360,7 @@ private:
         }
     }
 
-    Info& _info;
+    LazyPlugin<Info> _lazy_info;
     std::atomic<bool> _stopped{false};
     std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
 };
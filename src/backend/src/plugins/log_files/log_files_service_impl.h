@@ -5,6 +5,7 @@
 #include "log_files/log_files.grpc.pb.h"
 #include "plugins/log_files/log_files.h"
 
+#include "lazy_plugin.h"
 #include "log.h"
 #include <atomic>
 #include <cmath>
@@ -20,7 +21,9 @@ namespace backend {
 template<typename LogFiles = LogFiles>
 class LogFilesServiceImpl final : public rpc::log_files::LogFilesService::Service {
 public:
-    LogFilesServiceImpl(LogFiles& log_files) : _log_files(log_files) {}
+    LogFilesServiceImpl(LogFiles& log_files) : _lazy_log_files(log_files) {}
+
+    LogFilesServiceImpl(Mavsdk& mavsdk) : _lazy_log_files(mavsdk) {}
 
     template<typename ResponseType>
     void fillResponseWithResult(ResponseType* response, mavsdk::LogFiles::Result& result) const
@@ -40,10 +43,14 @@ public:
     translateToRpcProgressData(const mavsdk::LogFiles::ProgressData& progress_data)
     {
         auto rpc_obj = std::make_unique<rpc::log_files::ProgressData>();
+        translateToRpcProgressData(progress_data, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcProgressData(
+        const mavsdk::LogFiles::ProgressData& progress_data, rpc::log_files::ProgressData* rpc_obj)
+    {
         rpc_obj->set_progress(progress_data.progress);
-
-        return rpc_obj;
     }
 
     static mavsdk::LogFiles::ProgressData
@@ -60,14 +67,18 @@ public:
     translateToRpcEntry(const mavsdk::LogFiles::Entry& entry)
     {
         auto rpc_obj = std::make_unique<rpc::log_files::Entry>();
+        translateToRpcEntry(entry, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcEntry(
+        const mavsdk::LogFiles::Entry& entry, rpc::log_files::Entry* rpc_obj)
+    {
         rpc_obj->set_id(entry.id);
 
         rpc_obj->set_date(entry.date);
 
         rpc_obj->set_size_bytes(entry.size_bytes);
-
-        return rpc_obj;
     }
 
     static mavsdk::LogFiles::Entry translateFromRpcEntry(const rpc::log_files::Entry& entry)
@@ -132,11 +143,16 @@ public:
     }
 
     grpc::Status GetEntries(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::log_files::GetEntriesRequest* /* request */,
         rpc::log_files::GetEntriesResponse* response) override
     {
-        auto result = _log_files.get_entries();
+        auto* plugin = _lazy_log_files.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->get_entries();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
@@ -151,10 +167,15 @@ public:
     }
 
     grpc::Status SubscribeDownloadLogFile(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const mavsdk::rpc::log_files::SubscribeDownloadLogFileRequest* request,
         grpc::ServerWriter<rpc::log_files::DownloadLogFileResponse>* writer) override
     {
+        auto* plugin = _lazy_log_files.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         auto stream_closed_promise = std::make_shared<std::promise<void>>();
         auto stream_closed_future = stream_closed_promise->get_future();
         register_stream_stop_promise(stream_closed_promise);
@@ -163,7 +184,7 @@ public:
 
         std::mutex subscribe_mutex{};
 
-        _log_files.download_log_file_async(
+        plugin->download_log_file_async(
             request->id(),
             request->path(),
             [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
@@ -230,7 +251,7 @@ private:
         }
     }
 
-    LogFiles& _log_files;
+    LazyPlugin<LogFiles> _lazy_log_files;
     std::atomic<bool> _stopped{false};
     std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
 };
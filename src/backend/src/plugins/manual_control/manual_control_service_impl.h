@@ -6,6 +6,7 @@
 #include "manual_control/manual_control.grpc.pb.h"
 #include "plugins/manual_control/manual_control.h"
 
+#include "lazy_plugin.h"
 #include "log.h"
 #include <atomic>
 #include <cmath>
@@ -21,7 +22,11 @@ namespace backend {
 template<typename ManualControl = ManualControl>
 class ManualControlServiceImpl final : public rpc::manual_control::ManualControlService::Service {
 public:
-    ManualControlServiceImpl(ManualControl& manual_control) : _manual_control(manual_control) {}
+    ManualControlServiceImpl(ManualControl& manual_control) :
+        _lazy_manual_control(manual_control)
+    {}
+
+    ManualControlServiceImpl(Mavsdk& mavsdk) : _lazy_manual_control(mavsdk) {}
 
     template<typename ResponseType>
     void fillResponseWithResult(ResponseType* response, mavsdk::ManualControl::Result& result) const
@@ -94,11 +99,16 @@ public:
     }
 
     grpc::Status StartPositionControl(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::manual_control::StartPositionControlRequest* /* request */,
         rpc::manual_control::StartPositionControlResponse* response) override
     {
-        auto result = _manual_control.start_position_control();
+        auto* plugin = _lazy_manual_control.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->start_position_control();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -108,11 +118,16 @@ public:
     }
 
     grpc::Status StartAltitudeControl(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::manual_control::StartAltitudeControlRequest* /* request */,
         rpc::manual_control::StartAltitudeControlResponse* response) override
     {
-        auto result = _manual_control.start_altitude_control();
+        auto* plugin = _lazy_manual_control.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->start_altitude_control();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -122,16 +137,21 @@ public:
     }
 
     grpc::Status SetManualControlInput(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::manual_control::SetManualControlInputRequest* request,
         rpc::manual_control::SetManualControlInputResponse* response) override
     {
+        auto* plugin = _lazy_manual_control.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetManualControlInput sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _manual_control.set_manual_control_input(
+        auto result = plugin->set_manual_control_input(
             request->x(), request->y(), request->z(), request->r());
 
         if (response != nullptr) {
@@ -176,7 +196,7 @@ private:
         }
     }
 
-    ManualControl& _manual_control;
+    LazyPlugin<ManualControl> _lazy_manual_control;
     std::atomic<bool> _stopped{false};
     std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
 };
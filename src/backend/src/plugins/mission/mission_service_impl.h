@@ -5,6 +5,7 @@
 #include "mission/mission.grpc.pb.h"
 #include "plugins/mission/mission.h"
 
+#include "lazy_plugin.h"
 #include "log.h"
 #include <atomic>
 #include <cmath>
@@ -20,7 +21,9 @@ namespace backend {
 template<typename Mission = Mission>
 class MissionServiceImpl final : public rpc::mission::MissionService::Service {
 public:
-    MissionServiceImpl(Mission& mission) : _mission(mission) {}
+    MissionServiceImpl(Mission& mission) : _lazy_mission(mission) {}
+
+    MissionServiceImpl(Mavsdk& mavsdk) : _lazy_mission(mavsdk) {}
 
     template<typename ResponseType>
     void fillResponseWithResult(ResponseType* response, mavsdk::Mission::Result& result) const
@@ -84,7 +87,13 @@ public:
     translateToRpcMissionItem(const mavsdk::Mission::MissionItem& mission_item)
     {
         auto rpc_obj = std::make_unique<rpc::mission::MissionItem>();
+        translateToRpcMissionItem(mission_item, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcMissionItem(
+        const mavsdk::Mission::MissionItem& mission_item, rpc::mission::MissionItem* rpc_obj)
+    {
         rpc_obj->set_latitude_deg(mission_item.latitude_deg);
 
         rpc_obj->set_longitude_deg(mission_item.longitude_deg);
@@ -104,8 +113,6 @@ public:
         rpc_obj->set_loiter_time_s(mission_item.loiter_time_s);
 
         rpc_obj->set_camera_photo_interval_s(mission_item.camera_photo_interval_s);
-
-        return rpc_obj;
     }
 
     static mavsdk::Mission::MissionItem
@@ -140,13 +147,17 @@ public:
     translateToRpcMissionPlan(const mavsdk::Mission::MissionPlan& mission_plan)
     {
         auto rpc_obj = std::make_unique<rpc::mission::MissionPlan>();
+        translateToRpcMissionPlan(mission_plan, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcMissionPlan(
+        const mavsdk::Mission::MissionPlan& mission_plan, rpc::mission::MissionPlan* rpc_obj)
+    {
+        rpc_obj->clear_mission_items();
         for (const auto& elem : mission_plan.mission_items) {
-            auto* ptr = rpc_obj->add_mission_items();
-            ptr->CopyFrom(*translateToRpcMissionItem(elem).release());
+            translateToRpcMissionItem(elem, rpc_obj->add_mission_items());
         }
-
-        return rpc_obj;
     }
 
     static mavsdk::Mission::MissionPlan
@@ -166,12 +177,17 @@ public:
     translateToRpcMissionProgress(const mavsdk::Mission::MissionProgress& mission_progress)
     {
         auto rpc_obj = std::make_unique<rpc::mission::MissionProgress>();
+        translateToRpcMissionProgress(mission_progress, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcMissionProgress(
+        const mavsdk::Mission::MissionProgress& mission_progress,
+        rpc::mission::MissionProgress* rpc_obj)
+    {
         rpc_obj->set_current(mission_progress.current);
 
         rpc_obj->set_total(mission_progress.total);
-
-        return rpc_obj;
     }
 
     static mavsdk::Mission::MissionProgress
@@ -259,16 +275,21 @@ public:
     }
 
     grpc::Status UploadMission(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission::UploadMissionRequest* request,
         rpc::mission::UploadMissionResponse* response) override
     {
+        auto* plugin = _lazy_mission.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "UploadMission sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _mission.upload_mission(translateFromRpcMissionPlan(request->mission_plan()));
+        auto result = plugin->upload_mission(translateFromRpcMissionPlan(request->mission_plan()));
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -278,11 +299,16 @@ public:
     }
 
     grpc::Status CancelMissionUpload(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission::CancelMissionUploadRequest* /* request */,
         rpc::mission::CancelMissionUploadResponse* response) override
     {
-        auto result = _mission.cancel_mission_upload();
+        auto* plugin = _lazy_mission.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->cancel_mission_upload();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -292,11 +318,16 @@ public:
     }
 
     grpc::Status DownloadMission(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission::DownloadMissionRequest* /* request */,
         rpc::mission::DownloadMissionResponse* response) override
     {
-        auto result = _mission.download_mission();
+        auto* plugin = _lazy_mission.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->download_mission();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
@@ -309,11 +340,16 @@ public:
     }
 
     grpc::Status CancelMissionDownload(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission::CancelMissionDownloadRequest* /* request */,
         rpc::mission::CancelMissionDownloadResponse* response) override
     {
-        auto result = _mission.cancel_mission_download();
+        auto* plugin = _lazy_mission.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->cancel_mission_download();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -323,11 +359,16 @@ public:
     }
 
     grpc::Status StartMission(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission::StartMissionRequest* /* request */,
         rpc::mission::StartMissionResponse* response) override
     {
-        auto result = _mission.start_mission();
+        auto* plugin = _lazy_mission.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->start_mission();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -337,11 +378,16 @@ public:
     }
 
     grpc::Status PauseMission(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission::PauseMissionRequest* /* request */,
         rpc::mission::PauseMissionResponse* response) override
     {
-        auto result = _mission.pause_mission();
+        auto* plugin = _lazy_mission.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->pause_mission();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -351,11 +397,16 @@ public:
     }
 
     grpc::Status ClearMission(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission::ClearMissionRequest* /* request */,
         rpc::mission::ClearMissionResponse* response) override
     {
-        auto result = _mission.clear_mission();
+        auto* plugin = _lazy_mission.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->clear_mission();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -365,16 +416,21 @@ public:
     }
 
     grpc::Status SetCurrentMissionItem(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission::SetCurrentMissionItemRequest* request,
         rpc::mission::SetCurrentMissionItemResponse* response) override
     {
+        auto* plugin = _lazy_mission.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetCurrentMissionItem sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _mission.set_current_mission_item(request->index());
+        auto result = plugin->set_current_mission_item(request->index());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -384,11 +440,16 @@ public:
     }
 
     grpc::Status IsMissionFinished(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission::IsMissionFinishedRequest* /* request */,
         rpc::mission::IsMissionFinishedResponse* response) override
     {
-        auto result = _mission.is_mission_finished();
+        auto* plugin = _lazy_mission.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->is_mission_finished();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
@@ -400,10 +461,15 @@ public:
     }
 
     grpc::Status SubscribeMissionProgress(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const mavsdk::rpc::mission::SubscribeMissionProgressRequest* /* request */,
         grpc::ServerWriter<rpc::mission::MissionProgressResponse>* writer) override
     {
+        auto* plugin = _lazy_mission.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         auto stream_closed_promise = std::make_shared<std::promise<void>>();
         auto stream_closed_future = stream_closed_promise->get_future();
         register_stream_stop_promise(stream_closed_promise);
@@ -412,8 +478,8 @@ public:
 
         std::mutex subscribe_mutex{};
 
-        _mission.subscribe_mission_progress(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
+        plugin->subscribe_mission_progress(
+            [this, plugin, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
                 const mavsdk::Mission::MissionProgress mission_progress) {
                 rpc::mission::MissionProgressResponse rpc_response;
 
@@ -422,7 +488,7 @@ public:
 
                 std::unique_lock<std::mutex> lock(subscribe_mutex);
                 if (!*is_finished && !writer->Write(rpc_response)) {
-                    _mission.subscribe_mission_progress(nullptr);
+                    plugin->subscribe_mission_progress(nullptr);
 
                     *is_finished = true;
                     unregister_stream_stop_promise(stream_closed_promise);
@@ -436,11 +502,16 @@ public:
     }
 
     grpc::Status GetReturnToLaunchAfterMission(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission::GetReturnToLaunchAfterMissionRequest* /* request */,
         rpc::mission::GetReturnToLaunchAfterMissionResponse* response) override
     {
-        auto result = _mission.get_return_to_launch_after_mission();
+        auto* plugin = _lazy_mission.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->get_return_to_launch_after_mission();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
@@ -452,16 +523,21 @@ public:
     }
 
     grpc::Status SetReturnToLaunchAfterMission(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission::SetReturnToLaunchAfterMissionRequest* request,
         rpc::mission::SetReturnToLaunchAfterMissionResponse* response) override
     {
+        auto* plugin = _lazy_mission.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetReturnToLaunchAfterMission sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _mission.set_return_to_launch_after_mission(request->enable());
+        auto result = plugin->set_return_to_launch_after_mission(request->enable());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -471,16 +547,21 @@ public:
     }
 
     grpc::Status ImportQgroundcontrolMission(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission::ImportQgroundcontrolMissionRequest* request,
         rpc::mission::ImportQgroundcontrolMissionResponse* response) override
     {
+        auto* plugin = _lazy_mission.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "ImportQgroundcontrolMission sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _mission.import_qgroundcontrol_mission(request->qgc_plan_path());
+        auto result = plugin->import_qgroundcontrol_mission(request->qgc_plan_path());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
@@ -527,7 +608,7 @@ private:
         }
     }
 
-    Mission& _mission;
+    LazyPlugin<Mission> _lazy_mission;
     std::atomic<bool> _stopped{false};
     std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
 };
@@ -5,6 +5,7 @@
 #include "mission_raw/mission_raw.grpc.pb.h"
 #include "plugins/mission_raw/mission_raw.h"
 
+#include "lazy_plugin.h"
 #include "log.h"
 #include <atomic>
 #include <cmath>
@@ -20,7 +21,9 @@ namespace backend {
 template<typename MissionRaw = MissionRaw>
 class MissionRawServiceImpl final : public rpc::mission_raw::MissionRawService::Service {
 public:
-    MissionRawServiceImpl(MissionRaw& mission_raw) : _mission_raw(mission_raw) {}
+    MissionRawServiceImpl(MissionRaw& mission_raw) : _lazy_mission_raw(mission_raw) {}
+
+    MissionRawServiceImpl(Mavsdk& mavsdk) : _lazy_mission_raw(mavsdk) {}
 
     template<typename ResponseType>
     void fillResponseWithResult(ResponseType* response, mavsdk::MissionRaw::Result& result) const
@@ -40,12 +43,17 @@ public:
     translateToRpcMissionProgress(const mavsdk::MissionRaw::MissionProgress& mission_progress)
     {
         auto rpc_obj = std::make_unique<rpc::mission_raw::MissionProgress>();
+        translateToRpcMissionProgress(mission_progress, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcMissionProgress(
+        const mavsdk::MissionRaw::MissionProgress& mission_progress,
+        rpc::mission_raw::MissionProgress* rpc_obj)
+    {
         rpc_obj->set_current(mission_progress.current);
 
         rpc_obj->set_total(mission_progress.total);
-
-        return rpc_obj;
     }
 
     static mavsdk::MissionRaw::MissionProgress
@@ -64,7 +72,13 @@ public:
     translateToRpcMissionItem(const mavsdk::MissionRaw::MissionItem& mission_item)
     {
         auto rpc_obj = std::make_unique<rpc::mission_raw::MissionItem>();
+        translateToRpcMissionItem(mission_item, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcMissionItem(
+        const mavsdk::MissionRaw::MissionItem& mission_item, rpc::mission_raw::MissionItem* rpc_obj)
+    {
         rpc_obj->set_seq(mission_item.seq);
 
         rpc_obj->set_frame(mission_item.frame);
@@ -90,8 +104,6 @@ public:
         rpc_obj->set_z(mission_item.z);
 
         rpc_obj->set_mission_type(mission_item.mission_type);
-
-        return rpc_obj;
     }
 
     static mavsdk::MissionRaw::MissionItem
@@ -189,10 +201,15 @@ public:
     }
 
     grpc::Status UploadMission(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission_raw::UploadMissionRequest* request,
         rpc::mission_raw::UploadMissionResponse* response) override
     {
+        auto* plugin = _lazy_mission_raw.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "UploadMission sent with a null request! Ignoring...";
             return grpc::Status::OK;
@@ -203,7 +220,7 @@ public:
             mission_items_vec.push_back(translateFromRpcMissionItem(elem));
         }
 
-        auto result = _mission_raw.upload_mission(mission_items_vec);
+        auto result = plugin->upload_mission(mission_items_vec);
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -213,11 +230,16 @@ public:
     }
 
     grpc::Status CancelMissionUpload(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission_raw::CancelMissionUploadRequest* /* request */,
         rpc::mission_raw::CancelMissionUploadResponse* response) override
     {
-        auto result = _mission_raw.cancel_mission_upload();
+        auto* plugin = _lazy_mission_raw.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->cancel_mission_upload();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -227,11 +249,16 @@ public:
     }
 
     grpc::Status DownloadMission(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission_raw::DownloadMissionRequest* /* request */,
         rpc::mission_raw::DownloadMissionResponse* response) override
     {
-        auto result = _mission_raw.download_mission();
+        auto* plugin = _lazy_mission_raw.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->download_mission();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
@@ -246,11 +273,16 @@ public:
     }
 
     grpc::Status CancelMissionDownload(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission_raw::CancelMissionDownloadRequest* /* request */,
         rpc::mission_raw::CancelMissionDownloadResponse* response) override
     {
-        auto result = _mission_raw.cancel_mission_download();
+        auto* plugin = _lazy_mission_raw.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->cancel_mission_download();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -260,11 +292,16 @@ public:
     }
 
     grpc::Status StartMission(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission_raw::StartMissionRequest* /* request */,
         rpc::mission_raw::StartMissionResponse* response) override
     {
-        auto result = _mission_raw.start_mission();
+        auto* plugin = _lazy_mission_raw.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->start_mission();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -274,11 +311,16 @@ public:
     }
 
     grpc::Status PauseMission(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission_raw::PauseMissionRequest* /* request */,
         rpc::mission_raw::PauseMissionResponse* response) override
     {
-        auto result = _mission_raw.pause_mission();
+        auto* plugin = _lazy_mission_raw.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->pause_mission();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -288,11 +330,16 @@ public:
     }
 
     grpc::Status ClearMission(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission_raw::ClearMissionRequest* /* request */,
         rpc::mission_raw::ClearMissionResponse* response) override
     {
-        auto result = _mission_raw.clear_mission();
+        auto* plugin = _lazy_mission_raw.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->clear_mission();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -302,16 +349,21 @@ public:
     }
 
     grpc::Status SetCurrentMissionItem(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mission_raw::SetCurrentMissionItemRequest* request,
         rpc::mission_raw::SetCurrentMissionItemResponse* response) override
     {
+        auto* plugin = _lazy_mission_raw.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetCurrentMissionItem sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _mission_raw.set_current_mission_item(request->index());
+        auto result = plugin->set_current_mission_item(request->index());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -321,10 +373,15 @@ public:
     }
 
     grpc::Status SubscribeMissionProgress(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const mavsdk::rpc::mission_raw::SubscribeMissionProgressRequest* /* request */,
         grpc::ServerWriter<rpc::mission_raw::MissionProgressResponse>* writer) override
     {
+        auto* plugin = _lazy_mission_raw.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         auto stream_closed_promise = std::make_shared<std::promise<void>>();
         auto stream_closed_future = stream_closed_promise->get_future();
         register_stream_stop_promise(stream_closed_promise);
@@ -333,8 +390,8 @@ public:
 
         std::mutex subscribe_mutex{};
 
-        _mission_raw.subscribe_mission_progress(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
+        plugin->subscribe_mission_progress(
+            [this, plugin, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
                 const mavsdk::MissionRaw::MissionProgress mission_progress) {
                 rpc::mission_raw::MissionProgressResponse rpc_response;
 
@@ -343,7 +400,7 @@ public:
 
                 std::unique_lock<std::mutex> lock(subscribe_mutex);
                 if (!*is_finished && !writer->Write(rpc_response)) {
-                    _mission_raw.subscribe_mission_progress(nullptr);
+                    plugin->subscribe_mission_progress(nullptr);
 
                     *is_finished = true;
                     unregister_stream_stop_promise(stream_closed_promise);
@@ -357,10 +414,15 @@ public:
     }
 
     grpc::Status SubscribeMissionChanged(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const mavsdk::rpc::mission_raw::SubscribeMissionChangedRequest* /* request */,
         grpc::ServerWriter<rpc::mission_raw::MissionChangedResponse>* writer) override
     {
+        auto* plugin = _lazy_mission_raw.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         auto stream_closed_promise = std::make_shared<std::promise<void>>();
         auto stream_closed_future = stream_closed_promise->get_future();
         register_stream_stop_promise(stream_closed_promise);
@@ -369,8 +431,8 @@ public:
 
         std::mutex subscribe_mutex{};
 
-        _mission_raw.subscribe_mission_changed(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
+        plugin->subscribe_mission_changed(
+            [this, plugin, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
                 const bool mission_changed) {
                 rpc::mission_raw::MissionChangedResponse rpc_response;
 
@@ -378,7 +440,7 @@ public:
 
                 std::unique_lock<std::mutex> lock(subscribe_mutex);
                 if (!*is_finished && !writer->Write(rpc_response)) {
-                    _mission_raw.subscribe_mission_changed(nullptr);
+                    plugin->subscribe_mission_changed(nullptr);
 
                     *is_finished = true;
                     unregister_stream_stop_promise(stream_closed_promise);
@@ -426,7 +488,7 @@ private:
         }
     }
 
-    MissionRaw& _mission_raw;
+    LazyPlugin<MissionRaw> _lazy_mission_raw;
     std::atomic<bool> _stopped{false};
     std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
 };
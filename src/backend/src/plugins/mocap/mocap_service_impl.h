@@ -5,6 +5,7 @@
 #include "mocap/mocap.grpc.pb.h"
 #include "plugins/mocap/mocap.h"
 
+#include "lazy_plugin.h"
 #include "log.h"
 #include <atomic>
 #include <cmath>
@@ -20,7 +21,9 @@ namespace backend {
 template<typename Mocap = Mocap>
 class MocapServiceImpl final : public rpc::mocap::MocapService::Service {
 public:
-    MocapServiceImpl(Mocap& mocap) : _mocap(mocap) {}
+    MocapServiceImpl(Mocap& mocap) : _lazy_mocap(mocap) {}
+
+    MocapServiceImpl(Mavsdk& mavsdk) : _lazy_mocap(mavsdk) {}
 
     template<typename ResponseType>
     void fillResponseWithResult(ResponseType* response, mavsdk::Mocap::Result& result) const
@@ -40,14 +43,18 @@ public:
     translateToRpcPositionBody(const mavsdk::Mocap::PositionBody& position_body)
     {
         auto rpc_obj = std::make_unique<rpc::mocap::PositionBody>();
+        translateToRpcPositionBody(position_body, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcPositionBody(
+        const mavsdk::Mocap::PositionBody& position_body, rpc::mocap::PositionBody* rpc_obj)
+    {
         rpc_obj->set_x_m(position_body.x_m);
 
         rpc_obj->set_y_m(position_body.y_m);
 
         rpc_obj->set_z_m(position_body.z_m);
-
-        return rpc_obj;
     }
 
     static mavsdk::Mocap::PositionBody
@@ -68,14 +75,18 @@ public:
     translateToRpcAngleBody(const mavsdk::Mocap::AngleBody& angle_body)
     {
         auto rpc_obj = std::make_unique<rpc::mocap::AngleBody>();
+        translateToRpcAngleBody(angle_body, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcAngleBody(
+        const mavsdk::Mocap::AngleBody& angle_body, rpc::mocap::AngleBody* rpc_obj)
+    {
         rpc_obj->set_roll_rad(angle_body.roll_rad);
 
         rpc_obj->set_pitch_rad(angle_body.pitch_rad);
 
         rpc_obj->set_yaw_rad(angle_body.yaw_rad);
-
-        return rpc_obj;
     }
 
     static mavsdk::Mocap::AngleBody
@@ -96,14 +107,18 @@ public:
     translateToRpcSpeedBody(const mavsdk::Mocap::SpeedBody& speed_body)
     {
         auto rpc_obj = std::make_unique<rpc::mocap::SpeedBody>();
+        translateToRpcSpeedBody(speed_body, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcSpeedBody(
+        const mavsdk::Mocap::SpeedBody& speed_body, rpc::mocap::SpeedBody* rpc_obj)
+    {
         rpc_obj->set_x_m_s(speed_body.x_m_s);
 
         rpc_obj->set_y_m_s(speed_body.y_m_s);
 
         rpc_obj->set_z_m_s(speed_body.z_m_s);
-
-        return rpc_obj;
     }
 
     static mavsdk::Mocap::SpeedBody
@@ -124,14 +139,19 @@ public:
         const mavsdk::Mocap::AngularVelocityBody& angular_velocity_body)
     {
         auto rpc_obj = std::make_unique<rpc::mocap::AngularVelocityBody>();
+        translateToRpcAngularVelocityBody(angular_velocity_body, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcAngularVelocityBody(
+        const mavsdk::Mocap::AngularVelocityBody& angular_velocity_body,
+        rpc::mocap::AngularVelocityBody* rpc_obj)
+    {
         rpc_obj->set_roll_rad_s(angular_velocity_body.roll_rad_s);
 
         rpc_obj->set_pitch_rad_s(angular_velocity_body.pitch_rad_s);
 
         rpc_obj->set_yaw_rad_s(angular_velocity_body.yaw_rad_s);
-
-        return rpc_obj;
     }
 
     static mavsdk::Mocap::AngularVelocityBody translateFromRpcAngularVelocityBody(
@@ -152,12 +172,17 @@ public:
     translateToRpcCovariance(const mavsdk::Mocap::Covariance& covariance)
     {
         auto rpc_obj = std::make_unique<rpc::mocap::Covariance>();
+        translateToRpcCovariance(covariance, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcCovariance(
+        const mavsdk::Mocap::Covariance& covariance, rpc::mocap::Covariance* rpc_obj)
+    {
+        rpc_obj->clear_covariance_matrix();
         for (const auto& elem : covariance.covariance_matrix) {
             rpc_obj->add_covariance_matrix(elem);
         }
-
-        return rpc_obj;
     }
 
     static mavsdk::Mocap::Covariance
@@ -176,7 +201,13 @@ public:
     translateToRpcQuaternion(const mavsdk::Mocap::Quaternion& quaternion)
     {
         auto rpc_obj = std::make_unique<rpc::mocap::Quaternion>();
+        translateToRpcQuaternion(quaternion, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcQuaternion(
+        const mavsdk::Mocap::Quaternion& quaternion, rpc::mocap::Quaternion* rpc_obj)
+    {
         rpc_obj->set_w(quaternion.w);
 
         rpc_obj->set_x(quaternion.x);
@@ -184,8 +215,6 @@ public:
         rpc_obj->set_y(quaternion.y);
 
         rpc_obj->set_z(quaternion.z);
-
-        return rpc_obj;
     }
 
     static mavsdk::Mocap::Quaternion
@@ -208,19 +237,23 @@ public:
         const mavsdk::Mocap::VisionPositionEstimate& vision_position_estimate)
     {
         auto rpc_obj = std::make_unique<rpc::mocap::VisionPositionEstimate>();
+        translateToRpcVisionPositionEstimate(vision_position_estimate, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcVisionPositionEstimate(
+        const mavsdk::Mocap::VisionPositionEstimate& vision_position_estimate,
+        rpc::mocap::VisionPositionEstimate* rpc_obj)
+    {
         rpc_obj->set_time_usec(vision_position_estimate.time_usec);
 
-        rpc_obj->set_allocated_position_body(
-            translateToRpcPositionBody(vision_position_estimate.position_body).release());
-
-        rpc_obj->set_allocated_angle_body(
-            translateToRpcAngleBody(vision_position_estimate.angle_body).release());
+        translateToRpcPositionBody(
+            vision_position_estimate.position_body, rpc_obj->mutable_position_body());
 
-        rpc_obj->set_allocated_pose_covariance(
-            translateToRpcCovariance(vision_position_estimate.pose_covariance).release());
+        translateToRpcAngleBody(vision_position_estimate.angle_body, rpc_obj->mutable_angle_body());
 
-        return rpc_obj;
+        translateToRpcCovariance(
+            vision_position_estimate.pose_covariance, rpc_obj->mutable_pose_covariance());
     }
 
     static mavsdk::Mocap::VisionPositionEstimate translateFromRpcVisionPositionEstimate(
@@ -244,18 +277,23 @@ public:
         const mavsdk::Mocap::AttitudePositionMocap& attitude_position_mocap)
     {
         auto rpc_obj = std::make_unique<rpc::mocap::AttitudePositionMocap>();
+        translateToRpcAttitudePositionMocap(attitude_position_mocap, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcAttitudePositionMocap(
+        const mavsdk::Mocap::AttitudePositionMocap& attitude_position_mocap,
+        rpc::mocap::AttitudePositionMocap* rpc_obj)
+    {
         rpc_obj->set_time_usec(attitude_position_mocap.time_usec);
 
-        rpc_obj->set_allocated_q(translateToRpcQuaternion(attitude_position_mocap.q).release());
+        translateToRpcQuaternion(attitude_position_mocap.q, rpc_obj->mutable_q());
 
-        rpc_obj->set_allocated_position_body(
-            translateToRpcPositionBody(attitude_position_mocap.position_body).release());
+        translateToRpcPositionBody(
+            attitude_position_mocap.position_body, rpc_obj->mutable_position_body());
 
-        rpc_obj->set_allocated_pose_covariance(
-            translateToRpcCovariance(attitude_position_mocap.pose_covariance).release());
-
-        return rpc_obj;
+        translateToRpcCovariance(
+            attitude_position_mocap.pose_covariance, rpc_obj->mutable_pose_covariance());
     }
 
     static mavsdk::Mocap::AttitudePositionMocap translateFromRpcAttitudePositionMocap(
@@ -306,28 +344,30 @@ public:
     translateToRpcOdometry(const mavsdk::Mocap::Odometry& odometry)
     {
         auto rpc_obj = std::make_unique<rpc::mocap::Odometry>();
+        translateToRpcOdometry(odometry, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcOdometry(
+        const mavsdk::Mocap::Odometry& odometry, rpc::mocap::Odometry* rpc_obj)
+    {
         rpc_obj->set_time_usec(odometry.time_usec);
 
         rpc_obj->set_frame_id(translateToRpcMavFrame(odometry.frame_id));
 
-        rpc_obj->set_allocated_position_body(
-            translateToRpcPositionBody(odometry.position_body).release());
-
-        rpc_obj->set_allocated_q(translateToRpcQuaternion(odometry.q).release());
+        translateToRpcPositionBody(odometry.position_body, rpc_obj->mutable_position_body());
 
-        rpc_obj->set_allocated_speed_body(translateToRpcSpeedBody(odometry.speed_body).release());
+        translateToRpcQuaternion(odometry.q, rpc_obj->mutable_q());
 
-        rpc_obj->set_allocated_angular_velocity_body(
-            translateToRpcAngularVelocityBody(odometry.angular_velocity_body).release());
+        translateToRpcSpeedBody(odometry.speed_body, rpc_obj->mutable_speed_body());
 
-        rpc_obj->set_allocated_pose_covariance(
-            translateToRpcCovariance(odometry.pose_covariance).release());
+        translateToRpcAngularVelocityBody(
+            odometry.angular_velocity_body, rpc_obj->mutable_angular_velocity_body());
 
-        rpc_obj->set_allocated_velocity_covariance(
-            translateToRpcCovariance(odometry.velocity_covariance).release());
+        translateToRpcCovariance(odometry.pose_covariance, rpc_obj->mutable_pose_covariance());
 
-        return rpc_obj;
+        translateToRpcCovariance(
+            odometry.velocity_covariance, rpc_obj->mutable_velocity_covariance());
     }
 
     static mavsdk::Mocap::Odometry translateFromRpcOdometry(const rpc::mocap::Odometry& odometry)
@@ -394,16 +434,21 @@ public:
     }
 
     grpc::Status SetVisionPositionEstimate(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mocap::SetVisionPositionEstimateRequest* request,
         rpc::mocap::SetVisionPositionEstimateResponse* response) override
     {
+        auto* plugin = _lazy_mocap.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetVisionPositionEstimate sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _mocap.set_vision_position_estimate(
+        auto result = plugin->set_vision_position_estimate(
             translateFromRpcVisionPositionEstimate(request->vision_position_estimate()));
 
         if (response != nullptr) {
@@ -414,16 +459,21 @@ public:
     }
 
     grpc::Status SetAttitudePositionMocap(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mocap::SetAttitudePositionMocapRequest* request,
         rpc::mocap::SetAttitudePositionMocapResponse* response) override
     {
+        auto* plugin = _lazy_mocap.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetAttitudePositionMocap sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _mocap.set_attitude_position_mocap(
+        auto result = plugin->set_attitude_position_mocap(
             translateFromRpcAttitudePositionMocap(request->attitude_position_mocap()));
 
         if (response != nullptr) {
@@ -434,16 +484,21 @@ public:
     }
 
     grpc::Status SetOdometry(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::mocap::SetOdometryRequest* request,
         rpc::mocap::SetOdometryResponse* response) override
     {
+        auto* plugin = _lazy_mocap.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetOdometry sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _mocap.set_odometry(translateFromRpcOdometry(request->odometry()));
+        auto result = plugin->set_odometry(translateFromRpcOdometry(request->odometry()));
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -487,7 +542,7 @@ private:
         }
     }
 
-    Mocap& _mocap;
+    LazyPlugin<Mocap> _lazy_mocap;
     std::atomic<bool> _stopped{false};
     std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
 };
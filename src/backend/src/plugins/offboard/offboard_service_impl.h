@@ -5,6 +5,7 @@
 #include "offboard/offboard.grpc.pb.h"
 #include "plugins/offboard/offboard.h"
 
+#include "lazy_plugin.h"
 #include "log.h"
 #include <atomic>
 #include <cmath>
@@ -20,7 +21,9 @@ namespace backend {
 template<typename Offboard = Offboard>
 class OffboardServiceImpl final : public rpc::offboard::OffboardService::Service {
 public:
-    OffboardServiceImpl(Offboard& offboard) : _offboard(offboard) {}
+    OffboardServiceImpl(Offboard& offboard) : _lazy_offboard(offboard) {}
+
+    OffboardServiceImpl(Mavsdk& mavsdk) : _lazy_offboard(mavsdk) {}
 
     template<typename ResponseType>
     void fillResponseWithResult(ResponseType* response, mavsdk::Offboard::Result& result) const
@@ -40,7 +43,13 @@ public:
     translateToRpcAttitude(const mavsdk::Offboard::Attitude& attitude)
     {
         auto rpc_obj = std::make_unique<rpc::offboard::Attitude>();
+        translateToRpcAttitude(attitude, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcAttitude(
+        const mavsdk::Offboard::Attitude& attitude, rpc::offboard::Attitude* rpc_obj)
+    {
         rpc_obj->set_roll_deg(attitude.roll_deg);
 
         rpc_obj->set_pitch_deg(attitude.pitch_deg);
@@ -48,8 +57,6 @@ public:
         rpc_obj->set_yaw_deg(attitude.yaw_deg);
 
         rpc_obj->set_thrust_value(attitude.thrust_value);
-
-        return rpc_obj;
     }
 
     static mavsdk::Offboard::Attitude
@@ -72,12 +79,18 @@ public:
         const mavsdk::Offboard::ActuatorControlGroup& actuator_control_group)
     {
         auto rpc_obj = std::make_unique<rpc::offboard::ActuatorControlGroup>();
+        translateToRpcActuatorControlGroup(actuator_control_group, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcActuatorControlGroup(
+        const mavsdk::Offboard::ActuatorControlGroup& actuator_control_group,
+        rpc::offboard::ActuatorControlGroup* rpc_obj)
+    {
+        rpc_obj->clear_controls();
         for (const auto& elem : actuator_control_group.controls) {
             rpc_obj->add_controls(elem);
         }
-
-        return rpc_obj;
     }
 
     static mavsdk::Offboard::ActuatorControlGroup translateFromRpcActuatorControlGroup(
@@ -96,13 +109,18 @@ public:
     translateToRpcActuatorControl(const mavsdk::Offboard::ActuatorControl& actuator_control)
     {
         auto rpc_obj = std::make_unique<rpc::offboard::ActuatorControl>();
+        translateToRpcActuatorControl(actuator_control, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcActuatorControl(
+        const mavsdk::Offboard::ActuatorControl& actuator_control,
+        rpc::offboard::ActuatorControl* rpc_obj)
+    {
+        rpc_obj->clear_groups();
         for (const auto& elem : actuator_control.groups) {
-            auto* ptr = rpc_obj->add_groups();
-            ptr->CopyFrom(*translateToRpcActuatorControlGroup(elem).release());
+            translateToRpcActuatorControlGroup(elem, rpc_obj->add_groups());
         }
-
-        return rpc_obj;
     }
 
     static mavsdk::Offboard::ActuatorControl
@@ -122,7 +140,13 @@ public:
     translateToRpcAttitudeRate(const mavsdk::Offboard::AttitudeRate& attitude_rate)
     {
         auto rpc_obj = std::make_unique<rpc::offboard::AttitudeRate>();
+        translateToRpcAttitudeRate(attitude_rate, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcAttitudeRate(
+        const mavsdk::Offboard::AttitudeRate& attitude_rate, rpc::offboard::AttitudeRate* rpc_obj)
+    {
         rpc_obj->set_roll_deg_s(attitude_rate.roll_deg_s);
 
         rpc_obj->set_pitch_deg_s(attitude_rate.pitch_deg_s);
@@ -130,8 +154,6 @@ public:
         rpc_obj->set_yaw_deg_s(attitude_rate.yaw_deg_s);
 
         rpc_obj->set_thrust_value(attitude_rate.thrust_value);
-
-        return rpc_obj;
     }
 
     static mavsdk::Offboard::AttitudeRate
@@ -154,7 +176,14 @@ public:
     translateToRpcPositionNedYaw(const mavsdk::Offboard::PositionNedYaw& position_ned_yaw)
     {
         auto rpc_obj = std::make_unique<rpc::offboard::PositionNedYaw>();
+        translateToRpcPositionNedYaw(position_ned_yaw, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcPositionNedYaw(
+        const mavsdk::Offboard::PositionNedYaw& position_ned_yaw,
+        rpc::offboard::PositionNedYaw* rpc_obj)
+    {
         rpc_obj->set_north_m(position_ned_yaw.north_m);
 
         rpc_obj->set_east_m(position_ned_yaw.east_m);
@@ -162,8 +191,6 @@ public:
         rpc_obj->set_down_m(position_ned_yaw.down_m);
 
         rpc_obj->set_yaw_deg(position_ned_yaw.yaw_deg);
-
-        return rpc_obj;
     }
 
     static mavsdk::Offboard::PositionNedYaw
@@ -186,7 +213,14 @@ public:
         const mavsdk::Offboard::VelocityBodyYawspeed& velocity_body_yawspeed)
     {
         auto rpc_obj = std::make_unique<rpc::offboard::VelocityBodyYawspeed>();
+        translateToRpcVelocityBodyYawspeed(velocity_body_yawspeed, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcVelocityBodyYawspeed(
+        const mavsdk::Offboard::VelocityBodyYawspeed& velocity_body_yawspeed,
+        rpc::offboard::VelocityBodyYawspeed* rpc_obj)
+    {
         rpc_obj->set_forward_m_s(velocity_body_yawspeed.forward_m_s);
 
         rpc_obj->set_right_m_s(velocity_body_yawspeed.right_m_s);
@@ -194,8 +228,6 @@ public:
         rpc_obj->set_down_m_s(velocity_body_yawspeed.down_m_s);
 
         rpc_obj->set_yawspeed_deg_s(velocity_body_yawspeed.yawspeed_deg_s);
-
-        return rpc_obj;
     }
 
     static mavsdk::Offboard::VelocityBodyYawspeed translateFromRpcVelocityBodyYawspeed(
@@ -218,7 +250,14 @@ public:
     translateToRpcVelocityNedYaw(const mavsdk::Offboard::VelocityNedYaw& velocity_ned_yaw)
     {
         auto rpc_obj = std::make_unique<rpc::offboard::VelocityNedYaw>();
+        translateToRpcVelocityNedYaw(velocity_ned_yaw, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcVelocityNedYaw(
+        const mavsdk::Offboard::VelocityNedYaw& velocity_ned_yaw,
+        rpc::offboard::VelocityNedYaw* rpc_obj)
+    {
         rpc_obj->set_north_m_s(velocity_ned_yaw.north_m_s);
 
         rpc_obj->set_east_m_s(velocity_ned_yaw.east_m_s);
@@ -226,8 +265,6 @@ public:
         rpc_obj->set_down_m_s(velocity_ned_yaw.down_m_s);
 
         rpc_obj->set_yaw_deg(velocity_ned_yaw.yaw_deg);
-
-        return rpc_obj;
     }
 
     static mavsdk::Offboard::VelocityNedYaw
@@ -299,11 +336,16 @@ public:
     }
 
     grpc::Status Start(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::offboard::StartRequest* /* request */,
         rpc::offboard::StartResponse* response) override
     {
-        auto result = _offboard.start();
+        auto* plugin = _lazy_offboard.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->start();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -313,11 +355,16 @@ public:
     }
 
     grpc::Status Stop(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::offboard::StopRequest* /* request */,
         rpc::offboard::StopResponse* response) override
     {
-        auto result = _offboard.stop();
+        auto* plugin = _lazy_offboard.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->stop();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -327,11 +374,16 @@ public:
     }
 
     grpc::Status IsActive(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::offboard::IsActiveRequest* /* request */,
         rpc::offboard::IsActiveResponse* response) override
     {
-        auto result = _offboard.is_active();
+        auto* plugin = _lazy_offboard.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->is_active();
 
         if (response != nullptr) {
             response->set_is_active(result);
@@ -341,16 +393,21 @@ public:
     }
 
     grpc::Status SetAttitude(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::offboard::SetAttitudeRequest* request,
         rpc::offboard::SetAttitudeResponse* response) override
     {
+        auto* plugin = _lazy_offboard.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetAttitude sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _offboard.set_attitude(translateFromRpcAttitude(request->attitude()));
+        auto result = plugin->set_attitude(translateFromRpcAttitude(request->attitude()));
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -360,16 +417,21 @@ public:
     }
 
     grpc::Status SetActuatorControl(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::offboard::SetActuatorControlRequest* request,
         rpc::offboard::SetActuatorControlResponse* response) override
     {
+        auto* plugin = _lazy_offboard.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetActuatorControl sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _offboard.set_actuator_control(
+        auto result = plugin->set_actuator_control(
             translateFromRpcActuatorControl(request->actuator_control()));
 
         if (response != nullptr) {
@@ -380,17 +442,22 @@ public:
     }
 
     grpc::Status SetAttitudeRate(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::offboard::SetAttitudeRateRequest* request,
         rpc::offboard::SetAttitudeRateResponse* response) override
     {
+        auto* plugin = _lazy_offboard.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetAttitudeRate sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
         auto result =
-            _offboard.set_attitude_rate(translateFromRpcAttitudeRate(request->attitude_rate()));
+            plugin->set_attitude_rate(translateFromRpcAttitudeRate(request->attitude_rate()));
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -400,17 +467,22 @@ public:
     }
 
     grpc::Status SetPositionNed(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::offboard::SetPositionNedRequest* request,
         rpc::offboard::SetPositionNedResponse* response) override
     {
+        auto* plugin = _lazy_offboard.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetPositionNed sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
         auto result =
-            _offboard.set_position_ned(translateFromRpcPositionNedYaw(request->position_ned_yaw()));
+            plugin->set_position_ned(translateFromRpcPositionNedYaw(request->position_ned_yaw()));
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -420,16 +492,21 @@ public:
     }
 
     grpc::Status SetVelocityBody(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::offboard::SetVelocityBodyRequest* request,
         rpc::offboard::SetVelocityBodyResponse* response) override
     {
+        auto* plugin = _lazy_offboard.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetVelocityBody sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _offboard.set_velocity_body(
+        auto result = plugin->set_velocity_body(
             translateFromRpcVelocityBodyYawspeed(request->velocity_body_yawspeed()));
 
         if (response != nullptr) {
@@ -440,17 +517,22 @@ public:
     }
 
     grpc::Status SetVelocityNed(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::offboard::SetVelocityNedRequest* request,
         rpc::offboard::SetVelocityNedResponse* response) override
     {
+        auto* plugin = _lazy_offboard.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetVelocityNed sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
         auto result =
-            _offboard.set_velocity_ned(translateFromRpcVelocityNedYaw(request->velocity_ned_yaw()));
+            plugin->set_velocity_ned(translateFromRpcVelocityNedYaw(request->velocity_ned_yaw()));
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -460,16 +542,21 @@ public:
     }
 
     grpc::Status SetPositionVelocityNed(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::offboard::SetPositionVelocityNedRequest* request,
         rpc::offboard::SetPositionVelocityNedResponse* response) override
     {
+        auto* plugin = _lazy_offboard.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetPositionVelocityNed sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _offboard.set_position_velocity_ned(
+        auto result = plugin->set_position_velocity_ned(
             translateFromRpcPositionNedYaw(request->position_ned_yaw()),
             translateFromRpcVelocityNedYaw(request->velocity_ned_yaw()));
 
@@ -515,7 +602,7 @@ private:
         }
     }
 
-    Offboard& _offboard;
+    LazyPlugin<Offboard> _lazy_offboard;
     std::atomic<bool> _stopped{false};
     std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
 };
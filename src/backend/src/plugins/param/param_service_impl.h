@@ -5,6 +5,7 @@
 #include "param/param.grpc.pb.h"
 #include "plugins/param/param.h"
 
+#include "lazy_plugin.h"
 #include "log.h"
 #include <atomic>
 #include <cmath>
@@ -20,7 +21,9 @@ namespace backend {
 template<typename Param = Param>
 class ParamServiceImpl final : public rpc::param::ParamService::Service {
 public:
-    ParamServiceImpl(Param& param) : _param(param) {}
+    ParamServiceImpl(Param& param) : _lazy_param(param) {}
+
+    ParamServiceImpl(Mavsdk& mavsdk) : _lazy_param(mavsdk) {}
 
     template<typename ResponseType>
     void fillResponseWithResult(ResponseType* response, mavsdk::Param::Result& result) const
@@ -40,12 +43,16 @@ public:
     translateToRpcIntParam(const mavsdk::Param::IntParam& int_param)
     {
         auto rpc_obj = std::make_unique<rpc::param::IntParam>();
+        translateToRpcIntParam(int_param, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcIntParam(
+        const mavsdk::Param::IntParam& int_param, rpc::param::IntParam* rpc_obj)
+    {
         rpc_obj->set_name(int_param.name);
 
         rpc_obj->set_value(int_param.value);
-
-        return rpc_obj;
     }
 
     static mavsdk::Param::IntParam translateFromRpcIntParam(const rpc::param::IntParam& int_param)
@@ -63,12 +70,16 @@ public:
     translateToRpcFloatParam(const mavsdk::Param::FloatParam& float_param)
     {
         auto rpc_obj = std::make_unique<rpc::param::FloatParam>();
+        translateToRpcFloatParam(float_param, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcFloatParam(
+        const mavsdk::Param::FloatParam& float_param, rpc::param::FloatParam* rpc_obj)
+    {
         rpc_obj->set_name(float_param.name);
 
         rpc_obj->set_value(float_param.value);
-
-        return rpc_obj;
     }
 
     static mavsdk::Param::FloatParam
@@ -87,18 +98,22 @@ public:
     translateToRpcAllParams(const mavsdk::Param::AllParams& all_params)
     {
         auto rpc_obj = std::make_unique<rpc::param::AllParams>();
+        translateToRpcAllParams(all_params, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcAllParams(
+        const mavsdk::Param::AllParams& all_params, rpc::param::AllParams* rpc_obj)
+    {
+        rpc_obj->clear_int_params();
         for (const auto& elem : all_params.int_params) {
-            auto* ptr = rpc_obj->add_int_params();
-            ptr->CopyFrom(*translateToRpcIntParam(elem).release());
+            translateToRpcIntParam(elem, rpc_obj->add_int_params());
         }
 
+        rpc_obj->clear_float_params();
         for (const auto& elem : all_params.float_params) {
-            auto* ptr = rpc_obj->add_float_params();
-            ptr->CopyFrom(*translateToRpcFloatParam(elem).release());
+            translateToRpcFloatParam(elem, rpc_obj->add_float_params());
         }
-
-        return rpc_obj;
     }
 
     static mavsdk::Param::AllParams
@@ -163,16 +178,21 @@ public:
     }
 
     grpc::Status GetParamInt(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::param::GetParamIntRequest* request,
         rpc::param::GetParamIntResponse* response) override
     {
+        auto* plugin = _lazy_param.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "GetParamInt sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _param.get_param_int(request->name());
+        auto result = plugin->get_param_int(request->name());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
@@ -184,16 +204,21 @@ public:
     }
 
     grpc::Status SetParamInt(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::param::SetParamIntRequest* request,
         rpc::param::SetParamIntResponse* response) override
     {
+        auto* plugin = _lazy_param.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetParamInt sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _param.set_param_int(request->name(), request->value());
+        auto result = plugin->set_param_int(request->name(), request->value());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -203,16 +228,21 @@ public:
     }
 
     grpc::Status GetParamFloat(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::param::GetParamFloatRequest* request,
         rpc::param::GetParamFloatResponse* response) override
     {
+        auto* plugin = _lazy_param.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "GetParamFloat sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _param.get_param_float(request->name());
+        auto result = plugin->get_param_float(request->name());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
@@ -224,16 +254,21 @@ public:
     }
 
     grpc::Status SetParamFloat(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::param::SetParamFloatRequest* request,
         rpc::param::SetParamFloatResponse* response) override
     {
+        auto* plugin = _lazy_param.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetParamFloat sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _param.set_param_float(request->name(), request->value());
+        auto result = plugin->set_param_float(request->name(), request->value());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -243,11 +278,16 @@ public:
     }
 
     grpc::Status GetAllParams(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::param::GetAllParamsRequest* /* request */,
         rpc::param::GetAllParamsResponse* response) override
     {
-        auto result = _param.get_all_params();
+        auto* plugin = _lazy_param.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->get_all_params();
 
         if (response != nullptr) {
             response->set_allocated_params(translateToRpcAllParams(result).release());
@@ -291,7 +331,7 @@ private:
         }
     }
 
-    Param& _param;
+    LazyPlugin<Param> _lazy_param;
     std::atomic<bool> _stopped{false};
     std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
 };
@@ -5,6 +5,7 @@
 #include "shell/shell.grpc.pb.h"
 #include "plugins/shell/shell.h"
 
+#include "lazy_plugin.h"
 #include "log.h"
 #include <atomic>
 #include <cmath>
@@ -20,7 +21,9 @@ namespace backend {
 template<typename Shell = Shell>
 class ShellServiceImpl final : public rpc::shell::ShellService::Service {
 public:
-    ShellServiceImpl(Shell& shell) : _shell(shell) {}
+    ShellServiceImpl(Shell& shell) : _lazy_shell(shell) {}
+
+    ShellServiceImpl(Mavsdk& mavsdk) : _lazy_shell(mavsdk) {}
 
     template<typename ResponseType>
     void fillResponseWithResult(ResponseType* response, mavsdk::Shell::Result& result) const
@@ -80,16 +83,21 @@ public:
     }
 
     grpc::Status Send(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::shell::SendRequest* request,
         rpc::shell::SendResponse* response) override
     {
+        auto* plugin = _lazy_shell.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "Send sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _shell.send(request->command());
+        auto result = plugin->send(request->command());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -99,10 +107,15 @@ public:
     }
 
     grpc::Status SubscribeReceive(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const mavsdk::rpc::shell::SubscribeReceiveRequest* /* request */,
         grpc::ServerWriter<rpc::shell::ReceiveResponse>* writer) override
     {
+        auto* plugin = _lazy_shell.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         auto stream_closed_promise = std::make_shared<std::promise<void>>();
         auto stream_closed_future = stream_closed_promise->get_future();
         register_stream_stop_promise(stream_closed_promise);
@@ -111,8 +124,8 @@ public:
 
         std::mutex subscribe_mutex{};
 
-        _shell.subscribe_receive(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
+        plugin->subscribe_receive(
+            [this, plugin, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
                 const std::string receive) {
                 rpc::shell::ReceiveResponse rpc_response;
 
@@ -120,7 +133,7 @@ public:
 
                 std::unique_lock<std::mutex> lock(subscribe_mutex);
                 if (!*is_finished && !writer->Write(rpc_response)) {
-                    _shell.subscribe_receive(nullptr);
+                    plugin->subscribe_receive(nullptr);
 
                     *is_finished = true;
                     unregister_stream_stop_promise(stream_closed_promise);
@@ -168,7 +181,7 @@ private:
         }
     }
 
-    Shell& _shell;
+    LazyPlugin<Shell> _lazy_shell;
     std::atomic<bool> _stopped{false};
     std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
 };
@@ -4,23 +4,31 @@
 
 #include "telemetry/telemetry.grpc.pb.h"
 #include "plugins/telemetry/telemetry.h"
+#include "plugins/telemetry/telemetry_extended.h"
 
+#include "lazy_plugin.h"
 #include "log.h"
-#include <atomic>
+#include "stream_hub.h"
+#include "stream_write_reactor.h"
+#include <google/protobuf/descriptor.h>
 #include <cmath>
-#include <future>
+#include <functional>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <sstream>
+#include <string>
 #include <vector>
 
 namespace mavsdk {
 namespace backend {
 
-template<typename Telemetry = Telemetry>
+template<typename Telemetry = TelemetryExtended>
 class TelemetryServiceImpl final : public rpc::telemetry::TelemetryService::Service {
 public:
-    TelemetryServiceImpl(Telemetry& telemetry) : _telemetry(telemetry) {}
+    TelemetryServiceImpl(Telemetry& telemetry) : _lazy_telemetry(telemetry) {}
+
+    TelemetryServiceImpl(Mavsdk& mavsdk) : _lazy_telemetry(mavsdk) {}
 
     template<typename ResponseType>
     void fillResponseWithResult(ResponseType* response, mavsdk::Telemetry::Result& result) const
@@ -261,7 +269,13 @@ public:
     translateToRpcPosition(const mavsdk::Telemetry::Position& position)
     {
         auto rpc_obj = std::make_unique<rpc::telemetry::Position>();
+        translateToRpcPosition(position, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcPosition(
+        const mavsdk::Telemetry::Position& position, rpc::telemetry::Position* rpc_obj)
+    {
         rpc_obj->set_latitude_deg(position.latitude_deg);
 
         rpc_obj->set_longitude_deg(position.longitude_deg);
@@ -269,8 +283,6 @@ public:
         rpc_obj->set_absolute_altitude_m(position.absolute_altitude_m);
 
         rpc_obj->set_relative_altitude_m(position.relative_altitude_m);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::Position
@@ -293,7 +305,13 @@ public:
     translateToRpcQuaternion(const mavsdk::Telemetry::Quaternion& quaternion)
     {
         auto rpc_obj = std::make_unique<rpc::telemetry::Quaternion>();
+        translateToRpcQuaternion(quaternion, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcQuaternion(
+        const mavsdk::Telemetry::Quaternion& quaternion, rpc::telemetry::Quaternion* rpc_obj)
+    {
         rpc_obj->set_w(quaternion.w);
 
         rpc_obj->set_x(quaternion.x);
@@ -301,8 +319,6 @@ public:
         rpc_obj->set_y(quaternion.y);
 
         rpc_obj->set_z(quaternion.z);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::Quaternion
@@ -325,14 +341,18 @@ public:
     translateToRpcEulerAngle(const mavsdk::Telemetry::EulerAngle& euler_angle)
     {
         auto rpc_obj = std::make_unique<rpc::telemetry::EulerAngle>();
+        translateToRpcEulerAngle(euler_angle, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcEulerAngle(
+        const mavsdk::Telemetry::EulerAngle& euler_angle, rpc::telemetry::EulerAngle* rpc_obj)
+    {
         rpc_obj->set_roll_deg(euler_angle.roll_deg);
 
         rpc_obj->set_pitch_deg(euler_angle.pitch_deg);
 
         rpc_obj->set_yaw_deg(euler_angle.yaw_deg);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::EulerAngle
@@ -353,14 +373,19 @@ public:
         const mavsdk::Telemetry::AngularVelocityBody& angular_velocity_body)
     {
         auto rpc_obj = std::make_unique<rpc::telemetry::AngularVelocityBody>();
+        translateToRpcAngularVelocityBody(angular_velocity_body, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcAngularVelocityBody(
+        const mavsdk::Telemetry::AngularVelocityBody& angular_velocity_body,
+        rpc::telemetry::AngularVelocityBody* rpc_obj)
+    {
         rpc_obj->set_roll_rad_s(angular_velocity_body.roll_rad_s);
 
         rpc_obj->set_pitch_rad_s(angular_velocity_body.pitch_rad_s);
 
         rpc_obj->set_yaw_rad_s(angular_velocity_body.yaw_rad_s);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::AngularVelocityBody translateFromRpcAngularVelocityBody(
@@ -381,12 +406,16 @@ public:
     translateToRpcGpsInfo(const mavsdk::Telemetry::GpsInfo& gps_info)
     {
         auto rpc_obj = std::make_unique<rpc::telemetry::GpsInfo>();
+        translateToRpcGpsInfo(gps_info, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcGpsInfo(
+        const mavsdk::Telemetry::GpsInfo& gps_info, rpc::telemetry::GpsInfo* rpc_obj)
+    {
         rpc_obj->set_num_satellites(gps_info.num_satellites);
 
         rpc_obj->set_fix_type(translateToRpcFixType(gps_info.fix_type));
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::GpsInfo
@@ -405,12 +434,16 @@ public:
     translateToRpcBattery(const mavsdk::Telemetry::Battery& battery)
     {
         auto rpc_obj = std::make_unique<rpc::telemetry::Battery>();
+        translateToRpcBattery(battery, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcBattery(
+        const mavsdk::Telemetry::Battery& battery, rpc::telemetry::Battery* rpc_obj)
+    {
         rpc_obj->set_voltage_v(battery.voltage_v);
 
         rpc_obj->set_remaining_percent(battery.remaining_percent);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::Battery
@@ -429,7 +462,13 @@ public:
     translateToRpcHealth(const mavsdk::Telemetry::Health& health)
     {
         auto rpc_obj = std::make_unique<rpc::telemetry::Health>();
+        translateToRpcHealth(health, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcHealth(
+        const mavsdk::Telemetry::Health& health, rpc::telemetry::Health* rpc_obj)
+    {
         rpc_obj->set_is_gyrometer_calibration_ok(health.is_gyrometer_calibration_ok);
 
         rpc_obj->set_is_accelerometer_calibration_ok(health.is_accelerometer_calibration_ok);
@@ -443,8 +482,6 @@ public:
         rpc_obj->set_is_global_position_ok(health.is_global_position_ok);
 
         rpc_obj->set_is_home_position_ok(health.is_home_position_ok);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::Health translateFromRpcHealth(const rpc::telemetry::Health& health)
@@ -472,14 +509,18 @@ public:
     translateToRpcRcStatus(const mavsdk::Telemetry::RcStatus& rc_status)
     {
         auto rpc_obj = std::make_unique<rpc::telemetry::RcStatus>();
+        translateToRpcRcStatus(rc_status, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcRcStatus(
+        const mavsdk::Telemetry::RcStatus& rc_status, rpc::telemetry::RcStatus* rpc_obj)
+    {
         rpc_obj->set_was_available_once(rc_status.was_available_once);
 
         rpc_obj->set_is_available(rc_status.is_available);
 
         rpc_obj->set_signal_strength_percent(rc_status.signal_strength_percent);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::RcStatus
@@ -500,12 +541,16 @@ public:
     translateToRpcStatusText(const mavsdk::Telemetry::StatusText& status_text)
     {
         auto rpc_obj = std::make_unique<rpc::telemetry::StatusText>();
+        translateToRpcStatusText(status_text, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcStatusText(
+        const mavsdk::Telemetry::StatusText& status_text, rpc::telemetry::StatusText* rpc_obj)
+    {
         rpc_obj->set_type(translateToRpcStatusTextType(status_text.type));
 
         rpc_obj->set_text(status_text.text);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::StatusText
@@ -525,14 +570,20 @@ public:
         const mavsdk::Telemetry::ActuatorControlTarget& actuator_control_target)
     {
         auto rpc_obj = std::make_unique<rpc::telemetry::ActuatorControlTarget>();
+        translateToRpcActuatorControlTarget(actuator_control_target, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcActuatorControlTarget(
+        const mavsdk::Telemetry::ActuatorControlTarget& actuator_control_target,
+        rpc::telemetry::ActuatorControlTarget* rpc_obj)
+    {
         rpc_obj->set_group(actuator_control_target.group);
 
+        rpc_obj->clear_controls();
         for (const auto& elem : actuator_control_target.controls) {
             rpc_obj->add_controls(elem);
         }
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::ActuatorControlTarget translateFromRpcActuatorControlTarget(
@@ -553,14 +604,20 @@ public:
         const mavsdk::Telemetry::ActuatorOutputStatus& actuator_output_status)
     {
         auto rpc_obj = std::make_unique<rpc::telemetry::ActuatorOutputStatus>();
+        translateToRpcActuatorOutputStatus(actuator_output_status, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcActuatorOutputStatus(
+        const mavsdk::Telemetry::ActuatorOutputStatus& actuator_output_status,
+        rpc::telemetry::ActuatorOutputStatus* rpc_obj)
+    {
         rpc_obj->set_active(actuator_output_status.active);
 
+        rpc_obj->clear_actuator();
         for (const auto& elem : actuator_output_status.actuator) {
             rpc_obj->add_actuator(elem);
         }
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::ActuatorOutputStatus translateFromRpcActuatorOutputStatus(
@@ -581,12 +638,17 @@ public:
     translateToRpcCovariance(const mavsdk::Telemetry::Covariance& covariance)
     {
         auto rpc_obj = std::make_unique<rpc::telemetry::Covariance>();
+        translateToRpcCovariance(covariance, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcCovariance(
+        const mavsdk::Telemetry::Covariance& covariance, rpc::telemetry::Covariance* rpc_obj)
+    {
+        rpc_obj->clear_covariance_matrix();
         for (const auto& elem : covariance.covariance_matrix) {
             rpc_obj->add_covariance_matrix(elem);
         }
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::Covariance
@@ -605,14 +667,18 @@ public:
     translateToRpcVelocityBody(const mavsdk::Telemetry::VelocityBody& velocity_body)
     {
         auto rpc_obj = std::make_unique<rpc::telemetry::VelocityBody>();
+        translateToRpcVelocityBody(velocity_body, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcVelocityBody(
+        const mavsdk::Telemetry::VelocityBody& velocity_body, rpc::telemetry::VelocityBody* rpc_obj)
+    {
         rpc_obj->set_x_m_s(velocity_body.x_m_s);
 
         rpc_obj->set_y_m_s(velocity_body.y_m_s);
 
         rpc_obj->set_z_m_s(velocity_body.z_m_s);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::VelocityBody
@@ -633,14 +699,18 @@ public:
     translateToRpcPositionBody(const mavsdk::Telemetry::PositionBody& position_body)
     {
         auto rpc_obj = std::make_unique<rpc::telemetry::PositionBody>();
+        translateToRpcPositionBody(position_body, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcPositionBody(
+        const mavsdk::Telemetry::PositionBody& position_body, rpc::telemetry::PositionBody* rpc_obj)
+    {
         rpc_obj->set_x_m(position_body.x_m);
 
         rpc_obj->set_y_m(position_body.y_m);
 
         rpc_obj->set_z_m(position_body.z_m);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::PositionBody
@@ -697,31 +767,32 @@ public:
     translateToRpcOdometry(const mavsdk::Telemetry::Odometry& odometry)
     {
         auto rpc_obj = std::make_unique<rpc::telemetry::Odometry>();
+        translateToRpcOdometry(odometry, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcOdometry(
+        const mavsdk::Telemetry::Odometry& odometry, rpc::telemetry::Odometry* rpc_obj)
+    {
         rpc_obj->set_time_usec(odometry.time_usec);
 
         rpc_obj->set_frame_id(translateToRpcMavFrame(odometry.frame_id));
 
         rpc_obj->set_child_frame_id(translateToRpcMavFrame(odometry.child_frame_id));
 
-        rpc_obj->set_allocated_position_body(
-            translateToRpcPositionBody(odometry.position_body).release());
-
-        rpc_obj->set_allocated_q(translateToRpcQuaternion(odometry.q).release());
+        translateToRpcPositionBody(odometry.position_body, rpc_obj->mutable_position_body());
 
-        rpc_obj->set_allocated_velocity_body(
-            translateToRpcVelocityBody(odometry.velocity_body).release());
+        translateToRpcQuaternion(odometry.q, rpc_obj->mutable_q());
 
-        rpc_obj->set_allocated_angular_velocity_body(
-            translateToRpcAngularVelocityBody(odometry.angular_velocity_body).release());
+        translateToRpcVelocityBody(odometry.velocity_body, rpc_obj->mutable_velocity_body());
 
-        rpc_obj->set_allocated_pose_covariance(
-            translateToRpcCovariance(odometry.pose_covariance).release());
+        translateToRpcAngularVelocityBody(
+            odometry.angular_velocity_body, rpc_obj->mutable_angular_velocity_body());
 
-        rpc_obj->set_allocated_velocity_covariance(
-            translateToRpcCovariance(odometry.velocity_covariance).release());
+        translateToRpcCovariance(odometry.pose_covariance, rpc_obj->mutable_pose_covariance());
 
-        return rpc_obj;
+        translateToRpcCovariance(
+            odometry.velocity_covariance, rpc_obj->mutable_velocity_covariance());
     }
 
     static mavsdk::Telemetry::Odometry
@@ -755,14 +826,19 @@ public:
     translateToRpcDistanceSensor(const mavsdk::Telemetry::DistanceSensor& distance_sensor)
     {
         auto rpc_obj = std::make_unique<rpc::telemetry::DistanceSensor>();
+        translateToRpcDistanceSensor(distance_sensor, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcDistanceSensor(
+        const mavsdk::Telemetry::DistanceSensor& distance_sensor,
+        rpc::telemetry::DistanceSensor* rpc_obj)
+    {
         rpc_obj->set_minimum_distance_m(distance_sensor.minimum_distance_m);
 
         rpc_obj->set_maximum_distance_m(distance_sensor.maximum_distance_m);
 
         rpc_obj->set_current_distance_m(distance_sensor.current_distance_m);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::DistanceSensor
@@ -783,14 +859,18 @@ public:
     translateToRpcPositionNed(const mavsdk::Telemetry::PositionNed& position_ned)
     {
         auto rpc_obj = std::make_unique<rpc::telemetry::PositionNed>();
+        translateToRpcPositionNed(position_ned, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcPositionNed(
+        const mavsdk::Telemetry::PositionNed& position_ned, rpc::telemetry::PositionNed* rpc_obj)
+    {
         rpc_obj->set_north_m(position_ned.north_m);
 
         rpc_obj->set_east_m(position_ned.east_m);
 
         rpc_obj->set_down_m(position_ned.down_m);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::PositionNed
@@ -811,14 +891,18 @@ public:
     translateToRpcVelocityNed(const mavsdk::Telemetry::VelocityNed& velocity_ned)
     {
         auto rpc_obj = std::make_unique<rpc::telemetry::VelocityNed>();
+        translateToRpcVelocityNed(velocity_ned, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcVelocityNed(
+        const mavsdk::Telemetry::VelocityNed& velocity_ned, rpc::telemetry::VelocityNed* rpc_obj)
+    {
         rpc_obj->set_north_m_s(velocity_ned.north_m_s);
 
         rpc_obj->set_east_m_s(velocity_ned.east_m_s);
 
         rpc_obj->set_down_m_s(velocity_ned.down_m_s);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::VelocityNed
@@ -839,14 +923,17 @@ public:
         const mavsdk::Telemetry::PositionVelocityNed& position_velocity_ned)
     {
         auto rpc_obj = std::make_unique<rpc::telemetry::PositionVelocityNed>();
+        translateToRpcPositionVelocityNed(position_velocity_ned, rpc_obj.get());
+        return rpc_obj;
+    }
 
-        rpc_obj->set_allocated_position(
-            translateToRpcPositionNed(position_velocity_ned.position).release());
-
-        rpc_obj->set_allocated_velocity(
-            translateToRpcVelocityNed(position_velocity_ned.velocity).release());
+    static void translateToRpcPositionVelocityNed(
+        const mavsdk::Telemetry::PositionVelocityNed& position_velocity_ned,
+        rpc::telemetry::PositionVelocityNed* rpc_obj)
+    {
+        translateToRpcPositionNed(position_velocity_ned.position, rpc_obj->mutable_position());
 
-        return rpc_obj;
+        translateToRpcVelocityNed(position_velocity_ned.velocity, rpc_obj->mutable_velocity());
     }
 
     static mavsdk::Telemetry::PositionVelocityNed translateFromRpcPositionVelocityNed(
@@ -865,14 +952,18 @@ public:
     translateToRpcGroundTruth(const mavsdk::Telemetry::GroundTruth& ground_truth)
     {
         auto rpc_obj = std::make_unique<rpc::telemetry::GroundTruth>();
+        translateToRpcGroundTruth(ground_truth, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcGroundTruth(
+        const mavsdk::Telemetry::GroundTruth& ground_truth, rpc::telemetry::GroundTruth* rpc_obj)
+    {
         rpc_obj->set_latitude_deg(ground_truth.latitude_deg);
 
         rpc_obj->set_longitude_deg(ground_truth.longitude_deg);
 
         rpc_obj->set_absolute_altitude_m(ground_truth.absolute_altitude_m);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::GroundTruth
@@ -893,14 +984,19 @@ public:
     translateToRpcFixedwingMetrics(const mavsdk::Telemetry::FixedwingMetrics& fixedwing_metrics)
     {
         auto rpc_obj = std::make_unique<rpc::telemetry::FixedwingMetrics>();
+        translateToRpcFixedwingMetrics(fixedwing_metrics, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcFixedwingMetrics(
+        const mavsdk::Telemetry::FixedwingMetrics& fixedwing_metrics,
+        rpc::telemetry::FixedwingMetrics* rpc_obj)
+    {
         rpc_obj->set_airspeed_m_s(fixedwing_metrics.airspeed_m_s);
 
         rpc_obj->set_throttle_percentage(fixedwing_metrics.throttle_percentage);
 
         rpc_obj->set_climb_rate_m_s(fixedwing_metrics.climb_rate_m_s);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::FixedwingMetrics
@@ -921,14 +1017,19 @@ public:
     translateToRpcAccelerationFrd(const mavsdk::Telemetry::AccelerationFrd& acceleration_frd)
     {
         auto rpc_obj = std::make_unique<rpc::telemetry::AccelerationFrd>();
+        translateToRpcAccelerationFrd(acceleration_frd, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcAccelerationFrd(
+        const mavsdk::Telemetry::AccelerationFrd& acceleration_frd,
+        rpc::telemetry::AccelerationFrd* rpc_obj)
+    {
         rpc_obj->set_forward_m_s2(acceleration_frd.forward_m_s2);
 
         rpc_obj->set_right_m_s2(acceleration_frd.right_m_s2);
 
         rpc_obj->set_down_m_s2(acceleration_frd.down_m_s2);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::AccelerationFrd
@@ -949,14 +1050,19 @@ public:
         const mavsdk::Telemetry::AngularVelocityFrd& angular_velocity_frd)
     {
         auto rpc_obj = std::make_unique<rpc::telemetry::AngularVelocityFrd>();
+        translateToRpcAngularVelocityFrd(angular_velocity_frd, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcAngularVelocityFrd(
+        const mavsdk::Telemetry::AngularVelocityFrd& angular_velocity_frd,
+        rpc::telemetry::AngularVelocityFrd* rpc_obj)
+    {
         rpc_obj->set_forward_rad_s(angular_velocity_frd.forward_rad_s);
 
         rpc_obj->set_right_rad_s(angular_velocity_frd.right_rad_s);
 
         rpc_obj->set_down_rad_s(angular_velocity_frd.down_rad_s);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::AngularVelocityFrd translateFromRpcAngularVelocityFrd(
@@ -977,14 +1083,19 @@ public:
     translateToRpcMagneticFieldFrd(const mavsdk::Telemetry::MagneticFieldFrd& magnetic_field_frd)
     {
         auto rpc_obj = std::make_unique<rpc::telemetry::MagneticFieldFrd>();
+        translateToRpcMagneticFieldFrd(magnetic_field_frd, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcMagneticFieldFrd(
+        const mavsdk::Telemetry::MagneticFieldFrd& magnetic_field_frd,
+        rpc::telemetry::MagneticFieldFrd* rpc_obj)
+    {
         rpc_obj->set_forward_gauss(magnetic_field_frd.forward_gauss);
 
         rpc_obj->set_right_gauss(magnetic_field_frd.right_gauss);
 
         rpc_obj->set_down_gauss(magnetic_field_frd.down_gauss);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::MagneticFieldFrd
@@ -1004,19 +1115,21 @@ public:
     static std::unique_ptr<rpc::telemetry::Imu> translateToRpcImu(const mavsdk::Telemetry::Imu& imu)
     {
         auto rpc_obj = std::make_unique<rpc::telemetry::Imu>();
+        translateToRpcImu(imu, rpc_obj.get());
+        return rpc_obj;
+    }
 
-        rpc_obj->set_allocated_acceleration_frd(
-            translateToRpcAccelerationFrd(imu.acceleration_frd).release());
+    static void translateToRpcImu(const mavsdk::Telemetry::Imu& imu, rpc::telemetry::Imu* rpc_obj)
+    {
+        translateToRpcAccelerationFrd(imu.acceleration_frd, rpc_obj->mutable_acceleration_frd());
 
-        rpc_obj->set_allocated_angular_velocity_frd(
-            translateToRpcAngularVelocityFrd(imu.angular_velocity_frd).release());
+        translateToRpcAngularVelocityFrd(
+            imu.angular_velocity_frd, rpc_obj->mutable_angular_velocity_frd());
 
-        rpc_obj->set_allocated_magnetic_field_frd(
-            translateToRpcMagneticFieldFrd(imu.magnetic_field_frd).release());
+        translateToRpcMagneticFieldFrd(
+            imu.magnetic_field_frd, rpc_obj->mutable_magnetic_field_frd());
 
         rpc_obj->set_temperature_degc(imu.temperature_degc);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::Imu translateFromRpcImu(const rpc::telemetry::Imu& imu)
@@ -1038,14 +1151,19 @@ public:
     translateToRpcGpsGlobalOrigin(const mavsdk::Telemetry::GpsGlobalOrigin& gps_global_origin)
     {
         auto rpc_obj = std::make_unique<rpc::telemetry::GpsGlobalOrigin>();
+        translateToRpcGpsGlobalOrigin(gps_global_origin, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcGpsGlobalOrigin(
+        const mavsdk::Telemetry::GpsGlobalOrigin& gps_global_origin,
+        rpc::telemetry::GpsGlobalOrigin* rpc_obj)
+    {
         rpc_obj->set_latitude_deg(gps_global_origin.latitude_deg);
 
         rpc_obj->set_longitude_deg(gps_global_origin.longitude_deg);
 
         rpc_obj->set_altitude_m(gps_global_origin.altitude_m);
-
-        return rpc_obj;
     }
 
     static mavsdk::Telemetry::GpsGlobalOrigin
@@ -1110,975 +1228,1195 @@ public:
         }
     }
 
-    grpc::Status SubscribePosition(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribePositionRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::PositionResponse>* writer) override
+    // The synchronous version is replaced by the callback one below.
+    using Service::SubscribePosition;
+
+    ServerWriteReactor<grpc::ByteBuffer>* SubscribePosition(
+        CallbackServerContext* context, const grpc::ByteBuffer* /* request */)
     {
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return make_finished_reactor<grpc::ByteBuffer>(unknown_system_status());
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
+        auto hub = _stream_hubs.get(plugin, "position");
+        auto* reactor = new StreamWriteReactor<grpc::ByteBuffer>(
+            StreamPolicy::ConflateToLatest, [hub]() { hub->remove_finished(); });
+        auto writer = reactor->writer();
+        register_stream(writer);
 
-        std::mutex subscribe_mutex{};
+        hub->attach(writer, [plugin, hub]() {
+            const auto handle = plugin->subscribe_position(
+                [hub](const mavsdk::Telemetry::Position position) {
+                    thread_local rpc::telemetry::PositionResponse rpc_response;
 
-        _telemetry.subscribe_position(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
-                const mavsdk::Telemetry::Position position) {
-                rpc::telemetry::PositionResponse rpc_response;
+                    translateToRpcPosition(position, rpc_response.mutable_position());
 
-                rpc_response.set_allocated_position(translateToRpcPosition(position).release());
+                    hub->publish(rpc_response);
+                },
+                {});
 
-                std::unique_lock<std::mutex> lock(subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _telemetry.subscribe_position(nullptr);
+            return [plugin, handle]() { plugin->unsubscribe_position(handle); };
+        });
 
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    lock.unlock();
-                    stream_closed_promise->set_value();
-                }
-            });
+        // Tells the client that it gets the updates from now on.
+        writer->send_initial_metadata();
 
-        stream_closed_future.wait();
-        return grpc::Status::OK;
+        return reactor;
     }
 
-    grpc::Status SubscribeHome(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeHomeRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::HomeResponse>* writer) override
+    const bool _subscribe_position_registered{register_callback_stream(
+        "SubscribePosition",
+        [this](CallbackServerContext* context, const grpc::ByteBuffer* request) {
+            return SubscribePosition(context, request);
+        })};
+
+    // The synchronous version is replaced by the callback one below.
+    using Service::SubscribeHome;
+
+    ServerWriteReactor<grpc::ByteBuffer>* SubscribeHome(
+        CallbackServerContext* context, const grpc::ByteBuffer* /* request */)
     {
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return make_finished_reactor<grpc::ByteBuffer>(unknown_system_status());
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
+        auto hub = _stream_hubs.get(plugin, "home");
+        auto* reactor = new StreamWriteReactor<grpc::ByteBuffer>(
+            StreamPolicy::ConflateToLatest, [hub]() { hub->remove_finished(); });
+        auto writer = reactor->writer();
+        register_stream(writer);
 
-        std::mutex subscribe_mutex{};
+        hub->attach(writer, [plugin, hub]() {
+            const auto handle = plugin->subscribe_home(
+                [hub](const mavsdk::Telemetry::Position home) {
+                    thread_local rpc::telemetry::HomeResponse rpc_response;
 
-        _telemetry.subscribe_home(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
-                const mavsdk::Telemetry::Position home) {
-                rpc::telemetry::HomeResponse rpc_response;
+                    translateToRpcPosition(home, rpc_response.mutable_home());
 
-                rpc_response.set_allocated_home(translateToRpcPosition(home).release());
+                    hub->publish(rpc_response);
+                },
+                {});
 
-                std::unique_lock<std::mutex> lock(subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _telemetry.subscribe_home(nullptr);
+            return [plugin, handle]() { plugin->unsubscribe_home(handle); };
+        });
 
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    lock.unlock();
-                    stream_closed_promise->set_value();
-                }
-            });
+        // Tells the client that it gets the updates from now on.
+        writer->send_initial_metadata();
 
-        stream_closed_future.wait();
-        return grpc::Status::OK;
+        return reactor;
     }
 
-    grpc::Status SubscribeInAir(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeInAirRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::InAirResponse>* writer) override
+    const bool _subscribe_home_registered{register_callback_stream(
+        "SubscribeHome",
+        [this](CallbackServerContext* context, const grpc::ByteBuffer* request) {
+            return SubscribeHome(context, request);
+        })};
+
+    // The synchronous version is replaced by the callback one below.
+    using Service::SubscribeInAir;
+
+    ServerWriteReactor<grpc::ByteBuffer>* SubscribeInAir(
+        CallbackServerContext* context, const grpc::ByteBuffer* /* request */)
     {
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return make_finished_reactor<grpc::ByteBuffer>(unknown_system_status());
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
+        auto hub = _stream_hubs.get(plugin, "in_air");
+        auto* reactor = new StreamWriteReactor<grpc::ByteBuffer>(
+            StreamPolicy::ConflateToLatest, [hub]() { hub->remove_finished(); });
+        auto writer = reactor->writer();
+        register_stream(writer);
 
-        std::mutex subscribe_mutex{};
+        hub->attach(writer, [plugin, hub]() {
+            const auto handle = plugin->subscribe_in_air(
+                [hub](const bool in_air) {
+                    thread_local rpc::telemetry::InAirResponse rpc_response;
 
-        _telemetry.subscribe_in_air(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
-                const bool in_air) {
-                rpc::telemetry::InAirResponse rpc_response;
+                    rpc_response.set_is_in_air(in_air);
 
-                rpc_response.set_is_in_air(in_air);
+                    hub->publish(rpc_response);
+                },
+                {});
 
-                std::unique_lock<std::mutex> lock(subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _telemetry.subscribe_in_air(nullptr);
+            return [plugin, handle]() { plugin->unsubscribe_in_air(handle); };
+        });
 
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    lock.unlock();
-                    stream_closed_promise->set_value();
-                }
-            });
+        // Tells the client that it gets the updates from now on.
+        writer->send_initial_metadata();
 
-        stream_closed_future.wait();
-        return grpc::Status::OK;
+        return reactor;
     }
 
-    grpc::Status SubscribeLandedState(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeLandedStateRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::LandedStateResponse>* writer) override
+    const bool _subscribe_in_air_registered{register_callback_stream(
+        "SubscribeInAir",
+        [this](CallbackServerContext* context, const grpc::ByteBuffer* request) {
+            return SubscribeInAir(context, request);
+        })};
+
+    // The synchronous version is replaced by the callback one below.
+    using Service::SubscribeLandedState;
+
+    ServerWriteReactor<grpc::ByteBuffer>* SubscribeLandedState(
+        CallbackServerContext* context, const grpc::ByteBuffer* /* request */)
     {
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return make_finished_reactor<grpc::ByteBuffer>(unknown_system_status());
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
+        auto hub = _stream_hubs.get(plugin, "landed_state");
+        auto* reactor = new StreamWriteReactor<grpc::ByteBuffer>(
+            StreamPolicy::ConflateToLatest, [hub]() { hub->remove_finished(); });
+        auto writer = reactor->writer();
+        register_stream(writer);
 
-        std::mutex subscribe_mutex{};
+        hub->attach(writer, [plugin, hub]() {
+            const auto handle = plugin->subscribe_landed_state(
+                [hub](const mavsdk::Telemetry::LandedState landed_state) {
+                    thread_local rpc::telemetry::LandedStateResponse rpc_response;
 
-        _telemetry.subscribe_landed_state(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
-                const mavsdk::Telemetry::LandedState landed_state) {
-                rpc::telemetry::LandedStateResponse rpc_response;
+                    rpc_response.set_landed_state(translateToRpcLandedState(landed_state));
 
-                rpc_response.set_landed_state(translateToRpcLandedState(landed_state));
+                    hub->publish(rpc_response);
+                },
+                {});
 
-                std::unique_lock<std::mutex> lock(subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _telemetry.subscribe_landed_state(nullptr);
+            return [plugin, handle]() { plugin->unsubscribe_landed_state(handle); };
+        });
 
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    lock.unlock();
-                    stream_closed_promise->set_value();
-                }
-            });
+        // Tells the client that it gets the updates from now on.
+        writer->send_initial_metadata();
 
-        stream_closed_future.wait();
-        return grpc::Status::OK;
+        return reactor;
     }
 
-    grpc::Status SubscribeArmed(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeArmedRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::ArmedResponse>* writer) override
+    const bool _subscribe_landed_state_registered{register_callback_stream(
+        "SubscribeLandedState",
+        [this](CallbackServerContext* context, const grpc::ByteBuffer* request) {
+            return SubscribeLandedState(context, request);
+        })};
+
+    // The synchronous version is replaced by the callback one below.
+    using Service::SubscribeArmed;
+
+    ServerWriteReactor<grpc::ByteBuffer>* SubscribeArmed(
+        CallbackServerContext* context, const grpc::ByteBuffer* /* request */)
     {
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return make_finished_reactor<grpc::ByteBuffer>(unknown_system_status());
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
+        auto hub = _stream_hubs.get(plugin, "armed");
+        auto* reactor = new StreamWriteReactor<grpc::ByteBuffer>(
+            StreamPolicy::ConflateToLatest, [hub]() { hub->remove_finished(); });
+        auto writer = reactor->writer();
+        register_stream(writer);
 
-        std::mutex subscribe_mutex{};
+        hub->attach(writer, [plugin, hub]() {
+            const auto handle = plugin->subscribe_armed(
+                [hub](const bool armed) {
+                    thread_local rpc::telemetry::ArmedResponse rpc_response;
 
-        _telemetry.subscribe_armed(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
-                const bool armed) {
-                rpc::telemetry::ArmedResponse rpc_response;
+                    rpc_response.set_is_armed(armed);
 
-                rpc_response.set_is_armed(armed);
+                    hub->publish(rpc_response);
+                },
+                {});
 
-                std::unique_lock<std::mutex> lock(subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _telemetry.subscribe_armed(nullptr);
+            return [plugin, handle]() { plugin->unsubscribe_armed(handle); };
+        });
 
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    lock.unlock();
-                    stream_closed_promise->set_value();
-                }
-            });
+        // Tells the client that it gets the updates from now on.
+        writer->send_initial_metadata();
 
-        stream_closed_future.wait();
-        return grpc::Status::OK;
+        return reactor;
     }
 
-    grpc::Status SubscribeAttitudeQuaternion(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeAttitudeQuaternionRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::AttitudeQuaternionResponse>* writer) override
+    const bool _subscribe_armed_registered{register_callback_stream(
+        "SubscribeArmed",
+        [this](CallbackServerContext* context, const grpc::ByteBuffer* request) {
+            return SubscribeArmed(context, request);
+        })};
+
+    // The synchronous version is replaced by the callback one below.
+    using Service::SubscribeAttitudeQuaternion;
+
+    ServerWriteReactor<grpc::ByteBuffer>* SubscribeAttitudeQuaternion(
+        CallbackServerContext* context, const grpc::ByteBuffer* /* request */)
     {
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return make_finished_reactor<grpc::ByteBuffer>(unknown_system_status());
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
+        auto hub = _stream_hubs.get(plugin, "attitude_quaternion");
+        auto* reactor = new StreamWriteReactor<grpc::ByteBuffer>(
+            StreamPolicy::ConflateToLatest, [hub]() { hub->remove_finished(); });
+        auto writer = reactor->writer();
+        register_stream(writer);
 
-        std::mutex subscribe_mutex{};
+        hub->attach(writer, [plugin, hub]() {
+            const auto handle = plugin->subscribe_attitude_quaternion(
+                [hub](const mavsdk::Telemetry::Quaternion attitude_quaternion) {
+                    thread_local rpc::telemetry::AttitudeQuaternionResponse rpc_response;
 
-        _telemetry.subscribe_attitude_quaternion(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
-                const mavsdk::Telemetry::Quaternion attitude_quaternion) {
-                rpc::telemetry::AttitudeQuaternionResponse rpc_response;
+                    translateToRpcQuaternion(
+                        attitude_quaternion, rpc_response.mutable_attitude_quaternion());
 
-                rpc_response.set_allocated_attitude_quaternion(
-                    translateToRpcQuaternion(attitude_quaternion).release());
+                    hub->publish(rpc_response);
+                },
+                {});
 
-                std::unique_lock<std::mutex> lock(subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _telemetry.subscribe_attitude_quaternion(nullptr);
+            return [plugin, handle]() { plugin->unsubscribe_attitude_quaternion(handle); };
+        });
 
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    lock.unlock();
-                    stream_closed_promise->set_value();
-                }
-            });
+        // Tells the client that it gets the updates from now on.
+        writer->send_initial_metadata();
 
-        stream_closed_future.wait();
-        return grpc::Status::OK;
+        return reactor;
     }
 
-    grpc::Status SubscribeAttitudeEuler(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeAttitudeEulerRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::AttitudeEulerResponse>* writer) override
+    const bool _subscribe_attitude_quaternion_registered{register_callback_stream(
+        "SubscribeAttitudeQuaternion",
+        [this](CallbackServerContext* context, const grpc::ByteBuffer* request) {
+            return SubscribeAttitudeQuaternion(context, request);
+        })};
+
+    // The synchronous version is replaced by the callback one below.
+    using Service::SubscribeAttitudeEuler;
+
+    ServerWriteReactor<grpc::ByteBuffer>* SubscribeAttitudeEuler(
+        CallbackServerContext* context, const grpc::ByteBuffer* /* request */)
     {
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return make_finished_reactor<grpc::ByteBuffer>(unknown_system_status());
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
+        auto hub = _stream_hubs.get(plugin, "attitude_euler");
+        auto* reactor = new StreamWriteReactor<grpc::ByteBuffer>(
+            StreamPolicy::ConflateToLatest, [hub]() { hub->remove_finished(); });
+        auto writer = reactor->writer();
+        register_stream(writer);
 
-        std::mutex subscribe_mutex{};
+        hub->attach(writer, [plugin, hub]() {
+            const auto handle = plugin->subscribe_attitude_euler(
+                [hub](const mavsdk::Telemetry::EulerAngle attitude_euler) {
+                    thread_local rpc::telemetry::AttitudeEulerResponse rpc_response;
 
-        _telemetry.subscribe_attitude_euler(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
-                const mavsdk::Telemetry::EulerAngle attitude_euler) {
-                rpc::telemetry::AttitudeEulerResponse rpc_response;
+                    translateToRpcEulerAngle(attitude_euler, rpc_response.mutable_attitude_euler());
 
-                rpc_response.set_allocated_attitude_euler(
-                    translateToRpcEulerAngle(attitude_euler).release());
+                    hub->publish(rpc_response);
+                },
+                {});
 
-                std::unique_lock<std::mutex> lock(subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _telemetry.subscribe_attitude_euler(nullptr);
+            return [plugin, handle]() { plugin->unsubscribe_attitude_euler(handle); };
+        });
 
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    lock.unlock();
-                    stream_closed_promise->set_value();
-                }
-            });
+        // Tells the client that it gets the updates from now on.
+        writer->send_initial_metadata();
 
-        stream_closed_future.wait();
-        return grpc::Status::OK;
+        return reactor;
     }
 
-    grpc::Status SubscribeAttitudeAngularVelocityBody(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeAttitudeAngularVelocityBodyRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::AttitudeAngularVelocityBodyResponse>* writer) override
+    const bool _subscribe_attitude_euler_registered{register_callback_stream(
+        "SubscribeAttitudeEuler",
+        [this](CallbackServerContext* context, const grpc::ByteBuffer* request) {
+            return SubscribeAttitudeEuler(context, request);
+        })};
+
+    // The synchronous version is replaced by the callback one below.
+    using Service::SubscribeAttitudeAngularVelocityBody;
+
+    ServerWriteReactor<grpc::ByteBuffer>* SubscribeAttitudeAngularVelocityBody(
+        CallbackServerContext* context, const grpc::ByteBuffer* /* request */)
     {
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return make_finished_reactor<grpc::ByteBuffer>(unknown_system_status());
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
+        auto hub = _stream_hubs.get(plugin, "attitude_angular_velocity_body");
+        auto* reactor = new StreamWriteReactor<grpc::ByteBuffer>(
+            StreamPolicy::ConflateToLatest, [hub]() { hub->remove_finished(); });
+        auto writer = reactor->writer();
+        register_stream(writer);
 
-        std::mutex subscribe_mutex{};
+        hub->attach(writer, [plugin, hub]() {
+            const auto handle = plugin->subscribe_attitude_angular_velocity_body(
+                [hub](const mavsdk::Telemetry::AngularVelocityBody attitude_angular_velocity_body) {
+                    thread_local rpc::telemetry::AttitudeAngularVelocityBodyResponse rpc_response;
 
-        _telemetry.subscribe_attitude_angular_velocity_body(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
-                const mavsdk::Telemetry::AngularVelocityBody attitude_angular_velocity_body) {
-                rpc::telemetry::AttitudeAngularVelocityBodyResponse rpc_response;
+                    translateToRpcAngularVelocityBody(
+                        attitude_angular_velocity_body,
+                        rpc_response.mutable_attitude_angular_velocity_body());
 
-                rpc_response.set_allocated_attitude_angular_velocity_body(
-                    translateToRpcAngularVelocityBody(attitude_angular_velocity_body).release());
+                    hub->publish(rpc_response);
+                },
+                {});
 
-                std::unique_lock<std::mutex> lock(subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _telemetry.subscribe_attitude_angular_velocity_body(nullptr);
+            return [plugin, handle]() {
+                plugin->unsubscribe_attitude_angular_velocity_body(handle);
+            };
+        });
 
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    lock.unlock();
-                    stream_closed_promise->set_value();
-                }
-            });
+        // Tells the client that it gets the updates from now on.
+        writer->send_initial_metadata();
 
-        stream_closed_future.wait();
-        return grpc::Status::OK;
+        return reactor;
     }
 
-    grpc::Status SubscribeCameraAttitudeQuaternion(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeCameraAttitudeQuaternionRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::CameraAttitudeQuaternionResponse>* writer) override
+    const bool _subscribe_attitude_angular_velocity_body_registered{register_callback_stream(
+        "SubscribeAttitudeAngularVelocityBody",
+        [this](CallbackServerContext* context, const grpc::ByteBuffer* request) {
+            return SubscribeAttitudeAngularVelocityBody(context, request);
+        })};
+
+    // The synchronous version is replaced by the callback one below.
+    using Service::SubscribeCameraAttitudeQuaternion;
+
+    ServerWriteReactor<grpc::ByteBuffer>* SubscribeCameraAttitudeQuaternion(
+        CallbackServerContext* context, const grpc::ByteBuffer* /* request */)
     {
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return make_finished_reactor<grpc::ByteBuffer>(unknown_system_status());
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
+        auto hub = _stream_hubs.get(plugin, "camera_attitude_quaternion");
+        auto* reactor = new StreamWriteReactor<grpc::ByteBuffer>(
+            StreamPolicy::ConflateToLatest, [hub]() { hub->remove_finished(); });
+        auto writer = reactor->writer();
+        register_stream(writer);
 
-        std::mutex subscribe_mutex{};
+        hub->attach(writer, [plugin, hub]() {
+            const auto handle = plugin->subscribe_camera_attitude_quaternion(
+                [hub](const mavsdk::Telemetry::Quaternion camera_attitude_quaternion) {
+                    thread_local rpc::telemetry::CameraAttitudeQuaternionResponse rpc_response;
 
-        _telemetry.subscribe_camera_attitude_quaternion(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
-                const mavsdk::Telemetry::Quaternion camera_attitude_quaternion) {
-                rpc::telemetry::CameraAttitudeQuaternionResponse rpc_response;
+                    translateToRpcQuaternion(
+                        camera_attitude_quaternion, rpc_response.mutable_attitude_quaternion());
 
-                rpc_response.set_allocated_attitude_quaternion(
-                    translateToRpcQuaternion(camera_attitude_quaternion).release());
+                    hub->publish(rpc_response);
+                },
+                {});
 
-                std::unique_lock<std::mutex> lock(subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _telemetry.subscribe_camera_attitude_quaternion(nullptr);
+            return [plugin, handle]() { plugin->unsubscribe_camera_attitude_quaternion(handle); };
+        });
 
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    lock.unlock();
-                    stream_closed_promise->set_value();
-                }
-            });
+        // Tells the client that it gets the updates from now on.
+        writer->send_initial_metadata();
 
-        stream_closed_future.wait();
-        return grpc::Status::OK;
+        return reactor;
     }
 
-    grpc::Status SubscribeCameraAttitudeEuler(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeCameraAttitudeEulerRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::CameraAttitudeEulerResponse>* writer) override
+    const bool _subscribe_camera_attitude_quaternion_registered{register_callback_stream(
+        "SubscribeCameraAttitudeQuaternion",
+        [this](CallbackServerContext* context, const grpc::ByteBuffer* request) {
+            return SubscribeCameraAttitudeQuaternion(context, request);
+        })};
+
+    // The synchronous version is replaced by the callback one below.
+    using Service::SubscribeCameraAttitudeEuler;
+
+    ServerWriteReactor<grpc::ByteBuffer>* SubscribeCameraAttitudeEuler(
+        CallbackServerContext* context, const grpc::ByteBuffer* /* request */)
     {
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return make_finished_reactor<grpc::ByteBuffer>(unknown_system_status());
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
+        auto hub = _stream_hubs.get(plugin, "camera_attitude_euler");
+        auto* reactor = new StreamWriteReactor<grpc::ByteBuffer>(
+            StreamPolicy::ConflateToLatest, [hub]() { hub->remove_finished(); });
+        auto writer = reactor->writer();
+        register_stream(writer);
 
-        std::mutex subscribe_mutex{};
+        hub->attach(writer, [plugin, hub]() {
+            const auto handle = plugin->subscribe_camera_attitude_euler(
+                [hub](const mavsdk::Telemetry::EulerAngle camera_attitude_euler) {
+                    thread_local rpc::telemetry::CameraAttitudeEulerResponse rpc_response;
 
-        _telemetry.subscribe_camera_attitude_euler(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
-                const mavsdk::Telemetry::EulerAngle camera_attitude_euler) {
-                rpc::telemetry::CameraAttitudeEulerResponse rpc_response;
+                    translateToRpcEulerAngle(
+                        camera_attitude_euler, rpc_response.mutable_attitude_euler());
 
-                rpc_response.set_allocated_attitude_euler(
-                    translateToRpcEulerAngle(camera_attitude_euler).release());
+                    hub->publish(rpc_response);
+                },
+                {});
 
-                std::unique_lock<std::mutex> lock(subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _telemetry.subscribe_camera_attitude_euler(nullptr);
+            return [plugin, handle]() { plugin->unsubscribe_camera_attitude_euler(handle); };
+        });
 
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    lock.unlock();
-                    stream_closed_promise->set_value();
-                }
-            });
+        // Tells the client that it gets the updates from now on.
+        writer->send_initial_metadata();
 
-        stream_closed_future.wait();
-        return grpc::Status::OK;
+        return reactor;
     }
 
-    grpc::Status SubscribeVelocityNed(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeVelocityNedRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::VelocityNedResponse>* writer) override
+    const bool _subscribe_camera_attitude_euler_registered{register_callback_stream(
+        "SubscribeCameraAttitudeEuler",
+        [this](CallbackServerContext* context, const grpc::ByteBuffer* request) {
+            return SubscribeCameraAttitudeEuler(context, request);
+        })};
+
+    // The synchronous version is replaced by the callback one below.
+    using Service::SubscribeVelocityNed;
+
+    ServerWriteReactor<grpc::ByteBuffer>* SubscribeVelocityNed(
+        CallbackServerContext* context, const grpc::ByteBuffer* /* request */)
     {
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return make_finished_reactor<grpc::ByteBuffer>(unknown_system_status());
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
+        auto hub = _stream_hubs.get(plugin, "velocity_ned");
+        auto* reactor = new StreamWriteReactor<grpc::ByteBuffer>(
+            StreamPolicy::ConflateToLatest, [hub]() { hub->remove_finished(); });
+        auto writer = reactor->writer();
+        register_stream(writer);
 
-        std::mutex subscribe_mutex{};
+        hub->attach(writer, [plugin, hub]() {
+            const auto handle = plugin->subscribe_velocity_ned(
+                [hub](const mavsdk::Telemetry::VelocityNed velocity_ned) {
+                    thread_local rpc::telemetry::VelocityNedResponse rpc_response;
 
-        _telemetry.subscribe_velocity_ned(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
-                const mavsdk::Telemetry::VelocityNed velocity_ned) {
-                rpc::telemetry::VelocityNedResponse rpc_response;
+                    translateToRpcVelocityNed(velocity_ned, rpc_response.mutable_velocity_ned());
 
-                rpc_response.set_allocated_velocity_ned(
-                    translateToRpcVelocityNed(velocity_ned).release());
+                    hub->publish(rpc_response);
+                },
+                {});
 
-                std::unique_lock<std::mutex> lock(subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _telemetry.subscribe_velocity_ned(nullptr);
+            return [plugin, handle]() { plugin->unsubscribe_velocity_ned(handle); };
+        });
 
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    lock.unlock();
-                    stream_closed_promise->set_value();
-                }
-            });
+        // Tells the client that it gets the updates from now on.
+        writer->send_initial_metadata();
 
-        stream_closed_future.wait();
-        return grpc::Status::OK;
+        return reactor;
     }
 
-    grpc::Status SubscribeGpsInfo(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeGpsInfoRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::GpsInfoResponse>* writer) override
+    const bool _subscribe_velocity_ned_registered{register_callback_stream(
+        "SubscribeVelocityNed",
+        [this](CallbackServerContext* context, const grpc::ByteBuffer* request) {
+            return SubscribeVelocityNed(context, request);
+        })};
+
+    // The synchronous version is replaced by the callback one below.
+    using Service::SubscribeGpsInfo;
+
+    ServerWriteReactor<grpc::ByteBuffer>* SubscribeGpsInfo(
+        CallbackServerContext* context, const grpc::ByteBuffer* /* request */)
     {
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return make_finished_reactor<grpc::ByteBuffer>(unknown_system_status());
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
+        auto hub = _stream_hubs.get(plugin, "gps_info");
+        auto* reactor = new StreamWriteReactor<grpc::ByteBuffer>(
+            StreamPolicy::ConflateToLatest, [hub]() { hub->remove_finished(); });
+        auto writer = reactor->writer();
+        register_stream(writer);
 
-        std::mutex subscribe_mutex{};
+        hub->attach(writer, [plugin, hub]() {
+            const auto handle = plugin->subscribe_gps_info(
+                [hub](const mavsdk::Telemetry::GpsInfo gps_info) {
+                    thread_local rpc::telemetry::GpsInfoResponse rpc_response;
 
-        _telemetry.subscribe_gps_info(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
-                const mavsdk::Telemetry::GpsInfo gps_info) {
-                rpc::telemetry::GpsInfoResponse rpc_response;
+                    translateToRpcGpsInfo(gps_info, rpc_response.mutable_gps_info());
 
-                rpc_response.set_allocated_gps_info(translateToRpcGpsInfo(gps_info).release());
+                    hub->publish(rpc_response);
+                },
+                {});
 
-                std::unique_lock<std::mutex> lock(subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _telemetry.subscribe_gps_info(nullptr);
+            return [plugin, handle]() { plugin->unsubscribe_gps_info(handle); };
+        });
 
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    lock.unlock();
-                    stream_closed_promise->set_value();
-                }
-            });
+        // Tells the client that it gets the updates from now on.
+        writer->send_initial_metadata();
 
-        stream_closed_future.wait();
-        return grpc::Status::OK;
+        return reactor;
     }
 
-    grpc::Status SubscribeBattery(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeBatteryRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::BatteryResponse>* writer) override
+    const bool _subscribe_gps_info_registered{register_callback_stream(
+        "SubscribeGpsInfo",
+        [this](CallbackServerContext* context, const grpc::ByteBuffer* request) {
+            return SubscribeGpsInfo(context, request);
+        })};
+
+    // The synchronous version is replaced by the callback one below.
+    using Service::SubscribeBattery;
+
+    ServerWriteReactor<grpc::ByteBuffer>* SubscribeBattery(
+        CallbackServerContext* context, const grpc::ByteBuffer* /* request */)
     {
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return make_finished_reactor<grpc::ByteBuffer>(unknown_system_status());
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
+        auto hub = _stream_hubs.get(plugin, "battery");
+        auto* reactor = new StreamWriteReactor<grpc::ByteBuffer>(
+            StreamPolicy::ConflateToLatest, [hub]() { hub->remove_finished(); });
+        auto writer = reactor->writer();
+        register_stream(writer);
 
-        std::mutex subscribe_mutex{};
+        hub->attach(writer, [plugin, hub]() {
+            const auto handle = plugin->subscribe_battery(
+                [hub](const mavsdk::Telemetry::Battery battery) {
+                    thread_local rpc::telemetry::BatteryResponse rpc_response;
 
-        _telemetry.subscribe_battery(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
-                const mavsdk::Telemetry::Battery battery) {
-                rpc::telemetry::BatteryResponse rpc_response;
+                    translateToRpcBattery(battery, rpc_response.mutable_battery());
 
-                rpc_response.set_allocated_battery(translateToRpcBattery(battery).release());
+                    hub->publish(rpc_response);
+                },
+                {});
 
-                std::unique_lock<std::mutex> lock(subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _telemetry.subscribe_battery(nullptr);
+            return [plugin, handle]() { plugin->unsubscribe_battery(handle); };
+        });
 
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    lock.unlock();
-                    stream_closed_promise->set_value();
-                }
-            });
+        // Tells the client that it gets the updates from now on.
+        writer->send_initial_metadata();
 
-        stream_closed_future.wait();
-        return grpc::Status::OK;
+        return reactor;
     }
 
-    grpc::Status SubscribeFlightMode(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeFlightModeRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::FlightModeResponse>* writer) override
+    const bool _subscribe_battery_registered{register_callback_stream(
+        "SubscribeBattery",
+        [this](CallbackServerContext* context, const grpc::ByteBuffer* request) {
+            return SubscribeBattery(context, request);
+        })};
+
+    // The synchronous version is replaced by the callback one below.
+    using Service::SubscribeFlightMode;
+
+    ServerWriteReactor<grpc::ByteBuffer>* SubscribeFlightMode(
+        CallbackServerContext* context, const grpc::ByteBuffer* /* request */)
     {
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return make_finished_reactor<grpc::ByteBuffer>(unknown_system_status());
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
+        auto hub = _stream_hubs.get(plugin, "flight_mode");
+        auto* reactor = new StreamWriteReactor<grpc::ByteBuffer>(
+            StreamPolicy::ConflateToLatest, [hub]() { hub->remove_finished(); });
+        auto writer = reactor->writer();
+        register_stream(writer);
 
-        std::mutex subscribe_mutex{};
+        hub->attach(writer, [plugin, hub]() {
+            const auto handle = plugin->subscribe_flight_mode(
+                [hub](const mavsdk::Telemetry::FlightMode flight_mode) {
+                    thread_local rpc::telemetry::FlightModeResponse rpc_response;
 
-        _telemetry.subscribe_flight_mode(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
-                const mavsdk::Telemetry::FlightMode flight_mode) {
-                rpc::telemetry::FlightModeResponse rpc_response;
+                    rpc_response.set_flight_mode(translateToRpcFlightMode(flight_mode));
 
-                rpc_response.set_flight_mode(translateToRpcFlightMode(flight_mode));
+                    hub->publish(rpc_response);
+                },
+                {});
 
-                std::unique_lock<std::mutex> lock(subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _telemetry.subscribe_flight_mode(nullptr);
+            return [plugin, handle]() { plugin->unsubscribe_flight_mode(handle); };
+        });
 
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    lock.unlock();
-                    stream_closed_promise->set_value();
-                }
-            });
+        // Tells the client that it gets the updates from now on.
+        writer->send_initial_metadata();
 
-        stream_closed_future.wait();
-        return grpc::Status::OK;
+        return reactor;
     }
 
-    grpc::Status SubscribeHealth(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeHealthRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::HealthResponse>* writer) override
+    const bool _subscribe_flight_mode_registered{register_callback_stream(
+        "SubscribeFlightMode",
+        [this](CallbackServerContext* context, const grpc::ByteBuffer* request) {
+            return SubscribeFlightMode(context, request);
+        })};
+
+    // The synchronous version is replaced by the callback one below.
+    using Service::SubscribeHealth;
+
+    ServerWriteReactor<grpc::ByteBuffer>* SubscribeHealth(
+        CallbackServerContext* context, const grpc::ByteBuffer* /* request */)
     {
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return make_finished_reactor<grpc::ByteBuffer>(unknown_system_status());
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
+        auto hub = _stream_hubs.get(plugin, "health");
+        auto* reactor = new StreamWriteReactor<grpc::ByteBuffer>(
+            StreamPolicy::ConflateToLatest, [hub]() { hub->remove_finished(); });
+        auto writer = reactor->writer();
+        register_stream(writer);
 
-        std::mutex subscribe_mutex{};
+        hub->attach(writer, [plugin, hub]() {
+            const auto handle = plugin->subscribe_health(
+                [hub](const mavsdk::Telemetry::Health health) {
+                    thread_local rpc::telemetry::HealthResponse rpc_response;
 
-        _telemetry.subscribe_health(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
-                const mavsdk::Telemetry::Health health) {
-                rpc::telemetry::HealthResponse rpc_response;
+                    translateToRpcHealth(health, rpc_response.mutable_health());
 
-                rpc_response.set_allocated_health(translateToRpcHealth(health).release());
+                    hub->publish(rpc_response);
+                },
+                {});
 
-                std::unique_lock<std::mutex> lock(subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _telemetry.subscribe_health(nullptr);
+            return [plugin, handle]() { plugin->unsubscribe_health(handle); };
+        });
 
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    lock.unlock();
-                    stream_closed_promise->set_value();
-                }
-            });
+        // Tells the client that it gets the updates from now on.
+        writer->send_initial_metadata();
 
-        stream_closed_future.wait();
-        return grpc::Status::OK;
+        return reactor;
     }
 
-    grpc::Status SubscribeRcStatus(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeRcStatusRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::RcStatusResponse>* writer) override
+    const bool _subscribe_health_registered{register_callback_stream(
+        "SubscribeHealth",
+        [this](CallbackServerContext* context, const grpc::ByteBuffer* request) {
+            return SubscribeHealth(context, request);
+        })};
+
+    // The synchronous version is replaced by the callback one below.
+    using Service::SubscribeRcStatus;
+
+    ServerWriteReactor<grpc::ByteBuffer>* SubscribeRcStatus(
+        CallbackServerContext* context, const grpc::ByteBuffer* /* request */)
     {
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return make_finished_reactor<grpc::ByteBuffer>(unknown_system_status());
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
+        auto hub = _stream_hubs.get(plugin, "rc_status");
+        auto* reactor = new StreamWriteReactor<grpc::ByteBuffer>(
+            StreamPolicy::ConflateToLatest, [hub]() { hub->remove_finished(); });
+        auto writer = reactor->writer();
+        register_stream(writer);
 
-        std::mutex subscribe_mutex{};
+        hub->attach(writer, [plugin, hub]() {
+            const auto handle = plugin->subscribe_rc_status(
+                [hub](const mavsdk::Telemetry::RcStatus rc_status) {
+                    thread_local rpc::telemetry::RcStatusResponse rpc_response;
 
-        _telemetry.subscribe_rc_status(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
-                const mavsdk::Telemetry::RcStatus rc_status) {
-                rpc::telemetry::RcStatusResponse rpc_response;
+                    translateToRpcRcStatus(rc_status, rpc_response.mutable_rc_status());
 
-                rpc_response.set_allocated_rc_status(translateToRpcRcStatus(rc_status).release());
+                    hub->publish(rpc_response);
+                },
+                {});
 
-                std::unique_lock<std::mutex> lock(subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _telemetry.subscribe_rc_status(nullptr);
+            return [plugin, handle]() { plugin->unsubscribe_rc_status(handle); };
+        });
 
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    lock.unlock();
-                    stream_closed_promise->set_value();
-                }
-            });
+        // Tells the client that it gets the updates from now on.
+        writer->send_initial_metadata();
 
-        stream_closed_future.wait();
-        return grpc::Status::OK;
+        return reactor;
     }
 
-    grpc::Status SubscribeStatusText(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeStatusTextRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::StatusTextResponse>* writer) override
+    const bool _subscribe_rc_status_registered{register_callback_stream(
+        "SubscribeRcStatus",
+        [this](CallbackServerContext* context, const grpc::ByteBuffer* request) {
+            return SubscribeRcStatus(context, request);
+        })};
+
+    // The synchronous version is replaced by the callback one below.
+    using Service::SubscribeStatusText;
+
+    ServerWriteReactor<grpc::ByteBuffer>* SubscribeStatusText(
+        CallbackServerContext* context, const grpc::ByteBuffer* /* request */)
     {
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return make_finished_reactor<grpc::ByteBuffer>(unknown_system_status());
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
+        auto hub = _stream_hubs.get(plugin, "status_text");
+        auto* reactor = new StreamWriteReactor<grpc::ByteBuffer>(
+            StreamPolicy::Queue, [hub]() { hub->remove_finished(); });
+        auto writer = reactor->writer();
+        register_stream(writer);
 
-        std::mutex subscribe_mutex{};
+        hub->attach(writer, [plugin, hub]() {
+            const auto handle = plugin->subscribe_status_text(
+                [hub](const mavsdk::Telemetry::StatusText status_text) {
+                    thread_local rpc::telemetry::StatusTextResponse rpc_response;
 
-        _telemetry.subscribe_status_text(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
-                const mavsdk::Telemetry::StatusText status_text) {
-                rpc::telemetry::StatusTextResponse rpc_response;
+                    translateToRpcStatusText(status_text, rpc_response.mutable_status_text());
 
-                rpc_response.set_allocated_status_text(
-                    translateToRpcStatusText(status_text).release());
+                    hub->publish(rpc_response);
+                },
+                {});
 
-                std::unique_lock<std::mutex> lock(subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _telemetry.subscribe_status_text(nullptr);
+            return [plugin, handle]() { plugin->unsubscribe_status_text(handle); };
+        });
 
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    lock.unlock();
-                    stream_closed_promise->set_value();
-                }
-            });
+        // Tells the client that it gets the updates from now on.
+        writer->send_initial_metadata();
 
-        stream_closed_future.wait();
-        return grpc::Status::OK;
+        return reactor;
     }
 
-    grpc::Status SubscribeActuatorControlTarget(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeActuatorControlTargetRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::ActuatorControlTargetResponse>* writer) override
+    const bool _subscribe_status_text_registered{register_callback_stream(
+        "SubscribeStatusText",
+        [this](CallbackServerContext* context, const grpc::ByteBuffer* request) {
+            return SubscribeStatusText(context, request);
+        })};
+
+    // The synchronous version is replaced by the callback one below.
+    using Service::SubscribeActuatorControlTarget;
+
+    ServerWriteReactor<grpc::ByteBuffer>* SubscribeActuatorControlTarget(
+        CallbackServerContext* context, const grpc::ByteBuffer* /* request */)
     {
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return make_finished_reactor<grpc::ByteBuffer>(unknown_system_status());
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
+        auto hub = _stream_hubs.get(plugin, "actuator_control_target");
+        auto* reactor = new StreamWriteReactor<grpc::ByteBuffer>(
+            StreamPolicy::ConflateToLatest, [hub]() { hub->remove_finished(); });
+        auto writer = reactor->writer();
+        register_stream(writer);
 
-        std::mutex subscribe_mutex{};
+        hub->attach(writer, [plugin, hub]() {
+            const auto handle = plugin->subscribe_actuator_control_target(
+                [hub](const mavsdk::Telemetry::ActuatorControlTarget actuator_control_target) {
+                    thread_local rpc::telemetry::ActuatorControlTargetResponse rpc_response;
 
-        _telemetry.subscribe_actuator_control_target(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
-                const mavsdk::Telemetry::ActuatorControlTarget actuator_control_target) {
-                rpc::telemetry::ActuatorControlTargetResponse rpc_response;
+                    translateToRpcActuatorControlTarget(
+                        actuator_control_target, rpc_response.mutable_actuator_control_target());
 
-                rpc_response.set_allocated_actuator_control_target(
-                    translateToRpcActuatorControlTarget(actuator_control_target).release());
+                    hub->publish(rpc_response);
+                },
+                {});
 
-                std::unique_lock<std::mutex> lock(subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _telemetry.subscribe_actuator_control_target(nullptr);
+            return [plugin, handle]() { plugin->unsubscribe_actuator_control_target(handle); };
+        });
 
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    lock.unlock();
-                    stream_closed_promise->set_value();
-                }
-            });
+        // Tells the client that it gets the updates from now on.
+        writer->send_initial_metadata();
 
-        stream_closed_future.wait();
-        return grpc::Status::OK;
+        return reactor;
     }
 
-    grpc::Status SubscribeActuatorOutputStatus(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeActuatorOutputStatusRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::ActuatorOutputStatusResponse>* writer) override
+    const bool _subscribe_actuator_control_target_registered{register_callback_stream(
+        "SubscribeActuatorControlTarget",
+        [this](CallbackServerContext* context, const grpc::ByteBuffer* request) {
+            return SubscribeActuatorControlTarget(context, request);
+        })};
+
+    // The synchronous version is replaced by the callback one below.
+    using Service::SubscribeActuatorOutputStatus;
+
+    ServerWriteReactor<grpc::ByteBuffer>* SubscribeActuatorOutputStatus(
+        CallbackServerContext* context, const grpc::ByteBuffer* /* request */)
     {
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return make_finished_reactor<grpc::ByteBuffer>(unknown_system_status());
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
+        auto hub = _stream_hubs.get(plugin, "actuator_output_status");
+        auto* reactor = new StreamWriteReactor<grpc::ByteBuffer>(
+            StreamPolicy::Queue, [hub]() { hub->remove_finished(); });
+        auto writer = reactor->writer();
+        register_stream(writer);
 
-        std::mutex subscribe_mutex{};
+        hub->attach(writer, [plugin, hub]() {
+            const auto handle = plugin->subscribe_actuator_output_status(
+                [hub](const mavsdk::Telemetry::ActuatorOutputStatus actuator_output_status) {
+                    thread_local rpc::telemetry::ActuatorOutputStatusResponse rpc_response;
 
-        _telemetry.subscribe_actuator_output_status(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
-                const mavsdk::Telemetry::ActuatorOutputStatus actuator_output_status) {
-                rpc::telemetry::ActuatorOutputStatusResponse rpc_response;
+                    translateToRpcActuatorOutputStatus(
+                        actuator_output_status, rpc_response.mutable_actuator_output_status());
 
-                rpc_response.set_allocated_actuator_output_status(
-                    translateToRpcActuatorOutputStatus(actuator_output_status).release());
+                    hub->publish(rpc_response);
+                },
+                {});
 
-                std::unique_lock<std::mutex> lock(subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _telemetry.subscribe_actuator_output_status(nullptr);
+            return [plugin, handle]() { plugin->unsubscribe_actuator_output_status(handle); };
+        });
 
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    lock.unlock();
-                    stream_closed_promise->set_value();
-                }
-            });
+        // Tells the client that it gets the updates from now on.
+        writer->send_initial_metadata();
 
-        stream_closed_future.wait();
-        return grpc::Status::OK;
+        return reactor;
     }
 
-    grpc::Status SubscribeOdometry(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeOdometryRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::OdometryResponse>* writer) override
+    const bool _subscribe_actuator_output_status_registered{register_callback_stream(
+        "SubscribeActuatorOutputStatus",
+        [this](CallbackServerContext* context, const grpc::ByteBuffer* request) {
+            return SubscribeActuatorOutputStatus(context, request);
+        })};
+
+    // The synchronous version is replaced by the callback one below.
+    using Service::SubscribeOdometry;
+
+    ServerWriteReactor<grpc::ByteBuffer>* SubscribeOdometry(
+        CallbackServerContext* context, const grpc::ByteBuffer* /* request */)
     {
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return make_finished_reactor<grpc::ByteBuffer>(unknown_system_status());
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
+        auto hub = _stream_hubs.get(plugin, "odometry");
+        auto* reactor = new StreamWriteReactor<grpc::ByteBuffer>(
+            StreamPolicy::Queue, [hub]() { hub->remove_finished(); });
+        auto writer = reactor->writer();
+        register_stream(writer);
 
-        std::mutex subscribe_mutex{};
+        hub->attach(writer, [plugin, hub]() {
+            const auto handle = plugin->subscribe_odometry(
+                [hub](const mavsdk::Telemetry::Odometry odometry) {
+                    thread_local rpc::telemetry::OdometryResponse rpc_response;
 
-        _telemetry.subscribe_odometry(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
-                const mavsdk::Telemetry::Odometry odometry) {
-                rpc::telemetry::OdometryResponse rpc_response;
+                    translateToRpcOdometry(odometry, rpc_response.mutable_odometry());
 
-                rpc_response.set_allocated_odometry(translateToRpcOdometry(odometry).release());
+                    hub->publish(rpc_response);
+                },
+                {});
 
-                std::unique_lock<std::mutex> lock(subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _telemetry.subscribe_odometry(nullptr);
+            return [plugin, handle]() { plugin->unsubscribe_odometry(handle); };
+        });
 
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    lock.unlock();
-                    stream_closed_promise->set_value();
-                }
-            });
+        // Tells the client that it gets the updates from now on.
+        writer->send_initial_metadata();
 
-        stream_closed_future.wait();
-        return grpc::Status::OK;
+        return reactor;
     }
 
-    grpc::Status SubscribePositionVelocityNed(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribePositionVelocityNedRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::PositionVelocityNedResponse>* writer) override
+    const bool _subscribe_odometry_registered{register_callback_stream(
+        "SubscribeOdometry",
+        [this](CallbackServerContext* context, const grpc::ByteBuffer* request) {
+            return SubscribeOdometry(context, request);
+        })};
+
+    // The synchronous version is replaced by the callback one below.
+    using Service::SubscribePositionVelocityNed;
+
+    ServerWriteReactor<grpc::ByteBuffer>* SubscribePositionVelocityNed(
+        CallbackServerContext* context, const grpc::ByteBuffer* /* request */)
     {
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return make_finished_reactor<grpc::ByteBuffer>(unknown_system_status());
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
+        auto hub = _stream_hubs.get(plugin, "position_velocity_ned");
+        auto* reactor = new StreamWriteReactor<grpc::ByteBuffer>(
+            StreamPolicy::ConflateToLatest, [hub]() { hub->remove_finished(); });
+        auto writer = reactor->writer();
+        register_stream(writer);
 
-        std::mutex subscribe_mutex{};
+        hub->attach(writer, [plugin, hub]() {
+            const auto handle = plugin->subscribe_position_velocity_ned(
+                [hub](const mavsdk::Telemetry::PositionVelocityNed position_velocity_ned) {
+                    thread_local rpc::telemetry::PositionVelocityNedResponse rpc_response;
 
-        _telemetry.subscribe_position_velocity_ned(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
-                const mavsdk::Telemetry::PositionVelocityNed position_velocity_ned) {
-                rpc::telemetry::PositionVelocityNedResponse rpc_response;
+                    translateToRpcPositionVelocityNed(
+                        position_velocity_ned, rpc_response.mutable_position_velocity_ned());
 
-                rpc_response.set_allocated_position_velocity_ned(
-                    translateToRpcPositionVelocityNed(position_velocity_ned).release());
+                    hub->publish(rpc_response);
+                },
+                {});
 
-                std::unique_lock<std::mutex> lock(subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _telemetry.subscribe_position_velocity_ned(nullptr);
+            return [plugin, handle]() { plugin->unsubscribe_position_velocity_ned(handle); };
+        });
 
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    lock.unlock();
-                    stream_closed_promise->set_value();
-                }
-            });
+        // Tells the client that it gets the updates from now on.
+        writer->send_initial_metadata();
 
-        stream_closed_future.wait();
-        return grpc::Status::OK;
+        return reactor;
     }
 
-    grpc::Status SubscribeGroundTruth(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeGroundTruthRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::GroundTruthResponse>* writer) override
+    const bool _subscribe_position_velocity_ned_registered{register_callback_stream(
+        "SubscribePositionVelocityNed",
+        [this](CallbackServerContext* context, const grpc::ByteBuffer* request) {
+            return SubscribePositionVelocityNed(context, request);
+        })};
+
+    // The synchronous version is replaced by the callback one below.
+    using Service::SubscribeGroundTruth;
+
+    ServerWriteReactor<grpc::ByteBuffer>* SubscribeGroundTruth(
+        CallbackServerContext* context, const grpc::ByteBuffer* /* request */)
     {
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return make_finished_reactor<grpc::ByteBuffer>(unknown_system_status());
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
+        auto hub = _stream_hubs.get(plugin, "ground_truth");
+        auto* reactor = new StreamWriteReactor<grpc::ByteBuffer>(
+            StreamPolicy::ConflateToLatest, [hub]() { hub->remove_finished(); });
+        auto writer = reactor->writer();
+        register_stream(writer);
 
-        std::mutex subscribe_mutex{};
+        hub->attach(writer, [plugin, hub]() {
+            const auto handle = plugin->subscribe_ground_truth(
+                [hub](const mavsdk::Telemetry::GroundTruth ground_truth) {
+                    thread_local rpc::telemetry::GroundTruthResponse rpc_response;
 
-        _telemetry.subscribe_ground_truth(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
-                const mavsdk::Telemetry::GroundTruth ground_truth) {
-                rpc::telemetry::GroundTruthResponse rpc_response;
+                    translateToRpcGroundTruth(ground_truth, rpc_response.mutable_ground_truth());
 
-                rpc_response.set_allocated_ground_truth(
-                    translateToRpcGroundTruth(ground_truth).release());
+                    hub->publish(rpc_response);
+                },
+                {});
 
-                std::unique_lock<std::mutex> lock(subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _telemetry.subscribe_ground_truth(nullptr);
+            return [plugin, handle]() { plugin->unsubscribe_ground_truth(handle); };
+        });
 
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    lock.unlock();
-                    stream_closed_promise->set_value();
-                }
-            });
+        // Tells the client that it gets the updates from now on.
+        writer->send_initial_metadata();
 
-        stream_closed_future.wait();
-        return grpc::Status::OK;
+        return reactor;
     }
 
-    grpc::Status SubscribeFixedwingMetrics(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeFixedwingMetricsRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::FixedwingMetricsResponse>* writer) override
+    const bool _subscribe_ground_truth_registered{register_callback_stream(
+        "SubscribeGroundTruth",
+        [this](CallbackServerContext* context, const grpc::ByteBuffer* request) {
+            return SubscribeGroundTruth(context, request);
+        })};
+
+    // The synchronous version is replaced by the callback one below.
+    using Service::SubscribeFixedwingMetrics;
+
+    ServerWriteReactor<grpc::ByteBuffer>* SubscribeFixedwingMetrics(
+        CallbackServerContext* context, const grpc::ByteBuffer* /* request */)
     {
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return make_finished_reactor<grpc::ByteBuffer>(unknown_system_status());
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
+        auto hub = _stream_hubs.get(plugin, "fixedwing_metrics");
+        auto* reactor = new StreamWriteReactor<grpc::ByteBuffer>(
+            StreamPolicy::ConflateToLatest, [hub]() { hub->remove_finished(); });
+        auto writer = reactor->writer();
+        register_stream(writer);
 
-        std::mutex subscribe_mutex{};
+        hub->attach(writer, [plugin, hub]() {
+            const auto handle = plugin->subscribe_fixedwing_metrics(
+                [hub](const mavsdk::Telemetry::FixedwingMetrics fixedwing_metrics) {
+                    thread_local rpc::telemetry::FixedwingMetricsResponse rpc_response;
 
-        _telemetry.subscribe_fixedwing_metrics(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
-                const mavsdk::Telemetry::FixedwingMetrics fixedwing_metrics) {
-                rpc::telemetry::FixedwingMetricsResponse rpc_response;
+                    translateToRpcFixedwingMetrics(
+                        fixedwing_metrics, rpc_response.mutable_fixedwing_metrics());
 
-                rpc_response.set_allocated_fixedwing_metrics(
-                    translateToRpcFixedwingMetrics(fixedwing_metrics).release());
+                    hub->publish(rpc_response);
+                },
+                {});
 
-                std::unique_lock<std::mutex> lock(subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _telemetry.subscribe_fixedwing_metrics(nullptr);
+            return [plugin, handle]() { plugin->unsubscribe_fixedwing_metrics(handle); };
+        });
 
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    lock.unlock();
-                    stream_closed_promise->set_value();
-                }
-            });
+        // Tells the client that it gets the updates from now on.
+        writer->send_initial_metadata();
 
-        stream_closed_future.wait();
-        return grpc::Status::OK;
+        return reactor;
     }
 
-    grpc::Status SubscribeImu(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeImuRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::ImuResponse>* writer) override
+    const bool _subscribe_fixedwing_metrics_registered{register_callback_stream(
+        "SubscribeFixedwingMetrics",
+        [this](CallbackServerContext* context, const grpc::ByteBuffer* request) {
+            return SubscribeFixedwingMetrics(context, request);
+        })};
+
+    // The synchronous version is replaced by the callback one below.
+    using Service::SubscribeImu;
+
+    ServerWriteReactor<grpc::ByteBuffer>* SubscribeImu(
+        CallbackServerContext* context, const grpc::ByteBuffer* /* request */)
     {
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return make_finished_reactor<grpc::ByteBuffer>(unknown_system_status());
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
+        auto hub = _stream_hubs.get(plugin, "imu");
+        auto* reactor = new StreamWriteReactor<grpc::ByteBuffer>(
+            StreamPolicy::Queue, [hub]() { hub->remove_finished(); });
+        auto writer = reactor->writer();
+        register_stream(writer);
 
-        std::mutex subscribe_mutex{};
+        hub->attach(writer, [plugin, hub]() {
+            const auto handle = plugin->subscribe_imu(
+                [hub](const mavsdk::Telemetry::Imu imu) {
+                    thread_local rpc::telemetry::ImuResponse rpc_response;
 
-        _telemetry.subscribe_imu(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
-                const mavsdk::Telemetry::Imu imu) {
-                rpc::telemetry::ImuResponse rpc_response;
+                    translateToRpcImu(imu, rpc_response.mutable_imu());
 
-                rpc_response.set_allocated_imu(translateToRpcImu(imu).release());
+                    hub->publish(rpc_response);
+                },
+                {});
 
-                std::unique_lock<std::mutex> lock(subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _telemetry.subscribe_imu(nullptr);
+            return [plugin, handle]() { plugin->unsubscribe_imu(handle); };
+        });
 
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    lock.unlock();
-                    stream_closed_promise->set_value();
-                }
-            });
+        // Tells the client that it gets the updates from now on.
+        writer->send_initial_metadata();
 
-        stream_closed_future.wait();
-        return grpc::Status::OK;
+        return reactor;
     }
 
-    grpc::Status SubscribeHealthAllOk(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeHealthAllOkRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::HealthAllOkResponse>* writer) override
+    const bool _subscribe_imu_registered{register_callback_stream(
+        "SubscribeImu",
+        [this](CallbackServerContext* context, const grpc::ByteBuffer* request) {
+            return SubscribeImu(context, request);
+        })};
+
+    // The synchronous version is replaced by the callback one below.
+    using Service::SubscribeHealthAllOk;
+
+    ServerWriteReactor<grpc::ByteBuffer>* SubscribeHealthAllOk(
+        CallbackServerContext* context, const grpc::ByteBuffer* /* request */)
     {
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return make_finished_reactor<grpc::ByteBuffer>(unknown_system_status());
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
+        auto hub = _stream_hubs.get(plugin, "health_all_ok");
+        auto* reactor = new StreamWriteReactor<grpc::ByteBuffer>(
+            StreamPolicy::ConflateToLatest, [hub]() { hub->remove_finished(); });
+        auto writer = reactor->writer();
+        register_stream(writer);
 
-        std::mutex subscribe_mutex{};
+        hub->attach(writer, [plugin, hub]() {
+            const auto handle = plugin->subscribe_health_all_ok(
+                [hub](const bool health_all_ok) {
+                    thread_local rpc::telemetry::HealthAllOkResponse rpc_response;
 
-        _telemetry.subscribe_health_all_ok(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
-                const bool health_all_ok) {
-                rpc::telemetry::HealthAllOkResponse rpc_response;
+                    rpc_response.set_is_health_all_ok(health_all_ok);
 
-                rpc_response.set_is_health_all_ok(health_all_ok);
+                    hub->publish(rpc_response);
+                },
+                {});
 
-                std::unique_lock<std::mutex> lock(subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _telemetry.subscribe_health_all_ok(nullptr);
+            return [plugin, handle]() { plugin->unsubscribe_health_all_ok(handle); };
+        });
 
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    lock.unlock();
-                    stream_closed_promise->set_value();
-                }
-            });
+        // Tells the client that it gets the updates from now on.
+        writer->send_initial_metadata();
 
-        stream_closed_future.wait();
-        return grpc::Status::OK;
+        return reactor;
     }
 
-    grpc::Status SubscribeUnixEpochTime(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeUnixEpochTimeRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::UnixEpochTimeResponse>* writer) override
+    const bool _subscribe_health_all_ok_registered{register_callback_stream(
+        "SubscribeHealthAllOk",
+        [this](CallbackServerContext* context, const grpc::ByteBuffer* request) {
+            return SubscribeHealthAllOk(context, request);
+        })};
+
+    // The synchronous version is replaced by the callback one below.
+    using Service::SubscribeUnixEpochTime;
+
+    ServerWriteReactor<grpc::ByteBuffer>* SubscribeUnixEpochTime(
+        CallbackServerContext* context, const grpc::ByteBuffer* /* request */)
     {
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return make_finished_reactor<grpc::ByteBuffer>(unknown_system_status());
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
+        auto hub = _stream_hubs.get(plugin, "unix_epoch_time");
+        auto* reactor = new StreamWriteReactor<grpc::ByteBuffer>(
+            StreamPolicy::ConflateToLatest, [hub]() { hub->remove_finished(); });
+        auto writer = reactor->writer();
+        register_stream(writer);
 
-        std::mutex subscribe_mutex{};
+        hub->attach(writer, [plugin, hub]() {
+            const auto handle = plugin->subscribe_unix_epoch_time(
+                [hub](const uint64_t unix_epoch_time) {
+                    thread_local rpc::telemetry::UnixEpochTimeResponse rpc_response;
 
-        _telemetry.subscribe_unix_epoch_time(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
-                const uint64_t unix_epoch_time) {
-                rpc::telemetry::UnixEpochTimeResponse rpc_response;
+                    rpc_response.set_time_us(unix_epoch_time);
 
-                rpc_response.set_time_us(unix_epoch_time);
+                    hub->publish(rpc_response);
+                },
+                {});
 
-                std::unique_lock<std::mutex> lock(subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _telemetry.subscribe_unix_epoch_time(nullptr);
+            return [plugin, handle]() { plugin->unsubscribe_unix_epoch_time(handle); };
+        });
 
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    lock.unlock();
-                    stream_closed_promise->set_value();
-                }
-            });
+        // Tells the client that it gets the updates from now on.
+        writer->send_initial_metadata();
 
-        stream_closed_future.wait();
-        return grpc::Status::OK;
+        return reactor;
     }
 
-    grpc::Status SubscribeDistanceSensor(
-        grpc::ServerContext* /* context */,
-        const mavsdk::rpc::telemetry::SubscribeDistanceSensorRequest* /* request */,
-        grpc::ServerWriter<rpc::telemetry::DistanceSensorResponse>* writer) override
+    const bool _subscribe_unix_epoch_time_registered{register_callback_stream(
+        "SubscribeUnixEpochTime",
+        [this](CallbackServerContext* context, const grpc::ByteBuffer* request) {
+            return SubscribeUnixEpochTime(context, request);
+        })};
+
+    // The synchronous version is replaced by the callback one below.
+    using Service::SubscribeDistanceSensor;
+
+    ServerWriteReactor<grpc::ByteBuffer>* SubscribeDistanceSensor(
+        CallbackServerContext* context, const grpc::ByteBuffer* /* request */)
     {
-        auto stream_closed_promise = std::make_shared<std::promise<void>>();
-        auto stream_closed_future = stream_closed_promise->get_future();
-        register_stream_stop_promise(stream_closed_promise);
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return make_finished_reactor<grpc::ByteBuffer>(unknown_system_status());
+        }
 
-        auto is_finished = std::make_shared<bool>(false);
+        auto hub = _stream_hubs.get(plugin, "distance_sensor");
+        auto* reactor = new StreamWriteReactor<grpc::ByteBuffer>(
+            StreamPolicy::ConflateToLatest, [hub]() { hub->remove_finished(); });
+        auto writer = reactor->writer();
+        register_stream(writer);
 
-        std::mutex subscribe_mutex{};
+        hub->attach(writer, [plugin, hub]() {
+            const auto handle = plugin->subscribe_distance_sensor(
+                [hub](const mavsdk::Telemetry::DistanceSensor distance_sensor) {
+                    thread_local rpc::telemetry::DistanceSensorResponse rpc_response;
 
-        _telemetry.subscribe_distance_sensor(
-            [this, &writer, &stream_closed_promise, is_finished, &subscribe_mutex](
-                const mavsdk::Telemetry::DistanceSensor distance_sensor) {
-                rpc::telemetry::DistanceSensorResponse rpc_response;
+                    translateToRpcDistanceSensor(
+                        distance_sensor, rpc_response.mutable_distance_sensor());
 
-                rpc_response.set_allocated_distance_sensor(
-                    translateToRpcDistanceSensor(distance_sensor).release());
+                    hub->publish(rpc_response);
+                },
+                {});
 
-                std::unique_lock<std::mutex> lock(subscribe_mutex);
-                if (!*is_finished && !writer->Write(rpc_response)) {
-                    _telemetry.subscribe_distance_sensor(nullptr);
+            return [plugin, handle]() { plugin->unsubscribe_distance_sensor(handle); };
+        });
 
-                    *is_finished = true;
-                    unregister_stream_stop_promise(stream_closed_promise);
-                    lock.unlock();
-                    stream_closed_promise->set_value();
-                }
-            });
+        // Tells the client that it gets the updates from now on.
+        writer->send_initial_metadata();
 
-        stream_closed_future.wait();
-        return grpc::Status::OK;
+        return reactor;
     }
 
+    const bool _subscribe_distance_sensor_registered{register_callback_stream(
+        "SubscribeDistanceSensor",
+        [this](CallbackServerContext* context, const grpc::ByteBuffer* request) {
+            return SubscribeDistanceSensor(context, request);
+        })};
+
     grpc::Status SetRatePosition(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRatePositionRequest* request,
         rpc::telemetry::SetRatePositionResponse* response) override
     {
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetRatePosition sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _telemetry.set_rate_position(request->rate_hz());
+        auto result = plugin->set_rate_position(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -2088,16 +2426,21 @@ public:
     }
 
     grpc::Status SetRateHome(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateHomeRequest* request,
         rpc::telemetry::SetRateHomeResponse* response) override
     {
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetRateHome sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _telemetry.set_rate_home(request->rate_hz());
+        auto result = plugin->set_rate_home(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -2107,16 +2450,21 @@ public:
     }
 
     grpc::Status SetRateInAir(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateInAirRequest* request,
         rpc::telemetry::SetRateInAirResponse* response) override
     {
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetRateInAir sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _telemetry.set_rate_in_air(request->rate_hz());
+        auto result = plugin->set_rate_in_air(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -2126,16 +2474,21 @@ public:
     }
 
     grpc::Status SetRateLandedState(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateLandedStateRequest* request,
         rpc::telemetry::SetRateLandedStateResponse* response) override
     {
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetRateLandedState sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _telemetry.set_rate_landed_state(request->rate_hz());
+        auto result = plugin->set_rate_landed_state(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -2145,16 +2498,21 @@ public:
     }
 
     grpc::Status SetRateAttitude(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateAttitudeRequest* request,
         rpc::telemetry::SetRateAttitudeResponse* response) override
     {
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetRateAttitude sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _telemetry.set_rate_attitude(request->rate_hz());
+        auto result = plugin->set_rate_attitude(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -2164,16 +2522,21 @@ public:
     }
 
     grpc::Status SetRateCameraAttitude(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateCameraAttitudeRequest* request,
         rpc::telemetry::SetRateCameraAttitudeResponse* response) override
     {
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetRateCameraAttitude sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _telemetry.set_rate_camera_attitude(request->rate_hz());
+        auto result = plugin->set_rate_camera_attitude(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -2183,16 +2546,21 @@ public:
     }
 
     grpc::Status SetRateVelocityNed(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateVelocityNedRequest* request,
         rpc::telemetry::SetRateVelocityNedResponse* response) override
     {
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetRateVelocityNed sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _telemetry.set_rate_velocity_ned(request->rate_hz());
+        auto result = plugin->set_rate_velocity_ned(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -2202,16 +2570,21 @@ public:
     }
 
     grpc::Status SetRateGpsInfo(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateGpsInfoRequest* request,
         rpc::telemetry::SetRateGpsInfoResponse* response) override
     {
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetRateGpsInfo sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _telemetry.set_rate_gps_info(request->rate_hz());
+        auto result = plugin->set_rate_gps_info(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -2221,16 +2594,21 @@ public:
     }
 
     grpc::Status SetRateBattery(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateBatteryRequest* request,
         rpc::telemetry::SetRateBatteryResponse* response) override
     {
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetRateBattery sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _telemetry.set_rate_battery(request->rate_hz());
+        auto result = plugin->set_rate_battery(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -2240,16 +2618,21 @@ public:
     }
 
     grpc::Status SetRateRcStatus(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateRcStatusRequest* request,
         rpc::telemetry::SetRateRcStatusResponse* response) override
     {
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetRateRcStatus sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _telemetry.set_rate_rc_status(request->rate_hz());
+        auto result = plugin->set_rate_rc_status(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -2259,16 +2642,21 @@ public:
     }
 
     grpc::Status SetRateActuatorControlTarget(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateActuatorControlTargetRequest* request,
         rpc::telemetry::SetRateActuatorControlTargetResponse* response) override
     {
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetRateActuatorControlTarget sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _telemetry.set_rate_actuator_control_target(request->rate_hz());
+        auto result = plugin->set_rate_actuator_control_target(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -2278,16 +2666,21 @@ public:
     }
 
     grpc::Status SetRateActuatorOutputStatus(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateActuatorOutputStatusRequest* request,
         rpc::telemetry::SetRateActuatorOutputStatusResponse* response) override
     {
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetRateActuatorOutputStatus sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _telemetry.set_rate_actuator_output_status(request->rate_hz());
+        auto result = plugin->set_rate_actuator_output_status(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -2297,16 +2690,21 @@ public:
     }
 
     grpc::Status SetRateOdometry(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateOdometryRequest* request,
         rpc::telemetry::SetRateOdometryResponse* response) override
     {
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetRateOdometry sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _telemetry.set_rate_odometry(request->rate_hz());
+        auto result = plugin->set_rate_odometry(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -2316,16 +2714,21 @@ public:
     }
 
     grpc::Status SetRatePositionVelocityNed(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRatePositionVelocityNedRequest* request,
         rpc::telemetry::SetRatePositionVelocityNedResponse* response) override
     {
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetRatePositionVelocityNed sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _telemetry.set_rate_position_velocity_ned(request->rate_hz());
+        auto result = plugin->set_rate_position_velocity_ned(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -2335,16 +2738,21 @@ public:
     }
 
     grpc::Status SetRateGroundTruth(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateGroundTruthRequest* request,
         rpc::telemetry::SetRateGroundTruthResponse* response) override
     {
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetRateGroundTruth sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _telemetry.set_rate_ground_truth(request->rate_hz());
+        auto result = plugin->set_rate_ground_truth(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -2354,16 +2762,21 @@ public:
     }
 
     grpc::Status SetRateFixedwingMetrics(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateFixedwingMetricsRequest* request,
         rpc::telemetry::SetRateFixedwingMetricsResponse* response) override
     {
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetRateFixedwingMetrics sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _telemetry.set_rate_fixedwing_metrics(request->rate_hz());
+        auto result = plugin->set_rate_fixedwing_metrics(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -2373,16 +2786,21 @@ public:
     }
 
     grpc::Status SetRateImu(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateImuRequest* request,
         rpc::telemetry::SetRateImuResponse* response) override
     {
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetRateImu sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _telemetry.set_rate_imu(request->rate_hz());
+        auto result = plugin->set_rate_imu(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -2392,16 +2810,21 @@ public:
     }
 
     grpc::Status SetRateUnixEpochTime(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateUnixEpochTimeRequest* request,
         rpc::telemetry::SetRateUnixEpochTimeResponse* response) override
     {
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetRateUnixEpochTime sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _telemetry.set_rate_unix_epoch_time(request->rate_hz());
+        auto result = plugin->set_rate_unix_epoch_time(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -2411,16 +2834,21 @@ public:
     }
 
     grpc::Status SetRateDistanceSensor(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::SetRateDistanceSensorRequest* request,
         rpc::telemetry::SetRateDistanceSensorResponse* response) override
     {
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "SetRateDistanceSensor sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _telemetry.set_rate_distance_sensor(request->rate_hz());
+        auto result = plugin->set_rate_distance_sensor(request->rate_hz());
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -2430,11 +2858,16 @@ public:
     }
 
     grpc::Status GetGpsGlobalOrigin(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::telemetry::GetGpsGlobalOriginRequest* /* request */,
         rpc::telemetry::GetGpsGlobalOriginResponse* response) override
     {
-        auto result = _telemetry.get_gps_global_origin();
+        auto* plugin = _lazy_telemetry.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
+        auto result = plugin->get_gps_global_origin();
 
         if (response != nullptr) {
             fillResponseWithResult(response, result.first);
@@ -2448,42 +2881,72 @@ public:
 
     void stop()
     {
-        _stopped.store(true);
-        for (auto& prom : _stream_stop_promises) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
+        std::vector<std::weak_ptr<ServerStream>> streams;
+        {
+            std::lock_guard<std::mutex> lock(_streams_mutex);
+            _stopped = true;
+            streams.swap(_streams);
+        }
+
+        for (auto& stream : streams) {
+            if (auto handle = stream.lock()) {
+                handle->finish();
             }
         }
     }
 
 private:
-    void register_stream_stop_promise(std::weak_ptr<std::promise<void>> prom)
-    {
-        // If we have already stopped, set promise immediately and don't add it to list.
-        if (_stopped.load()) {
-            if (auto handle = prom.lock()) {
-                handle->set_value();
+    using CallbackStreamHandler = std::function<ServerWriteReactor<grpc::ByteBuffer>*(
+        CallbackServerContext*, const grpc::ByteBuffer*)>;
+
+    // Serves a server streaming method with the callback API instead of the
+    // synchronous one. Returns true so it can initialize a member.
+    bool register_callback_stream(const std::string& method_name, CallbackStreamHandler handler)
+    {
+        const auto* service = google::protobuf::DescriptorPool::generated_pool()->FindServiceByName(
+            rpc::telemetry::TelemetryService::service_full_name());
+        const int index = service->FindMethodByName(method_name)->index();
+
+        auto* callback_handler =
+            new grpc::internal::CallbackServerStreamingHandler<grpc::ByteBuffer, grpc::ByteBuffer>(
+                std::move(handler));
+#ifdef GRPC_CALLBACK_API_NONEXPERIMENTAL
+        MarkMethodRawCallback(index, callback_handler);
+#else
+        experimental().MarkMethodRawCallback(index, callback_handler);
+#endif
+        return true;
+    }
+
+    void register_stream(std::weak_ptr<ServerStream> stream)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_streams_mutex);
+            // If we have not stopped yet, keep it to finish it later, otherwise finish it now.
+            if (!_stopped) {
+                // Forget about streams which are gone in the meantime.
+                for (auto it = _streams.begin(); it != _streams.end();) {
+                    if (it->expired()) {
+                        it = _streams.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+                _streams.push_back(stream);
+                return;
             }
-        } else {
-            _stream_stop_promises.push_back(prom);
         }
-    }
 
-    void unregister_stream_stop_promise(std::shared_ptr<std::promise<void>> prom)
-    {
-        for (auto it = _stream_stop_promises.begin(); it != _stream_stop_promises.end();
-             /* ++it */) {
-            if (it->lock() == prom) {
-                it = _stream_stop_promises.erase(it);
-            } else {
-                ++it;
-            }
+        if (auto handle = stream.lock()) {
+            handle->finish();
         }
     }
 
-    Telemetry& _telemetry;
-    std::atomic<bool> _stopped{false};
-    std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
+    LazyPlugin<Telemetry> _lazy_telemetry;
+    StreamHubs<Telemetry> _stream_hubs{};
+    std::mutex _streams_mutex{};
+    bool _stopped{false};
+    std::vector<std::weak_ptr<ServerStream>> _streams{};
 };
 
 } // namespace backend
@@ -5,6 +5,7 @@
 #include "tune/tune.grpc.pb.h"
 #include "plugins/tune/tune.h"
 
+#include "lazy_plugin.h"
 #include "log.h"
 #include <atomic>
 #include <cmath>
@@ -20,7 +21,9 @@ namespace backend {
 template<typename Tune = Tune>
 class TuneServiceImpl final : public rpc::tune::TuneService::Service {
 public:
-    TuneServiceImpl(Tune& tune) : _tune(tune) {}
+    TuneServiceImpl(Tune& tune) : _lazy_tune(tune) {}
+
+    TuneServiceImpl(Mavsdk& mavsdk) : _lazy_tune(mavsdk) {}
 
     template<typename ResponseType>
     void fillResponseWithResult(ResponseType* response, mavsdk::Tune::Result& result) const
@@ -144,14 +147,19 @@ public:
     translateToRpcTuneDescription(const mavsdk::Tune::TuneDescription& tune_description)
     {
         auto rpc_obj = std::make_unique<rpc::tune::TuneDescription>();
+        translateToRpcTuneDescription(tune_description, rpc_obj.get());
+        return rpc_obj;
+    }
 
+    static void translateToRpcTuneDescription(
+        const mavsdk::Tune::TuneDescription& tune_description, rpc::tune::TuneDescription* rpc_obj)
+    {
+        rpc_obj->clear_song_elements();
         for (const auto& elem : tune_description.song_elements) {
             rpc_obj->add_song_elements(translateToRpcSongElement(elem));
         }
 
         rpc_obj->set_tempo(tune_description.tempo);
-
-        return rpc_obj;
     }
 
     static mavsdk::Tune::TuneDescription
@@ -208,16 +216,22 @@ public:
     }
 
     grpc::Status PlayTune(
-        grpc::ServerContext* /* context */,
+        grpc::ServerContext* context,
         const rpc::tune::PlayTuneRequest* request,
         rpc::tune::PlayTuneResponse* response) override
     {
+        auto* plugin = _lazy_tune.maybe_plugin(context);
+        if (plugin == nullptr) {
+            return unknown_system_status();
+        }
+
         if (request == nullptr) {
             LogWarn() << "PlayTune sent with a null request! Ignoring...";
             return grpc::Status::OK;
         }
 
-        auto result = _tune.play_tune(translateFromRpcTuneDescription(request->tune_description()));
+        auto result =
+            plugin->play_tune(translateFromRpcTuneDescription(request->tune_description()));
 
         if (response != nullptr) {
             fillResponseWithResult(response, result);
@@ -261,7 +275,7 @@ private:
         }
     }
 
-    Tune& _tune;
+    LazyPlugin<Tune> _lazy_tune;
     std::atomic<bool> _stopped{false};
     std::vector<std::weak_ptr<std::promise<void>>> _stream_stop_promises{};
 };
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <grpcpp/impl/codegen/proto_utils.h>
+#include <grpcpp/support/byte_buffer.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "log.h"
+#include "stream_write_reactor.h"
+
+namespace mavsdk {
+namespace backend {
+
+// Shares one plugin subscription between all clients of a stream.
+//
+// The first client attaching subscribes to the plugin. Every update is then
+// translated and serialized once, and the same bytes are queued to all
+// clients, each with its own StreamPolicy. Once the last client is gone, the
+// plugin subscription is dropped again.
+//
+// The plugin must not call back synchronously from subscribing or
+// unsubscribing, as that happens with the hub locked.
+class StreamHub {
+public:
+    using Writer = StreamWriter<grpc::ByteBuffer>;
+
+    StreamHub() = default;
+    ~StreamHub() = default;
+
+    // Subscribes to the plugin and returns what unsubscribes again.
+    using Subscribe = std::function<std::function<void()>()>;
+
+    // Adds a client. The first one subscribes to the plugin.
+    void attach(std::weak_ptr<Writer> writer, const Subscribe& subscribe)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        prune();
+        _writers.push_back(std::move(writer));
+        if (!_unsubscribe) {
+            _unsubscribe = subscribe();
+        }
+    }
+
+    // Forgets about the clients which are gone, to be called when a client
+    // goes away. The plugin subscription is dropped with the last one.
+    //
+    // Subscribing and unsubscribing both happen under _mutex, so a client
+    // attaching meanwhile either keeps the subscription alive or subscribes
+    // again once it is dropped.
+    void remove_finished()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        prune();
+        if (_writers.empty() && _unsubscribe) {
+            _unsubscribe();
+            _unsubscribe = nullptr;
+        }
+    }
+
+    // Serializes the message once and queues it to all clients.
+    template<typename Message> void publish(const Message& message)
+    {
+        grpc::ByteBuffer buffer;
+        bool own_buffer = false;
+        if (!grpc::SerializationTraits<Message>::Serialize(message, &buffer, &own_buffer).ok()) {
+            LogErr() << "Could not serialize stream message";
+            return;
+        }
+
+        // The writers are collected into a member, which keeps its capacity, and
+        // written to without _mutex, as a write can end up in remove_finished().
+        std::lock_guard<std::mutex> publish_lock(_publish_mutex);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            for (auto& weak_writer : _writers) {
+                if (auto writer = weak_writer.lock()) {
+                    _publishing.push_back(std::move(writer));
+                }
+            }
+        }
+
+        // The buffer shares its slices, so copying it doesn't copy the bytes.
+        for (auto& writer : _publishing) {
+            writer->write(buffer);
+        }
+        _publishing.clear();
+    }
+
+    StreamHub(const StreamHub&) = delete;
+    StreamHub& operator=(const StreamHub&) = delete;
+
+private:
+    // Needs _mutex to be locked.
+    void prune()
+    {
+        for (auto it = _writers.begin(); it != _writers.end();) {
+            auto writer = it->lock();
+            if (!writer || writer->finished()) {
+                it = _writers.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    std::mutex _mutex{};
+    std::vector<std::weak_ptr<Writer>> _writers{};
+    std::function<void()> _unsubscribe{};
+
+    std::mutex _publish_mutex{};
+    std::vector<std::shared_ptr<Writer>> _publishing{};
+};
+
+// The hubs of a service, one per plugin instance and stream.
+template<typename Plugin> class StreamHubs {
+public:
+    StreamHubs() = default;
+    ~StreamHubs() = default;
+
+    std::shared_ptr<StreamHub> get(const Plugin* plugin, const std::string& stream)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto& hub = _hubs[std::make_pair(plugin, stream)];
+        if (!hub) {
+            hub = std::make_shared<StreamHub>();
+        }
+        return hub;
+    }
+
+    StreamHubs(const StreamHubs&) = delete;
+    StreamHubs& operator=(const StreamHubs&) = delete;
+
+private:
+    std::mutex _mutex{};
+    std::map<std::pair<const Plugin*, std::string>, std::shared_ptr<StreamHub>> _hubs{};
+};
+
+} // namespace backend
+} // namespace mavsdk
@@ -0,0 +1,318 @@
+#pragma once
+
+#include <grpcpp/support/server_callback.h>
+#include "log.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mavsdk {
+namespace backend {
+
+#ifdef GRPC_CALLBACK_API_NONEXPERIMENTAL
+using CallbackServerContext = grpc::CallbackServerContext;
+template<typename ResponseType> using ServerWriteReactor = grpc::ServerWriteReactor<ResponseType>;
+#else
+using CallbackServerContext = grpc::experimental::CallbackServerContext;
+template<typename ResponseType>
+using ServerWriteReactor = grpc::experimental::ServerWriteReactor<ResponseType>;
+#endif
+
+// What to do with responses a client does not read fast enough.
+enum class StreamPolicy {
+    // Only the latest state matters: at most one response waits to be sent
+    // and a newer one replaces it.
+    ConflateToLatest,
+    // Each response matters: up to max_queued responses wait to be sent,
+    // beyond that the oldest ones are dropped.
+    Queue,
+};
+
+// A server stream which can be finished from outside, e.g. when the server stops.
+class ServerStream {
+public:
+    virtual ~ServerStream() = default;
+
+    // Finishes the stream once everything written so far is sent.
+    virtual void finish() = 0;
+};
+
+// The writing side of a server streaming RPC using the callback API.
+//
+// Unlike a grpc::ServerWriter, write() never blocks: responses are queued
+// and sent one after the other by the completion of the previous write. The
+// stream therefore does not occupy a thread while it is open, and a slow
+// client does not stall the thread calling write().
+//
+// The queue is bounded according to the StreamPolicy, so a client which
+// can't keep up loses responses instead of growing the queue forever. The
+// responses lost that way are counted in dropped().
+//
+// This is shared between the reactor and the subscription callbacks writing
+// to it, so it outlives the RPC if needed. Writes after the RPC is done are
+// ignored.
+template<typename ResponseType> class StreamWriter : public ServerStream {
+public:
+    static constexpr std::size_t default_max_queued = 100;
+
+    StreamWriter(
+        ServerWriteReactor<ResponseType>& reactor,
+        StreamPolicy policy,
+        std::size_t max_queued,
+        std::function<void()> on_cancel) :
+        _reactor(reactor),
+        _policy(policy),
+        _on_cancel(std::move(on_cancel)),
+        _queue(max_queued_for(policy, max_queued))
+    {}
+
+    ~StreamWriter() override
+    {
+        if (_dropped > 0) {
+            LogWarn() << "Stream dropped " << _dropped << " responses for a slow client";
+        }
+    }
+
+    void write(ResponseType response)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_closed || _finish_requested) {
+                return;
+            }
+            if (_write_in_flight && _queue_size == _queue.size()) {
+                if (_dropped == 0) {
+                    LogWarn() << "Client too slow, dropping stream responses";
+                }
+                ++_dropped;
+                if (_policy == StreamPolicy::ConflateToLatest) {
+                    // Replace the pending one, it is sent once the write in flight is done.
+                    _queue[(_queue_begin + _queue_size - 1) % _queue.size()] = std::move(response);
+                    return;
+                }
+                pop_front();
+            }
+            push_back(std::move(response));
+            if (_write_in_flight) {
+                return;
+            }
+            start_next_write();
+        }
+        _reactor.StartWrite(&_in_flight);
+    }
+
+    // Sends the initial metadata, so the client knows the stream is set up
+    // before the first response. Does nothing if a response or the status is
+    // already on its way, they carry it along.
+    void send_initial_metadata()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_initial_metadata_sent || _closed || _finish_requested) {
+            return;
+        }
+        _initial_metadata_sent = true;
+        _reactor.StartSendInitialMetadata();
+    }
+
+    void finish() override { finish(grpc::Status::OK); }
+
+    // Finishes the stream with the given status once everything written so
+    // far is sent.
+    void finish(grpc::Status status)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_closed || _finish_requested) {
+                return;
+            }
+            _finish_requested = true;
+            _finish_status = std::move(status);
+            if (_write_in_flight) {
+                // The write completion finishes the stream once the queue is sent.
+                return;
+            }
+            _closed = true;
+        }
+        _reactor.Finish(_finish_status);
+    }
+
+    void on_write_done(bool ok)
+    {
+        bool start_write = false;
+        bool finish_stream = false;
+        bool notify = false;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _write_in_flight = false;
+            if (!ok) {
+                // The client is gone.
+                clear();
+                notify = !_finish_requested;
+                _finish_requested = true;
+                _closed = true;
+                finish_stream = true;
+            } else if (_queue_size > 0) {
+                start_next_write();
+                start_write = true;
+            } else if (_finish_requested) {
+                _closed = true;
+                finish_stream = true;
+            }
+        }
+
+        if (start_write) {
+            _reactor.StartWrite(&_in_flight);
+        } else if (finish_stream) {
+            _reactor.Finish(ok ? _finish_status : grpc::Status::OK);
+        }
+        if (notify && _on_cancel) {
+            _on_cancel();
+        }
+    }
+
+    // The client went away or the RPC was cancelled otherwise.
+    void on_cancel()
+    {
+        bool finish_stream = false;
+        bool notify = false;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            clear();
+            notify = !_finish_requested;
+            _finish_requested = true;
+            if (!_closed && !_write_in_flight) {
+                _closed = true;
+                finish_stream = true;
+            }
+        }
+
+        if (finish_stream) {
+            _reactor.Finish(grpc::Status::CANCELLED);
+        }
+        if (notify && _on_cancel) {
+            _on_cancel();
+        }
+    }
+
+    // Whether the stream is finished or about to be, so no more writes are taken.
+    bool finished() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _finish_requested || _closed;
+    }
+
+    // The number of responses dropped because the client was too slow.
+    uint64_t dropped() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _dropped;
+    }
+
+    StreamWriter(const StreamWriter&) = delete;
+    StreamWriter& operator=(const StreamWriter&) = delete;
+
+private:
+    static std::size_t max_queued_for(StreamPolicy policy, std::size_t max_queued)
+    {
+        if (policy == StreamPolicy::ConflateToLatest) {
+            return 1;
+        }
+        return max_queued > 0 ? max_queued : default_max_queued;
+    }
+
+    // The queue is a ring of fixed size, so queueing doesn't allocate.
+    // These need _mutex to be locked.
+    void push_back(ResponseType response)
+    {
+        _queue[(_queue_begin + _queue_size) % _queue.size()] = std::move(response);
+        ++_queue_size;
+    }
+
+    void pop_front()
+    {
+        _queue[_queue_begin] = ResponseType{};
+        _queue_begin = (_queue_begin + 1) % _queue.size();
+        --_queue_size;
+    }
+
+    void clear()
+    {
+        while (_queue_size > 0) {
+            pop_front();
+        }
+    }
+
+    void start_next_write()
+    {
+        _in_flight = std::move(_queue[_queue_begin]);
+        pop_front();
+        _write_in_flight = true;
+        _initial_metadata_sent = true;
+    }
+
+    ServerWriteReactor<ResponseType>& _reactor;
+    const StreamPolicy _policy;
+    std::function<void()> _on_cancel;
+
+    mutable std::mutex _mutex{};
+    std::vector<ResponseType> _queue;
+    std::size_t _queue_begin{0};
+    std::size_t _queue_size{0};
+    // Only touched while no write is in flight, gRPC reads it until the write is done.
+    ResponseType _in_flight{};
+    bool _write_in_flight{false};
+    bool _initial_metadata_sent{false};
+    bool _finish_requested{false};
+    bool _closed{false};
+    grpc::Status _finish_status{};
+    uint64_t _dropped{0};
+};
+
+// The reactor of a server streaming RPC, owned by gRPC and deleted once the
+// RPC is done. Responses are written through writer().
+template<typename ResponseType>
+class StreamWriteReactor final : public ServerWriteReactor<ResponseType> {
+public:
+    // on_cancel is called if the stream ends because of the client rather than
+    // because of finish(). max_queued only applies to StreamPolicy::Queue, 0
+    // uses the default.
+    explicit StreamWriteReactor(
+        StreamPolicy policy,
+        std::function<void()> on_cancel = nullptr,
+        std::size_t max_queued = 0) :
+        _writer(std::make_shared<StreamWriter<ResponseType>>(
+            *this, policy, max_queued, std::move(on_cancel)))
+    {}
+
+    ~StreamWriteReactor() override = default;
+
+    std::shared_ptr<StreamWriter<ResponseType>> writer() const { return _writer; }
+
+    void OnWriteDone(bool ok) override { _writer->on_write_done(ok); }
+
+    void OnCancel() override { _writer->on_cancel(); }
+
+    void OnDone() override { delete this; }
+
+    StreamWriteReactor(const StreamWriteReactor&) = delete;
+    StreamWriteReactor& operator=(const StreamWriteReactor&) = delete;
+
+private:
+    std::shared_ptr<StreamWriter<ResponseType>> _writer;
+};
+
+// Returns a reactor for a stream which is finished right away with the
+// given status, e.g. because the request can't be served.
+template<typename ResponseType>
+ServerWriteReactor<ResponseType>* make_finished_reactor(grpc::Status status)
+{
+    auto* reactor = new StreamWriteReactor<ResponseType>(StreamPolicy::ConflateToLatest);
+    reactor->writer()->finish(std::move(status));
+    return reactor;
+}
+
+} // namespace backend
+} // namespace mavsdk
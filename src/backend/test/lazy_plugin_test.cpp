@@ -0,0 +1,142 @@
+#include <gmock/gmock.h>
+#include <grpcpp/support/string_ref.h>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "lazy_plugin.h"
+
+namespace {
+
+class FakeSystem {
+public:
+    explicit FakeSystem(uint8_t system_id) : _system_id(system_id) {}
+
+    uint8_t get_system_id() const { return _system_id; }
+
+private:
+    uint8_t _system_id;
+};
+
+class FakeMavsdk {
+public:
+    FakeSystem& system() const { return *_systems.front(); }
+    std::vector<std::shared_ptr<FakeSystem>> systems() const { return _systems; }
+
+    void add_system(uint8_t system_id)
+    {
+        _systems.push_back(std::make_shared<FakeSystem>(system_id));
+    }
+
+private:
+    std::vector<std::shared_ptr<FakeSystem>> _systems{};
+};
+
+struct FakePlugin {
+    explicit FakePlugin(FakeSystem& system_) : system(&system_) {}
+    explicit FakePlugin(std::shared_ptr<FakeSystem> system_) : system(system_.get()) {}
+
+    FakeSystem* system;
+};
+
+class FakeContext {
+public:
+    FakeContext() = default;
+    explicit FakeContext(const char* system_id) :
+        _metadata{{mavsdk::backend::system_id_metadata_key, system_id}}
+    {}
+
+    const std::multimap<grpc::string_ref, grpc::string_ref>& client_metadata() const
+    {
+        return _metadata;
+    }
+
+private:
+    std::multimap<grpc::string_ref, grpc::string_ref> _metadata{};
+};
+
+using LazyFakePlugin = mavsdk::backend::LazyPlugin<FakePlugin, FakeMavsdk, FakeSystem>;
+
+class LazyPluginTest : public ::testing::Test {
+protected:
+    LazyPluginTest()
+    {
+        _mavsdk.add_system(1);
+        _mavsdk.add_system(2);
+    }
+
+    FakeMavsdk _mavsdk{};
+};
+
+TEST_F(LazyPluginTest, callWithoutSystemIdGoesToFirstSystem)
+{
+    LazyFakePlugin lazy_plugin(_mavsdk);
+    const FakeContext context;
+
+    auto* plugin = lazy_plugin.maybe_plugin(&context);
+    ASSERT_NE(nullptr, plugin);
+    EXPECT_EQ(1, plugin->system->get_system_id());
+    EXPECT_EQ(plugin, lazy_plugin.maybe_plugin(static_cast<const FakeContext*>(nullptr)));
+}
+
+TEST_F(LazyPluginTest, firstSystemIdUsesDefaultPlugin)
+{
+    LazyFakePlugin lazy_plugin(_mavsdk);
+    const FakeContext context;
+    const FakeContext first_context("1");
+
+    EXPECT_EQ(lazy_plugin.maybe_plugin(&context), lazy_plugin.maybe_plugin(&first_context));
+}
+
+TEST_F(LazyPluginTest, secondSystemIdGetsItsOwnPlugin)
+{
+    LazyFakePlugin lazy_plugin(_mavsdk);
+    const FakeContext context;
+    const FakeContext second_context("2");
+
+    auto* second_plugin = lazy_plugin.maybe_plugin(&second_context);
+    ASSERT_NE(nullptr, second_plugin);
+    EXPECT_EQ(2, second_plugin->system->get_system_id());
+    EXPECT_NE(lazy_plugin.maybe_plugin(&context), second_plugin);
+
+    // The plugin is only created once.
+    EXPECT_EQ(second_plugin, lazy_plugin.maybe_plugin(&second_context));
+}
+
+TEST_F(LazyPluginTest, unknownSystemIdGivesNoPlugin)
+{
+    LazyFakePlugin lazy_plugin(_mavsdk);
+    const FakeContext unknown_context("3");
+
+    EXPECT_EQ(nullptr, lazy_plugin.maybe_plugin(&unknown_context));
+
+    // Once the system is connected, calls reach it.
+    _mavsdk.add_system(3);
+    auto* plugin = lazy_plugin.maybe_plugin(&unknown_context);
+    ASSERT_NE(nullptr, plugin);
+    EXPECT_EQ(3, plugin->system->get_system_id());
+}
+
+TEST_F(LazyPluginTest, invalidSystemIdGivesNoPlugin)
+{
+    LazyFakePlugin lazy_plugin(_mavsdk);
+
+    for (const char* system_id : {"", "0", "256", "-1", "2a", "two"}) {
+        const FakeContext context(system_id);
+        EXPECT_EQ(nullptr, lazy_plugin.maybe_plugin(&context)) << "system id: " << system_id;
+    }
+}
+
+TEST_F(LazyPluginTest, givenPluginIsUsedForAllSystems)
+{
+    FakePlugin fake_plugin(_mavsdk.system());
+    LazyFakePlugin lazy_plugin(fake_plugin);
+    const FakeContext second_context("2");
+    const FakeContext unknown_context("3");
+
+    EXPECT_EQ(&fake_plugin, lazy_plugin.maybe_plugin(&second_context));
+    EXPECT_EQ(&fake_plugin, lazy_plugin.maybe_plugin(&unknown_context));
+}
+
+} // namespace
@@ -1,10 +1,15 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <future>
 #include <gmock/gmock.h>
 #include <grpc++/grpc++.h>
 #include <grpc++/server.h>
 #include <grpc++/server_builder.h>
 #include <memory>
+#include <mutex>
 #include <random>
+#include <thread>
 #include <vector>
 
 #include "telemetry/mocks/telemetry_mock.h"
@@ -13,11 +18,14 @@
 namespace {
 
 using testing::_;
+using testing::InvokeWithoutArgs;
 using testing::NiceMock;
+using testing::Return;
 
 using MockTelemetry = NiceMock<mavsdk::testing::MockTelemetry>;
 using TelemetryServiceImpl = mavsdk::backend::TelemetryServiceImpl<MockTelemetry>;
 using TelemetryService = mavsdk::rpc::telemetry::TelemetryService;
+using SubscriptionHandle = mavsdk::TelemetryExtended::SubscriptionHandle;
 
 using PositionResponse = mavsdk::rpc::telemetry::PositionResponse;
 using Position = mavsdk::Telemetry::Position;
@@ -68,7 +76,9 @@ protected:
 
     virtual void TearDown() { _server->Shutdown(); }
 
-    std::future<void> subscribePositionAsync(std::vector<Position>& positions);
+    // If given, attached_promise is set once the server has attached the client.
+    std::future<void> subscribePositionAsync(
+        std::vector<Position>& positions, std::promise<void>* attached_promise = nullptr);
     Position createPosition(
         const double lat, const double lng, const float abs_alt, const float rel_alt) const;
     void checkSendsPositions(const std::vector<Position>& positions);
@@ -150,6 +160,13 @@ protected:
     std::future<void> subscribeActuatorOutputStatusAsync(
         std::vector<ActuatorOutputStatus>& actuator_output_status_events) const;
 
+    // Called by the client streams for each response they read.
+    void notifyReceived() const;
+    // Waits up to a second until the clients read num_received responses in total.
+    // Conflated streams only send the latest update to a client which is behind,
+    // so tests sending several updates wait for each one to arrive.
+    void waitForReceived(size_t num_received) const;
+
     std::unique_ptr<grpc::Server> _server{};
     std::unique_ptr<TelemetryService::Stub> _stub{};
     std::unique_ptr<MockTelemetry> _telemetry{};
@@ -158,6 +175,10 @@ protected:
 private:
     void initRandomGenerator();
 
+    mutable std::mutex _received_mutex{};
+    mutable std::condition_variable _received_cv{};
+    mutable size_t _num_received{0};
+
     std::random_device _random_device{};
     std::mt19937 _generator{};
     std::uniform_int_distribution<> _uniform_int_distribution{};
@@ -169,15 +190,31 @@ void TelemetryServiceImplTest::initRandomGenerator()
     _uniform_int_distribution = std::uniform_int_distribution<>(0, 1);
 }
 
+void TelemetryServiceImplTest::notifyReceived() const
+{
+    std::lock_guard<std::mutex> lock(_received_mutex);
+    ++_num_received;
+    _received_cv.notify_all();
+}
+
+void TelemetryServiceImplTest::waitForReceived(const size_t num_received) const
+{
+    std::unique_lock<std::mutex> lock(_received_mutex);
+    _received_cv.wait_for(lock, std::chrono::seconds(1), [this, num_received]() {
+        return _num_received >= num_received;
+    });
+}
+
 ACTION_P2(SaveCallback, callback, callback_promise)
 {
     *callback = arg0;
     callback_promise->set_value();
+    return SubscriptionHandle{1};
 }
 
 TEST_F(TelemetryServiceImplTest, registersToTelemetryPositionAsync)
 {
-    EXPECT_CALL(*_telemetry, subscribe_position(_)).Times(1);
+    EXPECT_CALL(*_telemetry, subscribe_position(_, _)).Times(1);
 
     std::vector<Position> positions;
     auto position_stream_future = subscribePositionAsync(positions);
@@ -186,13 +223,20 @@ TEST_F(TelemetryServiceImplTest, registersToTelemetryPositionAsync)
     position_stream_future.wait();
 }
 
-std::future<void> TelemetryServiceImplTest::subscribePositionAsync(std::vector<Position>& positions)
+std::future<void> TelemetryServiceImplTest::subscribePositionAsync(
+    std::vector<Position>& positions, std::promise<void>* attached_promise)
 {
-    return std::async(std::launch::async, [&]() {
+    return std::async(std::launch::async, [&, attached_promise]() {
         grpc::ClientContext context;
         mavsdk::rpc::telemetry::SubscribePositionRequest request;
         auto response_reader = _stub->SubscribePosition(&context, request);
 
+        if (attached_promise != nullptr) {
+            // The server sends the initial metadata once the client is attached.
+            response_reader->WaitForInitialMetadata();
+            attached_promise->set_value();
+        }
+
         mavsdk::rpc::telemetry::PositionResponse response;
         while (response_reader->Read(&response)) {
             auto position_rpc = response.position();
@@ -204,6 +248,7 @@ std::future<void> TelemetryServiceImplTest::subscribePositionAsync(std::vector<P
             position.relative_altitude_m = position_rpc.relative_altitude_m();
 
             positions.push_back(position);
+            notifyReceived();
         }
 
         response_reader->Finish();
@@ -234,14 +279,16 @@ void TelemetryServiceImplTest::checkSendsPositions(const std::vector<Position>&
     std::promise<void> subscription_promise;
     auto subscription_future = subscription_promise.get_future();
     mavsdk::Telemetry::PositionCallback position_callback;
-    EXPECT_CALL(*_telemetry, subscribe_position(_))
+    EXPECT_CALL(*_telemetry, subscribe_position(_, _))
         .WillOnce(SaveCallback(&position_callback, &subscription_promise));
 
     std::vector<Position> received_positions;
     auto position_stream_future = subscribePositionAsync(received_positions);
     subscription_future.wait();
+    size_t num_sent = 0;
     for (const auto position : positions) {
         position_callback(position);
+        waitForReceived(++num_sent);
     }
     _telemetry_service->stop();
     position_stream_future.wait();
@@ -275,9 +322,79 @@ TEST_F(TelemetryServiceImplTest, sendsMultiplePositions)
     checkSendsPositions(positions);
 }
 
+TEST_F(TelemetryServiceImplTest, sharesPositionSubscriptionBetweenClients)
+{
+    std::vector<Position> positions;
+    positions.push_back(createPosition(41.848695, 75.132751, 3002.1f, 50.3f));
+    positions.push_back(createPosition(46.522626, 6.635356, 542.2f, 79.8f));
+
+    std::promise<void> subscription_promise;
+    auto subscription_future = subscription_promise.get_future();
+    mavsdk::Telemetry::PositionCallback position_callback;
+    EXPECT_CALL(*_telemetry, subscribe_position(_, _))
+        .WillOnce(SaveCallback(&position_callback, &subscription_promise));
+
+    std::vector<Position> received_positions;
+    auto position_stream_future = subscribePositionAsync(received_positions);
+    subscription_future.wait();
+
+    std::promise<void> other_attached_promise;
+    auto other_attached_future = other_attached_promise.get_future();
+    std::vector<Position> other_received_positions;
+    auto other_position_stream_future =
+        subscribePositionAsync(other_received_positions, &other_attached_promise);
+    other_attached_future.wait();
+
+    size_t num_sent = 0;
+    for (const auto position : positions) {
+        position_callback(position);
+        // Both clients read it.
+        num_sent += 2;
+        waitForReceived(num_sent);
+    }
+    _telemetry_service->stop();
+    position_stream_future.wait();
+    other_position_stream_future.wait();
+
+    EXPECT_EQ(positions, received_positions);
+    EXPECT_EQ(positions, other_received_positions);
+}
+
+TEST_F(TelemetryServiceImplTest, unsubscribesPositionWhenLastClientIsGone)
+{
+    const SubscriptionHandle handle{42};
+    EXPECT_CALL(*_telemetry, subscribe_position(_, _)).WillOnce(Return(handle));
+
+    std::atomic<bool> all_cancelled{false};
+    std::promise<void> unsubscribe_promise;
+    auto unsubscribe_future = unsubscribe_promise.get_future();
+    EXPECT_CALL(*_telemetry, unsubscribe_position(handle))
+        .WillOnce(InvokeWithoutArgs([&all_cancelled, &unsubscribe_promise]() {
+            EXPECT_TRUE(all_cancelled);
+            unsubscribe_promise.set_value();
+        }));
+
+    mavsdk::rpc::telemetry::SubscribePositionRequest request;
+    grpc::ClientContext context;
+    auto response_reader = _stub->SubscribePosition(&context, request);
+    response_reader->WaitForInitialMetadata();
+    grpc::ClientContext other_context;
+    auto other_response_reader = _stub->SubscribePosition(&other_context, request);
+    other_response_reader->WaitForInitialMetadata();
+
+    context.TryCancel();
+    response_reader->Finish();
+
+    all_cancelled = true;
+    other_context.TryCancel();
+    other_response_reader->Finish();
+
+    EXPECT_EQ(std::future_status::ready, unsubscribe_future.wait_for(std::chrono::seconds(1)));
+}
+
 TEST_F(TelemetryServiceImplTest, registersToTelemetryHealthAsync)
 {
-    EXPECT_CALL(*_telemetry, subscribe_health(_)).Times(1);
+    EXPECT_CALL(*_telemetry, subscribe_health(_, _)).Times(1);
 
     std::vector<Health> healths;
     auto health_stream_future = subscribeHealthAsync(healths);
@@ -307,6 +424,7 @@ std::future<void> TelemetryServiceImplTest::subscribeHealthAsync(std::vector<Hea
             health.is_home_position_ok = health_rpc.is_home_position_ok();
 
             healths.push_back(health);
+            notifyReceived();
         }
 
         response_reader->Finish();
@@ -345,14 +463,16 @@ void TelemetryServiceImplTest::checkSendsHealths(const std::vector<Health>& heal
     std::promise<void> subscription_promise;
     auto subscription_future = subscription_promise.get_future();
     mavsdk::Telemetry::HealthCallback health_callback;
-    EXPECT_CALL(*_telemetry, subscribe_health(_))
+    EXPECT_CALL(*_telemetry, subscribe_health(_, _))
         .WillOnce(SaveCallback(&health_callback, &subscription_promise));
 
     std::vector<Health> received_healths;
     auto health_stream_future = subscribeHealthAsync(received_healths);
     subscription_future.wait();
+    size_t num_sent = 0;
     for (const auto health : healths) {
         health_callback(health);
+        waitForReceived(++num_sent);
     }
     _telemetry_service->stop();
     health_stream_future.wait();
@@ -391,7 +511,7 @@ TEST_F(TelemetryServiceImplTest, sendsMultipleHealths)
 
 TEST_F(TelemetryServiceImplTest, registersToTelemetryHomeAsync)
 {
-    EXPECT_CALL(*_telemetry, subscribe_home(_)).Times(1);
+    EXPECT_CALL(*_telemetry, subscribe_home(_, _)).Times(1);
 
     std::vector<Position> home_positions;
     auto home_stream_future = subscribeHomeAsync(home_positions);
@@ -419,6 +539,7 @@ TelemetryServiceImplTest::subscribeHomeAsync(std::vector<Position>& home_positio
             home.relative_altitude_m = home_rpc.relative_altitude_m();
 
             home_positions.push_back(home);
+            notifyReceived();
         }
 
         response_reader->Finish();
@@ -450,14 +571,16 @@ void TelemetryServiceImplTest::checkSendsHomePositions(
     std::promise<void> subscription_promise;
     auto subscription_future = subscription_promise.get_future();
     mavsdk::Telemetry::PositionCallback home_callback;
-    EXPECT_CALL(*_telemetry, subscribe_home(_))
+    EXPECT_CALL(*_telemetry, subscribe_home(_, _))
         .WillOnce(SaveCallback(&home_callback, &subscription_promise));
 
     std::vector<Position> received_home_positions;
     auto home_stream_future = subscribeHomeAsync(received_home_positions);
     subscription_future.wait();
+    size_t num_sent = 0;
     for (const auto home_position : home_positions) {
         home_callback(home_position);
+        waitForReceived(++num_sent);
     }
     _telemetry_service->stop();
     home_stream_future.wait();
@@ -481,7 +604,7 @@ TEST_F(TelemetryServiceImplTest, sendsMultipleHomePositions)
 
 TEST_F(TelemetryServiceImplTest, registersToTelemetryInAirAsync)
 {
-    EXPECT_CALL(*_telemetry, subscribe_in_air(_)).Times(1);
+    EXPECT_CALL(*_telemetry, subscribe_in_air(_, _)).Times(1);
 
     std::vector<bool> in_air_events;
     auto in_air_stream_future = subscribeInAirAsync(in_air_events);
@@ -502,6 +625,7 @@ TelemetryServiceImplTest::subscribeInAirAsync(std::vector<bool>& in_air_events)
         while (response_reader->Read(&response)) {
             auto is_in_air = response.is_in_air();
             in_air_events.push_back(is_in_air);
+            notifyReceived();
         }
 
         response_reader->Finish();
@@ -532,14 +656,16 @@ void TelemetryServiceImplTest::checkSendsInAirEvents(const std::vector<bool>& in
     std::promise<void> subscription_promise;
     auto subscription_future = subscription_promise.get_future();
     mavsdk::Telemetry::InAirCallback in_air_callback;
-    EXPECT_CALL(*_telemetry, subscribe_in_air(_))
+    EXPECT_CALL(*_telemetry, subscribe_in_air(_, _))
         .WillOnce(SaveCallback(&in_air_callback, &subscription_promise));
 
     std::vector<bool> received_in_air_events;
     auto in_air_stream_future = subscribeInAirAsync(received_in_air_events);
     subscription_future.wait();
+    size_t num_sent = 0;
     for (const auto is_in_air : in_air_events) {
         in_air_callback(is_in_air);
+        waitForReceived(++num_sent);
     }
     _telemetry_service->stop();
     in_air_stream_future.wait();
@@ -563,7 +689,7 @@ TEST_F(TelemetryServiceImplTest, sendsMultipleInAirEvents)
 
 TEST_F(TelemetryServiceImplTest, registersToTelemetryArmedAsync)
 {
-    EXPECT_CALL(*_telemetry, subscribe_armed(_)).Times(1);
+    EXPECT_CALL(*_telemetry, subscribe_armed(_, _)).Times(1);
 
     std::vector<bool> armed_events;
     auto armed_stream_future = subscribeArmedAsync(armed_events);
@@ -584,6 +710,7 @@ TelemetryServiceImplTest::subscribeArmedAsync(std::vector<bool>& armed_events) c
         while (response_reader->Read(&response)) {
             auto is_armed = response.is_armed();
             armed_events.push_back(is_armed);
+            notifyReceived();
         }
 
         response_reader->Finish();
@@ -614,14 +741,16 @@ void TelemetryServiceImplTest::checkSendsArmedEvents(const std::vector<bool>& ar
     std::promise<void> subscription_promise;
     auto subscription_future = subscription_promise.get_future();
     mavsdk::Telemetry::ArmedCallback armed_callback;
-    EXPECT_CALL(*_telemetry, subscribe_armed(_))
+    EXPECT_CALL(*_telemetry, subscribe_armed(_, _))
         .WillOnce(SaveCallback(&armed_callback, &subscription_promise));
 
     std::vector<bool> received_armed_events;
     auto armed_stream_future = subscribeArmedAsync(received_armed_events);
     subscription_future.wait();
+    size_t num_sent = 0;
     for (const auto is_armed : armed_events) {
         armed_callback(is_armed);
+        waitForReceived(++num_sent);
     }
     _telemetry_service->stop();
     armed_stream_future.wait();
@@ -645,7 +774,7 @@ TEST_F(TelemetryServiceImplTest, sendsMultipleArmedEvents)
 
 TEST_F(TelemetryServiceImplTest, registersToTelemetryGpsInfoAsync)
 {
-    EXPECT_CALL(*_telemetry, subscribe_gps_info(_)).Times(1);
+    EXPECT_CALL(*_telemetry, subscribe_gps_info(_, _)).Times(1);
 
     std::vector<GpsInfo> gps_info_events;
     auto gps_info_stream_future = subscribeGpsInfoAsync(gps_info_events);
@@ -671,6 +800,7 @@ TelemetryServiceImplTest::subscribeGpsInfoAsync(std::vector<GpsInfo>& gps_info_e
             gps_info.fix_type = translateRPCGpsFixType(gps_info_rpc.fix_type());
 
             gps_info_events.push_back(gps_info);
+            notifyReceived();
         }
 
         response_reader->Finish();
@@ -724,14 +854,16 @@ void TelemetryServiceImplTest::checkSendsGpsInfoEvents(
     std::promise<void> subscription_promise;
     auto subscription_future = subscription_promise.get_future();
     mavsdk::Telemetry::GpsInfoCallback gps_info_callback;
-    EXPECT_CALL(*_telemetry, subscribe_gps_info(_))
+    EXPECT_CALL(*_telemetry, subscribe_gps_info(_, _))
         .WillOnce(SaveCallback(&gps_info_callback, &subscription_promise));
 
     std::vector<GpsInfo> received_gps_info_events;
     auto gps_info_stream_future = subscribeGpsInfoAsync(received_gps_info_events);
     subscription_future.wait();
+    size_t num_sent = 0;
     for (const auto gps_info : gps_info_events) {
         gps_info_callback(gps_info);
+        waitForReceived(++num_sent);
     }
     _telemetry_service->stop();
     gps_info_stream_future.wait();
@@ -769,7 +901,7 @@ TEST_F(TelemetryServiceImplTest, sendsMultipleGpsInfoEvents)
 
 TEST_F(TelemetryServiceImplTest, registersToTelemetryBatteryAsync)
 {
-    EXPECT_CALL(*_telemetry, subscribe_battery(_)).Times(1);
+    EXPECT_CALL(*_telemetry, subscribe_battery(_, _)).Times(1);
 
     std::vector<Battery> battery_events;
     auto battery_stream_future = subscribeBatteryAsync(battery_events);
@@ -795,6 +927,7 @@ TelemetryServiceImplTest::subscribeBatteryAsync(std::vector<Battery>& battery_ev
             battery.remaining_percent = battery_rpc.remaining_percent();
 
             battery_events.push_back(battery);
+            notifyReceived();
         }
 
         response_reader->Finish();
@@ -836,14 +969,16 @@ void TelemetryServiceImplTest::checkSendsBatteryEvents(
     std::promise<void> subscription_promise;
     auto subscription_future = subscription_promise.get_future();
     mavsdk::Telemetry::BatteryCallback battery_callback;
-    EXPECT_CALL(*_telemetry, subscribe_battery(_))
+    EXPECT_CALL(*_telemetry, subscribe_battery(_, _))
         .WillOnce(SaveCallback(&battery_callback, &subscription_promise));
 
     std::vector<Battery> received_battery_events;
     auto battery_stream_future = subscribeBatteryAsync(received_battery_events);
     subscription_future.wait();
+    size_t num_sent = 0;
     for (const auto battery : battery_events) {
         battery_callback(battery);
+        waitForReceived(++num_sent);
     }
     _telemetry_service->stop();
     battery_stream_future.wait();
@@ -868,7 +1003,7 @@ TEST_F(TelemetryServiceImplTest, sendsMultipleBatteryEvents)
 
 TEST_F(TelemetryServiceImplTest, registersToTelemetryFlightModeAsync)
 {
-    EXPECT_CALL(*_telemetry, subscribe_flight_mode(_)).Times(1);
+    EXPECT_CALL(*_telemetry, subscribe_flight_mode(_, _)).Times(1);
 
     std::vector<FlightMode> flight_mode_events;
     auto flight_mode_stream_future = subscribeFlightModeAsync(flight_mode_events);
@@ -889,6 +1024,7 @@ std::future<void> TelemetryServiceImplTest::subscribeFlightModeAsync(
         while (response_reader->Read(&response)) {
             FlightMode flight_mode = translateRPCFlightMode(response.flight_mode());
             flight_mode_events.push_back(flight_mode);
+            notifyReceived();
         }
 
         response_reader->Finish();
@@ -946,14 +1082,16 @@ void TelemetryServiceImplTest::checkSendsFlightModeEvents(
     std::promise<void> subscription_promise;
     auto subscription_future = subscription_promise.get_future();
     mavsdk::Telemetry::FlightModeCallback flight_mode_callback;
-    EXPECT_CALL(*_telemetry, subscribe_flight_mode(_))
+    EXPECT_CALL(*_telemetry, subscribe_flight_mode(_, _))
         .WillOnce(SaveCallback(&flight_mode_callback, &subscription_promise));
 
     std::vector<FlightMode> received_flight_mode_events;
     auto flight_mode_stream_future = subscribeFlightModeAsync(received_flight_mode_events);
     subscription_future.wait();
+    size_t num_sent = 0;
     for (const auto flight_mode : flight_mode_events) {
         flight_mode_callback(flight_mode);
+        waitForReceived(++num_sent);
     }
     _telemetry_service->stop();
     flight_mode_stream_future.wait();
@@ -982,7 +1120,7 @@ TEST_F(TelemetryServiceImplTest, sendsMultipleFlightModeEvents)
 
 TEST_F(TelemetryServiceImplTest, registersToTelemetryAttitudeQuaternionAsync)
 {
-    EXPECT_CALL(*_telemetry, subscribe_attitude_quaternion(_)).Times(1);
+    EXPECT_CALL(*_telemetry, subscribe_attitude_quaternion(_, _)).Times(1);
 
     std::vector<Quaternion> quaternions;
     auto quaternion_stream_future = subscribeAttitudeQuaternionAsync(quaternions);
@@ -993,7 +1131,7 @@ TEST_F(TelemetryServiceImplTest, registersToTelemetryAttitudeQuaternionAsync)
 
 TEST_F(TelemetryServiceImplTest, registersToTelemetryAttitudeAngularVelocityBodyAsync)
 {
-    EXPECT_CALL(*_telemetry, subscribe_attitude_angular_velocity_body(_)).Times(1);
+    EXPECT_CALL(*_telemetry, subscribe_attitude_angular_velocity_body(_, _)).Times(1);
 
     std::vector<AngularVelocityBody> angular_velocities_body;
     auto angular_velocity_body_stream_future =
@@ -1022,6 +1160,7 @@ std::future<void> TelemetryServiceImplTest::subscribeAttitudeQuaternionAsync(
             quaternion.z = quaternion_rpc.z();
 
             quaternions.push_back(quaternion);
+            notifyReceived();
         }
 
         response_reader->Finish();
@@ -1057,6 +1196,7 @@ std::future<void> TelemetryServiceImplTest::subscribeAttitudeAngularVelocityBody
             angular_velocity_body.yaw_rad_s = angular_velocity_body_rpc.yaw_rad_s();
 
             angular_velocities_body.push_back(angular_velocity_body);
+            notifyReceived();
         }
 
         response_reader->Finish();
@@ -1122,14 +1262,16 @@ void TelemetryServiceImplTest::checkSendsAttitudeQuaternions(
     std::promise<void> subscription_promise;
     auto subscription_future = subscription_promise.get_future();
     mavsdk::Telemetry::AttitudeQuaternionCallback attitude_quaternion_callback;
-    EXPECT_CALL(*_telemetry, subscribe_attitude_quaternion(_))
+    EXPECT_CALL(*_telemetry, subscribe_attitude_quaternion(_, _))
         .WillOnce(SaveCallback(&attitude_quaternion_callback, &subscription_promise));
 
     std::vector<Quaternion> received_quaternions;
     auto quaternion_stream_future = subscribeAttitudeQuaternionAsync(received_quaternions);
     subscription_future.wait();
+    size_t num_sent = 0;
     for (const auto quaternion : quaternions) {
         attitude_quaternion_callback(quaternion);
+        waitForReceived(++num_sent);
     }
     _telemetry_service->stop();
     quaternion_stream_future.wait();
@@ -1146,15 +1288,17 @@ void TelemetryServiceImplTest::checkSendsAttitudeAngularVelocitiesBody(
     std::promise<void> subscription_promise;
     auto subscription_future = subscription_promise.get_future();
     mavsdk::Telemetry::AttitudeAngularVelocityBodyCallback attitude_angular_velocity_body_callback;
-    EXPECT_CALL(*_telemetry, subscribe_attitude_angular_velocity_body(_))
+    EXPECT_CALL(*_telemetry, subscribe_attitude_angular_velocity_body(_, _))
         .WillOnce(SaveCallback(&attitude_angular_velocity_body_callback, &subscription_promise));
 
     std::vector<AngularVelocityBody> received_angular_velocities_body;
     auto angular_velocity_body_stream_future =
         subscribeAttitudeAngularVelocityBodyAsync(received_angular_velocities_body);
     subscription_future.wait();
+    size_t num_sent = 0;
     for (const auto angular_velocity_body : angular_velocities_body) {
         attitude_angular_velocity_body_callback(angular_velocity_body);
+        waitForReceived(++num_sent);
     }
     _telemetry_service->stop();
     angular_velocity_body_stream_future.wait();
@@ -1187,7 +1331,7 @@ TEST_F(TelemetryServiceImplTest, sendsMultipleAttitudeAngularVelocityBodys)
 
 TEST_F(TelemetryServiceImplTest, registersToTelemetryAttitudeEulerAsync)
 {
-    EXPECT_CALL(*_telemetry, subscribe_attitude_euler(_)).Times(1);
+    EXPECT_CALL(*_telemetry, subscribe_attitude_euler(_, _)).Times(1);
 
     std::vector<EulerAngle> euler_angles;
     auto euler_angle_stream_future = subscribeAttitudeEulerAsync(euler_angles);
@@ -1214,6 +1358,7 @@ TelemetryServiceImplTest::subscribeAttitudeEulerAsync(std::vector<EulerAngle>& e
             euler_angle.yaw_deg = euler_angle_rpc.yaw_deg();
 
             euler_angles.push_back(euler_angle);
+            notifyReceived();
         }
 
         response_reader->Finish();
@@ -1256,14 +1401,16 @@ void TelemetryServiceImplTest::checkSendsAttitudeEulerAngles(
     std::promise<void> subscription_promise;
     auto subscription_future = subscription_promise.get_future();
     mavsdk::Telemetry::AttitudeEulerCallback attitude_euler_angle_callback;
-    EXPECT_CALL(*_telemetry, subscribe_attitude_euler(_))
+    EXPECT_CALL(*_telemetry, subscribe_attitude_euler(_, _))
         .WillOnce(SaveCallback(&attitude_euler_angle_callback, &subscription_promise));
 
     std::vector<EulerAngle> received_euler_angles;
     auto euler_angle_stream_future = subscribeAttitudeEulerAsync(received_euler_angles);
     subscription_future.wait();
+    size_t num_sent = 0;
     for (const auto euler_angle : euler_angles) {
         attitude_euler_angle_callback(euler_angle);
+        waitForReceived(++num_sent);
     }
     _telemetry_service->stop();
     euler_angle_stream_future.wait();
@@ -1286,7 +1433,7 @@ TEST_F(TelemetryServiceImplTest, sendsMultipleAttitudeEuler)
 
 TEST_F(TelemetryServiceImplTest, registersToTelemetryCameraAttitudeQuaternionAsync)
 {
-    EXPECT_CALL(*_telemetry, subscribe_camera_attitude_quaternion(_)).Times(1);
+    EXPECT_CALL(*_telemetry, subscribe_camera_attitude_quaternion(_, _)).Times(1);
 
     std::vector<Quaternion> quaternions;
     auto quaternion_stream_future = subscribeCameraAttitudeQuaternionAsync(quaternions);
@@ -1314,6 +1461,7 @@ std::future<void> TelemetryServiceImplTest::subscribeCameraAttitudeQuaternionAsy
             quaternion.z = quaternion_rpc.z();
 
             quaternions.push_back(quaternion);
+            notifyReceived();
         }
 
         response_reader->Finish();
@@ -1345,14 +1493,16 @@ void TelemetryServiceImplTest::checkSendsCameraAttitudeQuaternions(
     std::promise<void> subscription_promise;
     auto subscription_future = subscription_promise.get_future();
     mavsdk::Telemetry::AttitudeQuaternionCallback attitude_quaternion_callback;
-    EXPECT_CALL(*_telemetry, subscribe_camera_attitude_quaternion(_))
+    EXPECT_CALL(*_telemetry, subscribe_camera_attitude_quaternion(_, _))
         .WillOnce(SaveCallback(&attitude_quaternion_callback, &subscription_promise));
 
     std::vector<Quaternion> received_quaternions;
     auto quaternion_stream_future = subscribeCameraAttitudeQuaternionAsync(received_quaternions);
     subscription_future.wait();
+    size_t num_sent = 0;
     for (const auto quaternion : quaternions) {
         attitude_quaternion_callback(quaternion);
+        waitForReceived(++num_sent);
     }
     _telemetry_service->stop();
     quaternion_stream_future.wait();
@@ -1375,7 +1525,7 @@ TEST_F(TelemetryServiceImplTest, sendsMultipleCameraAttitudeQuaternions)
 
 TEST_F(TelemetryServiceImplTest, registersToTelemetryCameraAttitudeEulerAsync)
 {
-    EXPECT_CALL(*_telemetry, subscribe_camera_attitude_euler(_)).Times(1);
+    EXPECT_CALL(*_telemetry, subscribe_camera_attitude_euler(_, _)).Times(1);
 
     std::vector<EulerAngle> euler_angles;
     auto euler_angle_stream_future = subscribeCameraAttitudeEulerAsync(euler_angles);
@@ -1402,6 +1552,7 @@ std::future<void> TelemetryServiceImplTest::subscribeCameraAttitudeEulerAsync(
             euler_angle.yaw_deg = euler_angle_rpc.yaw_deg();
 
             euler_angles.push_back(euler_angle);
+            notifyReceived();
         }
 
         response_reader->Finish();
@@ -1433,14 +1584,16 @@ void TelemetryServiceImplTest::checkSendsCameraAttitudeEulerAngles(
     std::promise<void> subscription_promise;
     auto subscription_future = subscription_promise.get_future();
     mavsdk::Telemetry::AttitudeEulerCallback attitude_euler_angle_callback;
-    EXPECT_CALL(*_telemetry, subscribe_camera_attitude_euler(_))
+    EXPECT_CALL(*_telemetry, subscribe_camera_attitude_euler(_, _))
         .WillOnce(SaveCallback(&attitude_euler_angle_callback, &subscription_promise));
 
     std::vector<EulerAngle> received_euler_angles;
     auto euler_angle_stream_future = subscribeCameraAttitudeEulerAsync(received_euler_angles);
     subscription_future.wait();
+    size_t num_sent = 0;
     for (const auto euler_angle : euler_angles) {
         attitude_euler_angle_callback(euler_angle);
+        waitForReceived(++num_sent);
     }
     _telemetry_service->stop();
     euler_angle_stream_future.wait();
@@ -1463,7 +1616,7 @@ TEST_F(TelemetryServiceImplTest, sendsMultipleCameraAttitudeEuler)
 
 TEST_F(TelemetryServiceImplTest, registersToTelemetryVelocityNedAsync)
 {
-    EXPECT_CALL(*_telemetry, subscribe_velocity_ned(_)).Times(1);
+    EXPECT_CALL(*_telemetry, subscribe_velocity_ned(_, _)).Times(1);
 
     std::vector<VelocityNed> velocity_events;
     auto velocity_stream_future = subscribeVelocityNedAsync(velocity_events);
@@ -1490,6 +1643,7 @@ TelemetryServiceImplTest::subscribeVelocityNedAsync(std::vector<VelocityNed>& ve
             velocity.down_m_s = velocity_rpc.down_m_s();
 
             velocity_events.push_back(velocity);
+            notifyReceived();
         }
 
         response_reader->Finish();
@@ -1533,14 +1687,16 @@ void TelemetryServiceImplTest::checkSendsVelocityEvents(
     std::promise<void> subscription_promise;
     auto subscription_future = subscription_promise.get_future();
     mavsdk::Telemetry::VelocityNedCallback velocity_ned_callback;
-    EXPECT_CALL(*_telemetry, subscribe_velocity_ned(_))
+    EXPECT_CALL(*_telemetry, subscribe_velocity_ned(_, _))
         .WillOnce(SaveCallback(&velocity_ned_callback, &subscription_promise));
 
     std::vector<VelocityNed> received_velocity_events;
     auto velocity_stream_future = subscribeVelocityNedAsync(received_velocity_events);
     subscription_future.wait();
+    size_t num_sent = 0;
     for (const auto velocity : velocity_events) {
         velocity_ned_callback(velocity);
+        waitForReceived(++num_sent);
     }
     _telemetry_service->stop();
     velocity_stream_future.wait();
@@ -1563,7 +1719,7 @@ TEST_F(TelemetryServiceImplTest, sendsMultipleVelocityEvents)
 
 TEST_F(TelemetryServiceImplTest, registersToTelemetryRcStatusAsync)
 {
-    EXPECT_CALL(*_telemetry, subscribe_rc_status(_)).Times(1);
+    EXPECT_CALL(*_telemetry, subscribe_rc_status(_, _)).Times(1);
 
     std::vector<RcStatus> rc_status_events;
     auto rc_status_stream_future = subscribeRcStatusAsync(rc_status_events);
@@ -1590,6 +1746,7 @@ TelemetryServiceImplTest::subscribeRcStatusAsync(std::vector<RcStatus>& rc_statu
             rc_status.signal_strength_percent = rc_status_rpc.signal_strength_percent();
 
             rc_status_events.push_back(rc_status);
+            notifyReceived();
         }
 
         response_reader->Finish();
@@ -1635,14 +1792,16 @@ void TelemetryServiceImplTest::checkSendsRcStatusEvents(
     std::promise<void> subscription_promise;
     auto subscription_future = subscription_promise.get_future();
     mavsdk::Telemetry::RcStatusCallback rc_status_callback;
-    EXPECT_CALL(*_telemetry, subscribe_rc_status(_))
+    EXPECT_CALL(*_telemetry, subscribe_rc_status(_, _))
         .WillOnce(SaveCallback(&rc_status_callback, &subscription_promise));
 
     std::vector<RcStatus> received_rc_status_events;
     auto rc_status_stream_future = subscribeRcStatusAsync(received_rc_status_events);
     subscription_future.wait();
+    size_t num_sent = 0;
     for (const auto rc_status : rc_status_events) {
         rc_status_callback(rc_status);
+        waitForReceived(++num_sent);
     }
     _telemetry_service->stop();
     rc_status_stream_future.wait();
@@ -1673,6 +1832,7 @@ std::future<void> TelemetryServiceImplTest::subscribeActuatorControlTargetAsync(
             }
 
             actuator_control_target_events.push_back(actuator_control_target);
+            notifyReceived();
         }
 
         response_reader->Finish();
@@ -1699,6 +1859,7 @@ std::future<void> TelemetryServiceImplTest::subscribeActuatorOutputStatusAsync(
             }
 
             actuator_output_status_events.push_back(actuator_output_status);
+            notifyReceived();
         }
 
         response_reader->Finish();
@@ -1747,7 +1908,7 @@ void TelemetryServiceImplTest::checkSendsActuatorControlTargetEvents(
     std::promise<void> subscription_promise;
     auto subscription_future = subscription_promise.get_future();
     mavsdk::Telemetry::ActuatorControlTargetCallback actuator_control_target_callback;
-    EXPECT_CALL(*_telemetry, subscribe_actuator_control_target(_))
+    EXPECT_CALL(*_telemetry, subscribe_actuator_control_target(_, _))
         .WillOnce(SaveCallback(&actuator_control_target_callback, &subscription_promise));
 
     std::vector<ActuatorControlTarget> received_actuator_control_target_events;
@@ -1755,8 +1916,10 @@ void TelemetryServiceImplTest::checkSendsActuatorControlTargetEvents(
         subscribeActuatorControlTargetAsync(received_actuator_control_target_events);
     subscription_future.wait();
 
+    size_t num_sent = 0;
     for (const auto actuator_control_target : actuator_control_target_events) {
         actuator_control_target_callback(actuator_control_target);
+        waitForReceived(++num_sent);
     }
     _telemetry_service->stop();
     actuator_control_target_stream_future.wait();
@@ -1775,7 +1938,7 @@ void TelemetryServiceImplTest::checkSendsActuatorOutputStatusEvents(
     std::promise<void> subscription_promise;
     auto subscription_future = subscription_promise.get_future();
     mavsdk::Telemetry::ActuatorOutputStatusCallback actuator_output_status_callback;
-    EXPECT_CALL(*_telemetry, subscribe_actuator_output_status(_))
+    EXPECT_CALL(*_telemetry, subscribe_actuator_output_status(_, _))
         .WillOnce(SaveCallback(&actuator_output_status_callback, &subscription_promise));
 
     std::vector<ActuatorOutputStatus> received_actuator_output_status_events;
@@ -0,0 +1,230 @@
+// Measures the heap allocations and the time it takes to turn telemetry
+// updates into serialized stream responses, once with a fresh message per
+// update and once with a reused message filled in place, as the telemetry
+// service does. Then the same is measured for publishing the updates to
+// several clients through a StreamHub.
+//
+// Usage: telemetry_stream_benchmark
+//
+// Allocations through operator new, which covers protobuf and the standard
+// library, and through gpr_malloc, which gRPC uses, are counted separately.
+// Serializing into a grpc::ByteBuffer still allocates with gpr_malloc for
+// every message: the byte buffer, and the slice unless the message is small
+// enough to be inlined. Publishing cannot avoid these, as every message needs
+// its own buffer which the clients hold on to until it is written.
+
+#include "stream_hub.h"
+#include "stream_write_reactor.h"
+#include "telemetry/telemetry_service_impl.h"
+#include <grpc/support/alloc.h>
+#include <grpcpp/impl/codegen/proto_utils.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace {
+
+std::atomic<uint64_t> num_allocations{0};
+std::atomic<uint64_t> num_gpr_allocations{0};
+
+void* gpr_malloc_counted(std::size_t size)
+{
+    num_gpr_allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size);
+}
+
+void* gpr_zalloc_counted(std::size_t size)
+{
+    num_gpr_allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::calloc(1, size);
+}
+
+void* gpr_realloc_counted(void* ptr, std::size_t size)
+{
+    num_gpr_allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::realloc(ptr, size);
+}
+
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    num_allocations.fetch_add(1, std::memory_order_relaxed);
+    void* ptr = std::malloc(size > 0 ? size : 1);
+    if (ptr == nullptr) {
+        std::abort();
+    }
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /* size */) noexcept
+{
+    std::free(ptr);
+}
+
+namespace {
+
+using TelemetryServiceImpl = mavsdk::backend::TelemetryServiceImpl<>;
+using mavsdk::Telemetry;
+using mavsdk::backend::StreamHub;
+using mavsdk::backend::StreamPolicy;
+using StreamWriteReactor = mavsdk::backend::StreamWriteReactor<grpc::ByteBuffer>;
+namespace rpc = mavsdk::rpc::telemetry;
+
+constexpr unsigned num_messages = 1000000;
+constexpr unsigned num_clients = 4;
+
+Telemetry::Odometry create_odometry()
+{
+    Telemetry::Odometry odometry;
+    odometry.frame_id = Telemetry::Odometry::MavFrame::EstimNed;
+    odometry.child_frame_id = Telemetry::Odometry::MavFrame::BodyNed;
+    odometry.position_body = {1.0f, 2.0f, -3.0f};
+    odometry.q = {1.0f, 0.0f, 0.0f, 0.0f};
+    odometry.velocity_body = {0.1f, 0.2f, 0.3f};
+    odometry.angular_velocity_body = {0.01f, 0.02f, 0.03f};
+    odometry.pose_covariance.covariance_matrix.assign(21, 0.1f);
+    odometry.velocity_covariance.covariance_matrix.assign(21, 0.2f);
+    return odometry;
+}
+
+template<typename Message> void serialize(const Message& message)
+{
+    grpc::ByteBuffer buffer;
+    bool own_buffer = false;
+    if (!grpc::SerializationTraits<Message>::Serialize(message, &buffer, &own_buffer).ok()) {
+        std::abort();
+    }
+}
+
+template<typename Function> void run(const char* name, const Function& function)
+{
+    // Once, so that reused messages are set up before measuring.
+    function(0);
+
+    const uint64_t allocations_before = num_allocations.load();
+    const uint64_t gpr_allocations_before = num_gpr_allocations.load();
+    const auto start = std::chrono::steady_clock::now();
+
+    for (unsigned i = 0; i < num_messages; ++i) {
+        function(i);
+    }
+
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const auto allocations = static_cast<double>(num_allocations.load() - allocations_before);
+    const auto gpr_allocations =
+        static_cast<double>(num_gpr_allocations.load() - gpr_allocations_before);
+
+    std::printf(
+        "%-30s %10.0f messages/s %6.2f new/message %6.2f gpr_malloc/message\n",
+        name,
+        num_messages / seconds,
+        allocations / num_messages,
+        gpr_allocations / num_messages);
+}
+
+// Clients which are not connected to an RPC: their first write never
+// completes, so every later update waits in their queue, as for clients
+// which are behind. Half of them conflate, the other half queue.
+class Clients {
+public:
+    explicit Clients(StreamHub& hub)
+    {
+        for (unsigned i = 0; i < num_clients; ++i) {
+            _reactors.push_back(std::make_unique<StreamWriteReactor>(
+                i % 2 == 0 ? StreamPolicy::ConflateToLatest : StreamPolicy::Queue));
+            hub.attach(_reactors.back()->writer(), []() { return []() {}; });
+        }
+    }
+
+private:
+    std::vector<std::unique_ptr<StreamWriteReactor>> _reactors{};
+};
+
+} // namespace
+
+int main()
+{
+    // Needs to be set before gRPC allocates anything.
+    gpr_allocation_functions allocation_functions = gpr_get_allocation_functions();
+    allocation_functions.malloc_fn = gpr_malloc_counted;
+    allocation_functions.zalloc_fn = gpr_zalloc_counted;
+    allocation_functions.realloc_fn = gpr_realloc_counted;
+    allocation_functions.free_fn = std::free;
+    gpr_set_allocation_functions(allocation_functions);
+
+    Telemetry::Position position{47.397742, 8.545594, 488.0f, 10.0f};
+    run("position, new message", [&](unsigned i) {
+        position.relative_altitude_m = static_cast<float>(i);
+        rpc::PositionResponse rpc_response;
+        rpc_response.set_allocated_position(
+            TelemetryServiceImpl::translateToRpcPosition(position).release());
+        serialize(rpc_response);
+    });
+    run("position, reused message", [&](unsigned i) {
+        position.relative_altitude_m = static_cast<float>(i);
+        thread_local rpc::PositionResponse rpc_response;
+        TelemetryServiceImpl::translateToRpcPosition(position, rpc_response.mutable_position());
+        serialize(rpc_response);
+    });
+    StreamHub position_hub;
+    Clients position_clients(position_hub);
+    run("position, published", [&](unsigned i) {
+        position.relative_altitude_m = static_cast<float>(i);
+        thread_local rpc::PositionResponse rpc_response;
+        TelemetryServiceImpl::translateToRpcPosition(position, rpc_response.mutable_position());
+        position_hub.publish(rpc_response);
+    });
+
+    Telemetry::Odometry odometry = create_odometry();
+    run("odometry, new message", [&](unsigned i) {
+        odometry.time_usec = i;
+        rpc::OdometryResponse rpc_response;
+        rpc_response.set_allocated_odometry(
+            TelemetryServiceImpl::translateToRpcOdometry(odometry).release());
+        serialize(rpc_response);
+    });
+    run("odometry, reused message", [&](unsigned i) {
+        odometry.time_usec = i;
+        thread_local rpc::OdometryResponse rpc_response;
+        TelemetryServiceImpl::translateToRpcOdometry(odometry, rpc_response.mutable_odometry());
+        serialize(rpc_response);
+    });
+    StreamHub odometry_hub;
+    Clients odometry_clients(odometry_hub);
+    run("odometry, published", [&](unsigned i) {
+        odometry.time_usec = i;
+        thread_local rpc::OdometryResponse rpc_response;
+        TelemetryServiceImpl::translateToRpcOdometry(odometry, rpc_response.mutable_odometry());
+        odometry_hub.publish(rpc_response);
+    });
+
+    Telemetry::StatusText status_text{
+        Telemetry::StatusTextType::Info, "[logger] file: ./log/2021-01-01/12_00_00.ulg"};
+    run("status text, new message", [&](unsigned) {
+        rpc::StatusTextResponse rpc_response;
+        rpc_response.set_allocated_status_text(
+            TelemetryServiceImpl::translateToRpcStatusText(status_text).release());
+        serialize(rpc_response);
+    });
+    run("status text, reused message", [&](unsigned) {
+        thread_local rpc::StatusTextResponse rpc_response;
+        TelemetryServiceImpl::translateToRpcStatusText(
+            status_text, rpc_response.mutable_status_text());
+        serialize(rpc_response);
+    });
+
+    return 0;
+}
@@ -19,23 +19,41 @@ void CallEveryHandler::add(std::function<void()> callback, double interval_s, vo
 
     void* new_cookie = static_cast<void*>(new_entry.get());
 
+    std::function<void()> wakeup_callback{nullptr};
     {
         std::lock_guard<std::mutex> lock(_entries_mutex);
         _entries.insert(std::pair<void*, std::shared_ptr<Entry>>(new_cookie, new_entry));
+        if (schedule(new_cookie, *new_entry)) {
+            wakeup_callback = _wakeup_callback;
+        }
     }
 
     if (cookie != nullptr) {
         *cookie = new_cookie;
     }
+
+    if (wakeup_callback) {
+        wakeup_callback();
+    }
 }
 
 void CallEveryHandler::change(double interval_s, const void* cookie)
 {
-    std::lock_guard<std::mutex> lock(_entries_mutex);
+    std::function<void()> wakeup_callback{nullptr};
+    {
+        std::lock_guard<std::mutex> lock(_entries_mutex);
 
-    auto it = _entries.find(const_cast<void*>(cookie));
-    if (it != _entries.end()) {
-        it->second->interval_s = interval_s;
+        auto it = _entries.find(const_cast<void*>(cookie));
+        if (it != _entries.end()) {
+            it->second->interval_s = interval_s;
+            if (schedule(it->first, *it->second)) {
+                wakeup_callback = _wakeup_callback;
+            }
+        }
+    }
+
+    if (wakeup_callback) {
+        wakeup_callback();
     }
 }
 
@@ -46,6 +64,8 @@ void CallEveryHandler::reset(const void* cookie)
     auto it = _entries.find(const_cast<void*>(cookie));
     if (it != _entries.end()) {
         it->second->last_time = _time.steady_time();
+        // This can only ever move the deadline later, so no need to wake anyone up.
+        schedule(it->first, *it->second);
     }
 }
 
@@ -53,40 +73,115 @@ void CallEveryHandler::remove(const void* cookie)
 {
     std::lock_guard<std::mutex> lock(_entries_mutex);
 
-    auto it = _entries.find(const_cast<void*>(cookie));
-    if (it != _entries.end()) {
-        _entries.erase(const_cast<void*>(cookie));
-        _iterator_invalidated = true;
-    }
+    // The heap entry becomes outdated and is dropped once it comes up.
+    _entries.erase(const_cast<void*>(cookie));
 }
 
 void CallEveryHandler::run_once()
 {
-    _entries_mutex.lock();
+    std::unique_lock<std::mutex> lock(_entries_mutex);
 
-    for (auto it = _entries.begin(); it != _entries.end(); ++it) {
-        if (_time.elapsed_since_s(it->second->last_time) > double(it->second->interval_s)) {
-            _time.shift_steady_time_by(it->second->last_time, double(it->second->interval_s));
+    const dl_time_t now = _time.steady_time();
 
-            if (it->second->callback) {
-                // Get a copy for the callback because we unlock.
-                std::function<void()> callback = it->second->callback;
+    // First, collect everything that is due. This way every entry is called at
+    // most once per run, even if it has fallen behind by more than one interval.
+    std::vector<std::pair<void*, std::shared_ptr<Entry>>> due_entries;
 
-                // Unlock while we callback because it might in turn want to add timeouts.
-                _entries_mutex.unlock();
-                callback();
-                _entries_mutex.lock();
-            }
+    while (!_heap.empty() && _heap.top().time < now) {
+        const HeapEntry heap_entry = _heap.top();
+        _heap.pop();
+
+        if (!is_current(heap_entry)) {
+            continue;
+        }
+
+        due_entries.emplace_back(heap_entry.cookie, _entries[heap_entry.cookie]);
+    }
+
+    for (auto& due_entry : due_entries) {
+        _time.shift_steady_time_by(
+            due_entry.second->last_time, double(due_entry.second->interval_s));
+        schedule(due_entry.first, *due_entry.second);
+    }
+
+    for (const auto& due_entry : due_entries) {
+        // Someone might have removed it while we were calling the previous one.
+        const auto it = _entries.find(due_entry.first);
+        if (it == _entries.end() || it->second != due_entry.second) {
+            continue;
         }
 
-        // We leave the loop.
-        // FIXME: there should be a nicer way to do this.
-        if (_iterator_invalidated) {
-            _iterator_invalidated = false;
-            break;
+        if (it->second->callback) {
+            // Get a copy for the callback because we unlock.
+            std::function<void()> callback = it->second->callback;
+
+            // Unlock while we callback because it might in turn want to add timeouts.
+            lock.unlock();
+            callback();
+            lock.lock();
         }
     }
-    _entries_mutex.unlock();
+}
+
+std::pair<bool, dl_time_t> CallEveryHandler::next_deadline()
+{
+    std::lock_guard<std::mutex> lock(_entries_mutex);
+
+    while (!_heap.empty() && !is_current(_heap.top())) {
+        _heap.pop();
+    }
+
+    if (_heap.empty()) {
+        return std::make_pair<>(false, dl_time_t{});
+    }
+    return std::make_pair<>(true, _heap.top().time);
+}
+
+void CallEveryHandler::set_wakeup_callback(std::function<void()> callback)
+{
+    std::lock_guard<std::mutex> lock(_entries_mutex);
+    _wakeup_callback = callback;
+}
+
+dl_time_t CallEveryHandler::due_time(const Entry& entry)
+{
+    return entry.last_time + std::chrono::duration_cast<dl_time_t::duration>(
+                                 std::chrono::duration<double>(entry.interval_s));
+}
+
+bool CallEveryHandler::schedule(void* cookie, Entry& entry)
+{
+    // Needs to be called with the mutex locked. Returns true if this is now the
+    // next deadline.
+
+    const dl_time_t time = due_time(entry);
+    const bool earlier_than_before = _heap.empty() || time < _heap.top().time;
+
+    entry.generation = _next_generation++;
+    _heap.push(HeapEntry{time, cookie, entry.generation});
+
+    if (_heap.size() > 2 * _entries.size() + 16) {
+        compact_heap();
+    }
+
+    return earlier_than_before;
+}
+
+bool CallEveryHandler::is_current(const HeapEntry& heap_entry) const
+{
+    const auto it = _entries.find(heap_entry.cookie);
+    return it != _entries.end() && it->second->generation == heap_entry.generation;
+}
+
+void CallEveryHandler::compact_heap()
+{
+    std::vector<HeapEntry> heap_entries;
+    heap_entries.reserve(_entries.size());
+    for (const auto& entry : _entries) {
+        heap_entries.push_back(HeapEntry{due_time(*entry.second), entry.first, entry.second->generation});
+    }
+
+    _heap = decltype(_heap)(std::greater<HeapEntry>(), std::move(heap_entries));
 }
 
 } // namespace mavsdk
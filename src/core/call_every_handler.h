@@ -3,7 +3,9 @@
 #include <mutex>
 #include <memory>
 #include <functional>
+#include <queue>
 #include <unordered_map>
+#include <vector>
 #include "global_include.h"
 
 namespace mavsdk {
@@ -26,16 +28,44 @@ public:
 
     void run_once();
 
+    // Returns the earliest time at which run_once has something to do, or
+    // false as first if there are no entries.
+    std::pair<bool, dl_time_t> next_deadline();
+
+    // The callback is called whenever the next deadline has moved earlier, so
+    // that whoever sleeps until next_deadline() can wake up and re-check.
+    void set_wakeup_callback(std::function<void()> callback);
+
 private:
     struct Entry {
         std::function<void()> callback{nullptr};
         dl_time_t last_time{};
         double interval_s{0.0f};
+        uint64_t generation{0};
     };
 
+    // Entries are kept in a min-heap sorted by when they are due next. Outdated
+    // heap entries after a change, reset or remove are left in the heap and
+    // skipped when they come up, recognized by their generation.
+    struct HeapEntry {
+        dl_time_t time;
+        void* cookie;
+        uint64_t generation;
+
+        bool operator>(const HeapEntry& other) const { return time > other.time; }
+    };
+
+    static dl_time_t due_time(const Entry& entry);
+    bool schedule(void* cookie, Entry& entry);
+    bool is_current(const HeapEntry& heap_entry) const;
+    void compact_heap();
+
     std::unordered_map<void*, std::shared_ptr<Entry>> _entries{};
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>> _heap{};
+    uint64_t _next_generation{0};
     std::mutex _entries_mutex{};
-    bool _iterator_invalidated{false};
+
+    std::function<void()> _wakeup_callback{nullptr};
 
     Time& _time;
 };
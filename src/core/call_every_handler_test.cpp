@@ -144,3 +144,28 @@ TEST(CallEveryHandler, CallImmediately)
     }
     EXPECT_EQ(num_called, 1);
 }
+
+TEST(CallEveryHandler, NextDeadline)
+{
+    Time time{};
+    CallEveryHandler ceh(time);
+
+    int num_wakeups = 0;
+    ceh.set_wakeup_callback([&num_wakeups]() { ++num_wakeups; });
+
+    EXPECT_FALSE(ceh.next_deadline().first);
+
+    void* cookie = nullptr;
+    ceh.add([]() {}, 0.1, &cookie);
+    EXPECT_EQ(num_wakeups, 1);
+
+    // It is due straightaway.
+    EXPECT_TRUE(ceh.next_deadline().first);
+    EXPECT_LT(ceh.next_deadline().second, time.steady_time());
+
+    ceh.run_once();
+    EXPECT_GT(ceh.next_deadline().second, time.steady_time());
+
+    ceh.remove(cookie);
+    EXPECT_FALSE(ceh.next_deadline().first);
+}
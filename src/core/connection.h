@@ -2,13 +2,15 @@
 
 #include "mavsdk.h"
 #include "mavlink_receiver.h"
+#include "io_loop.h"
 #include <memory>
 
 namespace mavsdk {
 
 class Connection {
 public:
-    typedef std::function<void(mavlink_message_t& message)> receiver_callback_t;
+    typedef std::function<void(const std::shared_ptr<mavlink_message_t>& message)>
+        receiver_callback_t;
 
     Connection(receiver_callback_t receiver_callback);
     virtual ~Connection();
@@ -18,6 +20,13 @@ public:
 
     virtual bool send_message(const mavlink_message_t& message) = 0;
 
+    // Sends whatever has been queued up, for connections which batch sends.
+    virtual void flush() {}
+
+    // If set before start(), the connection is serviced by the I/O loop
+    // instead of its own receive thread, where supported.
+    void set_io_loop(IoLoop* io_loop) { _io_loop = io_loop; }
+
     // Non-copyable
     Connection(const Connection&) = delete;
     const Connection& operator=(const Connection&) = delete;
@@ -25,10 +34,11 @@ public:
 protected:
     bool start_mavlink_receiver();
     void stop_mavlink_receiver();
-    void receive_message(mavlink_message_t& message);
+    void receive_message(const std::shared_ptr<mavlink_message_t>& message);
 
     receiver_callback_t _receiver_callback{};
     std::unique_ptr<MAVLinkReceiver> _mavlink_receiver;
+    IoLoop* _io_loop{nullptr};
 
     // void received_mavlink_message(mavlink_message_t &);
 };
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace mavsdk {
+
+// Keeps the most recent samples of a stream together with their timestamps
+// in a fixed size ring buffer and allows to look them up by time.
+//
+// The timestamps are stored separately from the values, so searching by time
+// only touches the timestamps which are packed next to each other.
+//
+// Samples need to arrive in order. A sample going back in time by more than
+// reset_threshold_us is taken as a reset of the clock (e.g. an autopilot
+// reboot) and clears the history, other out of order samples are dropped.
+//
+// This is not thread-safe, calls need to be guarded by the owner.
+template<typename T> class HistoryBuffer {
+public:
+    struct Sample {
+        uint64_t timestamp_us{0};
+        T value{};
+    };
+
+    static constexpr uint64_t reset_threshold_us = 1000000;
+
+    HistoryBuffer() = default;
+
+    // Keeps at most max_samples which are at most duration_us older than the
+    // newest one. A max_samples of 0 disables the history.
+    void reset(std::size_t max_samples, uint64_t duration_us)
+    {
+        _timestamps.assign(max_samples, 0);
+        _values.assign(max_samples, T{});
+        _duration_us = duration_us;
+        _begin = 0;
+        _size = 0;
+    }
+
+    bool enabled() const { return !_timestamps.empty(); }
+
+    std::size_t size() const { return _size; }
+
+    void push(uint64_t timestamp_us, const T& value)
+    {
+        if (!enabled()) {
+            return;
+        }
+
+        if (_size > 0) {
+            const uint64_t newest = timestamp_at(_size - 1);
+            if (timestamp_us < newest) {
+                if (newest - timestamp_us <= reset_threshold_us) {
+                    return;
+                }
+                _begin = 0;
+                _size = 0;
+            } else if (timestamp_us == newest) {
+                _values[index(_size - 1)] = value;
+                return;
+            }
+        }
+
+        if (_size == _timestamps.size()) {
+            _begin = index(1);
+            --_size;
+        }
+
+        _timestamps[index(_size)] = timestamp_us;
+        _values[index(_size)] = value;
+        ++_size;
+
+        while (_size > 1 && timestamp_at(0) + _duration_us < timestamp_us) {
+            _begin = index(1);
+            --_size;
+        }
+    }
+
+    // All samples with from_us <= timestamp <= to_us, oldest first.
+    std::vector<Sample> range(uint64_t from_us, uint64_t to_us) const
+    {
+        std::vector<Sample> samples;
+        for (std::size_t i = lower_bound(from_us); i < _size && timestamp_at(i) <= to_us; ++i) {
+            samples.push_back(Sample{timestamp_at(i), _values[index(i)]});
+        }
+        return samples;
+    }
+
+    // The sample closest in time. First is false if there are no samples or
+    // if the closest one is further away than the duration of the history, so
+    // a timestamp from a long time ago or in the future does not match anything.
+    std::pair<bool, Sample> nearest(uint64_t timestamp_us) const
+    {
+        if (_size == 0) {
+            return {false, {}};
+        }
+
+        std::size_t i = lower_bound(timestamp_us);
+        if (i == _size ||
+            (i > 0 && timestamp_us - timestamp_at(i - 1) < timestamp_at(i) - timestamp_us)) {
+            --i;
+        }
+
+        const uint64_t sample_us = timestamp_at(i);
+        const uint64_t distance_us =
+            sample_us > timestamp_us ? sample_us - timestamp_us : timestamp_us - sample_us;
+        if (distance_us > _duration_us) {
+            return {false, {}};
+        }
+        return {true, Sample{sample_us, _values[index(i)]}};
+    }
+
+    // The value at timestamp_us interpolated between the samples before and
+    // after it. First is false if timestamp_us is not within the history.
+    //
+    // interpolate(before, after, fraction) returns the value in between, with
+    // fraction going from 0 at before to 1 at after.
+    template<typename Interpolate>
+    std::pair<bool, Sample>
+    interpolated(uint64_t timestamp_us, const Interpolate& interpolate) const
+    {
+        const std::size_t i = lower_bound(timestamp_us);
+        if (i == _size) {
+            return {false, {}};
+        }
+        if (timestamp_at(i) == timestamp_us) {
+            return {true, Sample{timestamp_us, _values[index(i)]}};
+        }
+        if (i == 0) {
+            return {false, {}};
+        }
+
+        const uint64_t before = timestamp_at(i - 1);
+        const uint64_t after = timestamp_at(i);
+        const double fraction =
+            static_cast<double>(timestamp_us - before) / static_cast<double>(after - before);
+        return {
+            true,
+            Sample{timestamp_us, interpolate(_values[index(i - 1)], _values[index(i)], fraction)}};
+    }
+
+private:
+    std::size_t index(std::size_t i) const { return (_begin + i) % _timestamps.size(); }
+
+    uint64_t timestamp_at(std::size_t i) const { return _timestamps[index(i)]; }
+
+    // The first sample with a timestamp not before timestamp_us.
+    std::size_t lower_bound(uint64_t timestamp_us) const
+    {
+        std::size_t first = 0;
+        std::size_t count = _size;
+        while (count > 0) {
+            const std::size_t step = count / 2;
+            if (timestamp_at(first + step) < timestamp_us) {
+                first += step + 1;
+                count -= step + 1;
+            } else {
+                count = step;
+            }
+        }
+        return first;
+    }
+
+    std::vector<uint64_t> _timestamps{};
+    std::vector<T> _values{};
+    uint64_t _duration_us{0};
+    std::size_t _begin{0};
+    std::size_t _size{0};
+};
+
+} // namespace mavsdk
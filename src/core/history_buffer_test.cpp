@@ -0,0 +1,126 @@
+#include "history_buffer.h"
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+namespace {
+
+double interpolate(double before, double after, double fraction)
+{
+    return before + (after - before) * fraction;
+}
+
+} // namespace
+
+TEST(HistoryBuffer, DisabledByDefault)
+{
+    HistoryBuffer<double> history;
+    EXPECT_FALSE(history.enabled());
+
+    history.push(1000, 1.0);
+    EXPECT_EQ(history.size(), 0u);
+    EXPECT_FALSE(history.nearest(1000).first);
+}
+
+TEST(HistoryBuffer, Range)
+{
+    HistoryBuffer<double> history;
+    history.reset(10, 1000000);
+    for (uint64_t i = 0; i < 5; ++i) {
+        history.push(i * 100, static_cast<double>(i));
+    }
+
+    const auto samples = history.range(100, 300);
+    ASSERT_EQ(samples.size(), 3u);
+    EXPECT_EQ(samples[0].timestamp_us, 100u);
+    EXPECT_DOUBLE_EQ(samples[2].value, 3.0);
+
+    EXPECT_TRUE(history.range(1000, 2000).empty());
+}
+
+TEST(HistoryBuffer, DropsOldestWhenFull)
+{
+    HistoryBuffer<double> history;
+    history.reset(3, 1000000);
+    for (uint64_t i = 0; i < 5; ++i) {
+        history.push(i * 100, static_cast<double>(i));
+    }
+
+    EXPECT_EQ(history.size(), 3u);
+    const auto samples = history.range(0, 1000);
+    ASSERT_EQ(samples.size(), 3u);
+    EXPECT_EQ(samples.front().timestamp_us, 200u);
+    EXPECT_EQ(samples.back().timestamp_us, 400u);
+}
+
+TEST(HistoryBuffer, DropsSamplesOlderThanDuration)
+{
+    HistoryBuffer<double> history;
+    history.reset(100, 250);
+    for (uint64_t i = 0; i < 10; ++i) {
+        history.push(i * 100, static_cast<double>(i));
+    }
+
+    const auto samples = history.range(0, 1000);
+    ASSERT_EQ(samples.size(), 3u);
+    EXPECT_EQ(samples.front().timestamp_us, 700u);
+}
+
+TEST(HistoryBuffer, Nearest)
+{
+    HistoryBuffer<double> history;
+    history.reset(10, 1000000);
+    history.push(100, 1.0);
+    history.push(200, 2.0);
+    history.push(300, 3.0);
+
+    EXPECT_EQ(history.nearest(0).second.timestamp_us, 100u);
+    EXPECT_EQ(history.nearest(140).second.timestamp_us, 100u);
+    EXPECT_EQ(history.nearest(160).second.timestamp_us, 200u);
+    EXPECT_EQ(history.nearest(300).second.timestamp_us, 300u);
+    EXPECT_EQ(history.nearest(1000).second.timestamp_us, 300u);
+}
+
+TEST(HistoryBuffer, NearestWithinDuration)
+{
+    HistoryBuffer<double> history;
+    history.reset(10, 1000);
+    history.push(10000, 1.0);
+    history.push(10500, 2.0);
+
+    EXPECT_TRUE(history.nearest(9000).first);
+    EXPECT_TRUE(history.nearest(11500).first);
+    EXPECT_FALSE(history.nearest(8999).first);
+    EXPECT_FALSE(history.nearest(11501).first);
+    EXPECT_FALSE(history.nearest(0).first);
+}
+
+TEST(HistoryBuffer, Interpolated)
+{
+    HistoryBuffer<double> history;
+    history.reset(10, 1000000);
+    history.push(100, 1.0);
+    history.push(200, 2.0);
+
+    EXPECT_DOUBLE_EQ(history.interpolated(125, interpolate).second.value, 1.25);
+    EXPECT_DOUBLE_EQ(history.interpolated(200, interpolate).second.value, 2.0);
+    EXPECT_FALSE(history.interpolated(50, interpolate).first);
+    EXPECT_FALSE(history.interpolated(250, interpolate).first);
+}
+
+TEST(HistoryBuffer, OutOfOrderAndReset)
+{
+    HistoryBuffer<double> history;
+    history.reset(10, 10000000);
+    history.push(2000000, 1.0);
+    history.push(2000100, 2.0);
+
+    // Slightly out of order samples are dropped.
+    history.push(2000050, 3.0);
+    EXPECT_EQ(history.size(), 2u);
+
+    // A big jump back means the clock was reset.
+    history.push(100, 4.0);
+    EXPECT_EQ(history.size(), 1u);
+    EXPECT_DOUBLE_EQ(history.nearest(100).second.value, 4.0);
+}
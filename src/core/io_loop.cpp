@@ -0,0 +1,203 @@
+#include "io_loop.h"
+#include "global_include.h"
+#include "log.h"
+
+#if defined(LINUX)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace mavsdk {
+
+IoLoop::~IoLoop()
+{
+    stop();
+}
+
+bool IoLoop::is_supported()
+{
+#if defined(LINUX)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool IoLoop::start()
+{
+#if defined(LINUX)
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (_thread != nullptr) {
+        return true;
+    }
+
+    _epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (_epoll_fd < 0) {
+        LogErr() << "epoll_create1 failure: " << strerror(errno);
+        return false;
+    }
+
+    // Used to wake up the loop thread when stopping.
+    _wakeup_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (_wakeup_fd < 0) {
+        LogErr() << "eventfd failure: " << strerror(errno);
+        close(_epoll_fd);
+        _epoll_fd = -1;
+        return false;
+    }
+
+    struct epoll_event event {};
+    event.events = EPOLLIN;
+    event.data.fd = _wakeup_fd;
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _wakeup_fd, &event) != 0) {
+        LogErr() << "epoll_ctl failure: " << strerror(errno);
+        close(_wakeup_fd);
+        _wakeup_fd = -1;
+        close(_epoll_fd);
+        _epoll_fd = -1;
+        return false;
+    }
+
+    _should_exit = false;
+    _thread = new std::thread(&IoLoop::loop_thread, this);
+    return true;
+#else
+    LogErr() << "I/O loop not supported on this platform";
+    return false;
+#endif
+}
+
+void IoLoop::stop()
+{
+#if defined(LINUX)
+    std::thread* thread;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_thread == nullptr) {
+            return;
+        }
+        thread = _thread;
+        _thread = nullptr;
+        _should_exit = true;
+
+        const uint64_t value = 1;
+        if (write(_wakeup_fd, &value, sizeof(value)) != sizeof(value)) {
+            LogErr() << "eventfd write failure: " << strerror(errno);
+        }
+    }
+
+    thread->join();
+    delete thread;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _callbacks.clear();
+    close(_wakeup_fd);
+    _wakeup_fd = -1;
+    close(_epoll_fd);
+    _epoll_fd = -1;
+#endif
+}
+
+bool IoLoop::add(int fd, ReadableCallback callback)
+{
+#if defined(LINUX)
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (_thread == nullptr) {
+        return false;
+    }
+
+    struct epoll_event event {};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+        LogErr() << "epoll_ctl failure: " << strerror(errno);
+        return false;
+    }
+
+    _callbacks[fd] = std::make_shared<ReadableCallback>(std::move(callback));
+    return true;
+#else
+    UNUSED(fd);
+    UNUSED(callback);
+    return false;
+#endif
+}
+
+void IoLoop::remove(int fd)
+{
+#if defined(LINUX)
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    if (_callbacks.erase(fd) == 0) {
+        return;
+    }
+
+    epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+
+    // If the callback is running right now, we need to wait for it to finish,
+    // unless we are called from it.
+    if (std::this_thread::get_id() != _loop_thread_id) {
+        _done_condition.wait(lock, [this, fd]() { return _running_fd != fd; });
+    }
+#else
+    UNUSED(fd);
+#endif
+}
+
+void IoLoop::loop_thread()
+{
+#if defined(LINUX)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _loop_thread_id = std::this_thread::get_id();
+    }
+
+    // Whatever is readable at the same time is handled in one go.
+    constexpr int max_events = 64;
+    struct epoll_event events[max_events];
+
+    while (true) {
+        const int num_events = epoll_wait(_epoll_fd, events, max_events, -1);
+
+        if (num_events < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LogErr() << "epoll_wait failure: " << strerror(errno);
+            return;
+        }
+
+        for (int i = 0; i < num_events; ++i) {
+            const int fd = events[i].data.fd;
+
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (_should_exit) {
+                return;
+            }
+
+            // The callback might have been removed by one called before.
+            const auto it = _callbacks.find(fd);
+            if (it == _callbacks.end()) {
+                continue;
+            }
+
+            auto callback = it->second;
+            _running_fd = fd;
+            lock.unlock();
+
+            (*callback)();
+
+            lock.lock();
+            _running_fd = -1;
+            _done_condition.notify_all();
+        }
+    }
+#endif
+}
+
+} // namespace mavsdk
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace mavsdk {
+
+// Waits on the file descriptors of all connections from one thread and calls
+// back whenever one of them has something to read. This replaces having a
+// receive thread per connection.
+//
+// This is based on epoll and therefore only available on Linux. Elsewhere,
+// start() fails and connections keep using their own receive threads.
+class IoLoop {
+public:
+    IoLoop() = default;
+    ~IoLoop();
+
+    // delete copy and move constructors and assign operators
+    IoLoop(IoLoop const&) = delete; // Copy construct
+    IoLoop(IoLoop&&) = delete; // Move construct
+    IoLoop& operator=(IoLoop const&) = delete; // Copy assign
+    IoLoop& operator=(IoLoop&&) = delete; // Move assign
+
+    bool start();
+    void stop();
+
+    using ReadableCallback = std::function<void()>;
+
+    // The callback is called from the I/O loop thread as long as there is
+    // something to read on fd, so it must not block.
+    bool add(int fd, ReadableCallback callback);
+
+    // Once this returns, the callback is not running anymore and won't be
+    // called again, unless called from the callback itself.
+    void remove(int fd);
+
+    static bool is_supported();
+
+private:
+    void loop_thread();
+
+    std::mutex _mutex{};
+    std::condition_variable _done_condition{};
+    std::unordered_map<int, std::shared_ptr<ReadableCallback>> _callbacks{};
+    int _running_fd{-1};
+    std::thread::id _loop_thread_id{};
+
+    int _epoll_fd{-1};
+    int _wakeup_fd{-1};
+    bool _should_exit{false};
+
+    std::thread* _thread{nullptr};
+};
+
+} // namespace mavsdk
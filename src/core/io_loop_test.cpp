@@ -0,0 +1,106 @@
+#include "io_loop.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+
+#if defined(LINUX)
+#include <unistd.h>
+#endif
+
+using namespace mavsdk;
+
+#if defined(LINUX)
+
+TEST(IoLoop, CallsBackWhenReadable)
+{
+    IoLoop io_loop;
+    ASSERT_TRUE(io_loop.start());
+
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+
+    std::atomic<int> num_bytes{0};
+    auto prom = std::make_shared<std::promise<void>>();
+    auto fut = prom->get_future();
+
+    ASSERT_TRUE(io_loop.add(fds[0], [&num_bytes, prom, fds]() {
+        char buffer[16];
+        const auto len = read(fds[0], buffer, sizeof(buffer));
+        if (len > 0 && (num_bytes += static_cast<int>(len)) == 3) {
+            prom->set_value();
+        }
+    }));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(num_bytes, 0);
+
+    ASSERT_EQ(write(fds[1], "abc", 3), 3);
+    EXPECT_EQ(fut.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+
+    io_loop.remove(fds[0]);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST(IoLoop, NotCalledAfterRemove)
+{
+    IoLoop io_loop;
+    ASSERT_TRUE(io_loop.start());
+
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+
+    std::atomic<bool> called{false};
+    ASSERT_TRUE(io_loop.add(fds[0], [&called]() { called = true; }));
+    io_loop.remove(fds[0]);
+
+    ASSERT_EQ(write(fds[1], "a", 1), 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(called);
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST(IoLoop, RemoveFromCallback)
+{
+    IoLoop io_loop;
+    ASSERT_TRUE(io_loop.start());
+
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+
+    // The data is never read, so without removing, this would be called again and again.
+    std::atomic<int> num_called{0};
+    ASSERT_TRUE(io_loop.add(fds[0], [&io_loop, &num_called, fds]() {
+        ++num_called;
+        io_loop.remove(fds[0]);
+    }));
+
+    ASSERT_EQ(write(fds[1], "a", 1), 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(num_called, 1);
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST(IoLoop, AddFailsWhenStopped)
+{
+    IoLoop io_loop;
+
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+
+    EXPECT_FALSE(io_loop.add(fds[0], []() {}));
+
+    ASSERT_TRUE(io_loop.start());
+    io_loop.stop();
+    EXPECT_FALSE(io_loop.add(fds[0], []() {}));
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+#endif
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mavsdk {
+
+/*
+ * Bounded lock-free queue based on Dmitry Vyukov's MPMC ring buffer:
+ * http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+ *
+ * Items are moved in and out, never copied. Enqueueing and dequeueing never
+ * take a lock. A mutex and condition variable are only used to put the consumer
+ * to sleep when the queue is empty, and producers only touch them if the
+ * consumer is actually sleeping.
+ *
+ * The capacity is rounded up to the next power of two.
+ */
+
+template<class T> class LockFreeQueue {
+public:
+    explicit LockFreeQueue(std::size_t capacity) :
+        _capacity(round_up_to_power_of_two(capacity)),
+        _mask(_capacity - 1),
+        _cells(new Cell[_capacity])
+    {
+        for (std::size_t i = 0; i < _capacity; ++i) {
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~LockFreeQueue() = default;
+
+    // delete copy and move constructors and assign operators
+    LockFreeQueue(LockFreeQueue const&) = delete; // Copy construct
+    LockFreeQueue(LockFreeQueue&&) = delete; // Move construct
+    LockFreeQueue& operator=(LockFreeQueue const&) = delete; // Copy assign
+    LockFreeQueue& operator=(LockFreeQueue&&) = delete; // Move assign
+
+    // Returns false if the queue is full, in which case item is left untouched.
+    bool try_enqueue(T& item)
+    {
+        Cell* cell;
+        std::size_t pos = _enqueue_pos.load(std::memory_order_relaxed);
+        while (true) {
+            cell = &_cells[pos & _mask];
+            const std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = _enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->data = std::move(item);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+
+        wake_consumer();
+        return true;
+    }
+
+    // Returns false if the queue is empty.
+    bool try_dequeue(T& item)
+    {
+        Cell* cell;
+        std::size_t pos = _dequeue_pos.load(std::memory_order_relaxed);
+        while (true) {
+            cell = &_cells[pos & _mask];
+            const std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const auto diff =
+                static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = _dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        item = std::move(cell->data);
+        cell->data = T{};
+        cell->sequence.store(pos + _mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Moves up to max_items into items (appended) and returns how many there were.
+    std::size_t try_dequeue_batch(std::vector<T>& items, std::size_t max_items)
+    {
+        std::size_t num_dequeued = 0;
+        T item{};
+        while (num_dequeued < max_items && try_dequeue(item)) {
+            items.push_back(std::move(item));
+            ++num_dequeued;
+        }
+        return num_dequeued;
+    }
+
+    // Blocks until there is something to dequeue or stop() has been called.
+    // Returns false if stopped.
+    bool wait_for_items()
+    {
+        std::unique_lock<std::mutex> lock(_wait_mutex);
+        _consumer_waiting.store(true);
+        _wait_condition.wait(lock, [this]() { return _should_exit || !empty(); });
+        _consumer_waiting.store(false);
+        return !_should_exit;
+    }
+
+    void stop()
+    {
+        // This can be used if the wait needs to be interrupted, e.g.
+        // when trying to stop a worker thread.
+        std::lock_guard<std::mutex> lock(_wait_mutex);
+        _should_exit = true;
+        _wait_condition.notify_all();
+    }
+
+    // This is only a snapshot when used concurrently.
+    std::size_t size() const
+    {
+        const std::size_t enqueue_pos = _enqueue_pos.load();
+        const std::size_t dequeue_pos = _dequeue_pos.load();
+        return (enqueue_pos > dequeue_pos) ? (enqueue_pos - dequeue_pos) : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    std::size_t capacity() const { return _capacity; }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence{0};
+        T data{};
+    };
+
+    static std::size_t round_up_to_power_of_two(std::size_t value)
+    {
+        std::size_t result = 2;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    void wake_consumer()
+    {
+        // The consumer sets the flag before checking whether the queue is empty,
+        // and we set the item before checking the flag, so one of us is bound
+        // to notice the other.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_consumer_waiting.load()) {
+            std::lock_guard<std::mutex> lock(_wait_mutex);
+            _wait_condition.notify_one();
+        }
+    }
+
+    const std::size_t _capacity;
+    const std::size_t _mask;
+    std::unique_ptr<Cell[]> _cells;
+
+    // Keep the two positions on separate cache lines to avoid false sharing
+    // between producers and the consumer.
+    alignas(64) std::atomic<std::size_t> _enqueue_pos{0};
+    alignas(64) std::atomic<std::size_t> _dequeue_pos{0};
+
+    std::atomic<bool> _consumer_waiting{false};
+    std::mutex _wait_mutex{};
+    std::condition_variable _wait_condition{};
+    bool _should_exit{false};
+};
+
+} // namespace mavsdk
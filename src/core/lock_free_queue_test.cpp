@@ -0,0 +1,119 @@
+#include "lock_free_queue.h"
+
+#include <future>
+#include <string>
+#include <thread>
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+TEST(LockFreeQueue, FillAndEmpty)
+{
+    LockFreeQueue<int> queue{4};
+    EXPECT_EQ(queue.capacity(), 4);
+
+    for (int i = 1; i <= 4; ++i) {
+        EXPECT_TRUE(queue.try_enqueue(i));
+    }
+    EXPECT_EQ(queue.size(), 4);
+
+    int overflow = 5;
+    EXPECT_FALSE(queue.try_enqueue(overflow));
+    EXPECT_EQ(overflow, 5);
+
+    int item = 0;
+    for (int i = 1; i <= 4; ++i) {
+        EXPECT_TRUE(queue.try_dequeue(item));
+        EXPECT_EQ(item, i);
+    }
+    EXPECT_FALSE(queue.try_dequeue(item));
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(LockFreeQueue, CapacityIsRoundedUp)
+{
+    LockFreeQueue<int> queue{100};
+    EXPECT_EQ(queue.capacity(), 128);
+}
+
+TEST(LockFreeQueue, MovesItems)
+{
+    LockFreeQueue<std::unique_ptr<std::string>> queue{8};
+
+    auto item = std::make_unique<std::string>("hello");
+    EXPECT_TRUE(queue.try_enqueue(item));
+    EXPECT_EQ(item, nullptr);
+
+    std::vector<std::unique_ptr<std::string>> items;
+    EXPECT_EQ(queue.try_dequeue_batch(items, 8), 1);
+    ASSERT_EQ(items.size(), 1);
+    EXPECT_EQ(*items[0], "hello");
+}
+
+TEST(LockFreeQueue, DequeueBatch)
+{
+    LockFreeQueue<int> queue{8};
+
+    for (int i = 0; i < 6; ++i) {
+        EXPECT_TRUE(queue.try_enqueue(i));
+    }
+
+    std::vector<int> items;
+    EXPECT_EQ(queue.try_dequeue_batch(items, 4), 4);
+    EXPECT_EQ(queue.try_dequeue_batch(items, 4), 2);
+    EXPECT_EQ(queue.try_dequeue_batch(items, 4), 0);
+    EXPECT_EQ(items, std::vector<int>({0, 1, 2, 3, 4, 5}));
+}
+
+TEST(LockFreeQueue, StopWakesConsumer)
+{
+    LockFreeQueue<int> queue{8};
+
+    auto fut = std::async(std::launch::async, [&queue]() { return queue.wait_for_items(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    queue.stop();
+
+    EXPECT_EQ(fut.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    EXPECT_FALSE(fut.get());
+}
+
+TEST(LockFreeQueue, MultipleProducers)
+{
+    LockFreeQueue<int> queue{64};
+
+    const int num_producers = 4;
+    const int num_items_per_producer = 10000;
+
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < num_producers; ++producer) {
+        producers.emplace_back([&queue, producer]() {
+            for (int i = 0; i < num_items_per_producer; ++i) {
+                int item = producer * num_items_per_producer + i;
+                while (!queue.try_enqueue(item)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // Every producer's items need to arrive complete and in order.
+    std::vector<int> next_expected(num_producers, 0);
+    int num_received = 0;
+    std::vector<int> items;
+    while (num_received < num_producers * num_items_per_producer) {
+        ASSERT_TRUE(queue.wait_for_items());
+        items.clear();
+        queue.try_dequeue_batch(items, queue.capacity());
+        for (const int item : items) {
+            const int producer = item / num_items_per_producer;
+            EXPECT_EQ(item % num_items_per_producer, next_expected[producer]);
+            ++next_expected[producer];
+            ++num_received;
+        }
+    }
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    EXPECT_TRUE(queue.empty());
+}
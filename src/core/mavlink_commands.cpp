@@ -97,6 +97,7 @@ void MavlinkCommandSender::queue_command_async(
     new_work->callback = callback;
     new_work->mavlink_command = command.command;
     _work_queue.push_back(new_work);
+    _parent.request_work();
 }
 
 void MavlinkCommandSender::queue_command_async(
@@ -126,9 +127,10 @@ void MavlinkCommandSender::queue_command_async(
     new_work->mavlink_command = command.command;
     new_work->time_started = _parent.get_time().steady_time();
     _work_queue.push_back(new_work);
+    _parent.request_work();
 }
 
-void MavlinkCommandSender::receive_command_ack(mavlink_message_t message)
+void MavlinkCommandSender::receive_command_ack(const mavlink_message_t& message)
 {
     mavlink_command_ack_t command_ack;
     mavlink_msg_command_ack_decode(&message, &command_ack);
@@ -160,6 +162,7 @@ void MavlinkCommandSender::receive_command_ack(mavlink_message_t message)
                 _parent.unregister_timeout_handler(_timeout_cookie);
                 temp_result = {Result::Success, 1.0f};
                 work_queue_guard.pop_front();
+                _parent.request_work();
                 break;
 
             case MAV_RESULT_DENIED:
@@ -167,6 +170,7 @@ void MavlinkCommandSender::receive_command_ack(mavlink_message_t message)
                 _parent.unregister_timeout_handler(_timeout_cookie);
                 temp_result = {Result::CommandDenied, NAN};
                 work_queue_guard.pop_front();
+                _parent.request_work();
                 break;
 
             case MAV_RESULT_UNSUPPORTED:
@@ -174,6 +178,7 @@ void MavlinkCommandSender::receive_command_ack(mavlink_message_t message)
                 _parent.unregister_timeout_handler(_timeout_cookie);
                 temp_result = {Result::Unsupported, NAN};
                 work_queue_guard.pop_front();
+                _parent.request_work();
                 break;
 
             case MAV_RESULT_TEMPORARILY_REJECTED:
@@ -181,12 +186,14 @@ void MavlinkCommandSender::receive_command_ack(mavlink_message_t message)
                 _parent.unregister_timeout_handler(_timeout_cookie);
                 temp_result = {Result::CommandDenied, NAN};
                 work_queue_guard.pop_front();
+                _parent.request_work();
                 break;
 
             case MAV_RESULT_FAILED:
                 _parent.unregister_timeout_handler(_timeout_cookie);
                 temp_result = {Result::CommandDenied, NAN};
                 work_queue_guard.pop_front();
+                _parent.request_work();
                 break;
 
             case MAV_RESULT_IN_PROGRESS:
@@ -246,6 +253,7 @@ void MavlinkCommandSender::receive_timeout()
                 temp_callback = work->callback;
                 temp_result = {Result::ConnectionError, NAN};
                 work_queue_guard.pop_front();
+                _parent.request_work();
 
             } else {
                 --work->retries_to_do;
@@ -262,6 +270,7 @@ void MavlinkCommandSender::receive_timeout()
             temp_callback = work->callback;
             temp_result = {Result::ConnectionError, NAN};
             work_queue_guard.pop_front();
+            _parent.request_work();
         }
     }
 
@@ -292,6 +301,7 @@ void MavlinkCommandSender::do_work()
                 temp_callback = work->callback;
                 temp_result = {Result::ConnectionError, NAN};
                 work_queue_guard.pop_front();
+                _parent.request_work();
             } else {
                 work->already_sent = true;
                 _parent.register_timeout_handler(
@@ -117,7 +117,7 @@ private:
         dl_time_t time_started{};
     };
 
-    void receive_command_ack(mavlink_message_t message);
+    void receive_command_ack(const mavlink_message_t& message);
     void receive_timeout();
 
     void call_callback(const CommandResultCallback& callback, Result result, float progress);
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace mavsdk {
+
+namespace detail {
+
+constexpr std::array<uint16_t, 256> make_mavlink_crc_table()
+{
+    std::array<uint16_t, 256> table{};
+    for (unsigned i = 0; i < 256; ++i) {
+        unsigned crc = i;
+        for (unsigned bit = 0; bit < 8; ++bit) {
+            // 0x8408 is the polynomial 0x1021 reflected.
+            crc = (crc & 1) ? ((crc >> 1) ^ 0x8408) : (crc >> 1);
+        }
+        table[i] = static_cast<uint16_t>(crc);
+    }
+    return table;
+}
+
+} // namespace detail
+
+// The CRC-16/MCRF4XX used by MAVLink (called X.25 in the MAVLink sources).
+// It gives the same result as crc_accumulate() but uses a lookup table
+// instead of going bit by bit.
+class MavlinkCrc {
+public:
+    static constexpr uint16_t init = 0xffff;
+
+    static uint16_t accumulate(uint8_t data, uint16_t crc)
+    {
+        return static_cast<uint16_t>((crc >> 8) ^ _table[(crc ^ data) & 0xff]);
+    }
+
+    static uint16_t accumulate(const uint8_t* data, std::size_t len, uint16_t crc)
+    {
+        for (std::size_t i = 0; i < len; ++i) {
+            crc = accumulate(data[i], crc);
+        }
+        return crc;
+    }
+
+private:
+    static constexpr std::array<uint16_t, 256> _table = detail::make_mavlink_crc_table();
+};
+
+} // namespace mavsdk
@@ -1,61 +1,125 @@
+#include <atomic>
 #include <mutex>
+#include <thread>
 #include "mavlink_message_handler.h"
 
 namespace mavsdk {
 
+// The dispatches the current thread is in the middle of, innermost first. A handler
+// is allowed to unregister (itself) from within its callback, in which case we
+// must not wait for the dispatches further up the stack of this thread to finish.
+struct Dispatch {
+    const MAVLinkMessageHandler* handler;
+    unsigned parity;
+    Dispatch* outer;
+};
+static thread_local Dispatch* current_dispatch = nullptr;
+
+// The shared message currently dispatched on this thread, if any, for retain().
+static thread_local const MAVLinkMessageHandler::MessagePtr* dispatched_message = nullptr;
+
 void MAVLinkMessageHandler::register_one(uint16_t msg_id, Callback callback, const void* cookie)
 {
     std::lock_guard<std::mutex> lock(_mutex);
 
+    auto new_table = std::make_shared<Table>(*load_table());
+
     Entry entry = {msg_id, callback, cookie};
-    _table.push_back(entry);
+    (*new_table)[msg_id].push_back(entry);
+
+    swap_table(new_table);
 }
 
 void MAVLinkMessageHandler::unregister_one(uint16_t msg_id, const void* cookie)
 {
-    std::lock_guard<std::mutex> lock(_mutex);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        auto new_table = std::make_shared<Table>(*load_table());
+
+        auto bucket = new_table->find(msg_id);
+        if (bucket == new_table->end()) {
+            return;
+        }
+
+        auto& entries = bucket->second;
+        for (auto it = entries.begin(); it != entries.end();
+             /* no ++it */) {
+            if (it->cookie == cookie) {
+                it = entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
 
-    for (auto it = _table.begin(); it != _table.end();
-         /* no ++it */) {
-        if (it->msg_id == msg_id && it->cookie == cookie) {
-            it = _table.erase(it);
-        } else {
-            ++it;
+        if (entries.empty()) {
+            new_table->erase(bucket);
         }
+
+        swap_table(new_table);
     }
+
+    wait_for_dispatches();
 }
 
 void MAVLinkMessageHandler::unregister_all(const void* cookie)
 {
-    std::lock_guard<std::mutex> lock(_mutex);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        auto new_table = std::make_shared<Table>(*load_table());
 
-    for (auto it = _table.begin(); it != _table.end();
-         /* no ++it */) {
-        if (it->cookie == cookie) {
-            it = _table.erase(it);
-        } else {
-            ++it;
+        for (auto bucket = new_table->begin(); bucket != new_table->end();
+             /* no ++bucket */) {
+            auto& entries = bucket->second;
+            for (auto it = entries.begin(); it != entries.end();
+                 /* no ++it */) {
+                if (it->cookie == cookie) {
+                    it = entries.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+
+            if (entries.empty()) {
+                bucket = new_table->erase(bucket);
+            } else {
+                ++bucket;
+            }
         }
+
+        swap_table(new_table);
     }
+
+    wait_for_dispatches();
 }
 
 void MAVLinkMessageHandler::process_message(const mavlink_message_t& message)
 {
-    std::lock_guard<std::mutex> lock(_mutex);
+    // A concurrent unregister waits for us if we might have seen the old table.
+    Dispatch dispatch{this, begin_dispatch(), current_dispatch};
+    current_dispatch = &dispatch;
+
+    const auto table = load_table();
 
 #if MESSAGE_DEBUGGING == 1
     bool forwarded = false;
 #endif
-    for (auto it = _table.begin(); it != _table.end(); ++it) {
-        if (it->msg_id == message.msgid) {
+    const auto bucket = table->find(message.msgid);
+    if (bucket != table->end()) {
+        for (const auto& entry : bucket->second) {
 #if MESSAGE_DEBUGGING == 1
-            LogDebug() << "Forwarding msg " << int(message.msgid) << " to " << size_t(it->cookie);
+            LogDebug() << "Forwarding msg " << int(message.msgid) << " to "
+                       << size_t(entry.cookie);
             forwarded = true;
 #endif
-            it->callback(message);
+            entry.callback(message);
         }
     }
 
+    current_dispatch = dispatch.outer;
+    end_dispatch(dispatch.parity);
+
 #if MESSAGE_DEBUGGING == 1
     if (!forwarded) {
         LogDebug() << "Ignoring msg " << int(message.msgid);
@@ -63,4 +127,87 @@ void MAVLinkMessageHandler::process_message(const mavlink_message_t& message)
 #endif
 }
 
+void MAVLinkMessageHandler::process_message(const MessagePtr& message)
+{
+    // Callbacks can dispatch other messages, so we need to restore what was there.
+    const auto previous = dispatched_message;
+    dispatched_message = &message;
+    process_message(*message);
+    dispatched_message = previous;
+}
+
+MAVLinkMessageHandler::MessagePtr MAVLinkMessageHandler::retain(const mavlink_message_t& message)
+{
+    if (dispatched_message != nullptr && dispatched_message->get() == &message) {
+        return *dispatched_message;
+    }
+    return std::make_shared<const mavlink_message_t>(message);
+}
+
+std::shared_ptr<const MAVLinkMessageHandler::Table> MAVLinkMessageHandler::load_table() const
+{
+    // With libstdc++ this takes one of a few internal spinlocks for the copy, which is
+    // only ever held for a moment, unlike _mutex.
+    return std::atomic_load_explicit(&_table, std::memory_order_acquire);
+}
+
+void MAVLinkMessageHandler::swap_table(std::shared_ptr<const Table> new_table)
+{
+    std::atomic_store_explicit(&_table, new_table, std::memory_order_seq_cst);
+}
+
+unsigned MAVLinkMessageHandler::begin_dispatch()
+{
+    while (true) {
+        const unsigned parity = _epoch.load() & 1;
+        ++_dispatches[parity];
+        if ((_epoch.load() & 1) == parity) {
+            return parity;
+        }
+        // The epoch was flipped in between, so the unregister which flipped it
+        // might already be past waiting for this parity.
+        --_dispatches[parity];
+    }
+}
+
+void MAVLinkMessageHandler::end_dispatch(unsigned parity)
+{
+    --_dispatches[parity];
+}
+
+void MAVLinkMessageHandler::wait_for_dispatches()
+{
+    // Once unregister returns, the caller expects that its callback is no longer
+    // called and usually goes on to destroy whatever the callback captured.
+    // Therefore, we need to wait until every dispatch which started before the
+    // table was swapped is done. Dispatches starting after the flip only ever see
+    // the new table, so this does not starve even with a constant stream of messages.
+    std::lock_guard<std::mutex> lock(_wait_mutex);
+
+    const unsigned parity = _epoch++ & 1;
+
+    // If we are called from within a callback, waiting for our own dispatches
+    // would deadlock.
+    unsigned own_dispatches = 0;
+    for (auto dispatch = current_dispatch; dispatch != nullptr; dispatch = dispatch->outer) {
+        if (dispatch->handler == this && dispatch->parity == parity) {
+            ++own_dispatches;
+        }
+    }
+
+    while (_dispatches[parity].load() > own_dispatches) {
+        std::this_thread::yield();
+    }
+
+    // Our own dispatches go on with the old table once we return, so the next
+    // unregister has to wait for them as well.
+    for (auto dispatch = current_dispatch; dispatch != nullptr; dispatch = dispatch->outer) {
+        if (dispatch->handler == this && dispatch->parity == parity) {
+            dispatch->parity = parity ^ 1;
+            ++_dispatches[parity ^ 1];
+            --_dispatches[parity];
+        }
+    }
+}
+
 } // namespace mavsdk
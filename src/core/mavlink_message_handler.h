@@ -1,8 +1,12 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <mutex>
+#include <unordered_map>
 #include <vector>
 #include "mavlink_include.h"
 
@@ -11,6 +15,7 @@ namespace mavsdk {
 class MAVLinkMessageHandler {
 public:
     using Callback = std::function<void(const mavlink_message_t&)>;
+    using MessagePtr = std::shared_ptr<const mavlink_message_t>;
 
     struct Entry {
         uint16_t msg_id;
@@ -23,9 +28,43 @@ public:
     void unregister_all(const void* cookie);
     void process_message(const mavlink_message_t& message);
 
+    // Same as above but callbacks can hold on to the message using retain().
+    void process_message(const MessagePtr& message);
+
+    // Returns a pointer to a message which can be kept beyond the callback.
+    // For a message dispatched as MessagePtr this is the message itself, so
+    // nothing is copied, otherwise it is a copy.
+    static MessagePtr retain(const mavlink_message_t& message);
+
 private:
+    // The handlers are bucketed by message ID so that dispatching a message only
+    // touches the handlers interested in it.
+    //
+    // The table is never modified in place. Writers copy it, change the copy, and
+    // swap it in. This way process_message works on a snapshot and never waits for
+    // a writer, which matters because it runs for every single incoming message.
+    using Table = std::unordered_map<uint32_t, std::vector<Entry>>;
+
+    std::shared_ptr<const Table> load_table() const;
+    void swap_table(std::shared_ptr<const Table> new_table);
+
+    // Dispatches are counted by the parity of the epoch they started in. After
+    // flipping the epoch, no dispatch can start with the old parity anymore, so
+    // once its count drops to zero, all dispatches which might still have been
+    // using a table swapped out before the flip are done.
+    unsigned begin_dispatch();
+    void end_dispatch(unsigned parity);
+    void wait_for_dispatches();
+
+    // Only serializes writers, the receive path does not use it.
     std::mutex _mutex{};
-    std::vector<Entry> _table{};
+    std::shared_ptr<const Table> _table{std::make_shared<const Table>()};
+
+    // Serializes waiting for dispatches, separately so registering does not have
+    // to wait for an unregister in progress.
+    std::mutex _wait_mutex{};
+    std::atomic<unsigned> _epoch{0};
+    std::array<std::atomic<unsigned>, 2> _dispatches{};
 };
 
 } // namespace mavsdk
@@ -0,0 +1,245 @@
+#include "mavlink_message_handler.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace mavsdk;
+
+static mavlink_message_t make_message(uint32_t msg_id)
+{
+    mavlink_message_t message{};
+    message.msgid = msg_id;
+    return message;
+}
+
+TEST(MAVLinkMessageHandler, DispatchesByMessageId)
+{
+    MAVLinkMessageHandler handler;
+
+    int heartbeat_count = 0;
+    int attitude_count = 0;
+    const int cookie = 0;
+
+    handler.register_one(
+        MAVLINK_MSG_ID_HEARTBEAT, [&](const mavlink_message_t&) { ++heartbeat_count; }, &cookie);
+    handler.register_one(
+        MAVLINK_MSG_ID_ATTITUDE, [&](const mavlink_message_t&) { ++attitude_count; }, &cookie);
+
+    handler.process_message(make_message(MAVLINK_MSG_ID_HEARTBEAT));
+    handler.process_message(make_message(MAVLINK_MSG_ID_HEARTBEAT));
+    handler.process_message(make_message(MAVLINK_MSG_ID_ATTITUDE));
+    handler.process_message(make_message(MAVLINK_MSG_ID_SYS_STATUS));
+
+    EXPECT_EQ(heartbeat_count, 2);
+    EXPECT_EQ(attitude_count, 1);
+}
+
+TEST(MAVLinkMessageHandler, UnregisterOneAndAll)
+{
+    MAVLinkMessageHandler handler;
+
+    int first_count = 0;
+    int second_count = 0;
+    const int first_cookie = 0;
+    const int second_cookie = 0;
+
+    handler.register_one(
+        MAVLINK_MSG_ID_HEARTBEAT, [&](const mavlink_message_t&) { ++first_count; }, &first_cookie);
+    handler.register_one(
+        MAVLINK_MSG_ID_ATTITUDE, [&](const mavlink_message_t&) { ++first_count; }, &first_cookie);
+    handler.register_one(
+        MAVLINK_MSG_ID_HEARTBEAT,
+        [&](const mavlink_message_t&) { ++second_count; },
+        &second_cookie);
+
+    handler.unregister_one(MAVLINK_MSG_ID_HEARTBEAT, &first_cookie);
+    handler.process_message(make_message(MAVLINK_MSG_ID_HEARTBEAT));
+    handler.process_message(make_message(MAVLINK_MSG_ID_ATTITUDE));
+    EXPECT_EQ(first_count, 1);
+    EXPECT_EQ(second_count, 1);
+
+    handler.unregister_all(&first_cookie);
+    handler.process_message(make_message(MAVLINK_MSG_ID_HEARTBEAT));
+    handler.process_message(make_message(MAVLINK_MSG_ID_ATTITUDE));
+    EXPECT_EQ(first_count, 1);
+    EXPECT_EQ(second_count, 2);
+}
+
+TEST(MAVLinkMessageHandler, UnregisterFromWithinCallback)
+{
+    MAVLinkMessageHandler handler;
+
+    int count = 0;
+    const int cookie = 0;
+
+    handler.register_one(
+        MAVLINK_MSG_ID_HEARTBEAT,
+        [&](const mavlink_message_t&) {
+            ++count;
+            // This must not deadlock.
+            handler.unregister_all(&cookie);
+        },
+        &cookie);
+
+    handler.process_message(make_message(MAVLINK_MSG_ID_HEARTBEAT));
+    handler.process_message(make_message(MAVLINK_MSG_ID_HEARTBEAT));
+    EXPECT_EQ(count, 1);
+}
+
+TEST(MAVLinkMessageHandler, NoCallbackAfterUnregister)
+{
+    MAVLinkMessageHandler handler;
+
+    std::atomic<bool> should_exit{false};
+    std::atomic<bool> unregistered{false};
+    std::atomic<bool> called_after_unregister{false};
+    const int cookie = 0;
+
+    handler.register_one(
+        MAVLINK_MSG_ID_HEARTBEAT,
+        [&](const mavlink_message_t&) {
+            if (unregistered) {
+                called_after_unregister = true;
+            }
+        },
+        &cookie);
+
+    std::thread receiver([&]() {
+        while (!should_exit) {
+            handler.process_message(make_message(MAVLINK_MSG_ID_HEARTBEAT));
+        }
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    handler.unregister_all(&cookie);
+    unregistered = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    should_exit = true;
+    receiver.join();
+
+    EXPECT_FALSE(called_after_unregister);
+}
+
+TEST(MAVLinkMessageHandler, RetainSharesDispatchedMessage)
+{
+    MAVLinkMessageHandler handler;
+
+    MAVLinkMessageHandler::MessagePtr retained;
+    const int cookie = 0;
+
+    handler.register_one(
+        MAVLINK_MSG_ID_HEARTBEAT,
+        [&](const mavlink_message_t& message) { retained = MAVLinkMessageHandler::retain(message); },
+        &cookie);
+
+    const auto message = std::make_shared<const mavlink_message_t>(
+        make_message(MAVLINK_MSG_ID_HEARTBEAT));
+    handler.process_message(message);
+    EXPECT_EQ(retained, message);
+
+    // Without a shared message to hand out, it has to be copied.
+    const auto other_message = make_message(MAVLINK_MSG_ID_HEARTBEAT);
+    handler.process_message(other_message);
+    ASSERT_TRUE(retained);
+    EXPECT_NE(retained.get(), &other_message);
+    EXPECT_EQ(retained->msgid, MAVLINK_MSG_ID_HEARTBEAT);
+}
+
+TEST(MAVLinkMessageHandler, UnregisterFromOtherHandlerCallbackWaitsForDispatch)
+{
+    MAVLinkMessageHandler handler;
+    MAVLinkMessageHandler other_handler;
+
+    std::atomic<bool> in_callback{false};
+    std::atomic<bool> callback_done{false};
+    const int cookie = 0;
+
+    handler.register_one(
+        MAVLINK_MSG_ID_HEARTBEAT,
+        [&](const mavlink_message_t&) {
+            in_callback = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            callback_done = true;
+        },
+        &cookie);
+
+    std::thread receiver(
+        [&]() { handler.process_message(make_message(MAVLINK_MSG_ID_HEARTBEAT)); });
+
+    while (!in_callback) {
+        std::this_thread::yield();
+    }
+
+    // Being in the middle of dispatching on another handler must not skip the wait.
+    bool done_after_unregister = false;
+    other_handler.register_one(
+        MAVLINK_MSG_ID_HEARTBEAT,
+        [&](const mavlink_message_t&) {
+            handler.unregister_all(&cookie);
+            done_after_unregister = callback_done;
+        },
+        &cookie);
+    other_handler.process_message(make_message(MAVLINK_MSG_ID_HEARTBEAT));
+
+    receiver.join();
+    EXPECT_TRUE(done_after_unregister);
+}
+
+TEST(MAVLinkMessageHandler, UnregisterWaitsForDispatchesOfEarlierTables)
+{
+    MAVLinkMessageHandler handler;
+
+    std::atomic<bool> in_callback{false};
+    std::atomic<bool> release_callback{false};
+    std::atomic<bool> second_called_after_unregister{false};
+    std::atomic<bool> second_unregistered{false};
+    const int first_cookie = 0;
+    const int second_cookie = 0;
+
+    handler.register_one(
+        MAVLINK_MSG_ID_HEARTBEAT,
+        [&](const mavlink_message_t&) {
+            in_callback = true;
+            while (!release_callback) {
+                std::this_thread::yield();
+            }
+        },
+        &first_cookie);
+    handler.register_one(
+        MAVLINK_MSG_ID_HEARTBEAT,
+        [&](const mavlink_message_t&) {
+            if (second_unregistered) {
+                second_called_after_unregister = true;
+            }
+        },
+        &second_cookie);
+
+    std::thread receiver(
+        [&]() { handler.process_message(make_message(MAVLINK_MSG_ID_HEARTBEAT)); });
+
+    while (!in_callback) {
+        std::this_thread::yield();
+    }
+
+    // The first unregister swaps out the table the receiver is dispatching from,
+    // the second one swaps out the table after. Both have to wait for the receiver.
+    const int unused_cookie = 0;
+    std::thread first_unregister(
+        [&]() { handler.unregister_one(MAVLINK_MSG_ID_HEARTBEAT, &unused_cookie); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    std::thread second_unregister([&]() {
+        handler.unregister_all(&second_cookie);
+        second_unregistered = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_FALSE(second_unregistered);
+
+    release_callback = true;
+    receiver.join();
+    first_unregister.join();
+    second_unregister.join();
+    EXPECT_TRUE(second_unregistered);
+    EXPECT_FALSE(second_called_after_unregister);
+}
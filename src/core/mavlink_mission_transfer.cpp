@@ -5,10 +5,14 @@
 namespace mavsdk {
 
 MAVLinkMissionTransfer::MAVLinkMissionTransfer(
-    Sender& sender, MAVLinkMessageHandler& message_handler, TimeoutHandler& timeout_handler) :
+    Sender& sender,
+    MAVLinkMessageHandler& message_handler,
+    TimeoutHandler& timeout_handler,
+    std::function<void()> request_work) :
     _sender(sender),
     _message_handler(message_handler),
-    _timeout_handler(timeout_handler)
+    _timeout_handler(timeout_handler),
+    _request_work(request_work)
 {}
 
 MAVLinkMissionTransfer::~MAVLinkMissionTransfer() {}
@@ -17,9 +21,10 @@ std::weak_ptr<MAVLinkMissionTransfer::WorkItem> MAVLinkMissionTransfer::upload_i
     uint8_t type, const std::vector<ItemInt>& items, ResultCallback callback)
 {
     auto ptr = std::make_shared<UploadWorkItem>(
-        _sender, _message_handler, _timeout_handler, type, items, callback);
+        _sender, _message_handler, _timeout_handler, type, items, with_request_work(callback));
 
     _work_queue.push_back(ptr);
+    request_work();
 
     return std::weak_ptr<WorkItem>(ptr);
 }
@@ -28,9 +33,10 @@ std::weak_ptr<MAVLinkMissionTransfer::WorkItem>
 MAVLinkMissionTransfer::download_items_async(uint8_t type, ResultAndItemsCallback callback)
 {
     auto ptr = std::make_shared<DownloadWorkItem>(
-        _sender, _message_handler, _timeout_handler, type, callback);
+        _sender, _message_handler, _timeout_handler, type, with_request_work(callback));
 
     _work_queue.push_back(ptr);
+    request_work();
 
     return std::weak_ptr<WorkItem>(ptr);
 }
@@ -38,17 +44,19 @@ MAVLinkMissionTransfer::download_items_async(uint8_t type, ResultAndItemsCallbac
 void MAVLinkMissionTransfer::clear_items_async(uint8_t type, ResultCallback callback)
 {
     auto ptr = std::make_shared<ClearWorkItem>(
-        _sender, _message_handler, _timeout_handler, type, callback);
+        _sender, _message_handler, _timeout_handler, type, with_request_work(callback));
 
     _work_queue.push_back(ptr);
+    request_work();
 }
 
 void MAVLinkMissionTransfer::set_current_item_async(int current, ResultCallback callback)
 {
     auto ptr = std::make_shared<SetCurrentWorkItem>(
-        _sender, _message_handler, _timeout_handler, current, callback);
+        _sender, _message_handler, _timeout_handler, current, with_request_work(callback));
 
     _work_queue.push_back(ptr);
+    request_work();
 }
 
 void MAVLinkMissionTransfer::do_work()
@@ -65,9 +73,40 @@ void MAVLinkMissionTransfer::do_work()
     }
     if (work->is_done()) {
         work_queue_guard.pop_front();
+        request_work();
+    }
+}
+
+void MAVLinkMissionTransfer::request_work()
+{
+    if (_request_work) {
+        _request_work();
     }
 }
 
+MAVLinkMissionTransfer::ResultCallback
+MAVLinkMissionTransfer::with_request_work(ResultCallback callback)
+{
+    // Once a transfer is done, the next one in the queue can be started.
+    return [this, callback](Result result) {
+        if (callback) {
+            callback(result);
+        }
+        request_work();
+    };
+}
+
+MAVLinkMissionTransfer::ResultAndItemsCallback
+MAVLinkMissionTransfer::with_request_work(ResultAndItemsCallback callback)
+{
+    return [this, callback](Result result, std::vector<ItemInt> items) {
+        if (callback) {
+            callback(result, items);
+        }
+        request_work();
+    };
+}
+
 bool MAVLinkMissionTransfer::is_idle()
 {
     LockedQueue<WorkItem>::Guard work_queue_guard(_work_queue);
@@ -248,8 +248,13 @@ public:
     static constexpr double timeout_s = 0.5;
     static constexpr unsigned retries = 4;
 
+    // request_work is called whenever do_work() has something new to do, e.g.
+    // because a transfer was queued or has finished.
     MAVLinkMissionTransfer(
-        Sender& sender, MAVLinkMessageHandler& message_handler, TimeoutHandler& timeout_handler);
+        Sender& sender,
+        MAVLinkMessageHandler& message_handler,
+        TimeoutHandler& timeout_handler,
+        std::function<void()> request_work = nullptr);
 
     ~MAVLinkMissionTransfer();
 
@@ -273,6 +278,11 @@ private:
     Sender& _sender;
     MAVLinkMessageHandler& _message_handler;
     TimeoutHandler& _timeout_handler;
+    std::function<void()> _request_work;
+
+    void request_work();
+    ResultCallback with_request_work(ResultCallback callback);
+    ResultAndItemsCallback with_request_work(ResultAndItemsCallback callback);
 
     LockedQueue<WorkItem> _work_queue{};
 };
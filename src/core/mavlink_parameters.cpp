@@ -58,6 +58,7 @@ void MAVLinkParameters::set_param_async(
     new_work->cookie = cookie;
 
     _work_queue.push_back(new_work);
+    _parent.request_work();
 }
 
 MAVLinkParameters::Result
@@ -100,6 +101,7 @@ void MAVLinkParameters::get_param_async(
     new_work->cookie = cookie;
 
     _work_queue.push_back(new_work);
+    _parent.request_work();
 }
 
 std::pair<MAVLinkParameters::Result, MAVLinkParameters::ParamValue>
@@ -170,6 +172,8 @@ void MAVLinkParameters::cancel_all_param(const void* cookie)
             ++item;
         }
     }
+
+    _parent.request_work();
 }
 
 void MAVLinkParameters::subscribe_param_changed(
@@ -252,6 +256,7 @@ void MAVLinkParameters::do_work()
                     work->set_param_callback(MAVLinkParameters::Result::ConnectionError);
                 }
                 work_queue_guard.pop_front();
+                _parent.request_work();
                 return;
             }
 
@@ -305,6 +310,7 @@ void MAVLinkParameters::do_work()
                         MAVLinkParameters::Result::ConnectionError, empty_param);
                 }
                 work_queue_guard.pop_front();
+                _parent.request_work();
                 return;
             }
 
@@ -390,6 +396,7 @@ void MAVLinkParameters::process_param_value(const mavlink_message_t& message)
             // LogDebug() << "time taken: " <<
             // _parent.get_time().elapsed_since_s(_last_request_time);
             work_queue_guard.pop_front();
+            _parent.request_work();
         } break;
         case WorkItem::Type::Set: {
             // We are done, inform caller and go back to idle
@@ -401,6 +408,7 @@ void MAVLinkParameters::process_param_value(const mavlink_message_t& message)
             // LogDebug() << "time taken: " <<
             // _parent.get_time().elapsed_since_s(_last_request_time);
             work_queue_guard.pop_front();
+            _parent.request_work();
         } break;
     }
 }
@@ -468,6 +476,7 @@ void MAVLinkParameters::process_param_ext_value(const mavlink_message_t& message
             // LogDebug() << "time taken: " <<
             // _parent.get_time().elapsed_since_s(_last_request_time);
             work_queue_guard.pop_front();
+            _parent.request_work();
         } break;
 
         case WorkItem::Type::Set:
@@ -515,6 +524,7 @@ void MAVLinkParameters::process_param_ext_ack(const mavlink_message_t& message)
                 // LogDebug() << "time taken: " <<
                 // _parent.get_time().elapsed_since_s(_last_request_time);
                 work_queue_guard.pop_front();
+                _parent.request_work();
 
             } else if (param_ext_ack.param_result == PARAM_ACK_IN_PROGRESS) {
                 // Reset timeout and wait again.
@@ -532,6 +542,7 @@ void MAVLinkParameters::process_param_ext_ack(const mavlink_message_t& message)
                 // LogDebug() << "time taken: " <<
                 // _parent.get_time().elapsed_since_s(_last_request_time);
                 work_queue_guard.pop_front();
+                _parent.request_work();
             }
         } break;
     }
@@ -568,6 +579,7 @@ void MAVLinkParameters::receive_timeout()
                 if (!_parent.send_message(work->mavlink_message)) {
                     LogErr() << "connection send error in retransmit (" << work->param_name << ").";
                     work_queue_guard.pop_front();
+                    _parent.request_work();
                     work->get_param_callback(
                         MAVLinkParameters::Result::ConnectionError, empty_value);
                 } else {
@@ -582,6 +594,7 @@ void MAVLinkParameters::receive_timeout()
                 LogErr() << "Error: Retrying failed get param busy timeout: " << work->param_name;
 
                 work_queue_guard.pop_front();
+                _parent.request_work();
 
                 work->get_param_callback(MAVLinkParameters::Result::Timeout, empty_value);
             }
@@ -594,6 +607,7 @@ void MAVLinkParameters::receive_timeout()
                 if (!_parent.send_message(work->mavlink_message)) {
                     LogErr() << "connection send error in retransmit (" << work->param_name << ").";
                     work_queue_guard.pop_front();
+                    _parent.request_work();
                     work->set_param_callback(MAVLinkParameters::Result::ConnectionError);
                 } else {
                     --work->retries_to_do;
@@ -607,6 +621,7 @@ void MAVLinkParameters::receive_timeout()
                 LogErr() << "Error: Retrying failed get param busy timeout: " << work->param_name;
 
                 work_queue_guard.pop_front();
+                _parent.request_work();
                 work->set_param_callback(MAVLinkParameters::Result::Timeout);
             }
         } break;
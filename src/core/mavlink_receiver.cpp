@@ -1,5 +1,8 @@
 #include "mavlink_receiver.h"
+#include "mavlink_crc.h"
 #include "global_include.h"
+#include <atomic>
+#include <cstring>
 
 #if DROP_DEBUG == 1
 #include <iomanip>
@@ -27,14 +30,31 @@ void MAVLinkReceiver::set_new_datagram(char* datagram, unsigned datagram_len)
 
 bool MAVLinkReceiver::parse_message()
 {
+    // Don't overwrite a message someone still holds on to.
+    if (_last_message.use_count() > 1) {
+        _last_message = std::make_shared<mavlink_message_t>();
+    } else {
+        // use_count() is a relaxed load. The last reads of whoever released the
+        // message need to be done before we overwrite it.
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+
     // Note that one datagram can contain multiple mavlink messages.
-    for (unsigned i = 0; i < _datagram_len; ++i) {
-        if (mavlink_parse_char(_channel, _datagram[i], &_last_message, &_status) == 1) {
-            // Move the pointer to the datagram forward by the amount parsed.
-            _datagram += (i + 1);
-            // And decrease the length, so we don't overshoot in the next round.
-            _datagram_len -= (i + 1);
+    while (_datagram_len > 0) {
+        // As long as the byte-wise parser is not in the middle of a message,
+        // whole frames are taken straight out of the datagram. Frames split
+        // across datagrams still need the byte-wise parser.
+        const auto result = parser_is_idle() ? parse_frame() : FrameResult::Incomplete;
+
+        if (result == FrameResult::NoStart) {
+            break;
+        }
 
+        if (result == FrameResult::Invalid) {
+            continue;
+        }
+
+        if (result == FrameResult::Ok || parse_bytes()) {
 #if DROP_DEBUG == 1
             debug_drop_rate();
 #endif
@@ -50,16 +70,180 @@ bool MAVLinkReceiver::parse_message()
     return false;
 }
 
+bool MAVLinkReceiver::parser_is_idle() const
+{
+    return mavlink_get_channel_status(_channel)->parse_state <= MAVLINK_PARSE_STATE_IDLE;
+}
+
+MAVLinkReceiver::FrameResult MAVLinkReceiver::parse_frame()
+{
+    const auto data = reinterpret_cast<const uint8_t*>(_datagram);
+
+    // Skip to the next start of a frame, whichever MAVLink version it is.
+    auto start = static_cast<const uint8_t*>(std::memchr(data, MAVLINK_STX, _datagram_len));
+    const unsigned search_len =
+        (start != nullptr) ? static_cast<unsigned>(start - data) : _datagram_len;
+    const auto start_v1 =
+        static_cast<const uint8_t*>(std::memchr(data, MAVLINK_STX_MAVLINK1, search_len));
+    if (start_v1 != nullptr) {
+        start = start_v1;
+    }
+
+    if (start == nullptr) {
+        consume(_datagram_len);
+        return FrameResult::NoStart;
+    }
+    consume(static_cast<unsigned>(start - data));
+
+    const auto frame = reinterpret_cast<const uint8_t*>(_datagram);
+    const bool is_v1 = (frame[0] == MAVLINK_STX_MAVLINK1);
+    const unsigned header_len =
+        1 + (is_v1 ? MAVLINK_CORE_HEADER_MAVLINK1_LEN : MAVLINK_CORE_HEADER_LEN);
+
+    if (_datagram_len < header_len) {
+        return FrameResult::Incomplete;
+    }
+
+    const uint8_t payload_len = frame[1];
+    uint8_t incompat_flags = 0;
+    uint8_t compat_flags = 0;
+    uint8_t seq;
+    uint8_t sysid;
+    uint8_t compid;
+    uint32_t msgid;
+
+    if (is_v1) {
+        seq = frame[2];
+        sysid = frame[3];
+        compid = frame[4];
+        msgid = frame[5];
+    } else {
+        incompat_flags = frame[2];
+        if ((incompat_flags & ~MAVLINK_IFLAG_MASK) != 0) {
+            // The byte-wise parser rejects flags it doesn't know as well.
+            mavlink_get_channel_status(_channel)->parse_error++;
+            consume(1);
+            return FrameResult::Invalid;
+        }
+        if ((incompat_flags & MAVLINK_IFLAG_SIGNED) != 0) {
+            // We leave checking signatures to the byte-wise parser.
+            return FrameResult::Unsupported;
+        }
+        compat_flags = frame[3];
+        seq = frame[4];
+        sysid = frame[5];
+        compid = frame[6];
+        msgid = frame[7] | (frame[8] << 8) | (frame[9] << 16);
+    }
+
+    const unsigned frame_len = header_len + payload_len + MAVLINK_NUM_CHECKSUM_BYTES;
+    if (_datagram_len < frame_len) {
+        return FrameResult::Incomplete;
+    }
+
+    // Without the CRC extra of a message, we can't check it.
+    const mavlink_msg_entry_t* entry = mavlink_get_msg_entry(msgid);
+    if (entry == nullptr) {
+        return FrameResult::Unsupported;
+    }
+
+    // The CRC covers everything but the start byte, plus the CRC extra.
+    uint16_t crc =
+        MavlinkCrc::accumulate(frame + 1, header_len - 1 + payload_len, MavlinkCrc::init);
+    crc = MavlinkCrc::accumulate(entry->crc_extra, crc);
+
+    const uint8_t ck0 = frame[header_len + payload_len];
+    const uint8_t ck1 = frame[header_len + payload_len + 1];
+    if (ck0 != (crc & 0xff) || ck1 != (crc >> 8)) {
+        // Only skip the start byte, a valid frame might start within this one.
+        mavlink_get_channel_status(_channel)->parse_error++;
+        consume(1);
+        return FrameResult::Invalid;
+    }
+
+    _last_message->magic = frame[0];
+    _last_message->len = payload_len;
+    _last_message->incompat_flags = incompat_flags;
+    _last_message->compat_flags = compat_flags;
+    _last_message->seq = seq;
+    _last_message->sysid = sysid;
+    _last_message->compid = compid;
+    _last_message->msgid = msgid;
+    _last_message->checksum = crc;
+    _last_message->ck[0] = ck0;
+    _last_message->ck[1] = ck1;
+
+    auto payload = reinterpret_cast<uint8_t*>(_MAV_PAYLOAD_NON_CONST(_last_message.get()));
+    std::memcpy(payload, frame + header_len, payload_len);
+    // MAVLink 2 truncates trailing zeros, so we fill them in again, the same
+    // way the byte-wise parser does.
+    if (payload_len < entry->max_msg_len) {
+        std::memset(payload + payload_len, 0, entry->max_msg_len - payload_len);
+    }
+
+    // Keep the channel status the same as if the byte-wise parser had seen
+    // the message, so it can carry on from here.
+    mavlink_status_t* status = mavlink_get_channel_status(_channel);
+    if (is_v1) {
+        status->flags |= MAVLINK_STATUS_FLAG_IN_MAVLINK1;
+    } else {
+        status->flags &= ~MAVLINK_STATUS_FLAG_IN_MAVLINK1;
+    }
+    status->msg_received = MAVLINK_FRAMING_OK;
+    status->current_rx_seq = seq;
+    if (status->packet_rx_success_count == 0) {
+        status->packet_rx_drop_count = 0;
+    }
+    status->packet_rx_success_count++;
+
+    _status.parse_state = status->parse_state;
+    _status.packet_idx = 0;
+    _status.current_rx_seq = static_cast<uint8_t>(status->current_rx_seq + 1);
+    _status.packet_rx_success_count = status->packet_rx_success_count;
+    _status.packet_rx_drop_count = status->parse_error;
+    _status.flags = status->flags;
+    status->parse_error = 0;
+
+    consume(frame_len);
+    return FrameResult::Ok;
+}
+
+bool MAVLinkReceiver::parse_bytes()
+{
+    // Keep going until a message is complete, or until the parser is idle
+    // again, so the fast path can take over.
+    while (_datagram_len > 0) {
+        const auto c = static_cast<uint8_t>(_datagram[0]);
+        consume(1);
+
+        if (mavlink_parse_char(_channel, c, _last_message.get(), &_status) == MAVLINK_FRAMING_OK) {
+            return true;
+        }
+
+        if (parser_is_idle()) {
+            return false;
+        }
+    }
+
+    return false;
+}
+
+void MAVLinkReceiver::consume(unsigned len)
+{
+    _datagram += len;
+    _datagram_len -= len;
+}
+
 #if DROP_DEBUG == 1
 void MAVLinkReceiver::debug_drop_rate()
 {
-    if (_last_message.msgid == MAVLINK_MSG_ID_SYS_STATUS) {
-        const unsigned msg_len = (_last_message.len + MAVLINK_NUM_NON_PAYLOAD_BYTES);
+    if (_last_message->msgid == MAVLINK_MSG_ID_SYS_STATUS) {
+        const unsigned msg_len = (_last_message->len + MAVLINK_NUM_NON_PAYLOAD_BYTES);
 
         _bytes_received -= msg_len;
 
         mavlink_sys_status_t sys_status;
-        mavlink_msg_sys_status_decode(&_last_message, &sys_status);
+        mavlink_msg_sys_status_decode(_last_message.get(), &sys_status);
 
         if (!_first) {
             LogDebug() << "-------------------------------------------------------------------"
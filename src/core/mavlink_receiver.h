@@ -3,6 +3,7 @@
 #include "mavlink_include.h"
 #include "global_include.h"
 #include <cstdint>
+#include <memory>
 
 namespace mavsdk {
 
@@ -12,7 +13,11 @@ public:
 
     uint8_t get_channel() { return _channel; }
 
-    mavlink_message_t& get_last_message() { return _last_message; }
+    mavlink_message_t& get_last_message() { return *_last_message; }
+
+    // The last message can be shared instead of copied. If it is still held on
+    // to when the next message is parsed, that one goes into a new buffer.
+    std::shared_ptr<mavlink_message_t> get_last_message_ptr() { return _last_message; }
 
     mavlink_status_t& get_status() { return _status; }
 
@@ -31,8 +36,21 @@ public:
 #endif
 
 private:
+    enum class FrameResult {
+        Ok, // A whole message has been parsed.
+        NoStart, // There is no start of a frame left.
+        Invalid, // This is not a valid frame, e.g. because of a bad CRC.
+        Incomplete, // The frame continues in the next datagram.
+        Unsupported, // This needs to go through the byte-wise parser.
+    };
+
+    bool parser_is_idle() const;
+    FrameResult parse_frame();
+    bool parse_bytes();
+    void consume(unsigned len);
+
     uint8_t _channel;
-    mavlink_message_t _last_message = {};
+    std::shared_ptr<mavlink_message_t> _last_message{std::make_shared<mavlink_message_t>()};
     mavlink_status_t _status = {};
     char* _datagram = nullptr;
     unsigned _datagram_len = 0;
@@ -0,0 +1,215 @@
+#include "mavlink_receiver.h"
+#include "mavlink_channels.h"
+#include "mavlink_crc.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace mavsdk;
+
+namespace {
+
+class MAVLinkReceiverTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(MAVLinkChannels::Instance().checkout_free_channel(channel));
+        ASSERT_TRUE(MAVLinkChannels::Instance().checkout_free_channel(reference_channel));
+        ASSERT_TRUE(MAVLinkChannels::Instance().checkout_free_channel(send_channel));
+        mavlink_get_channel_status(send_channel)->flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+    }
+
+    void TearDown() override
+    {
+        MAVLinkChannels::Instance().checkin_used_channel(channel);
+        MAVLinkChannels::Instance().checkin_used_channel(reference_channel);
+        MAVLinkChannels::Instance().checkin_used_channel(send_channel);
+    }
+
+    void append_attitude(std::vector<char>& data, float roll)
+    {
+        mavlink_message_t message;
+        mavlink_msg_attitude_pack_chan(
+            1, 1, send_channel, &message, 42, roll, 0.5f, 0.0f, 0.0f, 0.0f, 0.0f);
+        append(data, message);
+    }
+
+    void append_heartbeat(std::vector<char>& data)
+    {
+        mavlink_message_t message;
+        mavlink_msg_heartbeat_pack_chan(
+            1, 1, send_channel, &message, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_PX4, 0, 0, 0);
+        append(data, message);
+    }
+
+    static void append(std::vector<char>& data, const mavlink_message_t& message)
+    {
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        const uint16_t len = mavlink_msg_to_send_buffer(buffer, &message);
+        data.insert(data.end(), buffer, buffer + len);
+    }
+
+    std::vector<mavlink_message_t> parse(std::vector<char>& data, std::size_t chunk_size)
+    {
+        std::vector<mavlink_message_t> messages;
+        MAVLinkReceiver receiver(channel);
+        for (std::size_t i = 0; i < data.size(); i += chunk_size) {
+            const auto len = std::min(chunk_size, data.size() - i);
+            receiver.set_new_datagram(&data[i], static_cast<unsigned>(len));
+            while (receiver.parse_message()) {
+                messages.push_back(receiver.get_last_message());
+            }
+        }
+        return messages;
+    }
+
+    std::vector<mavlink_message_t> parse_byte_wise(const std::vector<char>& data)
+    {
+        std::vector<mavlink_message_t> messages;
+        mavlink_message_t message;
+        mavlink_status_t status;
+        for (const char c : data) {
+            if (mavlink_parse_char(reference_channel, static_cast<uint8_t>(c), &message, &status) ==
+                MAVLINK_FRAMING_OK) {
+                messages.push_back(message);
+            }
+        }
+        return messages;
+    }
+
+    static void expect_same(const mavlink_message_t& lhs, const mavlink_message_t& rhs)
+    {
+        EXPECT_EQ(lhs.msgid, rhs.msgid);
+        EXPECT_EQ(lhs.magic, rhs.magic);
+        EXPECT_EQ(lhs.len, rhs.len);
+        EXPECT_EQ(lhs.seq, rhs.seq);
+        EXPECT_EQ(lhs.sysid, rhs.sysid);
+        EXPECT_EQ(lhs.compid, rhs.compid);
+        EXPECT_EQ(lhs.checksum, rhs.checksum);
+        EXPECT_EQ(0, std::memcmp(_MAV_PAYLOAD(&lhs), _MAV_PAYLOAD(&rhs), lhs.len));
+    }
+
+    uint8_t channel{0};
+    uint8_t reference_channel{0};
+    uint8_t send_channel{0};
+};
+
+} // namespace
+
+TEST(MavlinkCrc, SameAsCrcAccumulate)
+{
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> distribution(0, 255);
+
+    uint16_t expected = X25_INIT_CRC;
+    uint16_t crc = MavlinkCrc::init;
+    for (unsigned i = 0; i < 1000; ++i) {
+        const auto byte = static_cast<uint8_t>(distribution(generator));
+        crc_accumulate(byte, &expected);
+        crc = MavlinkCrc::accumulate(byte, crc);
+        ASSERT_EQ(crc, expected);
+    }
+}
+
+TEST_F(MAVLinkReceiverTest, ParsesSeveralMessagesInOneDatagram)
+{
+    std::vector<char> data;
+    append_heartbeat(data);
+    append_attitude(data, 0.1f);
+    append_attitude(data, 0.2f);
+
+    const auto messages = parse(data, data.size());
+    ASSERT_EQ(messages.size(), 3u);
+    EXPECT_EQ(messages[0].msgid, MAVLINK_MSG_ID_HEARTBEAT);
+    EXPECT_EQ(mavlink_msg_heartbeat_get_type(&messages[0]), MAV_TYPE_QUADROTOR);
+    EXPECT_EQ(messages[1].msgid, MAVLINK_MSG_ID_ATTITUDE);
+    EXPECT_FLOAT_EQ(mavlink_msg_attitude_get_roll(&messages[1]), 0.1f);
+    EXPECT_FLOAT_EQ(mavlink_msg_attitude_get_roll(&messages[2]), 0.2f);
+    // Trailing zeros truncated by MAVLink 2 are filled in again.
+    EXPECT_FLOAT_EQ(mavlink_msg_attitude_get_yawspeed(&messages[2]), 0.0f);
+}
+
+TEST_F(MAVLinkReceiverTest, ParsesMavlink1)
+{
+    mavlink_get_channel_status(send_channel)->flags |= MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+
+    std::vector<char> data;
+    append_attitude(data, 0.3f);
+    append_heartbeat(data);
+
+    const auto messages = parse(data, data.size());
+    ASSERT_EQ(messages.size(), 2u);
+    EXPECT_EQ(messages[0].magic, MAVLINK_STX_MAVLINK1);
+    EXPECT_FLOAT_EQ(mavlink_msg_attitude_get_roll(&messages[0]), 0.3f);
+    EXPECT_EQ(messages[1].msgid, MAVLINK_MSG_ID_HEARTBEAT);
+}
+
+TEST_F(MAVLinkReceiverTest, SkipsCorruptedMessage)
+{
+    std::vector<char> data;
+    append_attitude(data, 0.1f);
+    const auto corrupted_begin = data.size();
+    append_attitude(data, 0.2f);
+    append_attitude(data, 0.3f);
+
+    data[corrupted_begin + 12] ^= 0x55;
+
+    const auto messages = parse(data, data.size());
+    ASSERT_EQ(messages.size(), 2u);
+    EXPECT_FLOAT_EQ(mavlink_msg_attitude_get_roll(&messages[0]), 0.1f);
+    EXPECT_FLOAT_EQ(mavlink_msg_attitude_get_roll(&messages[1]), 0.3f);
+}
+
+TEST_F(MAVLinkReceiverTest, SameAsByteWiseParser)
+{
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> distribution(0, 255);
+
+    std::vector<char> data;
+    for (unsigned i = 0; i < 200; ++i) {
+        switch (distribution(generator) % 4) {
+            case 0:
+                append_heartbeat(data);
+                break;
+            case 1:
+                // Some garbage in between, e.g. from a noisy serial link. A start
+                // byte would make the byte-wise parser swallow the next message.
+                data.push_back(static_cast<char>(distribution(generator) % MAVLINK_STX));
+                break;
+            default:
+                append_attitude(data, static_cast<float>(distribution(generator)));
+                break;
+        }
+    }
+
+    const auto expected = parse_byte_wise(data);
+
+    // Messages split across datagrams need to be parsed just the same.
+    for (const std::size_t chunk_size : {data.size(), std::size_t(1400), std::size_t(17)}) {
+        const auto messages = parse(data, chunk_size);
+        ASSERT_EQ(messages.size(), expected.size());
+        for (std::size_t i = 0; i < messages.size(); ++i) {
+            expect_same(messages[i], expected[i]);
+        }
+    }
+}
+
+TEST_F(MAVLinkReceiverTest, DoesNotOverwriteRetainedMessage)
+{
+    std::vector<char> data;
+    append_attitude(data, 0.1f);
+    append_attitude(data, 0.2f);
+
+    MAVLinkReceiver receiver(channel);
+    receiver.set_new_datagram(data.data(), static_cast<unsigned>(data.size()));
+
+    ASSERT_TRUE(receiver.parse_message());
+    const auto first = receiver.get_last_message_ptr();
+    ASSERT_TRUE(receiver.parse_message());
+    const auto second = receiver.get_last_message_ptr();
+
+    EXPECT_NE(first, second);
+    EXPECT_FLOAT_EQ(mavlink_msg_attitude_get_roll(first.get()), 0.1f);
+    EXPECT_FLOAT_EQ(mavlink_msg_attitude_get_roll(second.get()), 0.2f);
+}
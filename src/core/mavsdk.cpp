@@ -103,14 +103,22 @@ Mavsdk::Configuration::Configuration(
     _system_id(system_id),
     _component_id(component_id),
     _always_send_heartbeats(always_send_heartbeats),
-    _usage_type(Mavsdk::Configuration::UsageType::Custom)
+    _usage_type(Mavsdk::Configuration::UsageType::Custom),
+    _user_callback_overflow_policy(UserCallbackOverflowPolicy::DropNewest),
+    _num_user_callback_threads(1),
+    _use_io_loop(false),
+    _udp_send_batching(false)
 {}
 
 Mavsdk::Configuration::Configuration(UsageType usage_type) :
     _system_id(MavsdkImpl::DEFAULT_SYSTEM_ID_GCS),
     _component_id(MavsdkImpl::DEFAULT_COMPONENT_ID_GCS),
     _always_send_heartbeats(false),
-    _usage_type(usage_type)
+    _usage_type(usage_type),
+    _user_callback_overflow_policy(UserCallbackOverflowPolicy::DropNewest),
+    _num_user_callback_threads(1),
+    _use_io_loop(false),
+    _udp_send_batching(false)
 {
     switch (usage_type) {
         case Mavsdk::Configuration::UsageType::GroundStation:
@@ -174,4 +182,45 @@ void Mavsdk::Configuration::set_usage_type(Mavsdk::Configuration::UsageType usag
     _usage_type = usage_type;
 }
 
+Mavsdk::Configuration::UserCallbackOverflowPolicy
+Mavsdk::Configuration::get_user_callback_overflow_policy() const
+{
+    return _user_callback_overflow_policy;
+}
+
+void Mavsdk::Configuration::set_user_callback_overflow_policy(UserCallbackOverflowPolicy policy)
+{
+    _user_callback_overflow_policy = policy;
+}
+
+unsigned Mavsdk::Configuration::get_num_user_callback_threads() const
+{
+    return _num_user_callback_threads;
+}
+
+void Mavsdk::Configuration::set_num_user_callback_threads(unsigned num_threads)
+{
+    _num_user_callback_threads = (num_threads > 0) ? num_threads : 1;
+}
+
+bool Mavsdk::Configuration::get_use_io_loop() const
+{
+    return _use_io_loop;
+}
+
+void Mavsdk::Configuration::set_use_io_loop(bool use_io_loop)
+{
+    _use_io_loop = use_io_loop;
+}
+
+bool Mavsdk::Configuration::get_udp_send_batching() const
+{
+    return _udp_send_batching;
+}
+
+void Mavsdk::Configuration::set_udp_send_batching(bool udp_send_batching)
+{
+    _udp_send_batching = udp_send_batching;
+}
+
 } // namespace mavsdk
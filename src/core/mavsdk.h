@@ -158,6 +158,24 @@ public:
                       provided */
         };
 
+        /**
+         * @brief What to do with a user callback when the callback queue is full.
+         *
+         * User callbacks are queued and called from one thread, or several (see
+         * set_num_user_callback_threads). If they are not processed fast enough, the
+         * queue can run full.
+         */
+        enum class UserCallbackOverflowPolicy {
+            DropNewest, /**< @brief Drop the callback that is about to be queued (default). */
+            DropOldest, /**< @brief Drop the callback that has been queued the longest. */
+            Coalesce, /**< @brief Once the queue has overflown, only the most recent of the
+                         queued callbacks of a subscription is called, for subscriptions
+                         which opted in (see TelemetryExtended::SubscriptionOptions). To make
+                         space, such superseded callbacks are dropped first, and only if there
+                         are none the oldest callback is dropped like with DropOldest. Other
+                         callbacks, e.g. results of requests, are never coalesced. */
+        };
+
         /**
          * @brief Create new Configuration via manually configured
          * system and component ID.
@@ -218,11 +236,83 @@ public:
          */
         void set_usage_type(UsageType usage_type);
 
+        /**
+         * @brief Get the policy used when the user callback queue is full.
+         * @return the overflow policy of this configuration
+         */
+        UserCallbackOverflowPolicy get_user_callback_overflow_policy() const;
+
+        /**
+         * @brief Set the policy used when the user callback queue is full.
+         */
+        void set_user_callback_overflow_policy(UserCallbackOverflowPolicy policy);
+
+        /**
+         * @brief Get the number of threads used to call user callbacks.
+         * @return the number of user callback threads, 1 by default
+         */
+        unsigned get_num_user_callback_threads() const;
+
+        /**
+         * @brief Set the number of threads used to call user callbacks.
+         *
+         * By default, all user callbacks are called one after the other from one
+         * thread. With more threads, callbacks of different systems, and of different
+         * subscriptions with options (see TelemetryExtended), can run in parallel, so a
+         * slow callback does not hold up all others. All other callbacks of the same
+         * system, including plain telemetry subscriptions, are still always called in
+         * order from the same thread. However, the callbacks then need to be
+         * thread-safe with regards to each other.
+         *
+         * This can also be changed from within a callback, the threads are then
+         * replaced once the callback has returned.
+         *
+         * @param num_threads Number of threads, 0 is treated as 1.
+         */
+        void set_num_user_callback_threads(unsigned num_threads);
+
+        /**
+         * @brief Get whether connections are serviced by one shared I/O loop.
+         * @return whether to use the I/O loop, false by default
+         */
+        bool get_use_io_loop() const;
+
+        /**
+         * @brief Set whether connections are serviced by one shared I/O loop.
+         *
+         * By default, every connection receives on its own thread. With the I/O
+         * loop, one thread waits on all connections at once, which scales better
+         * with many connections. This is currently only supported on Linux and
+         * only applies to connections added after the configuration was set.
+         */
+        void set_use_io_loop(bool use_io_loop);
+
+        /**
+         * @brief Get whether outgoing UDP messages are sent in batches.
+         * @return whether UDP sends are batched, false by default
+         */
+        bool get_udp_send_batching() const;
+
+        /**
+         * @brief Set whether outgoing UDP messages are sent in batches.
+         *
+         * With batching, outgoing messages are queued and sent together every
+         * 10 ms (or once enough have been queued), which saves a lot of system
+         * calls on busy links at the cost of some latency. This is currently
+         * only supported on Linux and only applies to connections added after
+         * the configuration was set.
+         */
+        void set_udp_send_batching(bool udp_send_batching);
+
     private:
         uint8_t _system_id;
         uint8_t _component_id;
         bool _always_send_heartbeats;
         UsageType _usage_type;
+        UserCallbackOverflowPolicy _user_callback_overflow_policy;
+        unsigned _num_user_callback_threads;
+        bool _use_io_loop;
+        bool _udp_send_batching;
     };
 
     /**
@@ -26,26 +26,23 @@ MavsdkImpl::MavsdkImpl() : timeout_handler(_time), call_every_handler(_time)
         }
     }
 
-    _work_thread = new std::thread(&MavsdkImpl::work_thread, this);
+    timeout_handler.set_wakeup_callback([this]() { wake_work_thread(); });
+    call_every_handler.set_wakeup_callback([this]() { wake_work_thread(); });
 
-    _process_user_callbacks_thread =
-        new std::thread(&MavsdkImpl::process_user_callbacks_thread, this);
+    _work_thread = new std::thread(&MavsdkImpl::work_thread, this);
 }
 
 MavsdkImpl::~MavsdkImpl()
 {
     call_every_handler.remove(_heartbeat_send_cookie);
+    call_every_handler.remove(_flush_connections_cookie);
 
     _should_exit = true;
 
-    if (_process_user_callbacks_thread != nullptr) {
-        _user_callback_queue.stop();
-        _process_user_callbacks_thread->join();
-        delete _process_user_callbacks_thread;
-        _process_user_callbacks_thread = nullptr;
-    }
+    _user_callbacks.stop();
 
     if (_work_thread != nullptr) {
+        wake_work_thread();
         _work_thread->join();
         delete _work_thread;
         _work_thread = nullptr;
@@ -109,8 +106,10 @@ std::vector<std::shared_ptr<System>> MavsdkImpl::systems() const
     return systems_result;
 }
 
-void MavsdkImpl::receive_message(mavlink_message_t& message)
+void MavsdkImpl::receive_message(const std::shared_ptr<mavlink_message_t>& message_ptr)
 {
+    const auto& message = *message_ptr;
+
     // Don't ever create a system with sysid 0.
     if (message.sysid == 0) {
         return;
@@ -146,7 +145,7 @@ void MavsdkImpl::receive_message(mavlink_message_t& message)
     }
 
     if (_systems.find(message.sysid) != _systems.end()) {
-        _systems.at(message.sysid)->system_impl()->process_mavlink_message(message);
+        _systems.at(message.sysid)->system_impl()->process_mavlink_message(message_ptr);
     }
 }
 
@@ -217,6 +216,8 @@ ConnectionResult MavsdkImpl::add_udp_connection(const std::string& local_ip, con
     if (!new_conn) {
         return ConnectionResult::ConnectionError;
     }
+    new_conn->set_io_loop(io_loop_for_new_connection());
+    new_conn->set_send_batching(_configuration.get_udp_send_batching());
     ConnectionResult ret = new_conn->start();
     if (ret == ConnectionResult::Success) {
         add_connection(new_conn);
@@ -231,6 +232,8 @@ ConnectionResult MavsdkImpl::setup_udp_remote(const std::string& remote_ip, int
     if (!new_conn) {
         return ConnectionResult::ConnectionError;
     }
+    new_conn->set_io_loop(io_loop_for_new_connection());
+    new_conn->set_send_batching(_configuration.get_udp_send_batching());
     ConnectionResult ret = new_conn->start();
     _is_single_system = true;
     if (ret == ConnectionResult::Success) {
@@ -250,6 +253,7 @@ ConnectionResult MavsdkImpl::add_tcp_connection(const std::string& remote_ip, in
     if (!new_conn) {
         return ConnectionResult::ConnectionError;
     }
+    new_conn->set_io_loop(io_loop_for_new_connection());
     ConnectionResult ret = new_conn->start();
     if (ret == ConnectionResult::Success) {
         add_connection(new_conn);
@@ -268,6 +272,7 @@ MavsdkImpl::add_serial_connection(const std::string& dev_path, int baudrate, boo
     if (!new_conn) {
         return ConnectionResult::ConnectionError;
     }
+    new_conn->set_io_loop(io_loop_for_new_connection());
     ConnectionResult ret = new_conn->start();
     if (ret == ConnectionResult::Success) {
         add_connection(new_conn);
@@ -281,13 +286,29 @@ void MavsdkImpl::add_connection(std::shared_ptr<Connection> new_connection)
     _connections.push_back(new_connection);
 }
 
+IoLoop* MavsdkImpl::io_loop_for_new_connection()
+{
+    if (!_configuration.get_use_io_loop() || !IoLoop::is_supported()) {
+        return nullptr;
+    }
+
+    // The loop is only started once needed and keeps running until we are destroyed.
+    return _io_loop.start() ? &_io_loop : nullptr;
+}
+
 void MavsdkImpl::set_configuration(Mavsdk::Configuration configuration)
 {
     _configuration = configuration;
+    _user_callbacks.set_overflow_policy(configuration.get_user_callback_overflow_policy());
+    _user_callbacks.set_num_threads(configuration.get_num_user_callback_threads());
 
     if (configuration.get_always_send_heartbeats()) {
         start_sending_heartbeat();
     }
+
+    if (configuration.get_udp_send_batching()) {
+        start_flushing_connections();
+    }
 }
 
 std::vector<uint64_t> MavsdkImpl::get_system_uuids() const
@@ -494,66 +515,79 @@ void MavsdkImpl::work_thread()
     while (!_should_exit) {
         timeout_handler.run_once();
         call_every_handler.run_once();
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
-    }
-}
 
-void MavsdkImpl::call_user_callback_located(
-    const std::string& filename, const int linenumber, const std::function<void()>& func)
-{
-    auto callback_size = _user_callback_queue.size();
-    if (callback_size == 10) {
-        LogWarn()
-            << "User callback queue too slow.\n"
-               "See: https://mavsdk.mavlink.io/develop/en/cpp/troubleshooting.html#user_callbacks";
+        // Instead of polling, we sleep until something is due. If a timeout or
+        // call every is added that is due earlier than that, we get woken up.
+        const auto next_timeout = timeout_handler.next_deadline();
+        const auto next_call_every = call_every_handler.next_deadline();
 
-    } else if (callback_size == 99) {
-        LogErr()
-            << "User callback queue overflown\n"
-               "See: https://mavsdk.mavlink.io/develop/en/cpp/troubleshooting.html#user_callbacks";
+        // We don't expect to be idle for long, this is only a safety net.
+        dl_time_t until = _time.steady_time_in_future(1.0);
+        if (next_timeout.first && next_timeout.second < until) {
+            until = next_timeout.second;
+        }
+        if (next_call_every.first && next_call_every.second < until) {
+            until = next_call_every.second;
+        }
 
-    } else if (callback_size == 100) {
-        return;
+        std::unique_lock<std::mutex> lock(_work_mutex);
+        _work_condition.wait_until(lock, until, [this]() { return _work_wakeup || _should_exit; });
+        _work_wakeup = false;
     }
+}
 
-    // We only need to keep track of filename and linenumber if we're actually debugging this.
-    UserCallback user_callback =
-        _callback_debugging ? UserCallback{func, filename, linenumber} : UserCallback{func};
-
-    _user_callback_queue.enqueue(user_callback);
+void MavsdkImpl::wake_work_thread()
+{
+    std::lock_guard<std::mutex> lock(_work_mutex);
+    _work_wakeup = true;
+    _work_condition.notify_one();
 }
 
-void MavsdkImpl::process_user_callbacks_thread()
+void MavsdkImpl::call_user_callback_located(
+    const std::string& filename,
+    const int linenumber,
+    std::function<void()> func,
+    const void* origin,
+    bool coalesce)
 {
-    while (!_should_exit) {
-        auto callback = _user_callback_queue.dequeue();
-        if (!callback.first) {
-            continue;
-        }
+    // Callbacks are kept in order per origin, not per call site, so that e.g. the
+    // progress and the result of the same request are called in order.
+    const std::size_t origin_key = std::hash<const void*>{}(origin);
 
-        void* cookie{nullptr};
-
-        const double timeout_s = 1.0;
-        timeout_handler.add(
-            [&]() {
-                if (_callback_debugging) {
-                    LogWarn() << "Callback called from " << callback.second.filename << ":"
-                              << callback.second.linenumber << " took more than " << timeout_s
-                              << " second to run.";
-                    fflush(stdout);
-                    fflush(stderr);
-                    abort();
-                } else {
-                    LogWarn()
-                        << "Callback took more than " << timeout_s << " second to run.\n"
-                        << "See: https://mavsdk.mavlink.io/develop/en/cpp/troubleshooting.html#user_callbacks";
-                }
-            },
-            timeout_s,
-            &cookie);
-        callback.second.func();
-        timeout_handler.remove(cookie);
-    }
+    // We only need to keep track of filename and linenumber if we're actually debugging this.
+    UserCallbackQueue::UserCallback user_callback =
+        _callback_debugging ?
+            UserCallbackQueue::UserCallback{
+                std::move(func), origin_key, coalesce, filename, linenumber} :
+            UserCallbackQueue::UserCallback{std::move(func), origin_key, coalesce};
+
+    _user_callbacks.enqueue(user_callback);
+}
+
+void MavsdkImpl::run_user_callback(UserCallbackQueue::UserCallback& callback)
+{
+    void* cookie{nullptr};
+
+    const double timeout_s = 1.0;
+    timeout_handler.add(
+        [&]() {
+            if (_callback_debugging) {
+                LogWarn() << "Callback called from " << callback.filename << ":"
+                          << callback.linenumber << " took more than " << timeout_s
+                          << " second to run.";
+                fflush(stdout);
+                fflush(stderr);
+                abort();
+            } else {
+                LogWarn()
+                    << "Callback took more than " << timeout_s << " second to run.\n"
+                    << "See: https://mavsdk.mavlink.io/develop/en/cpp/troubleshooting.html#user_callbacks";
+            }
+        },
+        timeout_s,
+        &cookie);
+    callback.func();
+    timeout_handler.remove(cookie);
 }
 
 void MavsdkImpl::start_sending_heartbeat()
@@ -562,6 +596,26 @@ void MavsdkImpl::start_sending_heartbeat()
         [this]() { send_heartbeat(); }, _HEARTBEAT_SEND_INTERVAL_S, &_heartbeat_send_cookie);
 }
 
+void MavsdkImpl::start_flushing_connections()
+{
+    if (_flush_connections_cookie != nullptr) {
+        return;
+    }
+
+    call_every_handler.add(
+        [this]() { flush_connections(); },
+        _FLUSH_CONNECTIONS_INTERVAL_S,
+        &_flush_connections_cookie);
+}
+
+void MavsdkImpl::flush_connections()
+{
+    std::lock_guard<std::mutex> lock(_connections_mutex);
+    for (auto& connection : _connections) {
+        connection->flush();
+    }
+}
+
 void MavsdkImpl::send_heartbeat()
 {
     mavlink_message_t message;
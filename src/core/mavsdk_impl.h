@@ -1,18 +1,23 @@
 #pragma once
 
 #include <unordered_map>
+#include <memory>
 #include <mutex>
+#include <thread>
 #include <vector>
 #include <atomic>
+#include <condition_variable>
 
 #include "call_every_handler.h"
 #include "connection.h"
+#include "io_loop.h"
 #include "mavsdk.h"
 #include "mavlink_include.h"
 #include "mavlink_address.h"
-#include "safe_queue.h"
 #include "system.h"
 #include "timeout_handler.h"
+#include "user_callback_queue.h"
+#include "work_scheduler.h"
 
 namespace mavsdk {
 
@@ -38,7 +43,7 @@ public:
 
     std::string version() const;
 
-    void receive_message(mavlink_message_t& message);
+    void receive_message(const std::shared_ptr<mavlink_message_t>& message_ptr);
     bool send_message(mavlink_message_t& message);
 
     ConnectionResult add_any_connection(const std::string& connection_url);
@@ -77,23 +82,40 @@ public:
     TimeoutHandler timeout_handler;
     CallEveryHandler call_every_handler;
 
+    // Runs the queued work (params, commands, mission transfer) of all systems.
+    WorkScheduler system_work_scheduler{1};
+
+    // Callbacks of the same origin (usually the SystemImpl, or a subscription) are
+    // called in order. Only callbacks of subscriptions which opted in may be coalesced.
     void call_user_callback_located(
-        const std::string& filename, const int linenumber, const std::function<void()>& func);
+        const std::string& filename,
+        const int linenumber,
+        std::function<void()> func,
+        const void* origin = nullptr,
+        bool coalesce = false);
 
     MAVLinkAddress own_address{};
 
 private:
     void add_connection(std::shared_ptr<Connection>);
+    IoLoop* io_loop_for_new_connection();
     void make_system_with_component(uint8_t system_id, uint8_t component_id);
     bool does_system_exist(uint8_t system_id);
 
     void work_thread();
-    void process_user_callbacks_thread();
+    void wake_work_thread();
+
+    void run_user_callback(UserCallbackQueue::UserCallback& callback);
 
     void send_heartbeat();
 
+    void start_flushing_connections();
+    void flush_connections();
+
     using system_entry_t = std::pair<uint8_t, std::shared_ptr<System>>;
 
+    IoLoop _io_loop{};
+
     std::mutex _connections_mutex{};
     std::vector<std::shared_ptr<Connection>> _connections{};
 
@@ -111,32 +133,24 @@ private:
     Mavsdk::Configuration _configuration{Mavsdk::Configuration::UsageType::GroundStation};
     bool _is_single_system{false};
 
-    struct UserCallback {
-        UserCallback() {}
-        UserCallback(const std::function<void()>& func_) : func(func_) {}
-        UserCallback(
-            const std::function<void()>& func_,
-            const std::string& filename_,
-            const int linenumber_) :
-            func(func_),
-            filename(filename_),
-            linenumber(linenumber_)
-        {}
-
-        std::function<void()> func{};
-        std::string filename{};
-        int linenumber{};
-    };
-
     std::thread* _work_thread{nullptr};
-    std::thread* _process_user_callbacks_thread{nullptr};
-    SafeQueue<UserCallback> _user_callback_queue{};
+    std::mutex _work_mutex{};
+    std::condition_variable _work_condition{};
+    bool _work_wakeup{false};
+
+    static constexpr std::size_t _USER_CALLBACK_QUEUE_SIZE = 128;
     bool _callback_debugging{false};
+    UserCallbackQueue _user_callbacks{
+        _USER_CALLBACK_QUEUE_SIZE,
+        [this](UserCallbackQueue::UserCallback& callback) { run_user_callback(callback); }};
 
     static constexpr double _HEARTBEAT_SEND_INTERVAL_S = 1.0;
     std::atomic<bool> _sending_heartbeats{false};
     void* _heartbeat_send_cookie = nullptr;
 
+    static constexpr double _FLUSH_CONNECTIONS_INTERVAL_S = 0.01;
+    void* _flush_connections_cookie = nullptr;
+
     std::atomic<bool> _should_exit = {false};
 };
 
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+namespace mavsdk {
+
+// A value which can be read without ever blocking the writers, e.g. state
+// that is updated by the receive thread and polled by the user.
+//
+// Writers make the sequence number odd while they change the value, and
+// readers try again if the sequence number was odd or has changed while they
+// copied the value. The value is kept in atomic words, so copying it while it
+// is being written is not a data race.
+//
+// Concurrent writers are serialized among themselves.
+template<typename T> class Seqlock {
+    static_assert(std::is_trivially_copyable<T>::value, "Seqlock needs a trivially copyable type");
+
+public:
+    Seqlock() : Seqlock(T{}) {}
+
+    explicit Seqlock(const T& value) { write_words(value); }
+
+    T load() const
+    {
+        while (true) {
+            const uint64_t seq = _seq.load(std::memory_order_acquire);
+            if ((seq & 1) != 0) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            const T value = read_words();
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (_seq.load(std::memory_order_relaxed) == seq) {
+                return value;
+            }
+        }
+    }
+
+    void store(const T& value)
+    {
+        const uint64_t seq = lock();
+        write_words(value);
+        _seq.store(seq + 2, std::memory_order_release);
+    }
+
+    // Changes part of the value, e.g. one member, in one go.
+    template<typename F> void update(F func)
+    {
+        const uint64_t seq = lock();
+        T value = read_words();
+        func(value);
+        write_words(value);
+        _seq.store(seq + 2, std::memory_order_release);
+    }
+
+    // Non-copyable
+    Seqlock(const Seqlock&) = delete;
+    const Seqlock& operator=(const Seqlock&) = delete;
+
+private:
+    // Returns the (even) sequence number from before we made it odd.
+    uint64_t lock()
+    {
+        uint64_t seq = _seq.load(std::memory_order_relaxed);
+        while (true) {
+            if ((seq & 1) != 0) {
+                std::this_thread::yield();
+                seq = _seq.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (_seq.compare_exchange_weak(
+                    seq, seq + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        return seq;
+    }
+
+    T read_words() const
+    {
+        uint64_t words[num_words];
+        for (std::size_t i = 0; i < num_words; ++i) {
+            words[i] = _words[i].load(std::memory_order_relaxed);
+        }
+        T value;
+        std::memcpy(&value, words, sizeof(T));
+        return value;
+    }
+
+    void write_words(const T& value)
+    {
+        uint64_t words[num_words]{};
+        std::memcpy(words, &value, sizeof(T));
+        for (std::size_t i = 0; i < num_words; ++i) {
+            _words[i].store(words[i], std::memory_order_relaxed);
+        }
+    }
+
+    static constexpr std::size_t num_words = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint64_t> _seq{0};
+    std::array<std::atomic<uint64_t>, num_words> _words{};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,85 @@
+#include "seqlock.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace mavsdk;
+
+namespace {
+
+struct Pair {
+    double first{0.0};
+    uint32_t second{0};
+    bool flag{false};
+};
+
+} // namespace
+
+TEST(Seqlock, StoreAndLoad)
+{
+    Seqlock<Pair> seqlock;
+    EXPECT_EQ(seqlock.load().second, 0u);
+
+    seqlock.store(Pair{1.5, 42, true});
+    const auto value = seqlock.load();
+    EXPECT_DOUBLE_EQ(value.first, 1.5);
+    EXPECT_EQ(value.second, 42u);
+    EXPECT_TRUE(value.flag);
+}
+
+TEST(Seqlock, UpdateKeepsOtherMembers)
+{
+    Seqlock<Pair> seqlock{Pair{2.0, 7, false}};
+
+    seqlock.update([](Pair& value) { value.flag = true; });
+
+    const auto value = seqlock.load();
+    EXPECT_DOUBLE_EQ(value.first, 2.0);
+    EXPECT_EQ(value.second, 7u);
+    EXPECT_TRUE(value.flag);
+}
+
+TEST(Seqlock, ReadersNeverSeeTornValues)
+{
+    Seqlock<Pair> seqlock;
+    std::atomic<bool> should_exit{false};
+    std::atomic<bool> torn{false};
+
+    // Two writers, so they also have to be serialized against each other.
+    std::vector<std::thread> writers;
+    for (unsigned writer = 0; writer < 2; ++writer) {
+        writers.emplace_back([&seqlock, &should_exit]() {
+            uint32_t i = 0;
+            while (!should_exit) {
+                seqlock.update([i](Pair& value) {
+                    value.first = static_cast<double>(i);
+                    value.second = i;
+                });
+                ++i;
+            }
+        });
+    }
+
+    std::vector<std::thread> readers;
+    for (unsigned reader = 0; reader < 2; ++reader) {
+        readers.emplace_back([&seqlock, &torn]() {
+            for (unsigned j = 0; j < 100000; ++j) {
+                const auto value = seqlock.load();
+                if (value.first != static_cast<double>(value.second)) {
+                    torn = true;
+                }
+            }
+        });
+    }
+
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    should_exit = true;
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    EXPECT_FALSE(torn);
+}
@@ -72,6 +72,12 @@ ConnectionResult SerialConnection::start()
         return ret;
     }
 
+#if defined(LINUX)
+    if (_io_loop != nullptr && _io_loop->add(_fd, [this]() { receive_available(); })) {
+        return ConnectionResult::Success;
+    }
+#endif
+
     start_recv_thread();
 
     return ConnectionResult::Success;
@@ -229,6 +235,12 @@ ConnectionResult SerialConnection::stop()
 {
     _should_exit = true;
 
+#if defined(LINUX)
+    if (_io_loop != nullptr) {
+        _io_loop->remove(_fd);
+    }
+#endif
+
     if (_recv_thread) {
         _recv_thread->join();
         delete _recv_thread;
@@ -315,11 +327,41 @@ void SerialConnection::receive()
         if (recv_len > static_cast<int>(sizeof(buffer)) || recv_len == 0) {
             continue;
         }
-        _mavlink_receiver->set_new_datagram(buffer, recv_len);
-        // Parse all mavlink messages in one data packet. Once exhausted, we'll exit while.
-        while (_mavlink_receiver->parse_message()) {
-            receive_message(_mavlink_receiver->get_last_message());
-        }
+        process_data(buffer, recv_len);
+    }
+}
+
+#if defined(LINUX)
+void SerialConnection::receive_available()
+{
+    // Enough for MTU 1500 bytes.
+    char buffer[2048];
+
+    // We only get here if there is something to read, so this won't block.
+    const int recv_len = static_cast<int>(read(_fd, buffer, sizeof(buffer)));
+    if (recv_len < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
+        // Nothing lost, we get called again once there is data.
+        return;
+    }
+    if (recv_len < 0) {
+        LogErr() << "read failure: " << GET_ERROR();
+        // Otherwise we'd be called again right away, e.g. if the device is gone.
+        _io_loop->remove(_fd);
+        return;
+    }
+    if (recv_len == 0) {
+        return;
+    }
+    process_data(buffer, recv_len);
+}
+#endif
+
+void SerialConnection::process_data(char* buffer, int buffer_len)
+{
+    _mavlink_receiver->set_new_datagram(buffer, buffer_len);
+    // Parse all mavlink messages in one data packet. Once exhausted, we'll exit while.
+    while (_mavlink_receiver->parse_message()) {
+        receive_message(_mavlink_receiver->get_last_message_ptr());
     }
 }
 
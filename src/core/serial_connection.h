@@ -31,6 +31,8 @@ private:
     ConnectionResult setup_port();
     void start_recv_thread();
     void receive();
+    void receive_available();
+    void process_data(char* buffer, int buffer_len);
 
 #if defined(LINUX)
     static int define_from_baudrate(int baudrate);
@@ -0,0 +1,411 @@
+#pragma once
+
+#include "global_include.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace mavsdk {
+
+// The callback of a subscription, which does not necessarily get called for
+// every single update:
+// - max_rate_hz: at most this often, 0 for no limit.
+// - decimation: only for every n-th update.
+// - latest_only: while a callback is still queued, it is not queued again but
+//   gets the latest value once it runs.
+// - coalesce: if the user callback queue overflows, queued callbacks may be
+//   skipped in favour of the most recent one.
+//
+// The callbacks of a subscription made with options are queued together with an
+// origin which is the same for all its callbacks and differs between subscriptions.
+// Plain subscriptions, assigned without options, are queued with a null origin,
+// which stands for the system, so they stay in order with its other callbacks.
+//
+// This is not thread-safe, calls need to be guarded by the owner.
+template<typename T> class SubscriptionCallback {
+public:
+    using Callback = std::function<void(T)>;
+    using Queue =
+        std::function<void(std::function<void()>, const void* origin, bool coalesce)>;
+
+    struct Options {
+        double max_rate_hz{0.0};
+        unsigned decimation{1};
+        bool latest_only{false};
+        bool coalesce{false};
+    };
+
+    SubscriptionCallback() = default;
+
+    SubscriptionCallback& operator=(Callback callback)
+    {
+        set(std::move(callback), Options{});
+        _own_origin = false;
+        return *this;
+    }
+
+    void set(Callback callback, const Options& options)
+    {
+        _callback = std::move(callback);
+        _options = options;
+        _own_origin = true;
+        _num_updates = 0;
+        _called_once = false;
+        // A callback still queued for the previous subscription keeps the old one.
+        _latest = std::make_shared<Latest>();
+    }
+
+    explicit operator bool() const { return static_cast<bool>(_callback); }
+
+    // Called for every update, the callback is then queued using queue if the
+    // options let the update through.
+    void update(const T& value, const dl_time_t& now, const Queue& queue)
+    {
+        if (!_callback) {
+            return;
+        }
+        update(std::make_shared<const T>(value), now, queue);
+    }
+
+    // Same as above, but the value can be shared between several subscriptions.
+    void update(const std::shared_ptr<const T>& value, const dl_time_t& now, const Queue& queue)
+    {
+        if (!_callback) {
+            return;
+        }
+
+        if (_options.decimation > 1 && (_num_updates++ % _options.decimation) != 0) {
+            return;
+        }
+
+        if (_options.max_rate_hz > 0.0 && _called_once &&
+            std::chrono::duration<double>(now - _last_called).count() <
+                1.0 / _options.max_rate_hz) {
+            return;
+        }
+        _last_called = now;
+        _called_once = true;
+
+        auto callback = _callback;
+
+        if (!_options.latest_only) {
+            queue([callback, value]() { callback(*value); }, origin(), _options.coalesce);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_latest->mutex);
+            _latest->value = value;
+            if (_latest->queued) {
+                return;
+            }
+            _latest->queued = true;
+        }
+
+        auto pending = std::make_shared<Pending>(_latest);
+        queue(
+            [callback, pending]() { callback(*pending->take()); },
+            origin(),
+            _options.coalesce);
+    }
+
+private:
+    const void* origin() const { return _own_origin ? _latest.get() : nullptr; }
+
+    struct Latest {
+        std::mutex mutex{};
+        std::shared_ptr<const T> value{};
+        bool queued{false};
+    };
+
+    // Held by the queued callback. If the queue throws the callback away without
+    // calling it, e.g. because it is full, it is no longer marked as queued either,
+    // otherwise no callback would ever be queued again.
+    class Pending {
+    public:
+        explicit Pending(std::shared_ptr<Latest> latest) : _latest(std::move(latest)) {}
+
+        ~Pending()
+        {
+            std::lock_guard<std::mutex> lock(_latest->mutex);
+            if (!_taken) {
+                _latest->queued = false;
+            }
+        }
+
+        // delete copy and move constructors and assign operators
+        Pending(Pending const&) = delete; // Copy construct
+        Pending(Pending&&) = delete; // Move construct
+        Pending& operator=(Pending const&) = delete; // Copy assign
+        Pending& operator=(Pending&&) = delete; // Move assign
+
+        std::shared_ptr<const T> take()
+        {
+            std::lock_guard<std::mutex> lock(_latest->mutex);
+            _taken = true;
+            _latest->queued = false;
+            return _latest->value;
+        }
+
+    private:
+        std::shared_ptr<Latest> _latest;
+        bool _taken{false};
+    };
+
+    Callback _callback{nullptr};
+    Options _options{};
+    bool _own_origin{true};
+    unsigned _num_updates{0};
+    bool _called_once{false};
+    dl_time_t _last_called{};
+    // Replaced for every new subscription, so it also serves as its origin.
+    std::shared_ptr<Latest> _latest{std::make_shared<Latest>()};
+};
+
+// The callback of a subscription which gets updates in batches:
+// - max_samples: a batch is passed on once it has this many samples.
+// - max_interval_s: a batch is passed on once its first sample is this old,
+//   0 for no limit. This is checked when the next update arrives and whenever
+//   the owner calls flush_due(), e.g. on a timer, so that a batch does not wait
+//   for a stream that has stopped.
+//
+// This is not thread-safe, calls need to be guarded by the owner.
+template<typename T> class BatchSubscriptionCallback {
+public:
+    using Callback = std::function<void(std::vector<T>)>;
+    using Queue = typename SubscriptionCallback<T>::Queue;
+
+    struct Options {
+        unsigned max_samples{1};
+        double max_interval_s{0.0};
+    };
+
+    BatchSubscriptionCallback() = default;
+
+    void set(Callback callback, const Options& options)
+    {
+        _callback = std::move(callback);
+        _options = options;
+        if (_options.max_samples == 0) {
+            _options.max_samples = 1;
+        }
+        _samples.clear();
+        _samples.reserve(_options.max_samples);
+        _origin = std::make_shared<char>();
+    }
+
+    explicit operator bool() const { return static_cast<bool>(_callback); }
+
+    double max_interval_s() const { return _options.max_interval_s; }
+
+    void update(const T& value, const dl_time_t& now, const Queue& queue)
+    {
+        if (!_callback) {
+            return;
+        }
+
+        // A batch that is too old is passed on before the new sample is added,
+        // so that it only contains samples within max_interval_s.
+        if (!_samples.empty() && _options.max_interval_s > 0.0 &&
+            std::chrono::duration<double>(now - _first_sample_time).count() >=
+                _options.max_interval_s) {
+            flush(queue);
+        }
+
+        if (_samples.empty()) {
+            _first_sample_time = now;
+        }
+        _samples.push_back(value);
+
+        if (_samples.size() >= _options.max_samples) {
+            flush(queue);
+        }
+    }
+
+    // Passes on the batch if its first sample is older than max_interval_s.
+    void flush_due(const dl_time_t& now, const Queue& queue)
+    {
+        if (!_callback || _samples.empty() || _options.max_interval_s <= 0.0) {
+            return;
+        }
+
+        if (std::chrono::duration<double>(now - _first_sample_time).count() >=
+            _options.max_interval_s) {
+            flush(queue);
+        }
+    }
+
+    // Passes on what has been collected so far, e.g. before unsubscribing.
+    void flush(const Queue& queue)
+    {
+        if (!_callback || _samples.empty()) {
+            return;
+        }
+
+        // The batch is handed over to the callback, so we start a new one
+        // with the same capacity instead of clearing it.
+        auto samples = std::make_shared<std::vector<T>>(std::move(_samples));
+        _samples = std::vector<T>{};
+        _samples.reserve(_options.max_samples);
+
+        auto callback = _callback;
+        // Samples of a batch are never coalesced away.
+        queue([callback, samples]() { callback(std::move(*samples)); }, _origin.get(), false);
+    }
+
+    Callback _callback{nullptr};
+    Options _options{};
+    std::vector<T> _samples{};
+    dl_time_t _first_sample_time{};
+    // Only used to tell apart the callbacks of different subscriptions.
+    std::shared_ptr<char> _origin{std::make_shared<char>()};
+};
+
+// Several subscriptions to the same stream, each with its own options.
+//
+// Assigning a callback replaces the one default subscription, which is what
+// the single callback subscribe API uses. Additional subscriptions are added
+// with subscribe() or subscribe_batch() and removed again using the returned
+// handle. An update is shared between all subscriptions instead of being
+// copied for each of them.
+//
+// This is not thread-safe, calls need to be guarded by the owner.
+template<typename T> class SubscriptionCallbackList {
+public:
+    using Callback = typename SubscriptionCallback<T>::Callback;
+    using Queue = typename SubscriptionCallback<T>::Queue;
+    using Options = typename SubscriptionCallback<T>::Options;
+    using BatchCallback = typename BatchSubscriptionCallback<T>::Callback;
+    using BatchOptions = typename BatchSubscriptionCallback<T>::Options;
+    using Handle = uint64_t;
+
+    // Returned for an empty callback, never used for a subscription.
+    static constexpr Handle invalid_handle = 0;
+
+    SubscriptionCallbackList() = default;
+
+    SubscriptionCallbackList& operator=(Callback callback)
+    {
+        _default = std::move(callback);
+        return *this;
+    }
+
+    Handle subscribe(Callback callback, const Options& options)
+    {
+        if (!callback) {
+            return invalid_handle;
+        }
+        _subscriptions.emplace_back(++_last_handle, SubscriptionCallback<T>{});
+        _subscriptions.back().second.set(std::move(callback), options);
+        return _last_handle;
+    }
+
+    Handle subscribe_batch(BatchCallback callback, const BatchOptions& options)
+    {
+        if (!callback) {
+            return invalid_handle;
+        }
+        _batch_subscriptions.emplace_back(++_last_handle, BatchSubscriptionCallback<T>{});
+        _batch_subscriptions.back().second.set(std::move(callback), options);
+        return _last_handle;
+    }
+
+    // Returns false if there was no subscription with this handle.
+    bool unsubscribe(Handle handle)
+    {
+        return erase_handle(_subscriptions, handle) || erase_handle(_batch_subscriptions, handle);
+    }
+
+    // Same as above, but the samples a batch subscription has collected so far
+    // are passed on first instead of being dropped.
+    bool unsubscribe(Handle handle, const Queue& queue)
+    {
+        for (auto& subscription : _batch_subscriptions) {
+            if (subscription.first == handle) {
+                subscription.second.flush(queue);
+                break;
+            }
+        }
+        return unsubscribe(handle);
+    }
+
+    // Passes on the batches which have waited for longer than their max_interval_s.
+    void flush_due(const dl_time_t& now, const Queue& queue)
+    {
+        for (auto& subscription : _batch_subscriptions) {
+            subscription.second.flush_due(now, queue);
+        }
+    }
+
+    // The shortest max_interval_s of all batch subscriptions, 0 if none has one.
+    double min_batch_interval_s() const
+    {
+        double result = 0.0;
+        for (const auto& subscription : _batch_subscriptions) {
+            const double interval_s = subscription.second.max_interval_s();
+            if (interval_s > 0.0 && (result == 0.0 || interval_s < result)) {
+                result = interval_s;
+            }
+        }
+        return result;
+    }
+
+    explicit operator bool() const
+    {
+        return static_cast<bool>(_default) || !_subscriptions.empty() ||
+               !_batch_subscriptions.empty();
+    }
+
+    void update(const T& value, const dl_time_t& now, const Queue& queue)
+    {
+        if (!*this) {
+            return;
+        }
+
+        // The value is shared with the queued callbacks. Once they have all run,
+        // it is overwritten for the next update instead of allocating a new one.
+        if (!_value || _value.use_count() > 1) {
+            _value = std::make_shared<T>(value);
+        } else {
+            // use_count() is a relaxed load. The last reads of the callback thread
+            // which released the value need to be done before we overwrite it.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            *_value = value;
+        }
+
+        const std::shared_ptr<const T> shared_value = _value;
+        _default.update(shared_value, now, queue);
+        for (auto& subscription : _subscriptions) {
+            subscription.second.update(shared_value, now, queue);
+        }
+        for (auto& subscription : _batch_subscriptions) {
+            subscription.second.update(*shared_value, now, queue);
+        }
+    }
+
+private:
+    template<typename Subscriptions>
+    static bool erase_handle(Subscriptions& subscriptions, Handle handle)
+    {
+        for (auto it = subscriptions.begin(); it != subscriptions.end(); ++it) {
+            if (it->first == handle) {
+                subscriptions.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    SubscriptionCallback<T> _default{};
+    std::vector<std::pair<Handle, SubscriptionCallback<T>>> _subscriptions{};
+    std::vector<std::pair<Handle, BatchSubscriptionCallback<T>>> _batch_subscriptions{};
+    Handle _last_handle{invalid_handle};
+    std::shared_ptr<T> _value{};
+};
+
+} // namespace mavsdk
@@ -0,0 +1,459 @@
+#include "subscription_callback.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace mavsdk;
+
+namespace {
+
+// Collects what would be queued to be called later.
+struct FakeQueue {
+    std::vector<std::function<void()>> queued{};
+    std::vector<const void*> origins{};
+    std::vector<bool> coalesced{};
+    bool full{false};
+
+    SubscriptionCallback<int>::Queue get()
+    {
+        return [this](std::function<void()> func, const void* origin, bool coalesce) {
+            if (full) {
+                // Thrown away, just like a full user callback queue does.
+                return;
+            }
+            queued.push_back(func);
+            origins.push_back(origin);
+            coalesced.push_back(coalesce);
+        };
+    }
+
+    void run_all()
+    {
+        for (auto& func : queued) {
+            func();
+        }
+        queued.clear();
+        origins.clear();
+        coalesced.clear();
+    }
+};
+
+} // namespace
+
+TEST(SubscriptionCallback, CalledForEveryUpdateByDefault)
+{
+    FakeQueue queue;
+    std::vector<int> values;
+
+    SubscriptionCallback<int> subscription;
+    EXPECT_FALSE(subscription);
+    subscription = [&values](int value) { values.push_back(value); };
+    EXPECT_TRUE(subscription);
+
+    const dl_time_t now{};
+    for (int i = 0; i < 5; ++i) {
+        subscription.update(i, now, queue.get());
+    }
+    queue.run_all();
+
+    EXPECT_EQ(values, (std::vector<int>{0, 1, 2, 3, 4}));
+}
+
+TEST(SubscriptionCallback, Decimation)
+{
+    FakeQueue queue;
+    std::vector<int> values;
+
+    SubscriptionCallback<int> subscription;
+    SubscriptionCallback<int>::Options options;
+    options.decimation = 3;
+    subscription.set([&values](int value) { values.push_back(value); }, options);
+
+    const dl_time_t now{};
+    for (int i = 0; i < 7; ++i) {
+        subscription.update(i, now, queue.get());
+    }
+    queue.run_all();
+
+    EXPECT_EQ(values, (std::vector<int>{0, 3, 6}));
+}
+
+TEST(SubscriptionCallback, MaxRate)
+{
+    FakeQueue queue;
+    std::vector<int> values;
+
+    SubscriptionCallback<int> subscription;
+    SubscriptionCallback<int>::Options options;
+    options.max_rate_hz = 10.0;
+    subscription.set([&values](int value) { values.push_back(value); }, options);
+
+    // Updates at 250 Hz for 0.5 s.
+    dl_time_t now{};
+    for (int i = 0; i < 125; ++i) {
+        subscription.update(i, now, queue.get());
+        now += std::chrono::milliseconds(4);
+    }
+    queue.run_all();
+
+    EXPECT_EQ(values.size(), 5u);
+    EXPECT_EQ(values.front(), 0);
+    EXPECT_EQ(values[1], 25);
+}
+
+TEST(SubscriptionCallback, CoalesceOnlyIfOptedIn)
+{
+    FakeQueue queue;
+
+    SubscriptionCallback<int> subscription;
+    subscription = [](int) {};
+    subscription.update(1, dl_time_t{}, queue.get());
+
+    SubscriptionCallback<int>::Options options;
+    options.coalesce = true;
+    subscription.set([](int) {}, options);
+    subscription.update(2, dl_time_t{}, queue.get());
+
+    EXPECT_EQ(queue.coalesced, (std::vector<bool>{false, true}));
+    queue.run_all();
+}
+
+TEST(SubscriptionCallback, LatestOnly)
+{
+    FakeQueue queue;
+    std::vector<int> values;
+
+    SubscriptionCallback<int> subscription;
+    SubscriptionCallback<int>::Options options;
+    options.latest_only = true;
+    subscription.set([&values](int value) { values.push_back(value); }, options);
+
+    const dl_time_t now{};
+    for (int i = 0; i < 5; ++i) {
+        subscription.update(i, now, queue.get());
+    }
+    EXPECT_EQ(queue.queued.size(), 1u);
+    queue.run_all();
+    EXPECT_EQ(values, (std::vector<int>{4}));
+
+    // Once it has run, the next update is queued again.
+    subscription.update(5, now, queue.get());
+    EXPECT_EQ(queue.queued.size(), 1u);
+    queue.run_all();
+    EXPECT_EQ(values, (std::vector<int>{4, 5}));
+}
+
+TEST(SubscriptionCallback, LatestOnlyQueuedAgainAfterDrop)
+{
+    FakeQueue queue;
+    std::vector<int> values;
+
+    SubscriptionCallback<int> subscription;
+    SubscriptionCallback<int>::Options options;
+    options.latest_only = true;
+    subscription.set([&values](int value) { values.push_back(value); }, options);
+
+    const dl_time_t now{};
+    queue.full = true;
+    subscription.update(1, now, queue.get());
+    EXPECT_TRUE(queue.queued.empty());
+
+    // The dropped callback must not keep the subscription from queueing again.
+    queue.full = false;
+    subscription.update(2, now, queue.get());
+    EXPECT_EQ(queue.queued.size(), 1u);
+    queue.run_all();
+    EXPECT_EQ(values, (std::vector<int>{2}));
+
+    // A callback dropped after it has been queued, e.g. by coalescing.
+    subscription.update(3, now, queue.get());
+    EXPECT_EQ(queue.queued.size(), 1u);
+    queue.queued.clear();
+    subscription.update(4, now, queue.get());
+    EXPECT_EQ(queue.queued.size(), 1u);
+    queue.run_all();
+    EXPECT_EQ(values, (std::vector<int>{2, 4}));
+}
+
+TEST(SubscriptionCallback, UnsubscribeWithNullptr)
+{
+    FakeQueue queue;
+    bool called = false;
+
+    SubscriptionCallback<int> subscription;
+    subscription = [&called](int) { called = true; };
+    subscription = nullptr;
+    EXPECT_FALSE(subscription);
+
+    subscription.update(1, dl_time_t{}, queue.get());
+    queue.run_all();
+    EXPECT_FALSE(called);
+}
+
+TEST(SubscriptionCallbackList, SeveralSubscribers)
+{
+    FakeQueue queue;
+    std::vector<int> first;
+    std::vector<int> second;
+
+    SubscriptionCallbackList<int> subscriptions;
+    EXPECT_FALSE(subscriptions);
+
+    const auto first_handle = subscriptions.subscribe(
+        [&first](int value) { first.push_back(value); }, SubscriptionCallbackList<int>::Options{});
+    SubscriptionCallbackList<int>::Options options;
+    options.decimation = 2;
+    const auto second_handle =
+        subscriptions.subscribe([&second](int value) { second.push_back(value); }, options);
+    EXPECT_TRUE(subscriptions);
+    EXPECT_NE(first_handle, second_handle);
+
+    const dl_time_t now{};
+    for (int i = 0; i < 4; ++i) {
+        subscriptions.update(i, now, queue.get());
+    }
+    queue.run_all();
+
+    EXPECT_EQ(first, (std::vector<int>{0, 1, 2, 3}));
+    EXPECT_EQ(second, (std::vector<int>{0, 2}));
+
+    EXPECT_TRUE(subscriptions.unsubscribe(first_handle));
+    EXPECT_FALSE(subscriptions.unsubscribe(first_handle));
+    subscriptions.update(4, now, queue.get());
+    queue.run_all();
+
+    EXPECT_EQ(first, (std::vector<int>{0, 1, 2, 3}));
+    EXPECT_EQ(second, (std::vector<int>{0, 2, 4}));
+}
+
+TEST(SubscriptionCallbackList, QueuedValueIsNotOverwritten)
+{
+    FakeQueue queue;
+    std::vector<int> values;
+
+    SubscriptionCallbackList<int> subscriptions;
+    subscriptions.subscribe(
+        [&values](int value) { values.push_back(value); },
+        SubscriptionCallbackList<int>::Options{});
+
+    const dl_time_t now{};
+    subscriptions.update(0, now, queue.get());
+    queue.run_all();
+
+    // The first callback has run, so its value can be reused, but the second
+    // one still needs its own while the third one is added.
+    subscriptions.update(1, now, queue.get());
+    subscriptions.update(2, now, queue.get());
+    queue.run_all();
+
+    EXPECT_EQ(values, (std::vector<int>{0, 1, 2}));
+}
+
+TEST(SubscriptionCallbackList, OriginPerSubscription)
+{
+    FakeQueue queue;
+
+    SubscriptionCallbackList<int> subscriptions;
+    subscriptions.subscribe([](int) {}, SubscriptionCallbackList<int>::Options{});
+    subscriptions.subscribe([](int) {}, SubscriptionCallbackList<int>::Options{});
+    subscriptions.subscribe_batch(
+        [](std::vector<int>) {}, SubscriptionCallbackList<int>::BatchOptions{});
+
+    const dl_time_t now{};
+    subscriptions.update(1, now, queue.get());
+    ASSERT_EQ(queue.origins.size(), 3u);
+    const auto first_origins = queue.origins;
+    queue.run_all();
+
+    // The same subscription keeps its origin, different ones don't share it.
+    subscriptions.update(2, now, queue.get());
+    EXPECT_EQ(queue.origins, first_origins);
+    EXPECT_NE(first_origins[0], first_origins[1]);
+    EXPECT_NE(first_origins[0], first_origins[2]);
+    EXPECT_NE(first_origins[1], first_origins[2]);
+    queue.run_all();
+}
+
+TEST(SubscriptionCallbackList, PlainSubscriptionUsesSystemOrigin)
+{
+    FakeQueue queue;
+
+    SubscriptionCallbackList<int> subscriptions;
+    subscriptions = [](int) {};
+    subscriptions.subscribe([](int) {}, SubscriptionCallbackList<int>::Options{});
+
+    const dl_time_t now{};
+    subscriptions.update(1, now, queue.get());
+
+    // Only subscriptions with options may be called out of order with the system.
+    ASSERT_EQ(queue.origins.size(), 2u);
+    EXPECT_EQ(queue.origins[0], nullptr);
+    EXPECT_NE(queue.origins[1], nullptr);
+    queue.run_all();
+}
+
+TEST(SubscriptionCallbackList, DefaultSubscriberIsReplaced)
+{
+    FakeQueue queue;
+    std::vector<int> first;
+    std::vector<int> second;
+    std::vector<int> other;
+
+    SubscriptionCallbackList<int> subscriptions;
+    subscriptions.subscribe(
+        [&other](int value) { other.push_back(value); }, SubscriptionCallbackList<int>::Options{});
+
+    subscriptions = [&first](int value) { first.push_back(value); };
+    subscriptions.update(1, dl_time_t{}, queue.get());
+    subscriptions = [&second](int value) { second.push_back(value); };
+    subscriptions.update(2, dl_time_t{}, queue.get());
+    subscriptions = nullptr;
+    subscriptions.update(3, dl_time_t{}, queue.get());
+    queue.run_all();
+
+    EXPECT_EQ(first, (std::vector<int>{1}));
+    EXPECT_EQ(second, (std::vector<int>{2}));
+    EXPECT_EQ(other, (std::vector<int>{1, 2, 3}));
+}
+
+TEST(SubscriptionCallbackList, EmptyCallbackIsNotAdded)
+{
+    SubscriptionCallbackList<int> subscriptions;
+    EXPECT_EQ(
+        subscriptions.subscribe(nullptr, SubscriptionCallbackList<int>::Options{}),
+        SubscriptionCallbackList<int>::invalid_handle);
+    EXPECT_FALSE(subscriptions);
+}
+
+TEST(BatchSubscriptionCallback, MaxSamples)
+{
+    FakeQueue queue;
+    std::vector<std::vector<int>> batches;
+
+    BatchSubscriptionCallback<int> subscription;
+    BatchSubscriptionCallback<int>::Options options;
+    options.max_samples = 3;
+    subscription.set(
+        [&batches](std::vector<int> batch) { batches.push_back(std::move(batch)); }, options);
+
+    const dl_time_t now{};
+    for (int i = 0; i < 7; ++i) {
+        subscription.update(i, now, queue.get());
+    }
+    EXPECT_EQ(queue.queued.size(), 2u);
+    queue.run_all();
+
+    ASSERT_EQ(batches.size(), 2u);
+    EXPECT_EQ(batches[0], (std::vector<int>{0, 1, 2}));
+    EXPECT_EQ(batches[1], (std::vector<int>{3, 4, 5}));
+}
+
+TEST(BatchSubscriptionCallback, MaxInterval)
+{
+    FakeQueue queue;
+    std::vector<std::vector<int>> batches;
+
+    BatchSubscriptionCallback<int> subscription;
+    BatchSubscriptionCallback<int>::Options options;
+    options.max_samples = 100;
+    options.max_interval_s = 0.1;
+    subscription.set(
+        [&batches](std::vector<int> batch) { batches.push_back(std::move(batch)); }, options);
+
+    // Updates at 25 Hz, so a batch every 3 samples.
+    dl_time_t now{};
+    for (int i = 0; i < 7; ++i) {
+        subscription.update(i, now, queue.get());
+        now += std::chrono::milliseconds(40);
+    }
+    queue.run_all();
+
+    ASSERT_EQ(batches.size(), 2u);
+    EXPECT_EQ(batches[0], (std::vector<int>{0, 1, 2}));
+    EXPECT_EQ(batches[1], (std::vector<int>{3, 4, 5}));
+}
+
+TEST(BatchSubscriptionCallback, MaxIntervalWithoutUpdates)
+{
+    FakeQueue queue;
+    std::vector<std::vector<int>> batches;
+
+    BatchSubscriptionCallback<int> subscription;
+    BatchSubscriptionCallback<int>::Options options;
+    options.max_samples = 100;
+    options.max_interval_s = 0.1;
+    subscription.set(
+        [&batches](std::vector<int> batch) { batches.push_back(std::move(batch)); }, options);
+
+    dl_time_t now{};
+    subscription.update(0, now, queue.get());
+    subscription.update(1, now, queue.get());
+
+    // The stream stops, the batch is still passed on once it is due.
+    now += std::chrono::milliseconds(50);
+    subscription.flush_due(now, queue.get());
+    EXPECT_TRUE(queue.queued.empty());
+
+    now += std::chrono::milliseconds(50);
+    subscription.flush_due(now, queue.get());
+    queue.run_all();
+
+    EXPECT_EQ(batches, (std::vector<std::vector<int>>{{0, 1}}));
+
+    // Nothing left to pass on.
+    now += std::chrono::milliseconds(200);
+    subscription.flush_due(now, queue.get());
+    EXPECT_TRUE(queue.queued.empty());
+}
+
+TEST(SubscriptionCallbackList, BatchSubscriber)
+{
+    FakeQueue queue;
+    std::vector<int> values;
+    std::vector<std::vector<int>> batches;
+
+    SubscriptionCallbackList<int> subscriptions;
+    subscriptions = [&values](int value) { values.push_back(value); };
+    SubscriptionCallbackList<int>::BatchOptions options;
+    options.max_samples = 2;
+    const auto handle = subscriptions.subscribe_batch(
+        [&batches](std::vector<int> batch) { batches.push_back(std::move(batch)); }, options);
+
+    const dl_time_t now{};
+    for (int i = 0; i < 4; ++i) {
+        subscriptions.update(i, now, queue.get());
+    }
+    EXPECT_TRUE(subscriptions.unsubscribe(handle));
+    subscriptions.update(4, now, queue.get());
+    subscriptions.update(5, now, queue.get());
+    queue.run_all();
+
+    EXPECT_EQ(values, (std::vector<int>{0, 1, 2, 3, 4, 5}));
+    EXPECT_EQ(batches, (std::vector<std::vector<int>>{{0, 1}, {2, 3}}));
+}
+
+TEST(SubscriptionCallbackList, BatchFlushedOnUnsubscribe)
+{
+    FakeQueue queue;
+    std::vector<std::vector<int>> batches;
+
+    SubscriptionCallbackList<int> subscriptions;
+    SubscriptionCallbackList<int>::BatchOptions options;
+    options.max_samples = 10;
+    options.max_interval_s = 0.5;
+    const auto handle = subscriptions.subscribe_batch(
+        [&batches](std::vector<int> batch) { batches.push_back(std::move(batch)); }, options);
+    EXPECT_DOUBLE_EQ(subscriptions.min_batch_interval_s(), 0.5);
+
+    const dl_time_t now{};
+    subscriptions.update(0, now, queue.get());
+    subscriptions.update(1, now, queue.get());
+    subscriptions.flush_due(now, queue.get());
+    EXPECT_TRUE(queue.queued.empty());
+
+    EXPECT_TRUE(subscriptions.unsubscribe(handle, queue.get()));
+    EXPECT_FALSE(subscriptions.unsubscribe(handle, queue.get()));
+    EXPECT_DOUBLE_EQ(subscriptions.min_batch_interval_s(), 0.0);
+    queue.run_all();
+
+    EXPECT_EQ(batches, (std::vector<std::vector<int>>{{0, 1}}));
+}
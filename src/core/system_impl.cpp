@@ -25,7 +25,8 @@ SystemImpl::SystemImpl(MavsdkImpl& parent, uint8_t system_id, uint8_t comp_id, b
     _receive_commands(*this),
     _timesync(*this),
     _ping(*this),
-    _mission_transfer(*this, _message_handler, _parent.timeout_handler)
+    _mission_transfer(
+        *this, _message_handler, _parent.timeout_handler, [this]() { request_work(); })
 {
     _target_address.system_id = system_id;
     // FIXME: for now use this as a default.
@@ -37,7 +38,12 @@ SystemImpl::SystemImpl(MavsdkImpl& parent, uint8_t system_id, uint8_t comp_id, b
         _uuid_initialized = true;
         set_connected();
     }
-    _system_thread = new std::thread(&SystemImpl::system_thread, this);
+
+    _parent.system_work_scheduler.add([this]() { do_work(); }, &_work_cookie);
+    // Queued work is triggered as soon as it is added or progresses. This tick
+    // only takes care of timesync and ping, and of anything still waiting.
+    _parent.call_every_handler.add(
+        [this]() { request_work(); }, _work_tick_interval_s, &_work_tick_cookie);
 
     _message_handler.register_one(
         MAVLINK_MSG_ID_HEARTBEAT, std::bind(&SystemImpl::process_heartbeat, this, _1), this);
@@ -57,19 +63,15 @@ SystemImpl::SystemImpl(MavsdkImpl& parent, uint8_t system_id, uint8_t comp_id, b
 
 SystemImpl::~SystemImpl()
 {
-    _should_exit = true;
+    _parent.call_every_handler.remove(_work_tick_cookie);
+    _parent.system_work_scheduler.remove(_work_cookie);
+
     _message_handler.unregister_all(this);
 
     unregister_timeout_handler(_autopilot_version_timed_out_cookie);
     if (!_always_connected) {
         unregister_timeout_handler(_heartbeat_timeout_cookie);
     }
-
-    if (_system_thread != nullptr) {
-        _system_thread->join();
-        delete _system_thread;
-        _system_thread = nullptr;
-    }
 }
 
 bool SystemImpl::is_connected() const
@@ -120,8 +122,10 @@ void SystemImpl::subscribe_is_connected(System::IsConnectedCallback callback)
     _is_connected_callback = callback;
 }
 
-void SystemImpl::process_mavlink_message(mavlink_message_t& message)
+void SystemImpl::process_mavlink_message(const std::shared_ptr<mavlink_message_t>& message_ptr)
 {
+    auto& message = *message_ptr;
+
     // This is a low level interface where incoming messages can be tampered
     // with or even dropped.
     if (_incoming_messages_intercept_callback) {
@@ -132,7 +136,7 @@ void SystemImpl::process_mavlink_message(mavlink_message_t& message)
         }
     }
 
-    _message_handler.process_message(message);
+    _message_handler.process_message(message_ptr);
 }
 
 void SystemImpl::add_call_every(std::function<void()> callback, float interval_s, void** cookie)
@@ -237,30 +241,23 @@ void SystemImpl::heartbeats_timed_out()
     set_disconnected();
 }
 
-void SystemImpl::system_thread()
+void SystemImpl::request_work()
 {
-    dl_time_t last_ping_time{};
-
-    while (!_should_exit) {
-        _params.do_work();
-        _send_commands.do_work();
-        _timesync.do_work();
-        _mission_transfer.do_work();
+    _parent.system_work_scheduler.trigger(_work_cookie);
+}
 
-        if (_time.elapsed_since_s(last_ping_time) >= SystemImpl::_ping_interval_s) {
-            if (_connected) {
-                _ping.run_once();
-            }
-            last_ping_time = _time.steady_time();
-        }
+void SystemImpl::do_work()
+{
+    _params.do_work();
+    _send_commands.do_work();
+    _timesync.do_work();
+    _mission_transfer.do_work();
 
+    if (_time.elapsed_since_s(_last_ping_time) >= SystemImpl::_ping_interval_s) {
         if (_connected) {
-            // Work fairly fast if we're connected.
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        } else {
-            // Be less aggressive when unconnected.
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            _ping.run_once();
         }
+        _last_ping_time = _time.steady_time();
     }
 }
 
@@ -1164,9 +1161,20 @@ void SystemImpl::unregister_plugin(PluginImplBase* plugin_impl)
 }
 
 void SystemImpl::call_user_callback_located(
-    const std::string& filename, const int linenumber, const std::function<void()>& func)
+    const std::string& filename, const int linenumber, std::function<void()> func)
 {
-    _parent.call_user_callback_located(filename, linenumber, func);
+    _parent.call_user_callback_located(filename, linenumber, std::move(func), this);
+}
+
+void SystemImpl::call_user_callback_located(
+    const std::string& filename,
+    const int linenumber,
+    std::function<void()> func,
+    const void* origin,
+    bool coalesce)
+{
+    _parent.call_user_callback_located(
+        filename, linenumber, std::move(func), origin != nullptr ? origin : this, coalesce);
 }
 
 void SystemImpl::param_changed(const std::string& name)
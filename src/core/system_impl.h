@@ -58,7 +58,7 @@ public:
 
     void subscribe_is_connected(System::IsConnectedCallback callback);
 
-    void process_mavlink_message(mavlink_message_t& message);
+    void process_mavlink_message(const std::shared_ptr<mavlink_message_t>& message_ptr);
 
     typedef std::function<void(const mavlink_message_t&)> mavlink_message_handler_t;
 
@@ -224,13 +224,26 @@ public:
     void unregister_plugin(PluginImplBase* plugin_impl);
 
     void call_user_callback_located(
-        const std::string& filename, const int linenumber, const std::function<void()>& func);
+        const std::string& filename, const int linenumber, std::function<void()> func);
+    // Same as above for callbacks of a subscription, the origin needs to be the same
+    // for all its callbacks, and different from other subscriptions. A null origin
+    // stands for this system. Only if coalesce is set, callbacks may be skipped in
+    // favour of the most recent one.
+    void call_user_callback_located(
+        const std::string& filename,
+        const int linenumber,
+        std::function<void()> func,
+        const void* origin,
+        bool coalesce);
 
     void send_autopilot_version_request();
     void send_flight_information_request();
 
     MAVLinkMissionTransfer& mission_transfer() { return _mission_transfer; };
 
+    // To be called whenever work has been queued or has made progress.
+    void request_work();
+
     void intercept_incoming_messages(std::function<bool(mavlink_message_t&)> callback);
     void intercept_outgoing_messages(std::function<bool(mavlink_message_t&)> callback);
 
@@ -267,7 +280,7 @@ private:
     static std::string component_name(uint8_t component_id);
     static ComponentType component_type(uint8_t component_id);
 
-    void system_thread();
+    void do_work();
 
     // We use std::pair instead of a std::optional.
     std::pair<MavlinkCommandSender::Result, MavlinkCommandSender::CommandLong>
@@ -312,8 +325,10 @@ private:
 
     CommandResultCallback _command_result_callback{nullptr};
 
-    std::thread* _system_thread{nullptr};
-    std::atomic<bool> _should_exit{false};
+    void* _work_cookie{nullptr};
+    void* _work_tick_cookie{nullptr};
+    static constexpr float _work_tick_interval_s = 0.1f;
+    dl_time_t _last_ping_time{};
 
     static constexpr double _HEARTBEAT_TIMEOUT_S = 3.0;
 
@@ -52,6 +52,10 @@ ConnectionResult TcpConnection::start()
         return ret;
     }
 
+    if (add_to_io_loop()) {
+        return ConnectionResult::Success;
+    }
+
     start_recv_thread();
 
     return ConnectionResult::Success;
@@ -94,12 +98,36 @@ ConnectionResult TcpConnection::setup_port()
 
 void TcpConnection::start_recv_thread()
 {
+    // With the I/O loop, the thread is only used to reconnect and might
+    // have run before.
+    if (_recv_thread) {
+        _recv_thread->join();
+        delete _recv_thread;
+    }
     _recv_thread = new std::thread(&TcpConnection::receive, this);
 }
 
+bool TcpConnection::add_to_io_loop()
+{
+#ifndef WINDOWS
+    std::lock_guard<std::mutex> lock(_mutex);
+    return !_should_exit && _io_loop != nullptr &&
+           _io_loop->add(_socket_fd, [this]() { receive_available(); });
+#else
+    return false;
+#endif
+}
+
 ConnectionResult TcpConnection::stop()
 {
-    _should_exit = true;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _should_exit = true;
+    }
+
+    if (_io_loop != nullptr) {
+        _io_loop->remove(_socket_fd);
+    }
 
 #ifndef WINDOWS
     // This should interrupt a recv/recvfrom call.
@@ -179,6 +207,11 @@ void TcpConnection::receive()
             LogErr() << "TCP receive error, trying to reconnect...";
             std::this_thread::sleep_for(std::chrono::seconds(1));
             setup_port();
+
+            // Once connected again, the I/O loop takes over.
+            if (_is_ok && add_to_io_loop()) {
+                return;
+            }
         }
 
         const auto recv_len = recv(_socket_fd, buffer, sizeof(buffer), 0);
@@ -199,12 +232,45 @@ void TcpConnection::receive()
             continue;
         }
 
-        _mavlink_receiver->set_new_datagram(buffer, static_cast<int>(recv_len));
+        process_data(buffer, static_cast<int>(recv_len));
+    }
+}
 
-        // Parse all mavlink messages in one data packet. Once exhausted, we'll exit while.
-        while (_mavlink_receiver->parse_message()) {
-            receive_message(_mavlink_receiver->get_last_message());
+#ifndef WINDOWS
+void TcpConnection::receive_available()
+{
+    // Enough for MTU 1500 bytes.
+    char buffer[2048];
+
+    // Read everything that has arrived, so we only get woken up once for it.
+    while (!_should_exit) {
+        const auto recv_len = recv(_socket_fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+
+        if (recv_len < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return;
         }
+
+        if (recv_len <= 0) {
+            // Reconnecting blocks, so we leave that to the receive thread which
+            // hands the socket back to us once connected again.
+            _is_ok = false;
+            _io_loop->remove(_socket_fd);
+            start_recv_thread();
+            return;
+        }
+
+        process_data(buffer, static_cast<int>(recv_len));
+    }
+}
+#endif
+
+void TcpConnection::process_data(char* buffer, int buffer_len)
+{
+    _mavlink_receiver->set_new_datagram(buffer, buffer_len);
+
+    // Parse all mavlink messages in one data packet. Once exhausted, we'll exit while.
+    while (_mavlink_receiver->parse_message()) {
+        receive_message(_mavlink_receiver->get_last_message_ptr());
     }
 }
 
@@ -36,6 +36,9 @@ private:
     void start_recv_thread();
     int resolve_address(const std::string& ip_address, int port, struct sockaddr_in* addr);
     void receive();
+    void receive_available();
+    bool add_to_io_loop();
+    void process_data(char* buffer, int buffer_len);
 
     std::string _remote_ip = {};
     int _remote_port_number;
@@ -15,24 +15,42 @@ void TimeoutHandler::add(std::function<void()> callback, double duration_s, void
 
     void* new_cookie = static_cast<void*>(new_timeout.get());
 
+    std::function<void()> wakeup_callback{nullptr};
     {
         std::lock_guard<std::mutex> lock(_timeouts_mutex);
         _timeouts.insert(std::pair<void*, std::shared_ptr<Timeout>>(new_cookie, new_timeout));
+        if (schedule(new_cookie, *new_timeout)) {
+            wakeup_callback = _wakeup_callback;
+        }
     }
 
     if (cookie != nullptr) {
         *cookie = new_cookie;
     }
+
+    if (wakeup_callback) {
+        wakeup_callback();
+    }
 }
 
 void TimeoutHandler::refresh(const void* cookie)
 {
-    std::lock_guard<std::mutex> lock(_timeouts_mutex);
+    std::function<void()> wakeup_callback{nullptr};
+    {
+        std::lock_guard<std::mutex> lock(_timeouts_mutex);
 
-    auto it = _timeouts.find(const_cast<void*>(cookie));
-    if (it != _timeouts.end()) {
-        dl_time_t future_time = _time.steady_time_in_future(it->second->duration_s);
-        it->second->time = future_time;
+        auto it = _timeouts.find(const_cast<void*>(cookie));
+        if (it != _timeouts.end()) {
+            dl_time_t future_time = _time.steady_time_in_future(it->second->duration_s);
+            it->second->time = future_time;
+            if (schedule(it->first, *it->second)) {
+                wakeup_callback = _wakeup_callback;
+            }
+        }
+    }
+
+    if (wakeup_callback) {
+        wakeup_callback();
     }
 }
 
@@ -40,46 +58,93 @@ void TimeoutHandler::remove(const void* cookie)
 {
     std::lock_guard<std::mutex> lock(_timeouts_mutex);
 
-    auto it = _timeouts.find(const_cast<void*>(cookie));
-    if (it != _timeouts.end()) {
-        _timeouts.erase(const_cast<void*>(cookie));
-        _iterator_invalidated = true;
-    }
+    // The heap entry becomes outdated and is dropped once it comes up.
+    _timeouts.erase(const_cast<void*>(cookie));
 }
 
 void TimeoutHandler::run_once()
 {
-    _timeouts_mutex.lock();
+    std::unique_lock<std::mutex> lock(_timeouts_mutex);
 
     dl_time_t now = _time.steady_time();
 
-    for (auto it = _timeouts.begin(); it != _timeouts.end(); /* no ++it */) {
-        // If time is passed, call timeout callback.
-        if (it->second->time < now) {
-            if (it->second->callback) {
-                // Get a copy for the callback because we will remove it.
-                std::function<void()> callback = it->second->callback;
+    while (!_heap.empty() && _heap.top().time < now) {
+        const HeapEntry entry = _heap.top();
+        _heap.pop();
 
-                // Self-destruct before calling to avoid locking issues.
-                _timeouts.erase(it++);
+        if (!is_current(entry)) {
+            continue;
+        }
 
-                // Unlock while we callback because it might in turn want to add timeouts.
-                _timeouts_mutex.unlock();
-                callback();
-                _timeouts_mutex.lock();
-            }
+        // Get a copy for the callback because we will remove it.
+        std::function<void()> callback = _timeouts[entry.cookie]->callback;
 
-        } else {
-            ++it;
-        }
+        // Self-destruct before calling to avoid locking issues.
+        _timeouts.erase(entry.cookie);
 
-        // We start over if anyone has messed with this while we called the callback.
-        if (_iterator_invalidated) {
-            _iterator_invalidated = false;
-            it = _timeouts.begin();
+        if (callback) {
+            // Unlock while we callback because it might in turn want to add timeouts.
+            lock.unlock();
+            callback();
+            lock.lock();
         }
     }
-    _timeouts_mutex.unlock();
+}
+
+std::pair<bool, dl_time_t> TimeoutHandler::next_deadline()
+{
+    std::lock_guard<std::mutex> lock(_timeouts_mutex);
+
+    while (!_heap.empty() && !is_current(_heap.top())) {
+        _heap.pop();
+    }
+
+    if (_heap.empty()) {
+        return std::make_pair<>(false, dl_time_t{});
+    }
+    return std::make_pair<>(true, _heap.top().time);
+}
+
+void TimeoutHandler::set_wakeup_callback(std::function<void()> callback)
+{
+    std::lock_guard<std::mutex> lock(_timeouts_mutex);
+    _wakeup_callback = callback;
+}
+
+bool TimeoutHandler::schedule(void* cookie, Timeout& timeout)
+{
+    // Needs to be called with the mutex locked. Returns true if this is now the
+    // next deadline.
+
+    const bool earlier_than_before = _heap.empty() || timeout.time < _heap.top().time;
+
+    timeout.generation = _next_generation++;
+    _heap.push(HeapEntry{timeout.time, cookie, timeout.generation});
+
+    // Refreshing leaves outdated entries behind. We don't want them to pile up
+    // when a timeout is refreshed much more often than it expires.
+    if (_heap.size() > 2 * _timeouts.size() + 16) {
+        compact_heap();
+    }
+
+    return earlier_than_before;
+}
+
+bool TimeoutHandler::is_current(const HeapEntry& entry) const
+{
+    const auto it = _timeouts.find(entry.cookie);
+    return it != _timeouts.end() && it->second->generation == entry.generation;
+}
+
+void TimeoutHandler::compact_heap()
+{
+    std::vector<HeapEntry> entries;
+    entries.reserve(_timeouts.size());
+    for (const auto& timeout : _timeouts) {
+        entries.push_back(HeapEntry{timeout.second->time, timeout.first, timeout.second->generation});
+    }
+
+    _heap = decltype(_heap)(std::greater<HeapEntry>(), std::move(entries));
 }
 
 } // namespace mavsdk
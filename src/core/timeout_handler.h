@@ -3,7 +3,9 @@
 #include <mutex>
 #include <memory>
 #include <functional>
+#include <queue>
 #include <unordered_map>
+#include <vector>
 #include "global_include.h"
 
 namespace mavsdk {
@@ -25,16 +27,43 @@ public:
 
     void run_once();
 
+    // Returns the earliest time at which run_once has something to do, or
+    // false as first if there are no timeouts.
+    std::pair<bool, dl_time_t> next_deadline();
+
+    // The callback is called whenever the next deadline has moved earlier, so
+    // that whoever sleeps until next_deadline() can wake up and re-check.
+    void set_wakeup_callback(std::function<void()> callback);
+
 private:
     struct Timeout {
         std::function<void()> callback{};
         dl_time_t time{};
         double duration_s{0.0};
+        uint64_t generation{0};
     };
 
+    // Timeouts are kept in a min-heap sorted by their deadline. Instead of
+    // searching the heap on refresh or remove, the outdated entries are left in
+    // it and skipped when they come up, recognized by their generation.
+    struct HeapEntry {
+        dl_time_t time;
+        void* cookie;
+        uint64_t generation;
+
+        bool operator>(const HeapEntry& other) const { return time > other.time; }
+    };
+
+    bool schedule(void* cookie, Timeout& timeout);
+    bool is_current(const HeapEntry& entry) const;
+    void compact_heap();
+
     std::unordered_map<void*, std::shared_ptr<Timeout>> _timeouts{};
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>> _heap{};
+    uint64_t _next_generation{0};
     std::mutex _timeouts_mutex{};
-    bool _iterator_invalidated{false};
+
+    std::function<void()> _wakeup_callback{nullptr};
 
     Time& _time;
 };
@@ -169,3 +169,38 @@ TEST(TimeoutHandler, NextTimeoutRemovedDuringCallback)
     time.sleep_for(std::chrono::milliseconds(1000));
     th.run_once();
 }
+
+TEST(TimeoutHandler, NextDeadline)
+{
+    Time time{};
+    TimeoutHandler th(time);
+
+    int num_wakeups = 0;
+    th.set_wakeup_callback([&num_wakeups]() { ++num_wakeups; });
+
+    EXPECT_FALSE(th.next_deadline().first);
+
+    void* cookie1 = nullptr;
+    void* cookie2 = nullptr;
+    const auto deadline1 = time.steady_time_in_future(1.0);
+    th.add([]() {}, 1.0, &cookie1);
+    EXPECT_EQ(num_wakeups, 1);
+    th.add([]() {}, 0.5, &cookie2);
+    EXPECT_EQ(num_wakeups, 2);
+
+    auto next_deadline = th.next_deadline();
+    EXPECT_TRUE(next_deadline.first);
+    EXPECT_EQ(next_deadline.second, time.steady_time_in_future(0.5));
+
+    // Refreshing moves the deadline back which doesn't require a wakeup.
+    time.sleep_for(std::chrono::milliseconds(200));
+    th.refresh(cookie2);
+    EXPECT_EQ(num_wakeups, 2);
+    EXPECT_EQ(th.next_deadline().second, time.steady_time_in_future(0.5));
+
+    th.remove(cookie2);
+    EXPECT_EQ(th.next_deadline().second, deadline1);
+
+    th.remove(cookie1);
+    EXPECT_FALSE(th.next_deadline().first);
+}
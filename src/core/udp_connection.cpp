@@ -19,6 +19,7 @@
 
 #include <cassert>
 #include <algorithm>
+#include <array>
 
 #ifdef WINDOWS
 #define GET_ERROR(_x) WSAGetLastError()
@@ -28,14 +29,32 @@
 
 namespace mavsdk {
 
+#if defined(LINUX)
+struct UdpConnection::ReceiveBatch {
+    static constexpr unsigned size = 16;
+    // Enough for MTU 1500 bytes.
+    static constexpr unsigned buffer_len = 2048;
+
+    std::array<std::array<char, buffer_len>, size> buffers{};
+    std::array<struct sockaddr_in, size> src_addrs{};
+    std::array<struct iovec, size> iovecs{};
+    std::array<struct mmsghdr, size> msgs{};
+};
+#else
+struct UdpConnection::ReceiveBatch {};
+#endif
+
 UdpConnection::UdpConnection(
     Connection::receiver_callback_t receiver_callback,
     const std::string& local_ip,
     int local_port_number) :
     Connection(receiver_callback),
     _local_ip(local_ip),
-    _local_port_number(local_port_number)
-{}
+    _local_port_number(local_port_number),
+    _receive_batch(new ReceiveBatch)
+{
+    _outgoing.reserve(_max_outgoing_packets);
+}
 
 UdpConnection::~UdpConnection()
 {
@@ -54,6 +73,12 @@ ConnectionResult UdpConnection::start()
         return ret;
     }
 
+#if defined(LINUX)
+    if (_io_loop != nullptr && _io_loop->add(_socket_fd, [this]() { receive_available(); })) {
+        return ConnectionResult::Success;
+    }
+#endif
+
     start_recv_thread();
 
     return ConnectionResult::Success;
@@ -98,6 +123,13 @@ ConnectionResult UdpConnection::stop()
 {
     _should_exit = true;
 
+    // Don't lose what has been queued so far.
+    flush();
+
+    if (_io_loop != nullptr) {
+        _io_loop->remove(_socket_fd);
+    }
+
 #ifndef WINDOWS
     // This should interrupt a recv/recvfrom call.
     shutdown(_socket_fd, SHUT_RDWR);
@@ -127,6 +159,16 @@ ConnectionResult UdpConnection::stop()
 
 bool UdpConnection::send_message(const mavlink_message_t& message)
 {
+    uint8_t target_sysid;
+    uint8_t target_compid;
+    get_target(message, target_sysid, target_compid);
+
+#if defined(LINUX)
+    if (_send_batching) {
+        return send_queued(message, target_sysid, target_compid);
+    }
+#endif
+
     std::lock_guard<std::mutex> lock(_remote_mutex);
 
     if (_remotes.size() == 0) {
@@ -134,67 +176,237 @@ bool UdpConnection::send_message(const mavlink_message_t& message)
         return false;
     }
 
-    // Send the message to all the remotes. A remote is a UDP endpoint
-    // identified by its <ip, port>. This means that if we have two
-    // systems on two different endpoints, then messages directed towards
-    // only one system will be sent to both remotes. The systems are
-    // then expected to ignore messages that are not directed to them.
-    bool send_successful = true;
-    for (auto& remote : _remotes) {
-        struct sockaddr_in dest_addr {};
-        dest_addr.sin_family = AF_INET;
-
-        inet_pton(AF_INET, remote.ip.c_str(), &dest_addr.sin_addr.s_addr);
-        dest_addr.sin_port = htons(remote.port_number);
-
-        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
-        uint16_t buffer_len = mavlink_msg_to_send_buffer(buffer, &message);
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    uint16_t buffer_len = mavlink_msg_to_send_buffer(buffer, &message);
 
+    bool send_successful = true;
+    for_each_remote(target_sysid, target_compid, [&](const Remote& remote) {
         const auto send_len = sendto(
             _socket_fd,
             reinterpret_cast<char*>(buffer),
             buffer_len,
             0,
-            reinterpret_cast<const sockaddr*>(&dest_addr),
-            sizeof(dest_addr));
+            reinterpret_cast<const sockaddr*>(&remote.address),
+            sizeof(remote.address));
 
         if (send_len != buffer_len) {
             LogErr() << "sendto failure: " << GET_ERROR(errno);
             send_successful = false;
-            continue;
+        }
+    });
+
+    return send_successful;
+}
+
+void UdpConnection::get_target(
+    const mavlink_message_t& message, uint8_t& target_sysid, uint8_t& target_compid)
+{
+    target_sysid = 0;
+    target_compid = 0;
+
+    const mavlink_msg_entry_t* entry = mavlink_get_msg_entry(message.msgid);
+    if (entry == nullptr) {
+        return;
+    }
+
+    const auto payload = reinterpret_cast<const uint8_t*>(_MAV_PAYLOAD(&message));
+    if (entry->flags & MAV_MSG_ENTRY_FLAG_HAVE_TARGET_SYSTEM) {
+        target_sysid = payload[entry->target_system_ofs];
+    }
+    if (entry->flags & MAV_MSG_ENTRY_FLAG_HAVE_TARGET_COMPONENT) {
+        target_compid = payload[entry->target_component_ofs];
+    }
+}
+
+void UdpConnection::for_each_remote(
+    uint8_t target_sysid, uint8_t target_compid, const std::function<void(const Remote&)>& func)
+{
+    // A remote is a UDP endpoint identified by its <ip, port>. Messages which
+    // are directed towards one system only go to the remote we have heard it
+    // from. Broadcasts, and messages to systems we haven't heard from, still
+    // go to all remotes, which are then expected to ignore messages that are
+    // not directed to them.
+    if (target_sysid != 0) {
+        if (target_compid != 0) {
+            const auto component_route =
+                _remote_by_component.find(component_key(target_sysid, target_compid));
+            if (component_route != _remote_by_component.end()) {
+                func(_remotes[component_route->second]);
+                return;
+            }
+        }
+
+        const auto system_routes = _remotes_by_sysid.find(target_sysid);
+        if (system_routes != _remotes_by_sysid.end()) {
+            for (const auto index : system_routes->second) {
+                func(_remotes[index]);
+            }
+            return;
+        }
+    }
+
+    for (const auto& remote : _remotes) {
+        func(remote);
+    }
+}
+
+void UdpConnection::flush()
+{
+#if defined(LINUX)
+    std::lock_guard<std::mutex> lock(_outgoing_mutex);
+    if (!send_outgoing()) {
+        _outgoing_send_failed = true;
+    }
+#endif
+}
+
+#if defined(LINUX)
+bool UdpConnection::send_queued(
+    const mavlink_message_t& message, uint8_t target_sysid, uint8_t target_compid)
+{
+    {
+        std::lock_guard<std::mutex> lock(_remote_mutex);
+        if (_remotes.size() == 0) {
+            LogErr() << "No known remotes";
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_outgoing_mutex);
+
+    _outgoing.emplace_back();
+    auto& packet = _outgoing.back();
+    packet.len = mavlink_msg_to_send_buffer(packet.data.data(), &message);
+    packet.target_sysid = target_sysid;
+    packet.target_compid = target_compid;
+
+    // Errors of a message queued earlier can only be reported now.
+    bool send_successful = !_outgoing_send_failed;
+    _outgoing_send_failed = false;
+
+    if (_outgoing.size() >= _max_outgoing_packets && !send_outgoing()) {
+        send_successful = false;
+    }
+
+    return send_successful;
+}
+
+bool UdpConnection::send_outgoing()
+{
+    if (_outgoing.empty()) {
+        return true;
+    }
+
+    bool send_successful = true;
+
+    std::vector<struct mmsghdr> msgs;
+    std::vector<struct iovec> iovecs;
+    {
+        std::lock_guard<std::mutex> lock(_remote_mutex);
+
+        if (_remotes.size() == 0) {
+            LogErr() << "No known remotes";
+            _outgoing.clear();
+            return false;
+        }
+
+        // One iovec per packet, shared by all the remotes it goes to.
+        iovecs.resize(_outgoing.size());
+        msgs.reserve(_outgoing.size());
+        for (std::size_t i = 0; i < _outgoing.size(); ++i) {
+            auto& packet = _outgoing[i];
+            iovecs[i].iov_base = packet.data.data();
+            iovecs[i].iov_len = packet.len;
+
+            for_each_remote(packet.target_sysid, packet.target_compid, [&](const Remote& remote) {
+                struct mmsghdr msg {};
+                msg.msg_hdr.msg_name = const_cast<struct sockaddr_in*>(&remote.address);
+                msg.msg_hdr.msg_namelen = sizeof(remote.address);
+                msg.msg_hdr.msg_iov = &iovecs[i];
+                msg.msg_hdr.msg_iovlen = 1;
+                msgs.push_back(msg);
+            });
+        }
+
+        std::size_t num_sent = 0;
+        while (num_sent < msgs.size()) {
+            const int ret = sendmmsg(
+                _socket_fd,
+                &msgs[num_sent],
+                static_cast<unsigned>(msgs.size() - num_sent),
+                0);
+            if (ret <= 0) {
+                LogErr() << "sendmmsg failure: " << GET_ERROR(errno);
+                send_successful = false;
+                break;
+            }
+            num_sent += static_cast<std::size_t>(ret);
         }
     }
 
+    _outgoing.clear();
     return send_successful;
 }
+#endif
 
 void UdpConnection::add_remote(const std::string& remote_ip, const int remote_port)
 {
-    add_remote_with_remote_sysid(remote_ip, remote_port, 0);
+    struct sockaddr_in address {};
+    address.sin_family = AF_INET;
+    inet_pton(AF_INET, remote_ip.c_str(), &address.sin_addr.s_addr);
+    address.sin_port = htons(remote_port);
+
+    add_remote_with_remote_sysid(address, 0, 0);
 }
 
 void UdpConnection::add_remote_with_remote_sysid(
-    const std::string& remote_ip, const int remote_port, const uint8_t remote_sysid)
+    const struct sockaddr_in& address, const uint8_t remote_sysid, const uint8_t remote_compid)
 {
     std::lock_guard<std::mutex> lock(_remote_mutex);
-    Remote new_remote;
-    new_remote.ip = remote_ip;
-    new_remote.port_number = remote_port;
 
     auto existing_remote =
-        std::find_if(_remotes.begin(), _remotes.end(), [&new_remote](Remote& remote) {
-            return remote == new_remote;
+        std::find_if(_remotes.begin(), _remotes.end(), [&address](const Remote& remote) {
+            return remote.address.sin_addr.s_addr == address.sin_addr.s_addr &&
+                   remote.address.sin_port == address.sin_port;
         });
 
+    std::size_t index;
     if (existing_remote == _remotes.end()) {
+        Remote new_remote;
+        new_remote.ip = inet_ntoa(address.sin_addr);
+        new_remote.port_number = ntohs(address.sin_port);
+        new_remote.address = address;
+
         LogInfo() << "New system on: " << new_remote.ip << ":" << new_remote.port_number
                   << " (with sysid: " << (int)remote_sysid << ")";
         _remotes.push_back(new_remote);
+        index = _remotes.size() - 1;
+    } else {
+        index = static_cast<std::size_t>(existing_remote - _remotes.begin());
+    }
+
+    if (remote_sysid == 0) {
+        return;
+    }
+
+    // If a component moves to another endpoint, we follow it.
+    _remote_by_component[component_key(remote_sysid, remote_compid)] = index;
+
+    auto& system_remotes = _remotes_by_sysid[remote_sysid];
+    if (std::find(system_remotes.begin(), system_remotes.end(), index) == system_remotes.end()) {
+        system_remotes.push_back(index);
     }
 }
 
 void UdpConnection::receive()
 {
+#if defined(LINUX)
+    while (!_should_exit) {
+        // This blocks until there is at least one datagram, and then also
+        // takes whatever else has arrived in the meantime.
+        receive_batch(MSG_WAITFORONE);
+    }
+#else
     // Enough for MTU 1500 bytes.
     char buffer[2048];
 
@@ -222,22 +434,75 @@ void UdpConnection::receive()
             continue;
         }
 
-        _mavlink_receiver->set_new_datagram(buffer, static_cast<int>(recv_len));
+        process_datagram(buffer, static_cast<int>(recv_len), src_addr);
+    }
+#endif
+}
 
-        bool saved_remote = false;
+#if defined(LINUX)
+void UdpConnection::receive_available()
+{
+    // Read everything that has arrived, so we only get woken up once for it.
+    while (!_should_exit) {
+        if (receive_batch(MSG_DONTWAIT) < static_cast<int>(ReceiveBatch::size)) {
+            return;
+        }
+    }
+}
 
-        // Parse all mavlink messages in one datagram. Once exhausted, we'll exit while.
-        while (_mavlink_receiver->parse_message()) {
-            const uint8_t sysid = _mavlink_receiver->get_last_message().sysid;
+int UdpConnection::receive_batch(int flags)
+{
+    auto& batch = *_receive_batch;
+
+    for (unsigned i = 0; i < ReceiveBatch::size; ++i) {
+        batch.iovecs[i].iov_base = batch.buffers[i].data();
+        batch.iovecs[i].iov_len = ReceiveBatch::buffer_len;
+        batch.msgs[i].msg_hdr = {};
+        batch.msgs[i].msg_hdr.msg_name = &batch.src_addrs[i];
+        batch.msgs[i].msg_hdr.msg_namelen = sizeof(batch.src_addrs[i]);
+        batch.msgs[i].msg_hdr.msg_iov = &batch.iovecs[i];
+        batch.msgs[i].msg_hdr.msg_iovlen = 1;
+        batch.msgs[i].msg_len = 0;
+    }
 
-            if (!saved_remote && sysid != 0) {
-                saved_remote = true;
-                add_remote_with_remote_sysid(
-                    inet_ntoa(src_addr.sin_addr), ntohs(src_addr.sin_port), sysid);
-            }
+    const int num_received =
+        recvmmsg(_socket_fd, batch.msgs.data(), ReceiveBatch::size, flags, nullptr);
 
-            receive_message(_mavlink_receiver->get_last_message());
+    // An error happens on destruction when close(_socket_fd) is called,
+    // or if there is nothing to read, therefore be quiet.
+    for (int i = 0; i < num_received; ++i) {
+        if (batch.msgs[i].msg_len == 0) {
+            continue;
         }
+        process_datagram(
+            batch.buffers[i].data(), static_cast<int>(batch.msgs[i].msg_len), batch.src_addrs[i]);
+    }
+
+    return num_received;
+}
+#endif
+
+void UdpConnection::process_datagram(
+    char* buffer, int buffer_len, const struct sockaddr_in& src_addr)
+{
+    _mavlink_receiver->set_new_datagram(buffer, buffer_len);
+
+    uint8_t saved_sysid = 0;
+    uint8_t saved_compid = 0;
+
+    // Parse all mavlink messages in one datagram. Once exhausted, we'll exit while.
+    while (_mavlink_receiver->parse_message()) {
+        const uint8_t sysid = _mavlink_receiver->get_last_message().sysid;
+        const uint8_t compid = _mavlink_receiver->get_last_message().compid;
+
+        // Usually, all messages in one datagram come from the same component.
+        if (sysid != 0 && (sysid != saved_sysid || compid != saved_compid)) {
+            saved_sysid = sysid;
+            saved_compid = compid;
+            add_remote_with_remote_sysid(src_addr, sysid, compid);
+        }
+
+        receive_message(_mavlink_receiver->get_last_message_ptr());
     }
 }
 
@@ -1,12 +1,23 @@
 #pragma once
 
+#include <array>
+#include <functional>
 #include <string>
+#include <unordered_map>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <atomic>
 #include <vector>
 #include <cstdint>
 #include "connection.h"
+#ifndef WINDOWS
+#include <netinet/in.h>
+#else
+#include <winsock2.h>
+#include <Ws2tcpip.h> // For InetPton
+#undef SOCKET_ERROR
+#endif
 
 namespace mavsdk {
 
@@ -21,9 +32,15 @@ public:
     ConnectionResult stop() override;
 
     bool send_message(const mavlink_message_t& message) override;
+    void flush() override;
 
     void add_remote(const std::string& remote_ip, const int remote_port);
 
+    // With send batching, messages are queued and only sent once flush() is
+    // called or the queue is full. If sending fails in flush(), the next
+    // send_message() returns false. Has to be set before start().
+    void set_send_batching(bool send_batching) { _send_batching = send_batching; }
+
     // Non-copyable
     UdpConnection(const UdpConnection&) = delete;
     const UdpConnection& operator=(const UdpConnection&) = delete;
@@ -33,9 +50,22 @@ private:
     void start_recv_thread();
 
     void receive();
+    void receive_available();
+    int receive_batch(int flags);
+    void process_datagram(char* buffer, int buffer_len, const struct sockaddr_in& src_addr);
+
+    bool send_queued(const mavlink_message_t& message, uint8_t target_sysid, uint8_t target_compid);
+    bool send_outgoing();
 
     void add_remote_with_remote_sysid(
-        const std::string& remote_ip, const int remote_port, const uint8_t remote_sysid);
+        const struct sockaddr_in& address, const uint8_t remote_sysid, const uint8_t remote_compid);
+
+    static void
+    get_target(const mavlink_message_t& message, uint8_t& target_sysid, uint8_t& target_compid);
+    static uint16_t component_key(uint8_t sysid, uint8_t compid)
+    {
+        return static_cast<uint16_t>((sysid << 8) | compid);
+    }
 
     std::string _local_ip;
     int _local_port_number;
@@ -44,14 +74,38 @@ private:
     struct Remote {
         std::string ip{};
         int port_number{0};
-
-        bool operator==(const UdpConnection::Remote& other)
-        {
-            return ip == other.ip && port_number == other.port_number;
-        }
+        // Resolved once when the remote is added.
+        struct sockaddr_in address {};
     };
     std::vector<Remote> _remotes{};
 
+    // Where we have heard systems and components from, as indices into _remotes.
+    std::unordered_map<uint8_t, std::vector<std::size_t>> _remotes_by_sysid{};
+    std::unordered_map<uint16_t, std::size_t> _remote_by_component{};
+
+    // Has to be called with _remote_mutex locked.
+    void for_each_remote(
+        uint8_t target_sysid,
+        uint8_t target_compid,
+        const std::function<void(const Remote&)>& func);
+
+    // Buffers for receiving several datagrams with one call.
+    struct ReceiveBatch;
+    std::unique_ptr<ReceiveBatch> _receive_batch;
+
+    struct OutgoingPacket {
+        std::array<uint8_t, MAVLINK_MAX_PACKET_LEN> data{};
+        uint16_t len{0};
+        uint8_t target_sysid{0};
+        uint8_t target_compid{0};
+    };
+    static constexpr std::size_t _max_outgoing_packets = 32;
+    std::mutex _outgoing_mutex{};
+    std::vector<OutgoingPacket> _outgoing{};
+    // Set if flush() failed to send, to be reported by the next send_message().
+    bool _outgoing_send_failed{false};
+    bool _send_batching{false};
+
     int _socket_fd{-1};
     std::thread* _recv_thread{nullptr};
     std::atomic_bool _should_exit{false};
@@ -0,0 +1,254 @@
+#include "udp_connection.h"
+#include "mavsdk.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#if defined(LINUX)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using namespace mavsdk;
+
+#if defined(LINUX)
+
+namespace {
+
+// A UDP socket on localhost, standing in for a system on the other end of a connection.
+class Peer {
+public:
+    Peer()
+    {
+        _fd = socket(AF_INET, SOCK_DGRAM, 0);
+
+        struct sockaddr_in address = loopback(0);
+        bind(_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+
+        socklen_t address_len = sizeof(address);
+        getsockname(_fd, reinterpret_cast<sockaddr*>(&address), &address_len);
+        _port = ntohs(address.sin_port);
+    }
+
+    ~Peer() { close(_fd); }
+
+    Peer(const Peer&) = delete;
+    const Peer& operator=(const Peer&) = delete;
+
+    int port() const { return _port; }
+
+    void send_heartbeat(uint8_t sysid, uint8_t compid, int to_port) const
+    {
+        mavlink_message_t message;
+        mavlink_msg_heartbeat_pack(
+            sysid, compid, &message, MAV_TYPE_GCS, MAV_AUTOPILOT_INVALID, 0, 0, 0);
+
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        const auto buffer_len = mavlink_msg_to_send_buffer(buffer, &message);
+
+        const struct sockaddr_in address = loopback(to_port);
+        sendto(
+            _fd,
+            buffer,
+            buffer_len,
+            0,
+            reinterpret_cast<const sockaddr*>(&address),
+            sizeof(address));
+    }
+
+    // Returns the number of datagrams which arrived, waiting at most timeout for each.
+    unsigned receive(std::chrono::milliseconds timeout) const
+    {
+        unsigned num_received = 0;
+        struct pollfd poll_fd {};
+        poll_fd.fd = _fd;
+        poll_fd.events = POLLIN;
+        while (poll(&poll_fd, 1, static_cast<int>(timeout.count())) > 0) {
+            char buffer[2048];
+            if (recv(_fd, buffer, sizeof(buffer), 0) > 0) {
+                ++num_received;
+            }
+        }
+        return num_received;
+    }
+
+private:
+    static struct sockaddr_in loopback(int port)
+    {
+        struct sockaddr_in address {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(static_cast<uint16_t>(port));
+        return address;
+    }
+
+    int _fd{-1};
+    int _port{0};
+};
+
+mavlink_message_t command_long(uint8_t target_sysid, uint8_t target_compid)
+{
+    mavlink_message_t message;
+    mavlink_msg_command_long_pack(
+        245,
+        MAV_COMP_ID_MISSIONPLANNER,
+        &message,
+        target_sysid,
+        target_compid,
+        MAV_CMD_REQUEST_MESSAGE,
+        0,
+        0.0f,
+        0.0f,
+        0.0f,
+        0.0f,
+        0.0f,
+        0.0f,
+        0.0f);
+    return message;
+}
+
+mavlink_message_t heartbeat()
+{
+    mavlink_message_t message;
+    mavlink_msg_heartbeat_pack(
+        245,
+        MAV_COMP_ID_MISSIONPLANNER,
+        &message,
+        MAV_TYPE_GCS,
+        MAV_AUTOPILOT_INVALID,
+        0,
+        0,
+        0);
+    return message;
+}
+
+const auto short_timeout = std::chrono::milliseconds(50);
+
+} // namespace
+
+TEST(UdpConnection, RoutesToRemotesTargetWasHeardFrom)
+{
+    std::atomic<unsigned> num_received{0};
+    UdpConnection connection(
+        [&num_received](const std::shared_ptr<mavlink_message_t>&) { ++num_received; },
+        "127.0.0.1",
+        24601);
+    ASSERT_EQ(connection.start(), ConnectionResult::Success);
+
+    // System 1 has components behind both peers, system 2 only behind peer b.
+    Peer peer_a;
+    Peer peer_b;
+    peer_a.send_heartbeat(1, 1, 24601);
+    peer_b.send_heartbeat(1, 2, 24601);
+    peer_b.send_heartbeat(2, 1, 24601);
+    for (unsigned i = 0; i < 100 && num_received < 3; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(num_received, 3u);
+
+    // Component heard from.
+    EXPECT_TRUE(connection.send_message(command_long(1, 1)));
+    EXPECT_EQ(peer_a.receive(short_timeout), 1u);
+    EXPECT_EQ(peer_b.receive(short_timeout), 0u);
+
+    EXPECT_TRUE(connection.send_message(command_long(1, 2)));
+    EXPECT_EQ(peer_a.receive(short_timeout), 0u);
+    EXPECT_EQ(peer_b.receive(short_timeout), 1u);
+
+    // Unknown component of a known system goes to all remotes of the system.
+    EXPECT_TRUE(connection.send_message(command_long(2, 3)));
+    EXPECT_EQ(peer_a.receive(short_timeout), 0u);
+    EXPECT_EQ(peer_b.receive(short_timeout), 1u);
+
+    EXPECT_TRUE(connection.send_message(command_long(1, 0)));
+    EXPECT_EQ(peer_a.receive(short_timeout), 1u);
+    EXPECT_EQ(peer_b.receive(short_timeout), 1u);
+
+    // Unknown systems and broadcasts go to all remotes.
+    EXPECT_TRUE(connection.send_message(command_long(3, 1)));
+    EXPECT_EQ(peer_a.receive(short_timeout), 1u);
+    EXPECT_EQ(peer_b.receive(short_timeout), 1u);
+
+    EXPECT_TRUE(connection.send_message(heartbeat()));
+    EXPECT_EQ(peer_a.receive(short_timeout), 1u);
+    EXPECT_EQ(peer_b.receive(short_timeout), 1u);
+
+    connection.stop();
+}
+
+TEST(UdpConnection, BatchingSendsOnFlushOrWhenQueueIsFull)
+{
+    UdpConnection connection([](const std::shared_ptr<mavlink_message_t>&) {}, "127.0.0.1", 24602);
+    connection.set_send_batching(true);
+    ASSERT_EQ(connection.start(), ConnectionResult::Success);
+
+    Peer peer;
+    connection.add_remote("127.0.0.1", peer.port());
+
+    for (unsigned i = 0; i < 3; ++i) {
+        EXPECT_TRUE(connection.send_message(heartbeat()));
+    }
+    EXPECT_EQ(peer.receive(short_timeout), 0u);
+
+    connection.flush();
+    EXPECT_EQ(peer.receive(short_timeout), 3u);
+
+    // Nothing left to send.
+    connection.flush();
+    EXPECT_EQ(peer.receive(short_timeout), 0u);
+
+    // The queue holds 32 messages.
+    for (unsigned i = 0; i < 32; ++i) {
+        EXPECT_TRUE(connection.send_message(heartbeat()));
+    }
+    EXPECT_EQ(peer.receive(short_timeout), 32u);
+
+    connection.stop();
+}
+
+TEST(UdpConnection, BatchingReportsSendErrors)
+{
+    UdpConnection connection([](const std::shared_ptr<mavlink_message_t>&) {}, "127.0.0.1", 24603);
+    connection.set_send_batching(true);
+    ASSERT_EQ(connection.start(), ConnectionResult::Success);
+
+    EXPECT_FALSE(connection.send_message(heartbeat()));
+
+    // Without SO_BROADCAST, sending to the broadcast address fails.
+    connection.add_remote("255.255.255.255", 24604);
+
+    // When the queue is full and gets sent.
+    for (unsigned i = 0; i < 31; ++i) {
+        EXPECT_TRUE(connection.send_message(heartbeat()));
+    }
+    EXPECT_FALSE(connection.send_message(heartbeat()));
+
+    // When sent by flush(), with the next message.
+    EXPECT_TRUE(connection.send_message(heartbeat()));
+    connection.flush();
+    EXPECT_FALSE(connection.send_message(heartbeat()));
+    EXPECT_TRUE(connection.send_message(heartbeat()));
+
+    connection.stop();
+}
+
+TEST(UdpConnection, BatchingIsFlushedPeriodically)
+{
+    Peer peer;
+
+    Mavsdk mavsdk;
+    Mavsdk::Configuration configuration(Mavsdk::Configuration::UsageType::GroundStation);
+    configuration.set_always_send_heartbeats(true);
+    configuration.set_udp_send_batching(true);
+    mavsdk.set_configuration(configuration);
+    ASSERT_EQ(mavsdk.setup_udp_remote("127.0.0.1", peer.port()), ConnectionResult::Success);
+
+    // A single heartbeat does not fill the queue, so only the periodic flush sends it.
+    EXPECT_GT(peer.receive(std::chrono::milliseconds(2000)), 0u);
+}
+
+#endif
@@ -0,0 +1,340 @@
+#include "user_callback_queue.h"
+#include "log.h"
+#include <algorithm>
+
+namespace mavsdk {
+
+namespace {
+// The queue whose worker is running on this thread, if any.
+thread_local const UserCallbackQueue* current_queue{nullptr};
+} // namespace
+
+UserCallbackQueue::UserCallbackQueue(std::size_t queue_size, Runner runner) :
+    _queue_size(queue_size),
+    _runner(std::move(runner))
+{
+    auto workers = make_workers(1);
+    start_threads(*workers);
+    std::atomic_store(&_workers, workers);
+}
+
+UserCallbackQueue::~UserCallbackQueue()
+{
+    stop();
+}
+
+void UserCallbackQueue::set_overflow_policy(OverflowPolicy policy)
+{
+    _overflow_policy = policy;
+}
+
+void UserCallbackQueue::set_num_threads(unsigned num_threads)
+{
+    if (num_threads == 0) {
+        num_threads = 1;
+    }
+
+    if (current_queue != this) {
+        change_num_threads(num_threads);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_pending_mutex);
+    _pending_num_threads = num_threads;
+    if (_pending || _should_exit) {
+        // Already on its way.
+        return;
+    }
+    _pending = true;
+
+    // The previous one is done once it has reset _pending.
+    if (_pending_thread != nullptr) {
+        _pending_thread->join();
+    }
+    _pending_thread =
+        std::make_unique<std::thread>(&UserCallbackQueue::change_num_threads_pending, this);
+}
+
+void UserCallbackQueue::change_num_threads_pending()
+{
+    while (true) {
+        unsigned num_threads;
+        {
+            std::lock_guard<std::mutex> lock(_pending_mutex);
+            num_threads = _pending_num_threads;
+        }
+
+        change_num_threads(num_threads);
+
+        std::lock_guard<std::mutex> lock(_pending_mutex);
+        if (_pending_num_threads == num_threads || _should_exit) {
+            _pending = false;
+            return;
+        }
+    }
+}
+
+void UserCallbackQueue::change_num_threads(unsigned num_threads)
+{
+    std::lock_guard<std::mutex> lock(_workers_mutex);
+    {
+        // We must not hold on to the current workers, otherwise they can't be stopped.
+        const auto current_workers = std::atomic_load(&_workers);
+        if (current_workers == nullptr || current_workers->size() == num_threads) {
+            return;
+        }
+    }
+
+    // New callbacks go to the new workers straightaway, but these only start once
+    // the old ones are done. Whatever the old ones have not called yet is handed over
+    // first, so callbacks of the same origin stay in order.
+    auto new_workers = make_workers(num_threads);
+    auto old_workers = std::atomic_exchange(&_workers, new_workers);
+    stop_workers(old_workers);
+
+    UserCallback leftover;
+    for (auto& worker : *old_workers) {
+        for (auto& overflown : worker->overflow) {
+            (*new_workers)[worker_index(overflown, *new_workers)]->handed_over.push_back(
+                std::move(overflown));
+        }
+        while (worker->queue.try_dequeue(leftover)) {
+            (*new_workers)[worker_index(leftover, *new_workers)]->handed_over.push_back(
+                std::move(leftover));
+        }
+    }
+
+    start_threads(*new_workers);
+}
+
+void UserCallbackQueue::stop()
+{
+    _should_exit = true;
+
+    std::unique_ptr<std::thread> pending_thread;
+    {
+        std::lock_guard<std::mutex> lock(_pending_mutex);
+        pending_thread = std::move(_pending_thread);
+    }
+    if (pending_thread != nullptr) {
+        pending_thread->join();
+    }
+
+    std::lock_guard<std::mutex> lock(_workers_mutex);
+    auto workers = std::atomic_exchange(&_workers, std::shared_ptr<Workers>{});
+    stop_workers(workers);
+}
+
+void UserCallbackQueue::enqueue(UserCallback& user_callback)
+{
+    // We hold on to the workers while enqueueing, so they are not stopped underneath us.
+    const auto workers = std::atomic_load(&_workers);
+    if (workers == nullptr || workers->empty()) {
+        // We're shutting down.
+        return;
+    }
+
+    auto& worker = *(*workers)[worker_index(user_callback, *workers)];
+    auto& queue = worker.queue;
+
+    if (queue.size() == 10) {
+        LogWarn()
+            << "User callback queue too slow.\n"
+               "See: https://mavsdk.mavlink.io/develop/en/cpp/troubleshooting.html#user_callbacks";
+    }
+
+    const auto policy = _overflow_policy.load();
+
+    while (!queue.try_enqueue(user_callback)) {
+        if (policy == OverflowPolicy::DropNewest) {
+            report_dropped();
+            return;
+        }
+
+        if (policy == OverflowPolicy::Coalesce) {
+            worker.overflowed = true;
+            make_space_by_coalescing(worker, user_callback);
+            continue;
+        }
+
+        // Make space by throwing away the oldest one. If the queue has been emptied
+        // in the meantime, we just try again.
+        if (drop_oldest(worker)) {
+            report_dropped();
+        }
+    }
+}
+
+void UserCallbackQueue::make_space_by_coalescing(Worker& worker, const UserCallback& user_callback)
+{
+    std::lock_guard<std::mutex> lock(worker.overflow_mutex);
+
+    // Everything queued so far is older than what is queued from now on, so it
+    // stays in order when called before the queue.
+    worker.queue.try_dequeue_batch(worker.overflow, worker.queue.capacity());
+
+    // The samples superseded by a more recent one are thrown away first, including
+    // those superseded by the one about to be queued.
+    worker.overflow_origins_seen.clear();
+    if (user_callback.coalesce) {
+        worker.overflow_origins_seen.insert(user_callback.origin_key);
+    }
+    coalesce(worker.overflow, worker.overflow_origins_seen);
+    worker.overflow.erase(
+        std::remove_if(
+            worker.overflow.begin(),
+            worker.overflow.end(),
+            [](const UserCallback& callback) { return !callback.func; }),
+        worker.overflow.end());
+
+    // Only if that is not enough, whatever is oldest has to go.
+    if (worker.overflow.size() >= worker.queue.capacity()) {
+        worker.overflow.erase(
+            worker.overflow.begin(),
+            worker.overflow.begin() + (worker.overflow.size() - worker.queue.capacity() + 1));
+        report_dropped();
+    }
+}
+
+bool UserCallbackQueue::drop_oldest(Worker& worker)
+{
+    {
+        std::lock_guard<std::mutex> lock(worker.overflow_mutex);
+        if (!worker.overflow.empty()) {
+            worker.overflow.erase(worker.overflow.begin());
+            return true;
+        }
+    }
+
+    UserCallback oldest;
+    return worker.queue.try_dequeue(oldest);
+}
+
+void UserCallbackQueue::report_dropped()
+{
+    // We only complain once until the queue has been emptied again to avoid
+    // flooding the log while we are already overloaded.
+    if (!_overflow_reported.exchange(true)) {
+        LogErr()
+            << "User callback queue overflown\n"
+               "See: https://mavsdk.mavlink.io/develop/en/cpp/troubleshooting.html#user_callbacks";
+    }
+}
+
+std::size_t
+UserCallbackQueue::worker_index(const UserCallback& user_callback, const Workers& workers)
+{
+    return user_callback.origin_key % workers.size();
+}
+
+std::shared_ptr<UserCallbackQueue::Workers> UserCallbackQueue::make_workers(unsigned num_threads)
+{
+    auto workers = std::make_shared<Workers>();
+    for (unsigned i = 0; i < num_threads; ++i) {
+        workers->push_back(std::make_unique<Worker>(_queue_size));
+    }
+    return workers;
+}
+
+void UserCallbackQueue::start_threads(Workers& workers)
+{
+    for (auto& worker : workers) {
+        worker->thread = std::make_unique<std::thread>(
+            &UserCallbackQueue::process_thread, this, std::ref(*worker));
+    }
+}
+
+void UserCallbackQueue::stop_workers(std::shared_ptr<Workers>& workers)
+{
+    if (workers == nullptr) {
+        return;
+    }
+
+    // Wait until nobody is enqueueing to these workers anymore. At this point they
+    // have already been swapped out, so we should be holding the last reference.
+    while (workers.use_count() > 1) {
+        std::this_thread::yield();
+    }
+
+    for (auto& worker : *workers) {
+        worker->queue.stop();
+    }
+
+    for (auto& worker : *workers) {
+        if (worker->thread != nullptr) {
+            worker->thread->join();
+            worker->thread.reset();
+        }
+    }
+}
+
+void UserCallbackQueue::process_thread(Worker& worker)
+{
+    current_queue = this;
+
+    for (auto& callback : worker.handed_over) {
+        run(callback);
+    }
+    worker.handed_over.clear();
+
+    auto& queue = worker.queue;
+
+    std::vector<UserCallback> callbacks;
+    callbacks.reserve(2 * queue.capacity());
+
+    std::unordered_set<std::size_t> origins_seen;
+
+    while (!_should_exit) {
+        if (!queue.wait_for_items()) {
+            break;
+        }
+
+        // We take everything that is queued at once instead of one by one, so
+        // producers don't have to wait for us.
+        callbacks.clear();
+        {
+            std::lock_guard<std::mutex> lock(worker.overflow_mutex);
+            // What has been moved out of the queue is older than what is still in it.
+            callbacks.swap(worker.overflow);
+            queue.try_dequeue_batch(callbacks, queue.capacity());
+        }
+
+        if (queue.empty()) {
+            _overflow_reported = false;
+        }
+
+        // Coalescing only kicks in once we could not keep up.
+        if (worker.overflowed.exchange(false)) {
+            origins_seen.clear();
+            coalesce(callbacks, origins_seen);
+        }
+
+        for (auto& callback : callbacks) {
+            run(callback);
+        }
+    }
+}
+
+void UserCallbackQueue::run(UserCallback& callback)
+{
+    if (_should_exit || !callback.func) {
+        return;
+    }
+
+    _runner(callback);
+}
+
+void UserCallbackQueue::coalesce(
+    std::vector<UserCallback>& callbacks, std::unordered_set<std::size_t>& origins_seen)
+{
+    // Only the most recent callback of each origin survives, as long as it is from a
+    // subscription that opted in. Anything else, like the result of a request, is kept.
+    // Origins already in origins_seen have a more recent callback elsewhere.
+    for (auto it = callbacks.rbegin(); it != callbacks.rend(); ++it) {
+        if (it->coalesce && !origins_seen.insert(it->origin_key).second) {
+            it->func = nullptr;
+        }
+    }
+}
+
+} // namespace mavsdk
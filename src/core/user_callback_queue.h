@@ -0,0 +1,137 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "lock_free_queue.h"
+#include "mavsdk.h"
+
+namespace mavsdk {
+
+// User callbacks are queued and called from one or more worker threads, so the
+// threads receiving and sending messages never have to wait for the user.
+//
+// Every worker has its own queue and thread. Callbacks with the same origin key
+// always go to the same worker which keeps them in order, also while the number
+// of workers changes.
+class UserCallbackQueue {
+public:
+    using OverflowPolicy = Mavsdk::Configuration::UserCallbackOverflowPolicy;
+
+    struct UserCallback {
+        UserCallback() {}
+        UserCallback(std::function<void()> func_, std::size_t origin_key_, bool coalesce_) :
+            func(std::move(func_)),
+            origin_key(origin_key_),
+            coalesce(coalesce_)
+        {}
+        UserCallback(
+            std::function<void()> func_,
+            std::size_t origin_key_,
+            bool coalesce_,
+            const std::string& filename_,
+            const int linenumber_) :
+            func(std::move(func_)),
+            origin_key(origin_key_),
+            coalesce(coalesce_),
+            filename(filename_),
+            linenumber(linenumber_)
+        {}
+
+        std::function<void()> func{};
+        std::size_t origin_key{0};
+        // Whether it may be replaced by a more recent callback of the same origin
+        // when coalescing, only true for subscriptions which opted in.
+        bool coalesce{false};
+        std::string filename{};
+        int linenumber{};
+    };
+
+    // Used by the workers to call a callback, e.g. to supervise how long it takes.
+    using Runner = std::function<void(UserCallback&)>;
+
+    UserCallbackQueue(std::size_t queue_size, Runner runner);
+    ~UserCallbackQueue();
+
+    // delete copy and move constructors and assign operators
+    UserCallbackQueue(UserCallbackQueue const&) = delete; // Copy construct
+    UserCallbackQueue(UserCallbackQueue&&) = delete; // Move construct
+    UserCallbackQueue& operator=(UserCallbackQueue const&) = delete; // Copy assign
+    UserCallbackQueue& operator=(UserCallbackQueue&&) = delete; // Move assign
+
+    void set_overflow_policy(OverflowPolicy policy);
+
+    // Callbacks which have not been called yet are handed over to the new workers.
+    // If called from a callback, this happens in the background once it returns.
+    void set_num_threads(unsigned num_threads);
+
+    void enqueue(UserCallback& user_callback);
+
+    // Stops all workers, callbacks not called yet are dropped.
+    void stop();
+
+private:
+    struct Worker {
+        explicit Worker(std::size_t queue_size) : queue(queue_size)
+        {
+            overflow.reserve(2 * queue_size);
+        }
+
+        LockFreeQueue<UserCallback> queue;
+        // Left over from the previous workers, called before anything in the queue.
+        std::vector<UserCallback> handed_over{};
+        // Set when the queue ran full, the next batch taken from it is coalesced.
+        std::atomic<bool> overflowed{false};
+        // With the Coalesce policy, a full queue is moved here to throw away samples
+        // which have been superseded, as the queue itself can only drop its oldest.
+        // Called before anything still in the queue. Holds at most one queue size.
+        std::mutex overflow_mutex{};
+        std::vector<UserCallback> overflow{};
+        std::unordered_set<std::size_t> overflow_origins_seen{};
+        std::unique_ptr<std::thread> thread{};
+    };
+    using Workers = std::vector<std::unique_ptr<Worker>>;
+
+    std::shared_ptr<Workers> make_workers(unsigned num_threads);
+    void start_threads(Workers& workers);
+    void stop_workers(std::shared_ptr<Workers>& workers);
+    void change_num_threads(unsigned num_threads);
+    void change_num_threads_pending();
+    void process_thread(Worker& worker);
+    void run(UserCallback& callback);
+    void report_dropped();
+    void make_space_by_coalescing(Worker& worker, const UserCallback& user_callback);
+    static bool drop_oldest(Worker& worker);
+
+    static std::size_t worker_index(const UserCallback& user_callback, const Workers& workers);
+
+    static void
+    coalesce(std::vector<UserCallback>& callbacks, std::unordered_set<std::size_t>& origins_seen);
+
+    const std::size_t _queue_size;
+    const Runner _runner;
+
+    // The workers are swapped as a whole, so enqueueing never needs to take a lock.
+    std::shared_ptr<Workers> _workers{};
+    std::mutex _workers_mutex{};
+    std::atomic<OverflowPolicy> _overflow_policy{OverflowPolicy::DropNewest};
+    std::atomic<bool> _overflow_reported{false};
+    std::atomic<bool> _should_exit{false};
+
+    // A worker can't wait for itself to stop, so if the number of threads is changed
+    // from a callback, this is done on another thread.
+    std::mutex _pending_mutex{};
+    bool _pending{false};
+    unsigned _pending_num_threads{1};
+    std::unique_ptr<std::thread> _pending_thread{};
+};
+
+} // namespace mavsdk
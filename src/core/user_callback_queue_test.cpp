@@ -0,0 +1,274 @@
+#include "user_callback_queue.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+using namespace mavsdk;
+
+namespace {
+
+using OverflowPolicy = UserCallbackQueue::OverflowPolicy;
+using UserCallback = UserCallbackQueue::UserCallback;
+
+// Records the names of the callbacks in the order they are called.
+struct Recorder {
+    std::mutex mutex{};
+    std::condition_variable condition{};
+    std::vector<std::string> called{};
+
+    std::function<void()> make(const std::string& name)
+    {
+        return [this, name]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            called.push_back(name);
+            condition.notify_all();
+        };
+    }
+
+    // Waits until num_called callbacks have been called, or a second has passed.
+    std::vector<std::string> wait_for(std::size_t num_called)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait_for(lock, std::chrono::seconds(1), [this, num_called]() {
+            return called.size() >= num_called;
+        });
+        return called;
+    }
+};
+
+void enqueue(
+    UserCallbackQueue& queue, std::function<void()> func, std::size_t origin, bool coalesce)
+{
+    UserCallback callback{std::move(func), origin, coalesce};
+    queue.enqueue(callback);
+}
+
+// Keeps the worker busy until released, so the queue can be filled up.
+void block_worker(UserCallbackQueue& queue, std::shared_future<void> release)
+{
+    std::promise<void> blocking;
+    auto blocking_future = blocking.get_future();
+    enqueue(
+        queue,
+        [&blocking, release]() {
+            blocking.set_value();
+            release.wait();
+        },
+        0,
+        false);
+    ASSERT_EQ(blocking_future.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+}
+
+const auto run = [](UserCallback& callback) { callback.func(); };
+
+} // namespace
+
+TEST(UserCallbackQueue, CallsInOrder)
+{
+    Recorder recorder;
+    UserCallbackQueue queue{4, run};
+
+    for (int i = 0; i < 3; ++i) {
+        enqueue(queue, recorder.make(std::to_string(i)), 1, false);
+    }
+
+    EXPECT_EQ(recorder.wait_for(3), (std::vector<std::string>{"0", "1", "2"}));
+}
+
+TEST(UserCallbackQueue, DropNewestOnOverflow)
+{
+    Recorder recorder;
+    UserCallbackQueue queue{4, run};
+
+    std::promise<void> release;
+    block_worker(queue, release.get_future().share());
+
+    for (int i = 0; i < 5; ++i) {
+        enqueue(queue, recorder.make(std::to_string(i)), 1, false);
+    }
+    release.set_value();
+
+    EXPECT_EQ(recorder.wait_for(4), (std::vector<std::string>{"0", "1", "2", "3"}));
+}
+
+TEST(UserCallbackQueue, CoalesceNotWithoutOverflow)
+{
+    Recorder recorder;
+    UserCallbackQueue queue{4, run};
+    queue.set_overflow_policy(OverflowPolicy::Coalesce);
+
+    std::promise<void> release;
+    block_worker(queue, release.get_future().share());
+
+    enqueue(queue, recorder.make("sample 1"), 1, true);
+    enqueue(queue, recorder.make("sample 2"), 1, true);
+    enqueue(queue, recorder.make("sample 3"), 1, true);
+    release.set_value();
+
+    EXPECT_EQ(
+        recorder.wait_for(3), (std::vector<std::string>{"sample 1", "sample 2", "sample 3"}));
+}
+
+TEST(UserCallbackQueue, CoalesceOnOverflowOnlyIfOptedIn)
+{
+    Recorder recorder;
+    UserCallbackQueue queue{4, run};
+    queue.set_overflow_policy(OverflowPolicy::Coalesce);
+
+    std::promise<void> release;
+    block_worker(queue, release.get_future().share());
+
+    // The fifth one does not fit anymore and pushes out the oldest one.
+    enqueue(queue, recorder.make("sample 1"), 1, true);
+    enqueue(queue, recorder.make("sample 2"), 1, true);
+    enqueue(queue, recorder.make("result"), 1, false);
+    enqueue(queue, recorder.make("sample 3"), 1, true);
+    enqueue(queue, recorder.make("sample 4"), 1, true);
+    release.set_value();
+
+    EXPECT_EQ(recorder.wait_for(2), (std::vector<std::string>{"result", "sample 4"}));
+}
+
+TEST(UserCallbackQueue, CoalesceDropsSupersededSamplesFirst)
+{
+    Recorder recorder;
+    UserCallbackQueue queue{4, run};
+    queue.set_overflow_policy(OverflowPolicy::Coalesce);
+
+    std::promise<void> release;
+    block_worker(queue, release.get_future().share());
+
+    // The oldest one is a result, the samples in between make space instead.
+    enqueue(queue, recorder.make("result 1"), 1, false);
+    enqueue(queue, recorder.make("sample 1"), 2, true);
+    enqueue(queue, recorder.make("sample 2"), 2, true);
+    enqueue(queue, recorder.make("sample 3"), 2, true);
+    enqueue(queue, recorder.make("result 2"), 1, false);
+    enqueue(queue, recorder.make("sample 4"), 2, true);
+    release.set_value();
+
+    EXPECT_EQ(
+        recorder.wait_for(3), (std::vector<std::string>{"result 1", "result 2", "sample 4"}));
+}
+
+TEST(UserCallbackQueue, CoalesceDropsOldestWithoutSupersededSamples)
+{
+    Recorder recorder;
+    UserCallbackQueue queue{4, run};
+    queue.set_overflow_policy(OverflowPolicy::Coalesce);
+
+    std::promise<void> release;
+    block_worker(queue, release.get_future().share());
+
+    enqueue(queue, recorder.make("result 1"), 1, false);
+    enqueue(queue, recorder.make("result 2"), 1, false);
+    enqueue(queue, recorder.make("result 3"), 1, false);
+    enqueue(queue, recorder.make("result 4"), 1, false);
+    enqueue(queue, recorder.make("result 5"), 1, false);
+    release.set_value();
+
+    EXPECT_EQ(
+        recorder.wait_for(4),
+        (std::vector<std::string>{"result 2", "result 3", "result 4", "result 5"}));
+}
+
+TEST(UserCallbackQueue, CoalesceKeepsOtherOrigins)
+{
+    Recorder recorder;
+    UserCallbackQueue queue{4, run};
+    queue.set_overflow_policy(OverflowPolicy::Coalesce);
+
+    std::promise<void> release;
+    block_worker(queue, release.get_future().share());
+
+    enqueue(queue, recorder.make("first 1"), 1, true);
+    enqueue(queue, recorder.make("second 1"), 2, true);
+    enqueue(queue, recorder.make("first 2"), 1, true);
+    enqueue(queue, recorder.make("second 2"), 2, true);
+    enqueue(queue, recorder.make("first 3"), 1, true);
+    release.set_value();
+
+    EXPECT_EQ(recorder.wait_for(2), (std::vector<std::string>{"second 2", "first 3"}));
+}
+
+TEST(UserCallbackQueue, SameOriginInOrderWithSeveralThreads)
+{
+    Recorder recorder;
+    UserCallbackQueue queue{256, run};
+    queue.set_num_threads(4);
+
+    std::vector<std::string> first;
+    std::vector<std::string> second;
+    for (int i = 0; i < 50; ++i) {
+        first.push_back("first " + std::to_string(i));
+        second.push_back("second " + std::to_string(i));
+        enqueue(queue, recorder.make(first.back()), 1, false);
+        enqueue(queue, recorder.make(second.back()), 2, false);
+    }
+
+    const auto called = recorder.wait_for(100);
+    ASSERT_EQ(called.size(), 100u);
+
+    std::vector<std::string> called_first;
+    std::vector<std::string> called_second;
+    for (const auto& name : called) {
+        (name.rfind("first", 0) == 0 ? called_first : called_second).push_back(name);
+    }
+    EXPECT_EQ(called_first, first);
+    EXPECT_EQ(called_second, second);
+}
+
+TEST(UserCallbackQueue, ChangingThreadsKeepsOrder)
+{
+    Recorder recorder;
+    UserCallbackQueue queue{256, run};
+
+    std::promise<void> release;
+    block_worker(queue, release.get_future().share());
+
+    std::vector<std::string> expected;
+    for (int i = 0; i < 50; ++i) {
+        expected.push_back(std::to_string(i));
+        enqueue(queue, recorder.make(expected.back()), 1, false);
+    }
+
+    // This has to wait for the blocked worker, meanwhile more callbacks are queued.
+    auto changed = std::async(std::launch::async, [&queue]() { queue.set_num_threads(3); });
+    for (int i = 50; i < 100; ++i) {
+        expected.push_back(std::to_string(i));
+        enqueue(queue, recorder.make(expected.back()), 1, false);
+    }
+    release.set_value();
+    changed.wait();
+
+    for (int i = 100; i < 110; ++i) {
+        expected.push_back(std::to_string(i));
+        enqueue(queue, recorder.make(expected.back()), 1, false);
+    }
+
+    EXPECT_EQ(recorder.wait_for(110), expected);
+}
+
+TEST(UserCallbackQueue, ChangingThreadsFromCallback)
+{
+    Recorder recorder;
+    UserCallbackQueue queue{16, run};
+
+    enqueue(queue, [&queue]() { queue.set_num_threads(2); }, 1, false);
+    enqueue(queue, recorder.make("after"), 1, false);
+    EXPECT_EQ(recorder.wait_for(1), (std::vector<std::string>{"after"}));
+
+    // Back to one thread, again from a callback, while other callbacks are coming in.
+    enqueue(queue, [&queue]() { queue.set_num_threads(1); }, 1, false);
+    std::vector<std::string> expected{"after"};
+    for (int i = 0; i < 10; ++i) {
+        expected.push_back(std::to_string(i));
+        enqueue(queue, recorder.make(expected.back()), 1, false);
+    }
+    EXPECT_EQ(recorder.wait_for(11), expected);
+}
@@ -0,0 +1,130 @@
+#include "work_scheduler.h"
+
+namespace mavsdk {
+
+WorkScheduler::WorkScheduler(unsigned num_threads)
+{
+    if (num_threads == 0) {
+        num_threads = 1;
+    }
+
+    for (unsigned i = 0; i < num_threads; ++i) {
+        _threads.push_back(new std::thread(&WorkScheduler::work_thread, this));
+    }
+}
+
+WorkScheduler::~WorkScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _should_exit = true;
+        _ready_condition.notify_all();
+    }
+
+    for (auto& thread : _threads) {
+        thread->join();
+        delete thread;
+        thread = nullptr;
+    }
+}
+
+void WorkScheduler::add(std::function<void()> work, void** cookie)
+{
+    auto new_entry = std::make_shared<Entry>();
+    new_entry->work = work;
+
+    void* new_cookie = static_cast<void*>(new_entry.get());
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _entries.insert(std::pair<void*, std::shared_ptr<Entry>>(new_cookie, new_entry));
+    }
+
+    if (cookie != nullptr) {
+        *cookie = new_cookie;
+    }
+}
+
+void WorkScheduler::trigger(const void* cookie)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = _entries.find(const_cast<void*>(cookie));
+    if (it == _entries.end() || it->second->pending) {
+        return;
+    }
+
+    it->second->pending = true;
+
+    // If it is running right now, the thread running it will put it back
+    // once it's done.
+    if (!it->second->running) {
+        _ready.push_back(it->second);
+        _ready_condition.notify_one();
+    }
+}
+
+void WorkScheduler::remove(const void* cookie)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    auto it = _entries.find(const_cast<void*>(cookie));
+    if (it == _entries.end()) {
+        return;
+    }
+
+    auto entry = it->second;
+    _entries.erase(it);
+
+    // It might still be sitting in the ready queue, so we make sure it is skipped.
+    entry->pending = false;
+    entry->work = nullptr;
+
+    if (entry->running && entry->running_thread_id != std::this_thread::get_id()) {
+        _done_condition.wait(lock, [&entry]() { return !entry->running; });
+    }
+}
+
+void WorkScheduler::work_thread()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    while (!_should_exit) {
+        _ready_condition.wait(lock, [this]() { return _should_exit || !_ready.empty(); });
+
+        if (_should_exit) {
+            break;
+        }
+
+        auto entry = _ready.front();
+        _ready.pop_front();
+
+        if (!entry->pending || !entry->work) {
+            // It got removed in the meantime.
+            continue;
+        }
+
+        entry->pending = false;
+        entry->running = true;
+        entry->running_thread_id = std::this_thread::get_id();
+
+        // Get a copy for the work because we unlock.
+        auto work = entry->work;
+
+        lock.unlock();
+        work();
+        lock.lock();
+
+        entry->running = false;
+        entry->running_thread_id = std::thread::id{};
+        _done_condition.notify_all();
+
+        // It got triggered again while running.
+        if (entry->pending && entry->work) {
+            _ready.push_back(entry);
+            _ready_condition.notify_one();
+        }
+    }
+}
+
+} // namespace mavsdk
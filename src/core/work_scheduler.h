@@ -0,0 +1,59 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace mavsdk {
+
+// Runs registered work on a shared set of threads whenever it has been
+// triggered. This replaces having a thread per user which polls for work.
+//
+// The same work never runs on two threads at the same time. If it is triggered
+// while running, it is run again afterwards.
+class WorkScheduler {
+public:
+    explicit WorkScheduler(unsigned num_threads);
+    ~WorkScheduler();
+
+    // delete copy and move constructors and assign operators
+    WorkScheduler(WorkScheduler const&) = delete; // Copy construct
+    WorkScheduler(WorkScheduler&&) = delete; // Move construct
+    WorkScheduler& operator=(WorkScheduler const&) = delete; // Copy assign
+    WorkScheduler& operator=(WorkScheduler&&) = delete; // Move assign
+
+    void add(std::function<void()> work, void** cookie);
+
+    // Triggering work which is already pending does nothing.
+    void trigger(const void* cookie);
+
+    // Once this returns, the work is not running anymore and won't be run
+    // again, unless called from the work itself.
+    void remove(const void* cookie);
+
+private:
+    struct Entry {
+        std::function<void()> work{nullptr};
+        bool pending{false};
+        bool running{false};
+        std::thread::id running_thread_id{};
+    };
+
+    void work_thread();
+
+    std::unordered_map<void*, std::shared_ptr<Entry>> _entries{};
+    std::deque<std::shared_ptr<Entry>> _ready{};
+    std::mutex _mutex{};
+    std::condition_variable _ready_condition{};
+    std::condition_variable _done_condition{};
+    bool _should_exit{false};
+
+    std::vector<std::thread*> _threads{};
+};
+
+} // namespace mavsdk
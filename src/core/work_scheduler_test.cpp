@@ -0,0 +1,113 @@
+#include "work_scheduler.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+
+using namespace mavsdk;
+
+TEST(WorkScheduler, RunsWhenTriggered)
+{
+    WorkScheduler ws(1);
+
+    std::atomic<int> num_run{0};
+    auto prom = std::make_shared<std::promise<void>>();
+    auto fut = prom->get_future();
+
+    void* cookie = nullptr;
+    ws.add(
+        [&num_run, prom]() {
+            if (++num_run == 1) {
+                prom->set_value();
+            }
+        },
+        &cookie);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(num_run, 0);
+
+    ws.trigger(cookie);
+    EXPECT_EQ(fut.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+
+    ws.remove(cookie);
+    EXPECT_EQ(num_run, 1);
+}
+
+TEST(WorkScheduler, NeverRunsConcurrently)
+{
+    WorkScheduler ws(4);
+
+    std::atomic<bool> running{false};
+    std::atomic<bool> ran_concurrently{false};
+    std::atomic<int> num_run{0};
+
+    void* cookie = nullptr;
+    ws.add(
+        [&]() {
+            if (running.exchange(true)) {
+                ran_concurrently = true;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            running = false;
+            ++num_run;
+        },
+        &cookie);
+
+    for (int i = 0; i < 100; ++i) {
+        ws.trigger(cookie);
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+
+    ws.remove(cookie);
+    EXPECT_FALSE(ran_concurrently);
+    EXPECT_GT(num_run, 0);
+}
+
+TEST(WorkScheduler, NotRunAfterRemove)
+{
+    WorkScheduler ws(2);
+
+    std::atomic<bool> removed{false};
+    std::atomic<bool> run_after_remove{false};
+
+    void* cookie = nullptr;
+    ws.add(
+        [&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            if (removed) {
+                run_after_remove = true;
+            }
+        },
+        &cookie);
+
+    ws.trigger(cookie);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    ws.trigger(cookie);
+    ws.remove(cookie);
+    removed = true;
+
+    // Triggering removed work is ignored.
+    ws.trigger(cookie);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(run_after_remove);
+}
+
+TEST(WorkScheduler, RemoveFromWithinWork)
+{
+    WorkScheduler ws(1);
+
+    auto prom = std::make_shared<std::promise<void>>();
+    auto fut = prom->get_future();
+
+    void* cookie = nullptr;
+    ws.add(
+        [&ws, &cookie, prom]() {
+            // This must not deadlock.
+            ws.remove(cookie);
+            prom->set_value();
+        },
+        &cookie);
+
+    ws.trigger(cookie);
+    EXPECT_EQ(fut.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+}
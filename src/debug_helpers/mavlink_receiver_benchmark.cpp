@@ -0,0 +1,148 @@
+// Compares the throughput of MAVLinkReceiver with feeding every byte to
+// mavlink_parse_char().
+//
+// Usage: mavlink_receiver_benchmark [capture file]
+//
+// Without a capture file, synthetic telemetry traffic is used. A capture file
+// has to contain the raw bytes as received, e.g. dumped from a serial port.
+
+#include "mavlink_channels.h"
+#include "mavlink_receiver.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+using namespace mavsdk;
+
+namespace {
+
+constexpr unsigned num_rounds = 20;
+
+std::vector<char> create_traffic(uint8_t channel)
+{
+    std::vector<char> data;
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    mavlink_message_t message;
+
+    for (unsigned i = 0; i < 100000; ++i) {
+        switch (i % 4) {
+            case 0:
+                mavlink_msg_heartbeat_pack_chan(
+                    1, 1, channel, &message, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_PX4, 0, 0, 0);
+                break;
+            case 1:
+                mavlink_msg_global_position_int_pack_chan(
+                    1, 1, channel, &message, i, 473977418, 85455939, 488000, 10000, 1, 2, 3, 9000);
+                break;
+            default:
+                mavlink_msg_attitude_pack_chan(
+                    1, 1, channel, &message, i, 0.1f, 0.2f, 0.3f, 0.01f, 0.02f, 0.03f);
+                break;
+        }
+        const uint16_t len = mavlink_msg_to_send_buffer(buffer, &message);
+        data.insert(data.end(), buffer, buffer + len);
+    }
+    return data;
+}
+
+void print_result(const char* name, std::size_t num_bytes, double seconds, unsigned num_messages)
+{
+    std::printf(
+        "%-40s %8.1f MB/s (%u messages)\n",
+        name,
+        static_cast<double>(num_bytes) * num_rounds / seconds / 1e6,
+        num_messages);
+}
+
+unsigned run_byte_wise(uint8_t channel, const std::vector<char>& data)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    unsigned num_messages = 0;
+    for (unsigned round = 0; round < num_rounds; ++round) {
+        mavlink_message_t message;
+        mavlink_status_t status;
+        num_messages = 0;
+        for (const char c : data) {
+            if (mavlink_parse_char(channel, static_cast<uint8_t>(c), &message, &status) ==
+                MAVLINK_FRAMING_OK) {
+                ++num_messages;
+            }
+        }
+    }
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    print_result("mavlink_parse_char", data.size(), elapsed.count(), num_messages);
+    return num_messages;
+}
+
+unsigned run_receiver(uint8_t channel, std::vector<char>& data, std::size_t chunk_size)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    unsigned num_messages = 0;
+    for (unsigned round = 0; round < num_rounds; ++round) {
+        MAVLinkReceiver receiver(channel);
+        num_messages = 0;
+        for (std::size_t i = 0; i < data.size(); i += chunk_size) {
+            const auto len = std::min(chunk_size, data.size() - i);
+            receiver.set_new_datagram(&data[i], static_cast<unsigned>(len));
+            while (receiver.parse_message()) {
+                ++num_messages;
+            }
+        }
+    }
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    char name[64];
+    std::snprintf(name, sizeof(name), "MAVLinkReceiver (%zu byte chunks)", chunk_size);
+    print_result(name, data.size(), elapsed.count(), num_messages);
+    return num_messages;
+}
+
+} // namespace
+
+int main(int argc, const char* argv[])
+{
+    uint8_t channel;
+    if (!MAVLinkChannels::Instance().checkout_free_channel(channel)) {
+        std::cerr << "No free channel" << std::endl;
+        return 1;
+    }
+
+    std::vector<char> data;
+    if (argc > 1) {
+        std::ifstream file(argv[1], std::ios::binary);
+        if (!file) {
+            std::cerr << "Could not open " << argv[1] << std::endl;
+            return 1;
+        }
+        data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    } else {
+        data = create_traffic(channel);
+    }
+
+    std::cout << "Parsing " << data.size() << " bytes " << num_rounds << " times" << std::endl;
+
+    const unsigned expected = run_byte_wise(channel, data);
+
+    // Typical UDP datagrams, and small reads as they come from a serial port.
+    bool same_result = true;
+    for (const std::size_t chunk_size : {std::size_t(1400), std::size_t(64), std::size_t(8)}) {
+        if (run_receiver(channel, data, chunk_size) != expected) {
+            same_result = false;
+        }
+    }
+
+    MAVLinkChannels::Instance().checkin_used_channel(channel);
+
+    if (!same_result) {
+        std::cerr << "Message count differs from mavlink_parse_char" << std::endl;
+        return 1;
+    }
+    return 0;
+}
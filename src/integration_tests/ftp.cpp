@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstring>
 #include <iostream>
 #include <fstream>
@@ -5,12 +6,15 @@
 #include <vector>
 #include <atomic>
 #include <future>
+#include <mutex>
+#include <set>
 
 #include "integration_test_helper.h"
 #include "global_include.h"
 #include "mavsdk.h"
 #include "system.h"
 #include "plugins/ftp/ftp.h"
+#include "plugins/ftp/ftp_extended.h"
 
 #include <random>
 #include "plugins/mavlink_passthrough/mavlink_passthrough.h"
@@ -38,6 +42,19 @@ void create_test_file(std::string file_name, uint32_t size)
     of.close();
 }
 
+void create_random_test_file(std::string file_name, uint32_t size)
+{
+    // Unlike the same byte over and over, data written at the wrong offset shows in the CRC.
+    std::uniform_int_distribution<int> byte_distribution(0, 255);
+    std::string str(size, '\0');
+    for (auto& c : str) {
+        c = static_cast<char>(byte_distribution(random_engine));
+    }
+    std::ofstream of(file_name, std::fstream::trunc | std::fstream::binary);
+    of << str;
+    of.close();
+}
+
 void test_create_directory(std::shared_ptr<Ftp> ftp, const std::string& path)
 {
     auto prom = std::make_shared<std::promise<Ftp::Result>>();
@@ -137,6 +154,24 @@ void test_upload(
     EXPECT_EQ(result, Ftp::Result::Success);
 }
 
+Ftp::ProgressData test_sync_directory(
+    std::shared_ptr<FtpExtended> ftp, const std::string& remote_dir, const std::string& local_dir)
+{
+    auto prom = std::make_shared<std::promise<std::pair<Ftp::Result, Ftp::ProgressData>>>();
+    auto future_result = prom->get_future();
+    ftp->sync_directory_async(
+        remote_dir, local_dir, [prom](Ftp::Result result, Ftp::ProgressData progress) {
+            if (result != Ftp::Result::Next) {
+                prom->set_value(std::make_pair(result, progress));
+            }
+        });
+
+    auto result = future_result.get();
+    EXPECT_EQ(result.first, Ftp::Result::Success);
+    EXPECT_EQ(result.second.bytes_transferred, result.second.total_bytes);
+    return result.second;
+}
+
 void test_rename(std::shared_ptr<Ftp> ftp, const std::string& from, const std::string& to)
 {
     auto prom = std::make_shared<std::promise<Ftp::Result>>();
@@ -309,7 +344,7 @@ TEST(FtpTest, TestServer)
     ftp_server->set_root_directory(".");
     uint8_t server_comp_id = ftp_server->get_our_compid();
 
-    auto ftp_client = std::make_shared<Ftp>(system_gcs);
+    auto ftp_client = std::make_shared<FtpExtended>(system_gcs);
     ftp_client->set_target_compid(server_comp_id);
 
     test_list_directory(ftp_client, "/");
@@ -331,6 +366,10 @@ TEST(FtpTest, TestServer)
 
     test_download(ftp_client, "test/" + file_name2, ".");
 
+    // The first sync downloads the file, the second one finds it unchanged.
+    EXPECT_EQ(test_sync_directory(ftp_client, "test", "ftp_sync_dir").total_bytes, 100000);
+    EXPECT_EQ(test_sync_directory(ftp_client, "test", "ftp_sync_dir").total_bytes, 0);
+
     Ftp::Result result = test_remove_file(ftp_client, "test/" + file_name1);
     EXPECT_EQ(result, Ftp::Result::FileDoesNotExist);
 
@@ -340,3 +379,412 @@ TEST(FtpTest, TestServer)
     result = test_remove_directory(ftp_client, "test");
     EXPECT_EQ(result, Ftp::Result::Success);
 }
+
+// MAVLink FTP opcodes and errors used below, as defined by the protocol.
+enum FtpOpcode : uint8_t {
+    CMD_LIST_DIRECTORY = 3,
+    CMD_READ_FILE = 5,
+    CMD_WRITE_FILE = 7,
+    CMD_BURST_READ_FILE = 15,
+    RSP_ACK = 128,
+    RSP_NAK = 129,
+};
+static constexpr uint8_t ERR_UNKOWN_COMMAND = 7;
+
+// The parts of an FTP message the tests look at.
+struct FtpMessage {
+    bool outgoing;
+    bool dropped;
+    uint16_t seq_number;
+    uint8_t session;
+    uint8_t opcode;
+    uint8_t req_opcode;
+    uint32_t offset;
+};
+
+FtpMessage decode_ftp_message(const mavlink_message_t& message, bool outgoing)
+{
+    mavlink_file_transfer_protocol_t ftp_message;
+    mavlink_msg_file_transfer_protocol_decode(&message, &ftp_message);
+
+    FtpMessage result{};
+    result.outgoing = outgoing;
+    memcpy(&result.seq_number, &ftp_message.payload[0], sizeof(result.seq_number));
+    result.session = ftp_message.payload[2];
+    result.opcode = ftp_message.payload[3];
+    result.req_opcode = ftp_message.payload[5];
+    memcpy(&result.offset, &ftp_message.payload[8], sizeof(result.offset));
+    return result;
+}
+
+// A client and the FTP server of a second Mavsdk instance, connected over UDP on localhost.
+// The FTP messages of the client are logged, including the ones tests choose to drop.
+class FtpServerTest : public testing::Test {
+protected:
+    void SetUp() override
+    {
+        Mavsdk::Configuration config_gcs(Mavsdk::Configuration::UsageType::GroundStation);
+        _mavsdk_gcs.set_configuration(config_gcs);
+        ASSERT_EQ(_mavsdk_gcs.add_udp_connection(24550), ConnectionResult::Success);
+        auto system_gcs = _mavsdk_gcs.systems().at(0);
+
+        Mavsdk::Configuration config_cc(Mavsdk::Configuration::UsageType::GroundStation);
+        _mavsdk_cc.set_configuration(config_cc);
+        ASSERT_EQ(_mavsdk_cc.setup_udp_remote("127.0.0.1", 24550), ConnectionResult::Success);
+        auto system_cc = _mavsdk_cc.systems().at(0);
+
+        _ftp_server = std::make_shared<Ftp>(system_cc);
+        _ftp_server->set_root_directory(".");
+        _passthrough_server = std::make_shared<MavlinkPassthrough>(system_cc);
+
+        _ftp_client = std::make_shared<FtpExtended>(system_gcs);
+        _ftp_client->set_target_compid(_ftp_server->get_our_compid());
+        _passthrough_client = std::make_shared<MavlinkPassthrough>(system_gcs);
+        _passthrough_client->intercept_outgoing_messages_async(
+            [this](mavlink_message_t& message) { return log_client_message(message, true); });
+        _passthrough_client->intercept_incoming_messages_async(
+            [this](mavlink_message_t& message) { return log_client_message(message, false); });
+
+        test_create_directory(_ftp_client, server_dir);
+    }
+
+    void TearDown() override
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _drop_client_message = nullptr;
+        }
+        EXPECT_EQ(test_remove_directory(_ftp_client, server_dir), Ftp::Result::Success);
+    }
+
+    bool log_client_message(mavlink_message_t& message, bool outgoing)
+    {
+        if (message.msgid != MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL) {
+            return true;
+        }
+
+        auto ftp_message = decode_ftp_message(message, outgoing);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        ftp_message.dropped = _drop_client_message && _drop_client_message(ftp_message);
+        _client_log.push_back(ftp_message);
+        return !ftp_message.dropped;
+    }
+
+    // Drops the messages the client sends or receives for which drop returns true.
+    void drop_client_messages(std::function<bool(const FtpMessage&)> drop)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _drop_client_message = drop;
+    }
+
+    std::vector<FtpMessage> client_log()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _client_log;
+    }
+
+    // Uploads a file while the first attempt to write one of its chunks gets lost, and returns
+    // the largest number of writes which were waiting for their ACK at the same time.
+    unsigned upload_with_lost_write(uint32_t window)
+    {
+        const std::string file_name = "ftp_window_file";
+        const std::string remote_file = std::string(server_dir) + "/" + file_name;
+        create_random_test_file(file_name, 100000);
+
+        _ftp_client->set_upload_window(window);
+
+        const uint32_t lost_offset = 5 * 239;
+        auto lost = std::make_shared<bool>(false);
+        drop_client_messages([lost_offset, lost](const FtpMessage& message) {
+            if (!message.outgoing || message.opcode != CMD_WRITE_FILE ||
+                message.offset != lost_offset || *lost) {
+                return false;
+            }
+            *lost = true;
+            return true;
+        });
+
+        test_upload(_ftp_client, file_name, server_dir);
+        compare(_ftp_client, file_name, remote_file);
+
+        std::set<uint16_t> in_flight;
+        unsigned max_in_flight = 0;
+        unsigned num_lost_offset_writes = 0;
+        for (const auto& message : client_log()) {
+            if (message.outgoing && message.opcode == CMD_WRITE_FILE) {
+                in_flight.insert(message.seq_number);
+                if (message.offset == lost_offset) {
+                    ++num_lost_offset_writes;
+                }
+            } else if (
+                !message.outgoing && !message.dropped && message.opcode == RSP_ACK &&
+                message.req_opcode == CMD_WRITE_FILE) {
+                // The server acknowledges with the sequence number of the write plus one.
+                in_flight.erase(static_cast<uint16_t>(message.seq_number - 1));
+            }
+            max_in_flight = std::max(max_in_flight, static_cast<unsigned>(in_flight.size()));
+        }
+
+        // The lost write was sent again.
+        EXPECT_GE(num_lost_offset_writes, 2u);
+
+        remove(file_name.c_str());
+        remove(remote_file.c_str());
+        return max_in_flight;
+    }
+
+    // Downloads a file while all burst data from cutoff_offset on gets lost, so the download
+    // times out and keeps the part it got for a later download to resume.
+    void interrupt_download(const std::string& remote_file, uint32_t cutoff_offset)
+    {
+        drop_client_messages([cutoff_offset](const FtpMessage& message) {
+            return !message.outgoing && message.opcode == RSP_ACK &&
+                   message.req_opcode == CMD_BURST_READ_FILE && message.offset >= cutoff_offset;
+        });
+
+        auto prom = std::make_shared<std::promise<Ftp::Result>>();
+        auto future_result = prom->get_future();
+        _ftp_client->download_async(
+            remote_file, ".", [prom](Ftp::Result result, Ftp::ProgressData progress) {
+                UNUSED(progress);
+                if (result != Ftp::Result::Next) {
+                    prom->set_value(result);
+                }
+            });
+        EXPECT_EQ(future_result.get(), Ftp::Result::Timeout);
+
+        drop_client_messages(nullptr);
+
+        // The server still has the file of the timed out session open.
+        std::shared_ptr<Ftp> ftp = _ftp_client;
+        reset_server(ftp);
+    }
+
+    // Returns the offsets of the burst reads the client requested since the log had num_messages.
+    std::vector<uint32_t> burst_read_offsets_since(std::size_t num_messages)
+    {
+        std::vector<uint32_t> offsets;
+        const auto log = client_log();
+        for (auto it = log.begin() + num_messages; it != log.end(); ++it) {
+            if (it->outgoing && it->opcode == CMD_BURST_READ_FILE) {
+                offsets.push_back(it->offset);
+            }
+        }
+        return offsets;
+    }
+
+    static constexpr auto server_dir = "ftp_server_test";
+
+    Mavsdk _mavsdk_gcs{};
+    Mavsdk _mavsdk_cc{};
+    std::shared_ptr<Ftp> _ftp_server{};
+    std::shared_ptr<MavlinkPassthrough> _passthrough_server{};
+    std::shared_ptr<FtpExtended> _ftp_client{};
+    std::shared_ptr<MavlinkPassthrough> _passthrough_client{};
+
+    std::mutex _mutex{};
+    std::vector<FtpMessage> _client_log{};
+    std::function<bool(const FtpMessage&)> _drop_client_message{};
+};
+
+TEST_F(FtpServerTest, DownloadRereadsChunksLostInBurst)
+{
+    const std::string file_name = "ftp_burst_file";
+    const std::string remote_file = std::string(server_dir) + "/" + file_name;
+    create_random_test_file(remote_file, 100000);
+
+    // Two chunks of the first burst get lost, once.
+    const std::vector<uint32_t> lost_offsets{3 * 239, 10 * 239};
+    auto dropped = std::make_shared<std::vector<uint32_t>>();
+    drop_client_messages([lost_offsets, dropped](const FtpMessage& message) {
+        if (message.outgoing || message.opcode != RSP_ACK ||
+            message.req_opcode != CMD_BURST_READ_FILE) {
+            return false;
+        }
+        if (std::find(lost_offsets.begin(), lost_offsets.end(), message.offset) ==
+                lost_offsets.end() ||
+            std::find(dropped->begin(), dropped->end(), message.offset) != dropped->end()) {
+            return false;
+        }
+        dropped->push_back(message.offset);
+        return true;
+    });
+
+    test_download(_ftp_client, remote_file, ".");
+    compare(_ftp_client, file_name, remote_file);
+
+    // The lost chunks, and only these, are read again one by one.
+    std::set<uint32_t> reread_offsets;
+    for (const auto& message : client_log()) {
+        if (message.outgoing && message.opcode == CMD_READ_FILE) {
+            reread_offsets.insert(message.offset);
+        }
+    }
+    EXPECT_EQ(reread_offsets, std::set<uint32_t>(lost_offsets.begin(), lost_offsets.end()));
+
+    remove(file_name.c_str());
+    remove(remote_file.c_str());
+}
+
+TEST_F(FtpServerTest, DownloadFallsBackToChunksIfServerNaksBurst)
+{
+    const std::string file_name = "ftp_no_burst_file";
+    const std::string remote_file = std::string(server_dir) + "/" + file_name;
+    create_random_test_file(remote_file, 10000);
+
+    // The server does not know about burst reads, like older autopilots.
+    _passthrough_server->intercept_incoming_messages_async([this](mavlink_message_t& message) {
+        if (message.msgid != MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL) {
+            return true;
+        }
+        const auto request = decode_ftp_message(message, false);
+        if (request.opcode != CMD_BURST_READ_FILE) {
+            return true;
+        }
+
+        uint8_t payload[MAVLINK_MSG_FILE_TRANSFER_PROTOCOL_FIELD_PAYLOAD_LEN]{};
+        const uint16_t seq_number = request.seq_number + 1;
+        memcpy(&payload[0], &seq_number, sizeof(seq_number));
+        payload[2] = request.session;
+        payload[3] = RSP_NAK;
+        payload[4] = 1;
+        payload[5] = CMD_BURST_READ_FILE;
+        payload[12] = ERR_UNKOWN_COMMAND;
+
+        mavlink_message_t nak;
+        mavlink_msg_file_transfer_protocol_pack(
+            _passthrough_server->get_our_sysid(),
+            _passthrough_server->get_our_compid(),
+            &nak,
+            0,
+            message.sysid,
+            message.compid,
+            payload);
+        _passthrough_server->send_message(nak);
+        return false;
+    });
+
+    test_download(_ftp_client, remote_file, ".");
+    compare(_ftp_client, file_name, remote_file);
+
+    // After the NAK, the whole file is read chunk by chunk.
+    unsigned num_burst_reads = 0;
+    unsigned num_reads = 0;
+    for (const auto& message : client_log()) {
+        if (message.outgoing && message.opcode == CMD_BURST_READ_FILE) {
+            ++num_burst_reads;
+        } else if (message.outgoing && message.opcode == CMD_READ_FILE) {
+            ++num_reads;
+        }
+    }
+    EXPECT_EQ(num_burst_reads, 1u);
+    EXPECT_GE(num_reads, (10000u + 238u) / 239u);
+
+    _passthrough_server->intercept_incoming_messages_async(nullptr);
+    remove(file_name.c_str());
+    remove(remote_file.c_str());
+}
+
+TEST_F(FtpServerTest, UploadWithWindowOfOneWaitsForEachAck)
+{
+    EXPECT_EQ(upload_with_lost_write(1), 1u);
+}
+
+TEST_F(FtpServerTest, UploadWithWindowKeepsSeveralWritesInFlight)
+{
+    // While the lost write waits to be sent again, the other writes keep going.
+    const unsigned max_in_flight = upload_with_lost_write(4);
+    EXPECT_GT(max_in_flight, 1u);
+    EXPECT_LE(max_in_flight, 4u);
+}
+
+TEST_F(FtpServerTest, ListDirectoryQueuedBehindDownloadRunsBetweenBursts)
+{
+    const std::string file_name = "ftp_queued_file";
+    const std::string remote_file = std::string(server_dir) + "/" + file_name;
+    create_random_test_file(remote_file, 100000);
+
+    auto prom = std::make_shared<std::promise<Ftp::Result>>();
+    auto future_result = prom->get_future();
+    _ftp_client->download_async(
+        remote_file, ".", [prom](Ftp::Result result, Ftp::ProgressData progress) {
+            UNUSED(progress);
+            if (result != Ftp::Result::Next) {
+                prom->set_value(result);
+            }
+        });
+
+    // The download is running, so the listing is queued instead of failing with Busy.
+    test_list_directory(_ftp_client, server_dir);
+
+    EXPECT_EQ(future_result.get(), Ftp::Result::Success);
+    compare(_ftp_client, file_name, remote_file);
+
+    // The listing did not wait for the download to finish.
+    bool listed = false;
+    unsigned num_burst_reads_after_list = 0;
+    for (const auto& message : client_log()) {
+        if (message.outgoing && message.opcode == CMD_LIST_DIRECTORY) {
+            listed = true;
+        } else if (listed && message.outgoing && message.opcode == CMD_BURST_READ_FILE) {
+            ++num_burst_reads_after_list;
+        }
+    }
+    EXPECT_TRUE(listed);
+    EXPECT_GT(num_burst_reads_after_list, 0u);
+
+    remove(file_name.c_str());
+    remove(remote_file.c_str());
+}
+
+TEST_F(FtpServerTest, DownloadResumesWhereInterruptedDownloadStopped)
+{
+    const std::string file_name = "ftp_resume_file";
+    const std::string remote_file = std::string(server_dir) + "/" + file_name;
+    create_random_test_file(remote_file, 100000);
+
+    const uint32_t cutoff_offset = 30000;
+    interrupt_download(remote_file, cutoff_offset);
+    const auto num_messages = client_log().size();
+
+    test_download(_ftp_client, remote_file, ".");
+    compare(_ftp_client, file_name, remote_file);
+
+    // The kept part was not read again.
+    const auto offsets = burst_read_offsets_since(num_messages);
+    ASSERT_FALSE(offsets.empty());
+    EXPECT_GT(offsets.front(), 0u);
+    EXPECT_LE(offsets.front(), cutoff_offset);
+
+    // The checkpoint is gone once the file is complete.
+    EXPECT_FALSE(std::ifstream(file_name + ".resume").good());
+
+    remove(file_name.c_str());
+    remove(remote_file.c_str());
+}
+
+TEST_F(FtpServerTest, ResumedDownloadStartsOverIfRemoteFileChanged)
+{
+    const std::string file_name = "ftp_changed_file";
+    const std::string remote_file = std::string(server_dir) + "/" + file_name;
+    create_random_test_file(remote_file, 100000);
+
+    interrupt_download(remote_file, 30000);
+    const auto num_messages = client_log().size();
+
+    // Same path and size, so only the comparison at the end can tell.
+    create_random_test_file(remote_file, 100000);
+
+    test_download(_ftp_client, remote_file, ".");
+    compare(_ftp_client, file_name, remote_file);
+
+    // The resumed download did not match and was done again from the start.
+    const auto offsets = burst_read_offsets_since(num_messages);
+    ASSERT_FALSE(offsets.empty());
+    EXPECT_GT(offsets.front(), 0u);
+    EXPECT_NE(std::find(offsets.begin(), offsets.end(), 0u), offsets.end());
+
+    remove(file_name.c_str());
+    remove(remote_file.c_str());
+}
@@ -499,8 +499,8 @@ public:
      */
     const Action& operator=(const Action&) = delete;
 
-private:
-    /** @private Underlying implementation, set at instantiation */
+protected:
+    /** @private Underlying implementation, set at instantiation, also used by extensions */
     std::unique_ptr<ActionImpl> _impl;
 };
 
@@ -191,8 +191,8 @@ public:
      */
     const Calibration& operator=(const Calibration&) = delete;
 
-private:
-    /** @private Underlying implementation, set at instantiation */
+protected:
+    /** @private Underlying implementation, set at instantiation, also used by extensions */
     std::unique_ptr<CalibrationImpl> _impl;
 };
 
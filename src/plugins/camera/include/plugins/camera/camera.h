@@ -729,8 +729,8 @@ public:
      */
     const Camera& operator=(const Camera&) = delete;
 
-private:
-    /** @private Underlying implementation, set at instantiation */
+protected:
+    /** @private Underlying implementation, set at instantiation, also used by extensions */
     std::unique_ptr<CameraImpl> _impl;
 };
 
@@ -150,8 +150,8 @@ public:
      */
     const Failure& operator=(const Failure&) = delete;
 
-private:
-    /** @private Underlying implementation, set at instantiation */
+protected:
+    /** @private Underlying implementation, set at instantiation, also used by extensions */
     std::unique_ptr<FailureImpl> _impl;
 };
 
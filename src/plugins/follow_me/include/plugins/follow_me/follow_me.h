@@ -234,8 +234,8 @@ public:
      */
     const FollowMe& operator=(const FollowMe&) = delete;
 
-private:
-    /** @private Underlying implementation, set at instantiation */
+protected:
+    /** @private Underlying implementation, set at instantiation, also used by extensions */
     std::unique_ptr<FollowMeImpl> _impl;
 };
 
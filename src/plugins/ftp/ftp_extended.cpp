@@ -0,0 +1,23 @@
+#include "ftp_impl.h"
+#include "plugins/ftp/ftp_extended.h"
+
+namespace mavsdk {
+
+FtpExtended::FtpExtended(System& system) : Ftp(system) {}
+
+FtpExtended::FtpExtended(std::shared_ptr<System> system) : Ftp(std::move(system)) {}
+
+FtpExtended::~FtpExtended() {}
+
+void FtpExtended::sync_directory_async(
+    std::string remote_dir, std::string local_dir, SyncDirectoryCallback callback)
+{
+    _impl->sync_directory_async(remote_dir, local_dir, callback);
+}
+
+void FtpExtended::set_upload_window(uint32_t window) const
+{
+    _impl->set_upload_window(window);
+}
+
+} // namespace mavsdk
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cstdlib>
 #include <functional>
 #include <iostream>
 
@@ -70,20 +72,38 @@ void FtpImpl::_process_ack(PayloadHeader* payload)
             _session = payload->session;
             _bytes_transferred = 0;
             _file_size = *(reinterpret_cast<uint32_t*>(payload->data));
+            _burst_offset = 0;
+            _read_gaps.clear();
+            if (_resume_offset > 0 && _resume_file_size == _file_size) {
+                // Keep what an earlier attempt downloaded already.
+                LogInfo() << "Resuming download at " << _resume_offset << " B";
+                _burst_offset = _resume_offset;
+                _bytes_transferred = _resume_offset;
+            } else if (_resume_offset > 0) {
+                // The remote file changed since, so start over.
+                _ofstream.stream.close();
+                _ofstream.stream.open(_ofstream.path, std::fstream::trunc | std::fstream::binary);
+                if (!_ofstream.stream) {
+                    _session_result = ServerResult::ERR_FILE_IO_ERROR;
+                    _end_read_session();
+                    return;
+                }
+            }
+            _resume_offset = 0;
+            _checkpoint_offset = _burst_offset;
+            if (!_burst_read_supported) {
+                _read_rest_in_chunks();
+            }
             _call_op_progress_callback(_bytes_transferred, _file_size);
             _read();
             break;
 
         case CMD_READ_FILE:
-            _ofstream.stream.write(reinterpret_cast<const char*>(payload->data), payload->size);
-            if (!_ofstream.stream) {
-                _session_result = ServerResult::ERR_FILE_IO_ERROR;
-                _end_read_session();
-                return;
-            }
-            _bytes_transferred += payload->size;
-            _call_op_progress_callback(_bytes_transferred, _file_size);
-            _read();
+            _process_read_ack(payload);
+            break;
+
+        case CMD_BURST_READ_FILE:
+            _process_burst_read_ack(payload);
             break;
 
         case CMD_OPEN_FILE_WO:
@@ -91,13 +111,14 @@ void FtpImpl::_process_ack(PayloadHeader* payload)
             _session_valid = true;
             _session = payload->session;
             _bytes_transferred = 0;
+            _write_offset = 0;
+            _writes_in_flight.clear();
             _call_op_progress_callback(_bytes_transferred, _file_size);
             _write();
             break;
 
         case CMD_WRITE_FILE:
-            _call_op_progress_callback(_bytes_transferred, _file_size);
-            _write();
+            _process_write_ack(payload);
             break;
 
         case CMD_TERMINATE_SESSION:
@@ -170,6 +191,18 @@ void FtpImpl::_process_nak(PayloadHeader* payload)
 void FtpImpl::_process_nak(ServerResult result)
 {
     std::lock_guard<std::mutex> lock(_curr_op_mutex);
+
+    if (_curr_op == CMD_BURST_READ_FILE &&
+        (result == ServerResult::ERR_EOF || result == ServerResult::ERR_UNKOWN_COMMAND)) {
+        if (result == ServerResult::ERR_UNKOWN_COMMAND) {
+            LogWarn() << "Burst read not supported, reading chunk by chunk";
+            _burst_read_supported = false;
+        }
+        _read_rest_in_chunks();
+        _read();
+        return;
+    }
+
     switch (_curr_op) {
         case CMD_NONE:
             LogWarn() << "Received NAK without active operation";
@@ -177,11 +210,14 @@ void FtpImpl::_process_nak(ServerResult result)
 
         case CMD_OPEN_FILE_RO:
         case CMD_READ_FILE:
+        case CMD_BURST_READ_FILE:
             _session_result = result;
             if (_session_valid) {
-                const bool delete_file = (result == ServerResult::ERR_FAIL_FILE_DOES_NOT_EXIST);
-                _end_read_session(delete_file);
+                _end_read_session(result == ServerResult::ERR_FAIL_FILE_DOES_NOT_EXIST);
             } else {
+                // Close the file anyway, so it can be opened again to retry. If the file
+                // is gone, there is nothing to resume anymore.
+                _close_download_file(result == ServerResult::ERR_FAIL_FILE_DOES_NOT_EXIST);
                 _stop_timer();
                 _call_op_result_callback(_session_result);
             }
@@ -291,8 +327,7 @@ Ftp::Result FtpImpl::_translate(ServerResult result)
 void FtpImpl::reset_async(Ftp::ResultCallback callback)
 {
     std::lock_guard<std::mutex> lock(_curr_op_mutex);
-    if (_curr_op != CMD_NONE) {
-        callback(Ftp::Result::Busy);
+    if (_queue_if_busy([this, callback]() { reset_async(callback); })) {
         return;
     }
 
@@ -311,16 +346,34 @@ void FtpImpl::download_async(
     const std::string& remote_path, const std::string& local_folder, Ftp::DownloadCallback callback)
 {
     std::lock_guard<std::mutex> lock(_curr_op_mutex);
-    if (_curr_op != CMD_NONE) {
-        Ftp::ProgressData empty{};
-        callback(Ftp::Result::Busy, empty);
+    if (_queue_if_busy([this, remote_path, local_folder, callback]() {
+            download_async(remote_path, local_folder, callback);
+        })) {
         return;
     }
 
     std::string local_path = local_folder + path_separator + fs_filename(remote_path);
 
-    _ofstream.stream.open(local_path, std::fstream::trunc | std::fstream::binary);
+    // Continue an earlier attempt if it left a checkpoint matching the data on disk.
+    if (!_read_checkpoint(local_path, remote_path, _resume_file_size, _resume_offset) ||
+        fs_file_size(local_path) < _resume_offset) {
+        _resume_file_size = 0;
+        _resume_offset = 0;
+    }
+
+    if (_resume_offset > 0) {
+        callback = _verify_resumed_download(remote_path, local_folder, local_path, callback);
+    }
+
+    _ofstream.stream.open(
+        local_path,
+        (_resume_offset > 0) ? (std::fstream::in | std::fstream::binary) :
+                               (std::fstream::trunc | std::fstream::binary));
     _ofstream.path = local_path;
+    _download_remote_path = remote_path;
+    _file_size = 0;
+    _burst_offset = 0;
+    _read_gaps.clear();
     if (!_ofstream.stream) {
         _end_read_session();
         Ftp::ProgressData empty{};
@@ -338,17 +391,118 @@ void FtpImpl::download_async(
     _generic_command_async(CMD_OPEN_FILE_RO, 0, remote_path, result_callback);
 }
 
+Ftp::DownloadCallback FtpImpl::_verify_resumed_download(
+    const std::string& remote_path,
+    const std::string& local_folder,
+    const std::string& local_path,
+    Ftp::DownloadCallback callback)
+{
+    // The checkpoint only tells that the kept part came from a remote file with the same path and
+    // size. MAVLink FTP can't checksum part of a file, so the whole file is compared at the end.
+    return [this, remote_path, local_folder, local_path, callback](
+               Ftp::Result result, Ftp::ProgressData progress) {
+        if (result != Ftp::Result::Success) {
+            callback(result, progress);
+            return;
+        }
+
+        are_files_identical_async(
+            local_path,
+            remote_path,
+            [this, remote_path, local_folder, local_path, callback, progress](
+                Ftp::Result compare_result, bool identical) {
+                if (compare_result == Ftp::Result::Unsupported) {
+                    LogWarn() << "Can't verify resumed download of " << remote_path;
+                    callback(Ftp::Result::Success, progress);
+                } else if (compare_result != Ftp::Result::Success) {
+                    callback(compare_result, progress);
+                } else if (identical) {
+                    callback(Ftp::Result::Success, progress);
+                } else {
+                    LogWarn() << "Remote file " << remote_path
+                              << " changed since the download was interrupted, starting over";
+                    fs_remove(local_path);
+                    download_async(remote_path, local_folder, callback);
+                }
+            });
+    };
+}
+
 void FtpImpl::_end_read_session(bool delete_file)
 {
     _curr_op = CMD_NONE;
-    if (_ofstream.stream.is_open()) {
-        _ofstream.stream.close();
+    _close_download_file(delete_file);
+    _terminate_session();
+}
 
-        if (delete_file) {
-            fs_remove(_ofstream.path);
-        }
+void FtpImpl::_close_download_file(bool delete_file)
+{
+    if (!_ofstream.stream.is_open()) {
+        return;
+    }
+
+    if (_session_result == ServerResult::SUCCESS || delete_file) {
+        fs_remove(_checkpoint_path(_ofstream.path));
+    } else {
+        // Keep the partial file, a later download continues where this one stopped.
+        _write_checkpoint();
+    }
+
+    _ofstream.stream.close();
+
+    if (delete_file) {
+        fs_remove(_ofstream.path);
+    }
+}
+
+std::string FtpImpl::_checkpoint_path(const std::string& local_path)
+{
+    return local_path + ".resume";
+}
+
+uint32_t FtpImpl::_contiguous_read_offset() const
+{
+    return _read_gaps.empty() ? _burst_offset : _read_gaps.front().offset;
+}
+
+bool FtpImpl::_read_checkpoint(
+    const std::string& local_path,
+    const std::string& remote_path,
+    uint32_t& file_size,
+    uint32_t& offset)
+{
+    std::ifstream checkpoint(_checkpoint_path(local_path));
+    std::string checkpoint_remote_path;
+    if (!std::getline(checkpoint, checkpoint_remote_path) ||
+        checkpoint_remote_path != remote_path) {
+        return false;
+    }
+
+    checkpoint >> file_size >> offset;
+    return static_cast<bool>(checkpoint) && offset <= file_size;
+}
+
+void FtpImpl::_write_checkpoint()
+{
+    const uint32_t offset = _contiguous_read_offset();
+    if (offset == 0) {
+        // Nothing to keep, and an earlier checkpoint may still be valid.
+        return;
+    }
+
+    // The checkpoint must not claim more than what is on disk.
+    _ofstream.stream.flush();
+
+    std::ofstream checkpoint(_checkpoint_path(_ofstream.path), std::fstream::trunc);
+    checkpoint << _download_remote_path << '\n' << _file_size << '\n' << offset << '\n';
+    _checkpoint_offset = offset;
+}
+
+void FtpImpl::_update_checkpoint()
+{
+    if (_contiguous_read_offset() >= _checkpoint_offset + checkpoint_interval) {
+        _write_checkpoint();
     }
-    _terminate_session();
 }
 
 void FtpImpl::_read()
@@ -359,25 +513,131 @@ void FtpImpl::_read()
         return;
     }
 
+    if (_pause_read_for_queued_operation()) {
+        return;
+    }
+
     uint8_t raw_payload[MAVLINK_MSG_FILE_TRANSFER_PROTOCOL_FIELD_PAYLOAD_LEN];
+
+    // Burst through the file first, then read what got lost on the way.
+    if (_burst_offset < _file_size) {
+        _fill_burst_read_request(raw_payload);
+        _send_mavlink_ftp_message(raw_payload);
+        return;
+    }
+
+    if (_read_gaps.empty()) {
+        LogErr() << "Download incomplete without any data missing";
+        _session_result = ServerResult::ERR_FAIL;
+        _end_read_session(true);
+        return;
+    }
+
     PayloadHeader* payload = reinterpret_cast<PayloadHeader*>(raw_payload);
     payload->seq_number = _seq_number++;
     payload->session = _session;
     payload->opcode = _curr_op = CMD_READ_FILE;
-    payload->offset = _bytes_transferred;
+    payload->offset = _read_gaps.front().offset;
     payload->size = 0;
     _send_mavlink_ftp_message(raw_payload);
 }
 
+void FtpImpl::_process_read_ack(PayloadHeader* payload)
+{
+    if (_read_gaps.empty() || payload->offset != _read_gaps.front().offset) {
+        // Answer to a request which was sent again, we have this data already.
+        return;
+    }
+
+    if (payload->size == 0) {
+        _session_result = ServerResult::ERR_EOF;
+        _end_read_session(true);
+        return;
+    }
+
+    ReadGap& gap = _read_gaps.front();
+    const uint32_t size = std::min<uint32_t>(payload->size, gap.size);
+    if (!_write_read_data(payload->offset, payload->data, size)) {
+        _session_result = ServerResult::ERR_FILE_IO_ERROR;
+        _end_read_session();
+        return;
+    }
+
+    gap.offset += size;
+    gap.size -= size;
+    if (gap.size == 0) {
+        _read_gaps.pop_front();
+    }
+
+    _bytes_transferred += size;
+    _call_op_progress_callback(_bytes_transferred, _file_size);
+    _update_checkpoint();
+    _read();
+}
+
+void FtpImpl::_process_burst_read_ack(PayloadHeader* payload)
+{
+    // The burst is still coming, so don't time out in the middle of it.
+    _reset_timer();
+
+    if (payload->offset > _burst_offset) {
+        // Packets got lost, read their data again once the bursts are done.
+        _read_gaps.push_back(ReadGap{_burst_offset, payload->offset - _burst_offset});
+        _burst_offset = payload->offset;
+    }
+
+    // Anything before the burst offset was either received already or is a gap now.
+    if (payload->offset == _burst_offset && payload->size > 0) {
+        if (!_write_read_data(payload->offset, payload->data, payload->size)) {
+            _session_result = ServerResult::ERR_FILE_IO_ERROR;
+            _end_read_session();
+            return;
+        }
+        _burst_offset += payload->size;
+        _bytes_transferred += payload->size;
+        _call_op_progress_callback(_bytes_transferred, _file_size);
+        _update_checkpoint();
+    }
+
+    if (payload->burst_complete || _burst_offset >= _file_size) {
+        _read();
+    }
+}
+
+bool FtpImpl::_write_read_data(uint32_t offset, const uint8_t* data, uint32_t size)
+{
+    _ofstream.stream.seekp(offset);
+    _ofstream.stream.write(reinterpret_cast<const char*>(data), size);
+    return _ofstream.stream.good();
+}
+
+void FtpImpl::_read_rest_in_chunks()
+{
+    if (_burst_offset < _file_size) {
+        _read_gaps.push_back(ReadGap{_burst_offset, _file_size - _burst_offset});
+        _burst_offset = _file_size;
+    }
+}
+
+void FtpImpl::_fill_burst_read_request(uint8_t* raw_payload)
+{
+    PayloadHeader* payload = reinterpret_cast<PayloadHeader*>(raw_payload);
+    payload->seq_number = _seq_number++;
+    payload->session = _session;
+    payload->opcode = _curr_op = CMD_BURST_READ_FILE;
+    payload->offset = _burst_offset;
+    payload->size = 0;
+}
+
 void FtpImpl::upload_async(
     const std::string& local_file_path,
     const std::string& remote_folder,
     Ftp::UploadCallback callback)
 {
     std::lock_guard<std::mutex> lock(_curr_op_mutex);
-    if (_curr_op != CMD_NONE) {
-        Ftp::ProgressData empty{};
-        callback(Ftp::Result::Busy, empty);
+    if (_queue_if_busy([this, local_file_path, remote_folder, callback]() {
+            upload_async(local_file_path, remote_folder, callback);
+        })) {
         return;
     }
 
@@ -419,27 +679,49 @@ void FtpImpl::_end_write_session()
 
 void FtpImpl::_write()
 {
-    if (_bytes_transferred >= _file_size) {
+    // Keep up to _upload_window writes in flight, so the upload isn't bound by the round trip.
+    while (_writes_in_flight.size() < _upload_window && _write_offset < _file_size) {
+        uint8_t raw_payload[MAVLINK_MSG_FILE_TRANSFER_PROTOCOL_FIELD_PAYLOAD_LEN];
+        PayloadHeader* payload = reinterpret_cast<PayloadHeader*>(raw_payload);
+        payload->seq_number = _seq_number++;
+        payload->session = _session;
+        payload->opcode = _curr_op = CMD_WRITE_FILE;
+        payload->offset = _write_offset;
+        int bytes_read =
+            _ifstream.readsome(reinterpret_cast<char*>(payload->data), max_data_length);
+        if (!_ifstream || bytes_read <= 0) {
+            _end_write_session();
+            _call_op_result_callback(ServerResult::ERR_FILE_IO_ERROR);
+            return;
+        }
+        payload->size = bytes_read;
+        _write_offset += bytes_read;
+        _send_mavlink_ftp_message(raw_payload);
+        _writes_in_flight.emplace(
+            static_cast<uint16_t>(payload->seq_number),
+            WriteInFlight{payload->size, _last_command});
+    }
+
+    if (_writes_in_flight.empty()) {
         _session_result = ServerResult::SUCCESS;
         _end_write_session();
-        return;
     }
+}
 
-    uint8_t raw_payload[MAVLINK_MSG_FILE_TRANSFER_PROTOCOL_FIELD_PAYLOAD_LEN];
-    PayloadHeader* payload = reinterpret_cast<PayloadHeader*>(raw_payload);
-    payload->seq_number = _seq_number++;
-    payload->session = _session;
-    payload->opcode = _curr_op = CMD_WRITE_FILE;
-    payload->offset = _bytes_transferred;
-    int bytes_read = _ifstream.readsome(reinterpret_cast<char*>(payload->data), max_data_length);
-    if (!_ifstream) {
-        _end_write_session();
-        _call_op_result_callback(ServerResult::ERR_FILE_IO_ERROR);
+void FtpImpl::_process_write_ack(PayloadHeader* payload)
+{
+    // The server acknowledges with the sequence number of the write plus one.
+    const auto it = _writes_in_flight.find(static_cast<uint16_t>(payload->seq_number - 1));
+    if (it == _writes_in_flight.end()) {
+        // Answer to a write which was sent again, it is acknowledged already.
         return;
     }
-    payload->size = bytes_read;
-    _bytes_transferred += bytes_read;
-    _send_mavlink_ftp_message(raw_payload);
+
+    _reset_timer();
+    _bytes_transferred += it->second.size;
+    _writes_in_flight.erase(it);
+    _call_op_progress_callback(_bytes_transferred, _file_size);
+    _write();
 }
 
 void FtpImpl::_terminate_session()
@@ -474,8 +756,8 @@ void FtpImpl::list_directory_async(
     const std::string& path, Ftp::ListDirectoryCallback callback, uint32_t offset)
 {
     std::lock_guard<std::mutex> lock(_curr_op_mutex);
-    if (_curr_op != CMD_NONE && offset == 0) {
-        callback(Ftp::Result::Busy, std::vector<std::string>());
+    const auto operation = [this, path, callback]() { list_directory_async(path, callback); };
+    if (offset == 0 && _queue_if_busy(operation, false)) {
         return;
     }
     if (path.length() >= max_data_length) {
@@ -544,6 +826,9 @@ Ftp::Result FtpImpl::create_directory(const std::string& path)
 void FtpImpl::create_directory_async(const std::string& path, Ftp::ResultCallback callback)
 {
     std::lock_guard<std::mutex> lock(_curr_op_mutex);
+    if (_queue_if_busy([this, path, callback]() { create_directory_async(path, callback); })) {
+        return;
+    }
     _generic_command_async(CMD_CREATE_DIRECTORY, 0, path, callback);
 }
 
@@ -560,6 +845,9 @@ Ftp::Result FtpImpl::remove_directory(const std::string& path)
 void FtpImpl::remove_directory_async(const std::string& path, Ftp::ResultCallback callback)
 {
     std::lock_guard<std::mutex> lock(_curr_op_mutex);
+    if (_queue_if_busy([this, path, callback]() { remove_directory_async(path, callback); })) {
+        return;
+    }
     _generic_command_async(CMD_REMOVE_DIRECTORY, 0, path, callback);
 }
 
@@ -576,6 +864,9 @@ Ftp::Result FtpImpl::remove_file(const std::string& path)
 void FtpImpl::remove_file_async(const std::string& path, Ftp::ResultCallback callback)
 {
     std::lock_guard<std::mutex> lock(_curr_op_mutex);
+    if (_queue_if_busy([this, path, callback]() { remove_file_async(path, callback); })) {
+        return;
+    }
     _generic_command_async(CMD_REMOVE_FILE, 0, path, callback);
 }
 
@@ -593,8 +884,9 @@ void FtpImpl::rename_async(
     const std::string& from_path, const std::string& to_path, Ftp::ResultCallback callback)
 {
     std::lock_guard<std::mutex> lock(_curr_op_mutex);
-    if (_curr_op != CMD_NONE) {
-        callback(Ftp::Result::Busy);
+    if (_queue_if_busy([this, from_path, to_path, callback]() {
+            rename_async(from_path, to_path, callback);
+        })) {
         return;
     }
     if (from_path.length() + to_path.length() + 1 >= max_data_length) {
@@ -666,11 +958,195 @@ void FtpImpl::are_files_identical_async(
         });
 }
 
+void FtpImpl::sync_directory_async(
+    const std::string& remote_dir,
+    const std::string& local_dir,
+    FtpExtended::SyncDirectoryCallback callback)
+{
+    if (!callback) {
+        return;
+    }
+
+    if (!fs_exists(local_dir) && !fs_create_directory(local_dir)) {
+        const auto temp_callback = callback;
+        _parent->call_user_callback([temp_callback]() {
+            Ftp::ProgressData empty{};
+            temp_callback(Ftp::Result::FileIoError, empty);
+        });
+        return;
+    }
+
+    auto sync = std::make_shared<SyncDirectory>();
+    sync->callback = callback;
+    _sync_list(sync, remote_dir, local_dir);
+}
+
+void FtpImpl::_sync_list(
+    std::shared_ptr<SyncDirectory> sync,
+    const std::string& remote_dir,
+    const std::string& local_dir)
+{
+    {
+        std::lock_guard<std::mutex> lock(sync->mutex);
+        ++sync->pending_checks;
+    }
+
+    list_directory_async(
+        remote_dir,
+        [this, sync, remote_dir, local_dir](Ftp::Result result, std::vector<std::string> list) {
+            if (result != Ftp::Result::Success) {
+                std::lock_guard<std::mutex> lock(sync->mutex);
+                if (sync->result == Ftp::Result::Success) {
+                    sync->result = result;
+                }
+            }
+
+            for (const auto& entry : list) {
+                if (entry.size() < 2) {
+                    continue;
+                }
+
+                // Entries are "D<path>" or "F<path>\t<size>". Depending on the server, the path
+                // is just the name or the path from the root directory.
+                const auto tab_pos = entry.find('\t');
+                const std::string path = entry.substr(1, tab_pos - 1);
+                const std::string name = path.substr(path.rfind('/') + 1);
+                if (name.empty() || name == "." || name == "..") {
+                    continue;
+                }
+
+                if (entry.rfind(DIRENT_DIR, 0) == 0) {
+                    const std::string local_subdir = local_dir + path_separator + name;
+                    if (!fs_exists(local_subdir) && !fs_create_directory(local_subdir)) {
+                        LogErr() << "Could not create " << local_subdir;
+                        std::lock_guard<std::mutex> lock(sync->mutex);
+                        if (sync->result == Ftp::Result::Success) {
+                            sync->result = Ftp::Result::FileIoError;
+                        }
+                        continue;
+                    }
+                    _sync_list(sync, remote_dir + "/" + name, local_subdir);
+
+                } else if (entry.rfind(DIRENT_FILE, 0) == 0 && tab_pos != std::string::npos) {
+                    const auto size = static_cast<uint32_t>(
+                        std::strtoul(entry.c_str() + tab_pos + 1, nullptr, 10));
+                    _sync_compare(
+                        sync,
+                        local_dir + path_separator + name,
+                        SyncFile{remote_dir + "/" + name, local_dir, size});
+                }
+            }
+
+            _sync_check_done(sync);
+        });
+}
+
+void FtpImpl::_sync_compare(
+    std::shared_ptr<SyncDirectory> sync, const std::string& local_path, SyncFile file)
+{
+    if (!fs_exists(local_path) || fs_file_size(local_path) != file.size) {
+        std::lock_guard<std::mutex> lock(sync->mutex);
+        sync->downloads.push_back(std::move(file));
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(sync->mutex);
+        ++sync->pending_checks;
+    }
+
+    // Same size, only the CRC32 tells whether the file changed.
+    are_files_identical_async(
+        local_path, file.remote_path, [this, sync, file](Ftp::Result result, bool identical) {
+            if (result != Ftp::Result::Success || !identical) {
+                std::lock_guard<std::mutex> lock(sync->mutex);
+                sync->downloads.push_back(file);
+            }
+            _sync_check_done(sync);
+        });
+}
+
+void FtpImpl::_sync_check_done(std::shared_ptr<SyncDirectory> sync)
+{
+    std::vector<SyncFile> downloads;
+    {
+        std::lock_guard<std::mutex> lock(sync->mutex);
+        if (--sync->pending_checks > 0) {
+            return;
+        }
+
+        for (const auto& file : sync->downloads) {
+            sync->total_bytes += file.size;
+        }
+        downloads = sync->downloads;
+    }
+
+    if (downloads.empty()) {
+        _sync_finish(sync);
+        return;
+    }
+
+    // All downloads are queued at once, so each one starts as soon as the previous one is done.
+    for (const auto& file : downloads) {
+        const uint32_t size = file.size;
+        download_async(
+            file.remote_path,
+            file.local_dir,
+            [this, sync, size](Ftp::Result result, Ftp::ProgressData progress) {
+                if (result != Ftp::Result::Next) {
+                    _sync_download_done(sync, result, size);
+                    return;
+                }
+
+                Ftp::ProgressData total_progress;
+                {
+                    std::lock_guard<std::mutex> lock(sync->mutex);
+                    total_progress.bytes_transferred =
+                        sync->bytes_done + progress.bytes_transferred;
+                    total_progress.total_bytes = sync->total_bytes;
+                }
+                sync->callback(Ftp::Result::Next, total_progress);
+            });
+    }
+}
+
+void FtpImpl::_sync_download_done(
+    std::shared_ptr<SyncDirectory> sync, Ftp::Result result, uint32_t size)
+{
+    {
+        std::lock_guard<std::mutex> lock(sync->mutex);
+        if (result == Ftp::Result::Success) {
+            sync->bytes_done += size;
+        } else if (sync->result == Ftp::Result::Success) {
+            sync->result = result;
+        }
+        if (++sync->downloads_done < sync->downloads.size()) {
+            return;
+        }
+    }
+
+    _sync_finish(sync);
+}
+
+void FtpImpl::_sync_finish(std::shared_ptr<SyncDirectory> sync)
+{
+    Ftp::Result result;
+    Ftp::ProgressData progress;
+    {
+        std::lock_guard<std::mutex> lock(sync->mutex);
+        result = sync->result;
+        progress.bytes_transferred = sync->bytes_done;
+        progress.total_bytes = sync->total_bytes;
+    }
+
+    sync->callback(result, progress);
+}
+
 void FtpImpl::_calc_file_crc32_async(const std::string& path, file_crc32_ResultCallback callback)
 {
     std::lock_guard<std::mutex> lock(_curr_op_mutex);
-    if (_curr_op != CMD_NONE) {
-        callback(Ftp::Result::Busy, 0);
+    if (_queue_if_busy(
+            [this, path, callback]() { _calc_file_crc32_async(path, callback); }, false)) {
         return;
     }
     if (path.length() >= max_data_length) {
@@ -692,14 +1168,7 @@ void FtpImpl::_calc_file_crc32_async(const std::string& path, file_crc32_ResultC
 
 void FtpImpl::_send_mavlink_ftp_message(uint8_t* raw_payload)
 {
-    mavlink_msg_file_transfer_protocol_pack(
-        _parent->get_own_system_id(),
-        _parent->get_own_component_id(),
-        &_last_command,
-        _network_id,
-        _parent->get_system_id(),
-        _get_target_component_id(),
-        raw_payload);
+    _pack_mavlink_ftp_message(raw_payload);
     _parent->send_message(_last_command);
 
     _reset_timer();
@@ -713,20 +1182,117 @@ void FtpImpl::_send_mavlink_ftp_message(uint8_t* raw_payload)
     }
 }
 
+bool FtpImpl::_queue_if_busy(std::function<void()> operation, bool exclusive)
+{
+    if (_curr_op == CMD_NONE && !(_read_paused && exclusive)) {
+        return false;
+    }
+    _queued_operations.push_back(QueuedOperation{std::move(operation), exclusive});
+    return true;
+}
+
+bool FtpImpl::_pause_read_for_queued_operation()
+{
+    // Listing a directory and calculating a CRC32 don't touch the session and have their own
+    // result callbacks, so one of them can run before each read instead of after the download.
+    const auto it = std::find_if(
+        _queued_operations.begin(),
+        _queued_operations.end(),
+        [](const QueuedOperation& operation) { return !operation.exclusive; });
+    if (it == _queued_operations.end()) {
+        return false;
+    }
+
+    _operation_between_reads = std::move(it->start);
+    _queued_operations.erase(it);
+    _read_paused = true;
+    _curr_op = CMD_NONE;
+    _stop_timer();
+    return true;
+}
+
+void FtpImpl::_run_queued_operations()
+{
+    while (true) {
+        std::function<void()> operation;
+        {
+            std::lock_guard<std::mutex> lock(_curr_op_mutex);
+            if (_curr_op != CMD_NONE) {
+                return;
+            }
+            if (_operation_between_reads) {
+                operation = std::move(_operation_between_reads);
+                _operation_between_reads = nullptr;
+            } else if (_read_paused) {
+                // The operation in between is done, so the download continues.
+                _read_paused = false;
+                _read();
+                continue;
+            } else if (_queued_operations.empty()) {
+                return;
+            } else {
+                operation = std::move(_queued_operations.front().start);
+                _queued_operations.pop_front();
+            }
+        }
+        // Either this starts the operation, or it fails right away and the next one can go.
+        operation();
+    }
+}
+
+void FtpImpl::_pack_mavlink_ftp_message(uint8_t* raw_payload)
+{
+    mavlink_msg_file_transfer_protocol_pack(
+        _parent->get_own_system_id(),
+        _parent->get_own_component_id(),
+        &_last_command,
+        _network_id,
+        _parent->get_system_id(),
+        _get_target_component_id(),
+        raw_payload);
+}
+
 void FtpImpl::_command_timeout()
 {
     if (_last_command_retries >= _max_last_command_retries) {
         LogErr() << "Response timeout " << _curr_op;
+        bool read_paused;
+        {
+            std::lock_guard<std::mutex> lock(_curr_op_mutex);
+            read_paused = _read_paused;
+        }
         _timer_mutex.lock();
         _last_command_timer_running = false;
-        _session_result = ServerResult::ERR_TIMEOUT;
-        _session_valid = false;
+        if (!read_paused) {
+            // Otherwise it's the operation in between that timed out, not the download.
+            _session_result = ServerResult::ERR_TIMEOUT;
+            _session_valid = false;
+        }
         _timer_mutex.unlock();
         _process_nak(ServerResult::ERR_TIMEOUT);
+        _run_queued_operations();
     } else {
         _last_command_retries++;
         LogWarn() << "Response timeout. Retry: " << _last_command_retries;
-        _parent->send_message(_last_command);
+        bool resent = false;
+        {
+            std::lock_guard<std::mutex> lock(_curr_op_mutex);
+            if (_curr_op == CMD_BURST_READ_FILE) {
+                // Continue where the burst stopped instead of asking for all of it again.
+                uint8_t raw_payload[MAVLINK_MSG_FILE_TRANSFER_PROTOCOL_FIELD_PAYLOAD_LEN];
+                _fill_burst_read_request(raw_payload);
+                _pack_mavlink_ftp_message(raw_payload);
+            } else if (_curr_op == CMD_WRITE_FILE && !_writes_in_flight.empty()) {
+                // Either the writes or their ACKs got lost, writing the same data again is fine.
+                for (auto& write : _writes_in_flight) {
+                    _parent->send_message(write.second.message);
+                }
+                resent = true;
+            }
+        }
+        if (!resent) {
+            _parent->send_message(_last_command);
+        }
         _parent->register_timeout_handler(
             std::bind(&FtpImpl::_command_timeout, this),
             static_cast<double>(_last_command_timeout) / 1000.0,
@@ -869,10 +1435,12 @@ void FtpImpl::process_mavlink_ftp_message(const mavlink_message_t& msg)
 
             case RSP_ACK:
                 _process_ack(payload);
+                _run_queued_operations();
                 return;
 
             case RSP_NAK:
                 _process_nak(payload);
+                _run_queued_operations();
                 return;
 
             default:
@@ -1102,16 +1670,60 @@ FtpImpl::ServerResult FtpImpl::_work_read(PayloadHeader* payload)
 
 FtpImpl::ServerResult FtpImpl::_work_burst(PayloadHeader* payload)
 {
-    if (payload->session != 0 && _session_info.fd < 0) {
+    if (payload->session != 0 || _session_info.fd < 0) {
         return ServerResult::ERR_INVALID_SESSION;
     }
 
-    // Setup for streaming sends
+    // We have to test seek past EOF ourselves, lseek will allow seek past EOF
+    if (payload->offset >= _session_info.file_size) {
+        return ServerResult::ERR_EOF;
+    }
+
+    if (lseek(_session_info.fd, payload->offset, SEEK_SET) < 0) {
+        return ServerResult::ERR_FAIL;
+    }
+
     _session_info.stream_download = true;
-    _session_info.stream_offset = payload->offset;
-    _session_info.stream_chunk_transmitted = 0;
-    _session_info.stream_seq_number = payload->seq_number + 1;
-    _session_info.stream_target_system_id = _parent->get_system_id();
+
+    // The whole burst is sent right away, the client asks for the next one once it got this one.
+    uint8_t raw_reply[MAVLINK_MSG_FILE_TRANSFER_PROTOCOL_FIELD_PAYLOAD_LEN]{};
+    PayloadHeader* reply = reinterpret_cast<PayloadHeader*>(raw_reply);
+    reply->seq_number = payload->seq_number;
+    reply->session = payload->session;
+    reply->opcode = RSP_ACK;
+    reply->req_opcode = CMD_BURST_READ_FILE;
+    reply->offset = payload->offset;
+
+    for (unsigned chunk = 0; chunk < max_burst_chunks; ++chunk) {
+        int bytes_read = ::read(_session_info.fd, &reply->data[0], max_data_length);
+
+        if (bytes_read <= 0) {
+            // Once part of the burst is sent, the client times out and asks again.
+            return (chunk == 0) ? ServerResult::ERR_FAIL : ServerResult::SUCCESS;
+        }
+
+        reply->seq_number++;
+        reply->size = bytes_read;
+        const bool last_chunk = chunk + 1 == max_burst_chunks ||
+                                reply->offset + bytes_read >= _session_info.file_size;
+        reply->burst_complete = last_chunk ? 1 : 0;
+
+        mavlink_message_t message;
+        mavlink_msg_file_transfer_protocol_pack(
+            _parent->get_own_system_id(),
+            _parent->get_own_component_id(),
+            &message,
+            _network_id,
+            _parent->get_system_id(),
+            _get_target_component_id(),
+            raw_reply);
+        _parent->send_message(message);
+
+        if (reply->burst_complete) {
+            break;
+        }
+        reply->offset += bytes_read;
+    }
 
     return ServerResult::SUCCESS;
 }
@@ -1,11 +1,17 @@
 #pragma once
 
+#include <atomic>
+#include <deque>
 #include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "mavlink_include.h"
-#include "plugins/ftp/ftp.h"
+#include "plugins/ftp/ftp_extended.h"
 #include "plugin_impl_base.h"
 
 // As found in
@@ -63,8 +69,13 @@ public:
         const std::string& local_path,
         const std::string& remote_path,
         Ftp::AreFilesIdenticalCallback callback);
+    void sync_directory_async(
+        const std::string& remote_dir,
+        const std::string& local_dir,
+        FtpExtended::SyncDirectoryCallback callback);
 
     void set_retries(uint32_t retries) { _max_last_command_retries = retries; }
+    void set_upload_window(unsigned window) { _upload_window = (window > 0) ? window : 1; }
     Ftp::Result set_root_directory(const std::string& root_dir);
     Ftp::Result set_target_compid(uint8_t component_id)
     {
@@ -126,6 +137,15 @@ private:
     /// @brief Maximum data size in RequestHeader::data
     static constexpr uint8_t max_data_length = 239;
 
+    /// @brief Maximum number of chunks sent in reply to one CMD_BURST_READ_FILE
+    static constexpr unsigned max_burst_chunks = 32;
+
+    /// @brief Number of CMD_WRITE_FILE sent without waiting for their ACK by default
+    static constexpr unsigned default_upload_window = 4;
+
+    /// @brief Downloaded bytes after which the checkpoint of a download is updated
+    static constexpr uint32_t checkpoint_interval = 64 * 1024;
+
     /// @brief This is the payload which is in mavlink_file_transfer_protocol_t.payload.
     /// This needs to be packed, because it's typecasted from
     /// mavlink_file_transfer_protocol_t.payload, which starts at a 3 byte offset, causing an
@@ -147,10 +167,43 @@ private:
         int fd{-1};
         uint32_t file_size{0};
         bool stream_download{false};
-        uint32_t stream_offset{0};
-        uint16_t stream_seq_number{0};
-        uint8_t stream_target_system_id{0};
-        unsigned stream_chunk_transmitted{0};
+    };
+
+    /// @brief Part of a file being downloaded which got lost during a burst
+    struct ReadGap {
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    /// @brief Write sent during an upload which was not acknowledged yet
+    struct WriteInFlight {
+        uint32_t size;
+        mavlink_message_t message;
+    };
+
+    /// @brief Remote file sync_directory needs to download
+    struct SyncFile {
+        std::string remote_path;
+        std::string local_dir;
+        uint32_t size;
+    };
+
+    /// @brief Operation requested while another one was active
+    struct QueuedOperation {
+        std::function<void()> start;
+        bool exclusive; ///< Can't run while a download waits between two reads
+    };
+
+    /// @brief State of a sync_directory, shared by the operations it consists of
+    struct SyncDirectory {
+        std::mutex mutex{};
+        FtpExtended::SyncDirectoryCallback callback{};
+        unsigned pending_checks{0}; ///< Listings and comparisons not done yet
+        std::vector<SyncFile> downloads{};
+        unsigned downloads_done{0};
+        uint32_t bytes_done{0};
+        uint32_t total_bytes{0};
+        Ftp::Result result{Ftp::Result::Success}; ///< First error, if any
     };
 
     struct OfstreamWithPath {
@@ -181,6 +234,20 @@ private:
     ServerResult _session_result = ServerResult::SUCCESS;
     uint32_t _bytes_transferred = 0;
     uint32_t _file_size = 0;
+    uint32_t _burst_offset = 0; ///< Offset the current burst is expected to continue at
+    bool _burst_read_supported = true;
+    std::deque<ReadGap> _read_gaps{}; ///< Read chunk by chunk once the bursts are done
+    std::string _download_remote_path{};
+    uint32_t _resume_file_size = 0; ///< Remote file size when the partial file was downloaded
+    uint32_t _resume_offset = 0; ///< Bytes of the partial file which can be kept
+    uint32_t _checkpoint_offset = 0; ///< Offset last written to the checkpoint
+    std::atomic<unsigned> _upload_window{default_upload_window};
+    uint32_t _write_offset = 0; ///< Offset of the next chunk to upload
+    std::map<uint16_t, WriteInFlight> _writes_in_flight{}; ///< By sequence number
+    /// Started in order once the active operation is done, or between the reads of a download
+    std::deque<QueuedOperation> _queued_operations{};
+    std::function<void()> _operation_between_reads{}; ///< Next to run while the download waits
+    bool _read_paused{false}; ///< Download waiting for an operation to run in between
     std::vector<std::string> _curr_directory_list{};
 
     Ftp::ResultCallback _curr_op_result_callback{};
@@ -194,6 +261,16 @@ private:
     file_crc32_ResultCallback _current_crc32_result_callback{};
 
     void _calc_file_crc32_async(const std::string& path, file_crc32_ResultCallback callback);
+    void _sync_list(
+        std::shared_ptr<SyncDirectory> sync,
+        const std::string& remote_dir,
+        const std::string& local_dir);
+    void _sync_compare(
+        std::shared_ptr<SyncDirectory> sync, const std::string& local_path, SyncFile file);
+    void _sync_check_done(std::shared_ptr<SyncDirectory> sync);
+    void _sync_download_done(
+        std::shared_ptr<SyncDirectory> sync, Ftp::Result result, uint32_t size);
+    void _sync_finish(std::shared_ptr<SyncDirectory> sync);
     Ftp::Result _calc_local_file_crc32(const std::string& path, uint32_t& csum);
 
     void _process_ack(PayloadHeader* payload);
@@ -207,11 +284,36 @@ private:
     void _generic_command_async(
         Opcode opcode, uint32_t offset, const std::string& path, Ftp::ResultCallback callback);
     void _read();
+    void _process_read_ack(PayloadHeader* payload);
+    void _process_burst_read_ack(PayloadHeader* payload);
+    bool _write_read_data(uint32_t offset, const uint8_t* data, uint32_t size);
+    void _read_rest_in_chunks();
+    void _fill_burst_read_request(uint8_t* raw_payload);
     void _write();
+    void _process_write_ack(PayloadHeader* payload);
+    Ftp::DownloadCallback _verify_resumed_download(
+        const std::string& remote_path,
+        const std::string& local_folder,
+        const std::string& local_path,
+        Ftp::DownloadCallback callback);
     void _end_read_session(bool delete_file = false);
+    void _close_download_file(bool delete_file);
+    static std::string _checkpoint_path(const std::string& local_path);
+    uint32_t _contiguous_read_offset() const;
+    bool _read_checkpoint(
+        const std::string& local_path,
+        const std::string& remote_path,
+        uint32_t& file_size,
+        uint32_t& offset);
+    void _write_checkpoint();
+    void _update_checkpoint();
     void _end_write_session();
     void _terminate_session();
     void _send_mavlink_ftp_message(uint8_t* raw_payload);
+    void _pack_mavlink_ftp_message(uint8_t* raw_payload);
+    bool _queue_if_busy(std::function<void()> operation, bool exclusive = true);
+    bool _pause_read_for_queued_operation();
+    void _run_queued_operations();
     void _command_timeout();
     void _reset_timer();
     void _stop_timer();
@@ -286,8 +286,8 @@ public:
      */
     const Ftp& operator=(const Ftp&) = delete;
 
-private:
-    /** @private Underlying implementation, set at instantiation */
+protected:
+    /** @private Underlying implementation, set at instantiation, also used by extensions */
     std::unique_ptr<FtpImpl> _impl;
 };
 
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "plugins/ftp/ftp.h"
+
+namespace mavsdk {
+
+class System;
+
+/**
+ * @brief Ftp with additional API which is not (yet) part of the proto
+ * files: syncing whole directory trees and tuning uploads.
+ *
+ * It can be used everywhere an Ftp plugin is used.
+ *
+ * For Ftp as well as FtpExtended, operations requested while another one is
+ * running are queued instead of failing, so Ftp::Result::Busy is no longer
+ * returned. Queued operations start in order once the running one is done.
+ * Listing a directory and comparing files don't wait for a download to
+ * finish, they run in between its reads.
+ */
+class FtpExtended : public Ftp {
+public:
+    /**
+     * @brief Constructor. Creates the plugin for a specific System.
+     *
+     * @param system The specific system associated with this plugin.
+     */
+    explicit FtpExtended(System& system); // deprecated
+
+    /**
+     * @brief Constructor. Creates the plugin for a specific System.
+     *
+     * @param system The specific system associated with this plugin.
+     */
+    explicit FtpExtended(std::shared_ptr<System> system); // new
+
+    /**
+     * @brief Destructor (internal use only).
+     */
+    ~FtpExtended();
+
+    /**
+     * @brief Callback type for sync_directory_async.
+     */
+    using SyncDirectoryCallback = std::function<void(Ftp::Result, ProgressData)>;
+
+    /**
+     * @brief Downloads the files of a remote directory and its subdirectories which are
+     * missing locally or differ from the local copy.
+     *
+     * Files of the same size are compared by CRC32 first and only downloaded if they differ.
+     * Progress is reported over all files to download.
+     *
+     * This function is non-blocking.
+     */
+    void sync_directory_async(
+        std::string remote_dir, std::string local_dir, SyncDirectoryCallback callback);
+
+    /**
+     * @brief Set how many writes of an upload are sent without waiting for their ACK.
+     *
+     * The default is 4. With 1, each write waits for the ACK of the previous one.
+     * 0 is treated as 1.
+     */
+    void set_upload_window(uint32_t window) const;
+
+    /**
+     * @brief Copy constructor (object is not copyable).
+     */
+    FtpExtended(const FtpExtended& other) = delete;
+
+    /**
+     * @brief Equality operator (object is not copyable).
+     */
+    const FtpExtended& operator=(const FtpExtended&) = delete;
+};
+
+} // namespace mavsdk
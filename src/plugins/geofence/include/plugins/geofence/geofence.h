@@ -173,8 +173,8 @@ public:
      */
     const Geofence& operator=(const Geofence&) = delete;
 
-private:
-    /** @private Underlying implementation, set at instantiation */
+protected:
+    /** @private Underlying implementation, set at instantiation, also used by extensions */
     std::unique_ptr<GeofenceImpl> _impl;
 };
 
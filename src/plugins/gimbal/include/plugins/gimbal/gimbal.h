@@ -181,8 +181,8 @@ public:
      */
     const Gimbal& operator=(const Gimbal&) = delete;
 
-private:
-    /** @private Underlying implementation, set at instantiation */
+protected:
+    /** @private Underlying implementation, set at instantiation, also used by extensions */
     std::unique_ptr<GimbalImpl> _impl;
 };
 
@@ -234,8 +234,8 @@ public:
      */
     const Info& operator=(const Info&) = delete;
 
-private:
-    /** @private Underlying implementation, set at instantiation */
+protected:
+    /** @private Underlying implementation, set at instantiation, also used by extensions */
     std::unique_ptr<InfoImpl> _impl;
 };
 
@@ -169,8 +169,8 @@ public:
      */
     const LogFiles& operator=(const LogFiles&) = delete;
 
-private:
-    /** @private Underlying implementation, set at instantiation */
+protected:
+    /** @private Underlying implementation, set at instantiation, also used by extensions */
     std::unique_ptr<LogFilesImpl> _impl;
 };
 
@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <cmath>
 #include <ctime>
+#include <cstdio>
 #include <cstring>
 
 namespace mavsdk {
@@ -204,7 +205,7 @@ void LogFilesImpl::list_timeout()
 void LogFilesImpl::download_log_file_async(
     unsigned id, const std::string& file_path, LogFiles::DownloadLogFileCallback callback)
 {
-    unsigned bytes_to_get;
+    LogFiles::Entry entry;
     {
         std::lock_guard<std::mutex> lock(_entries.mutex);
 
@@ -222,13 +223,16 @@ void LogFilesImpl::download_log_file_async(
             return;
         }
 
-        bytes_to_get = _entries.entry_map[id].size_bytes;
+        entry = it->second;
     }
 
     {
         std::lock_guard<std::mutex> lock(_data.mutex);
 
-        if (!start_logfile(file_path)) {
+        // Continue where an earlier attempt to download the same log stopped.
+        const std::size_t resume_offset = read_checkpoint(file_path, entry);
+
+        if (!start_logfile(file_path, resume_offset)) {
             if (callback) {
                 const auto tmp_callback = callback;
                 _parent->call_user_callback([tmp_callback]() {
@@ -243,8 +247,10 @@ void LogFilesImpl::download_log_file_async(
         _data.id = id;
         _data.callback = callback;
         _data.time_started = _time.steady_time();
-        _data.bytes_to_get = bytes_to_get;
-        _data.part_start = 0;
+        _data.bytes_to_get = entry.size_bytes;
+        _data.path = file_path;
+        _data.date = entry.date;
+        _data.part_start = resume_offset;
         const auto part_size = determine_part_end() - _data.part_start;
         _data.bytes.resize(part_size);
         _data.chunks_received.resize(
@@ -258,9 +264,11 @@ void LogFilesImpl::download_log_file_async(
 
         if (_data.callback) {
             const auto tmp_callback = _data.callback;
-            _parent->call_user_callback([tmp_callback]() {
+            const float progress_start =
+                entry.size_bytes > 0 ? float(resume_offset) / float(entry.size_bytes) : 0.0f;
+            _parent->call_user_callback([tmp_callback, progress_start]() {
                 LogFiles::ProgressData progress;
-                progress.progress = 0.0f;
+                progress.progress = progress_start;
                 tmp_callback(LogFiles::Result::Next, progress);
             });
         }
@@ -420,11 +428,17 @@ void LogFilesImpl::data_timeout()
     }
 }
 
-bool LogFilesImpl::start_logfile(const std::string& path)
+bool LogFilesImpl::start_logfile(const std::string& path, std::size_t resume_offset)
 {
     // Assumes to have the lock for _data.mutex.
 
-    _data.file.open(path, std::ios::out | std::ios::binary);
+    if (resume_offset > 0) {
+        LogInfo() << "Resuming log download at " << resume_offset << " B";
+        _data.file.open(path, std::ios::in | std::ios::out | std::ios::binary);
+        _data.file.seekp(resume_offset);
+    } else {
+        _data.file.open(path, std::ios::out | std::ios::binary);
+    }
 
     return ((_data.file.rdstate() & std::ofstream::failbit) == 0);
 }
@@ -434,6 +448,15 @@ void LogFilesImpl::write_part_to_disk()
     // Assumes to have the lock for _data.mutex.
 
     _data.file.write(reinterpret_cast<char*>(_data.bytes.data()), _data.bytes.size());
+    _data.prefix_crc =
+        MavlinkCrc::accumulate(_data.bytes.data(), _data.bytes.size(), _data.prefix_crc);
+
+    const std::size_t part_end = _data.part_start + _data.bytes.size();
+    if (part_end < _data.bytes_to_get) {
+        // Remember how far the file is complete, so the download can be resumed from there.
+        _data.file.flush();
+        write_checkpoint(part_end);
+    }
 }
 
 void LogFilesImpl::finish_logfile()
@@ -441,6 +464,65 @@ void LogFilesImpl::finish_logfile()
     // Assumes to have the lock for _data.mutex.
 
     _data.file.close();
+    std::remove(checkpoint_path(_data.path).c_str());
+}
+
+std::string LogFilesImpl::checkpoint_path(const std::string& path)
+{
+    return path + ".resume";
+}
+
+std::size_t LogFilesImpl::read_checkpoint(const std::string& path, const LogFiles::Entry& entry)
+{
+    // Assumes to have the lock for _data.mutex.
+
+    _data.prefix_crc = MavlinkCrc::init;
+
+    std::ifstream checkpoint(checkpoint_path(path));
+    unsigned id = 0;
+    uint32_t size_bytes = 0;
+    std::string date;
+    std::size_t offset = 0;
+    unsigned prefix_crc = 0;
+    checkpoint >> id >> size_bytes >> date >> offset >> prefix_crc;
+
+    if (!checkpoint || id != entry.id || size_bytes != entry.size_bytes || date != entry.date ||
+        offset >= entry.size_bytes) {
+        return 0;
+    }
+
+    // The part kept needs to be what was written before the download stopped.
+    std::ifstream file(path, std::ios::binary);
+    std::vector<uint8_t> buffer(PART_SIZE * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN);
+    uint16_t crc = MavlinkCrc::init;
+    std::size_t bytes_read = 0;
+    while (file && bytes_read < offset) {
+        const auto len = std::min(buffer.size(), offset - bytes_read);
+        file.read(reinterpret_cast<char*>(buffer.data()), len);
+        const auto count = static_cast<std::size_t>(file.gcount());
+        crc = MavlinkCrc::accumulate(buffer.data(), count, crc);
+        bytes_read += count;
+    }
+
+    if (bytes_read < offset || crc != prefix_crc) {
+        LogWarn() << "Log file does not match its checkpoint, downloading it from the start";
+        return 0;
+    }
+
+    _data.prefix_crc = crc;
+    return offset;
+}
+
+void LogFilesImpl::write_checkpoint(std::size_t offset)
+{
+    // Assumes to have the lock for _data.mutex.
+
+    std::ofstream checkpoint(checkpoint_path(_data.path), std::ios::trunc);
+    checkpoint << _data.id << '\n'
+               << _data.bytes_to_get << '\n'
+               << _data.date << '\n'
+               << offset << '\n'
+               << _data.prefix_crc << '\n';
 }
 
 void LogFilesImpl::reset_data()
@@ -454,6 +536,9 @@ void LogFilesImpl::reset_data()
     _data.retries = 0;
     _data.rerequesting = false;
     _data.last_ofs_rerequested = -1;
+    _data.path.clear();
+    _data.date.clear();
+    _data.prefix_crc = MavlinkCrc::init;
     _data.callback = nullptr;
 }
 
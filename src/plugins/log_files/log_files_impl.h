@@ -1,5 +1,6 @@
 #pragma once
 
+#include "mavlink_crc.h"
 #include "mavlink_include.h"
 #include "plugins/log_files/log_files.h"
 #include "plugin_impl_base.h"
@@ -39,9 +40,13 @@ private:
     void request_log_data(unsigned id, unsigned start, unsigned count);
     void data_timeout();
 
-    bool start_logfile(const std::string& path);
+    bool start_logfile(const std::string& path, std::size_t resume_offset);
     void write_part_to_disk();
     void finish_logfile();
+
+    static std::string checkpoint_path(const std::string& path);
+    std::size_t read_checkpoint(const std::string& path, const LogFiles::Entry& entry);
+    void write_checkpoint(std::size_t offset);
     void report_progress(unsigned transferred, unsigned total);
 
     std::size_t determine_part_end();
@@ -83,6 +88,9 @@ private:
         bool rerequesting{false};
         int last_ofs_rerequested{-1};
         dl_time_t time_started{};
+        std::string path{};
+        std::string date{};
+        uint16_t prefix_crc{MavlinkCrc::init};
         std::ofstream file{};
         LogFiles::DownloadLogFileCallback callback{nullptr};
     } _data{};
@@ -152,8 +152,8 @@ public:
      */
     const ManualControl& operator=(const ManualControl&) = delete;
 
-private:
-    /** @private Underlying implementation, set at instantiation */
+protected:
+    /** @private Underlying implementation, set at instantiation, also used by extensions */
     std::unique_ptr<ManualControlImpl> _impl;
 };
 
@@ -119,7 +119,11 @@ void MavlinkPassthroughImpl::subscribe_message_async(
         _parent->register_mavlink_message_handler(
             message_id,
             [this, temp_callback](const mavlink_message_t& message) {
-                _parent->call_user_callback([temp_callback, message]() { temp_callback(message); });
+                // The user callback runs later, so we hold on to the message
+                // instead of copying it.
+                const auto shared_message = MAVLinkMessageHandler::retain(message);
+                _parent->call_user_callback(
+                    [temp_callback, shared_message]() { temp_callback(*shared_message); });
             },
             this);
     }
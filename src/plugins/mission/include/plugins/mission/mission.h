@@ -442,8 +442,8 @@ public:
      */
     const Mission& operator=(const Mission&) = delete;
 
-private:
-    /** @private Underlying implementation, set at instantiation */
+protected:
+    /** @private Underlying implementation, set at instantiation, also used by extensions */
     std::unique_ptr<MissionImpl> _impl;
 };
 
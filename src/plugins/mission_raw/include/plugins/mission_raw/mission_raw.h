@@ -336,8 +336,8 @@ public:
      */
     const MissionRaw& operator=(const MissionRaw&) = delete;
 
-private:
-    /** @private Underlying implementation, set at instantiation */
+protected:
+    /** @private Underlying implementation, set at instantiation, also used by extensions */
     std::unique_ptr<MissionRawImpl> _impl;
 };
 
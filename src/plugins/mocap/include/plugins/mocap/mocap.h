@@ -372,8 +372,8 @@ public:
      */
     const Mocap& operator=(const Mocap&) = delete;
 
-private:
-    /** @private Underlying implementation, set at instantiation */
+protected:
+    /** @private Underlying implementation, set at instantiation, also used by extensions */
     std::unique_ptr<MocapImpl> _impl;
 };
 
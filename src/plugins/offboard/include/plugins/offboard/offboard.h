@@ -410,8 +410,8 @@ public:
      */
     const Offboard& operator=(const Offboard&) = delete;
 
-private:
-    /** @private Underlying implementation, set at instantiation */
+protected:
+    /** @private Underlying implementation, set at instantiation, also used by extensions */
     std::unique_ptr<OffboardImpl> _impl;
 };
 
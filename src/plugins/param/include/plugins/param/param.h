@@ -211,8 +211,8 @@ public:
      */
     const Param& operator=(const Param&) = delete;
 
-private:
-    /** @private Underlying implementation, set at instantiation */
+protected:
+    /** @private Underlying implementation, set at instantiation, also used by extensions */
     std::unique_ptr<ParamImpl> _impl;
 };
 
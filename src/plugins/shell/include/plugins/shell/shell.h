@@ -114,8 +114,8 @@ public:
      */
     const Shell& operator=(const Shell&) = delete;
 
-private:
-    /** @private Underlying implementation, set at instantiation */
+protected:
+    /** @private Underlying implementation, set at instantiation, also used by extensions */
     std::unique_ptr<ShellImpl> _impl;
 };
 
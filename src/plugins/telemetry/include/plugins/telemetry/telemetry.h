@@ -1702,8 +1702,8 @@ public:
      */
     const Telemetry& operator=(const Telemetry&) = delete;
 
-private:
-    /** @private Underlying implementation, set at instantiation */
+protected:
+    /** @private Underlying implementation, set at instantiation, also used by extensions */
     std::unique_ptr<TelemetryImpl> _impl;
 };
 
@@ -0,0 +1,934 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include "plugins/telemetry/telemetry.h"
+
+namespace mavsdk {
+
+class System;
+
+/**
+ * @brief Telemetry with additional API which is not (yet) part of the proto
+ * files: subscriptions with options or in batches, consistent snapshots and
+ * a history of samples by autopilot time.
+ *
+ * It can be used everywhere a Telemetry plugin is used.
+ */
+class TelemetryExtended : public Telemetry {
+public:
+    /**
+     * @brief Constructor. Creates the plugin for a specific System.
+     *
+     * @param system The specific system associated with this plugin.
+     */
+    explicit TelemetryExtended(System& system); // deprecated
+
+    /**
+     * @brief Constructor. Creates the plugin for a specific System.
+     *
+     * @param system The specific system associated with this plugin.
+     */
+    explicit TelemetryExtended(std::shared_ptr<System> system); // new
+
+    /**
+     * @brief Destructor (internal use only).
+     */
+    ~TelemetryExtended();
+
+    /**
+     * @brief Snapshot type.
+     *
+     * The frequently updated telemetry, all taken at the same moment.
+     */
+    struct Snapshot {
+        Position position{}; /**< @brief Position */
+        Position home{}; /**< @brief Home position */
+        bool in_air{false}; /**< @brief True if the vehicle is in the air */
+        bool armed{false}; /**< @brief True if the vehicle is armed */
+        LandedState landed_state{LandedState::Unknown}; /**< @brief Landed state */
+        Quaternion attitude_quaternion{}; /**< @brief Attitude as quaternion */
+        EulerAngle attitude_euler{}; /**< @brief Attitude as Euler angles */
+        AngularVelocityBody
+            attitude_angular_velocity_body{}; /**< @brief Angular velocity in body frame */
+        VelocityNed velocity_ned{}; /**< @brief Velocity (NED) */
+        PositionVelocityNed position_velocity_ned{}; /**< @brief Position and velocity (NED) */
+        Imu imu{}; /**< @brief IMU reading */
+        GpsInfo gps_info{}; /**< @brief GPS information */
+        Battery battery{}; /**< @brief Battery */
+        Health health{}; /**< @brief Health */
+        GroundTruth ground_truth{}; /**< @brief Ground truth */
+        FixedwingMetrics fixedwing_metrics{}; /**< @brief Fixedwing metrics */
+    };
+
+    /**
+     * @brief Equal operator to compare two `TelemetryExtended::Snapshot` objects.
+     *
+     * @return `true` if items are equal.
+     */
+    friend bool operator==(
+        const TelemetryExtended::Snapshot& lhs, const TelemetryExtended::Snapshot& rhs);
+
+    /**
+     * @brief Stream operator to print information about a `TelemetryExtended::Snapshot`.
+     *
+     * @return A reference to the stream.
+     */
+    friend std::ostream& operator<<(std::ostream& str, TelemetryExtended::Snapshot const& snapshot);
+
+    /**
+     * @brief Options to receive fewer callbacks than updates.
+     *
+     * This is useful e.g. to feed a slow UI from a fast stream without
+     * flooding the callback queue.
+     */
+    struct SubscriptionOptions {
+        double max_rate_hz{0.0}; /**< @brief Maximum callback rate in Hz, 0 for no limit */
+        uint32_t decimation{1}; /**< @brief Only call back for every n-th update */
+        bool latest_only{false}; /**< @brief While a callback is still queued, do not queue
+                                    another one, it gets the latest value instead */
+        bool coalesce{false}; /**< @brief With the Coalesce overflow policy, queued callbacks
+                                 may be skipped in favour of the most recent one once the
+                                 callback queue has overflown */
+    };
+
+    /**
+     * @brief Equal operator to compare two `TelemetryExtended::SubscriptionOptions` objects.
+     *
+     * @return `true` if items are equal.
+     */
+    friend bool operator==(
+        const TelemetryExtended::SubscriptionOptions& lhs,
+        const TelemetryExtended::SubscriptionOptions& rhs);
+
+    /**
+     * @brief Stream operator to print information about a `TelemetryExtended::SubscriptionOptions`.
+     *
+     * @return A reference to the stream.
+     */
+    friend std::ostream& operator<<(
+        std::ostream& str, TelemetryExtended::SubscriptionOptions const& subscription_options);
+
+    /**
+     * @brief Handle of a subscription added with options, used to unsubscribe.
+     */
+    struct SubscriptionHandle {
+        uint64_t id{0}; /**< @brief Id of the subscription, 0 if invalid */
+    };
+
+    /**
+     * @brief Equal operator to compare two `TelemetryExtended::SubscriptionHandle` objects.
+     *
+     * @return `true` if items are equal.
+     */
+    friend bool operator==(
+        const TelemetryExtended::SubscriptionHandle& lhs,
+        const TelemetryExtended::SubscriptionHandle& rhs);
+
+    /**
+     * @brief Stream operator to print information about a `TelemetryExtended::SubscriptionHandle`.
+     *
+     * @return A reference to the stream.
+     */
+    friend std::ostream&
+    operator<<(std::ostream& str, TelemetryExtended::SubscriptionHandle const& subscription_handle);
+
+    /**
+     * @brief Options for subscriptions receiving samples in batches.
+     *
+     * A batch is delivered once either limit is reached, also if no more samples
+     * arrive. This is useful e.g. for logging high rate streams with one callback
+     * for many samples.
+     */
+    struct BatchOptions {
+        uint32_t max_samples{50}; /**< @brief Deliver a batch once it has this many samples */
+        double max_interval_s{0.1}; /**< @brief Deliver a batch once its first sample is this
+                                       old, 0 for no limit */
+    };
+
+    /**
+     * @brief Equal operator to compare two `TelemetryExtended::BatchOptions` objects.
+     *
+     * @return `true` if items are equal.
+     */
+    friend bool operator==(
+        const TelemetryExtended::BatchOptions& lhs, const TelemetryExtended::BatchOptions& rhs);
+
+    /**
+     * @brief Stream operator to print information about a `TelemetryExtended::BatchOptions`.
+     *
+     * @return A reference to the stream.
+     */
+    friend std::ostream&
+    operator<<(std::ostream& str, TelemetryExtended::BatchOptions const& batch_options);
+
+    /**
+     * @brief Telemetry streams which can be kept in a history.
+     */
+    enum class HistoryStream {
+        Position, /**< @brief Position, see position(). */
+        Attitude, /**< @brief Attitude quaternion, see attitude_quaternion(). */
+        VelocityNed, /**< @brief Velocity in NED, see velocity_ned(). */
+        Battery, /**< @brief Battery, see battery(). */
+    };
+
+    /**
+     * @brief Stream operator to print information about a `TelemetryExtended::HistoryStream`.
+     *
+     * @return A reference to the stream.
+     */
+    friend std::ostream&
+    operator<<(std::ostream& str, TelemetryExtended::HistoryStream const& history_stream);
+
+    /**
+     * @brief Position sample of the history with its autopilot timestamp.
+     */
+    struct PositionSample {
+        uint64_t timestamp_us{}; /**< @brief Time since autopilot boot in microseconds */
+        Position position{}; /**< @brief Position */
+    };
+
+    /**
+     * @brief Equal operator to compare two `TelemetryExtended::PositionSample` objects.
+     *
+     * @return `true` if items are equal.
+     */
+    friend bool operator==(
+        const TelemetryExtended::PositionSample& lhs, const TelemetryExtended::PositionSample& rhs);
+
+    /**
+     * @brief Stream operator to print information about a `TelemetryExtended::PositionSample`.
+     *
+     * @return A reference to the stream.
+     */
+    friend std::ostream&
+    operator<<(std::ostream& str, TelemetryExtended::PositionSample const& position_sample);
+
+    /**
+     * @brief Attitude quaternion sample of the history with its autopilot timestamp.
+     */
+    struct AttitudeSample {
+        uint64_t timestamp_us{}; /**< @brief Time since autopilot boot in microseconds */
+        Quaternion attitude_quaternion{}; /**< @brief Attitude quaternion */
+    };
+
+    /**
+     * @brief Equal operator to compare two `TelemetryExtended::AttitudeSample` objects.
+     *
+     * @return `true` if items are equal.
+     */
+    friend bool operator==(
+        const TelemetryExtended::AttitudeSample& lhs, const TelemetryExtended::AttitudeSample& rhs);
+
+    /**
+     * @brief Stream operator to print information about a `TelemetryExtended::AttitudeSample`.
+     *
+     * @return A reference to the stream.
+     */
+    friend std::ostream&
+    operator<<(std::ostream& str, TelemetryExtended::AttitudeSample const& attitude_sample);
+
+    /**
+     * @brief Velocity in NED sample of the history with its autopilot timestamp.
+     */
+    struct VelocityNedSample {
+        uint64_t timestamp_us{}; /**< @brief Time since autopilot boot in microseconds */
+        VelocityNed velocity_ned{}; /**< @brief Velocity in NED */
+    };
+
+    /**
+     * @brief Equal operator to compare two `TelemetryExtended::VelocityNedSample` objects.
+     *
+     * @return `true` if items are equal.
+     */
+    friend bool operator==(
+        const TelemetryExtended::VelocityNedSample& lhs,
+        const TelemetryExtended::VelocityNedSample& rhs);
+
+    /**
+     * @brief Stream operator to print information about a `TelemetryExtended::VelocityNedSample`.
+     *
+     * @return A reference to the stream.
+     */
+    friend std::ostream&
+    operator<<(std::ostream& str, TelemetryExtended::VelocityNedSample const& velocity_ned_sample);
+
+    /**
+     * @brief Battery sample of the history with its autopilot timestamp.
+     */
+    struct BatterySample {
+        uint64_t timestamp_us{}; /**< @brief Time since autopilot boot in microseconds */
+        Battery battery{}; /**< @brief Battery */
+    };
+
+    /**
+     * @brief Equal operator to compare two `TelemetryExtended::BatterySample` objects.
+     *
+     * @return `true` if items are equal.
+     */
+    friend bool operator==(
+        const TelemetryExtended::BatterySample& lhs, const TelemetryExtended::BatterySample& rhs);
+
+    /**
+     * @brief Stream operator to print information about a `TelemetryExtended::BatterySample`.
+     *
+     * @return A reference to the stream.
+     */
+    friend std::ostream&
+    operator<<(std::ostream& str, TelemetryExtended::BatterySample const& battery_sample);
+
+    using Telemetry::subscribe_position;
+
+    /**
+     * @brief Add a subscriber with options, e.g. to limit the rate of callbacks.
+     *
+     * This does not replace other subscribers to 'position', remove it again
+     * using unsubscribe_position().
+     *
+     * @return Handle of the subscription.
+     */
+    SubscriptionHandle subscribe_position(PositionCallback callback, SubscriptionOptions options);
+
+    /**
+     * @brief Remove a subscriber added using subscribe_position() with options.
+     */
+    void unsubscribe_position(SubscriptionHandle handle);
+
+    using Telemetry::subscribe_home;
+
+    /**
+     * @brief Add a subscriber with options, e.g. to limit the rate of callbacks.
+     *
+     * This does not replace other subscribers to 'home', remove it again
+     * using unsubscribe_home().
+     *
+     * @return Handle of the subscription.
+     */
+    SubscriptionHandle subscribe_home(HomeCallback callback, SubscriptionOptions options);
+
+    /**
+     * @brief Remove a subscriber added using subscribe_home() with options.
+     */
+    void unsubscribe_home(SubscriptionHandle handle);
+
+    using Telemetry::subscribe_in_air;
+
+    /**
+     * @brief Add a subscriber with options, e.g. to limit the rate of callbacks.
+     *
+     * This does not replace other subscribers to 'in_air', remove it again
+     * using unsubscribe_in_air().
+     *
+     * @return Handle of the subscription.
+     */
+    SubscriptionHandle subscribe_in_air(InAirCallback callback, SubscriptionOptions options);
+
+    /**
+     * @brief Remove a subscriber added using subscribe_in_air() with options.
+     */
+    void unsubscribe_in_air(SubscriptionHandle handle);
+
+    using Telemetry::subscribe_landed_state;
+
+    /**
+     * @brief Add a subscriber with options, e.g. to limit the rate of callbacks.
+     *
+     * This does not replace other subscribers to 'landed_state', remove it again
+     * using unsubscribe_landed_state().
+     *
+     * @return Handle of the subscription.
+     */
+    SubscriptionHandle subscribe_landed_state(
+        LandedStateCallback callback, SubscriptionOptions options);
+
+    /**
+     * @brief Remove a subscriber added using subscribe_landed_state() with options.
+     */
+    void unsubscribe_landed_state(SubscriptionHandle handle);
+
+    using Telemetry::subscribe_armed;
+
+    /**
+     * @brief Add a subscriber with options, e.g. to limit the rate of callbacks.
+     *
+     * This does not replace other subscribers to 'armed', remove it again
+     * using unsubscribe_armed().
+     *
+     * @return Handle of the subscription.
+     */
+    SubscriptionHandle subscribe_armed(ArmedCallback callback, SubscriptionOptions options);
+
+    /**
+     * @brief Remove a subscriber added using subscribe_armed() with options.
+     */
+    void unsubscribe_armed(SubscriptionHandle handle);
+
+    using Telemetry::subscribe_attitude_quaternion;
+
+    /**
+     * @brief Add a subscriber with options, e.g. to limit the rate of callbacks.
+     *
+     * This does not replace other subscribers to 'attitude_quaternion', remove it again
+     * using unsubscribe_attitude_quaternion().
+     *
+     * @return Handle of the subscription.
+     */
+    SubscriptionHandle subscribe_attitude_quaternion(
+        AttitudeQuaternionCallback callback, SubscriptionOptions options);
+
+    /**
+     * @brief Remove a subscriber added using subscribe_attitude_quaternion() with options.
+     */
+    void unsubscribe_attitude_quaternion(SubscriptionHandle handle);
+
+    using Telemetry::subscribe_attitude_euler;
+
+    /**
+     * @brief Add a subscriber with options, e.g. to limit the rate of callbacks.
+     *
+     * This does not replace other subscribers to 'attitude_euler', remove it again
+     * using unsubscribe_attitude_euler().
+     *
+     * @return Handle of the subscription.
+     */
+    SubscriptionHandle subscribe_attitude_euler(
+        AttitudeEulerCallback callback, SubscriptionOptions options);
+
+    /**
+     * @brief Remove a subscriber added using subscribe_attitude_euler() with options.
+     */
+    void unsubscribe_attitude_euler(SubscriptionHandle handle);
+
+    using Telemetry::subscribe_attitude_angular_velocity_body;
+
+    /**
+     * @brief Add a subscriber with options, e.g. to limit the rate of callbacks.
+     *
+     * This does not replace other subscribers to 'attitude_angular_velocity_body', remove it again
+     * using unsubscribe_attitude_angular_velocity_body().
+     *
+     * @return Handle of the subscription.
+     */
+    SubscriptionHandle subscribe_attitude_angular_velocity_body(
+        AttitudeAngularVelocityBodyCallback callback, SubscriptionOptions options);
+
+    /**
+     * @brief Remove a subscriber added using subscribe_attitude_angular_velocity_body() with
+     * options.
+     */
+    void unsubscribe_attitude_angular_velocity_body(SubscriptionHandle handle);
+
+    using Telemetry::subscribe_camera_attitude_quaternion;
+
+    /**
+     * @brief Add a subscriber with options, e.g. to limit the rate of callbacks.
+     *
+     * This does not replace other subscribers to 'camera_attitude_quaternion', remove it again
+     * using unsubscribe_camera_attitude_quaternion().
+     *
+     * @return Handle of the subscription.
+     */
+    SubscriptionHandle subscribe_camera_attitude_quaternion(
+        CameraAttitudeQuaternionCallback callback, SubscriptionOptions options);
+
+    /**
+     * @brief Remove a subscriber added using subscribe_camera_attitude_quaternion() with options.
+     */
+    void unsubscribe_camera_attitude_quaternion(SubscriptionHandle handle);
+
+    using Telemetry::subscribe_camera_attitude_euler;
+
+    /**
+     * @brief Add a subscriber with options, e.g. to limit the rate of callbacks.
+     *
+     * This does not replace other subscribers to 'camera_attitude_euler', remove it again
+     * using unsubscribe_camera_attitude_euler().
+     *
+     * @return Handle of the subscription.
+     */
+    SubscriptionHandle subscribe_camera_attitude_euler(
+        CameraAttitudeEulerCallback callback, SubscriptionOptions options);
+
+    /**
+     * @brief Remove a subscriber added using subscribe_camera_attitude_euler() with options.
+     */
+    void unsubscribe_camera_attitude_euler(SubscriptionHandle handle);
+
+    using Telemetry::subscribe_velocity_ned;
+
+    /**
+     * @brief Add a subscriber with options, e.g. to limit the rate of callbacks.
+     *
+     * This does not replace other subscribers to 'velocity_ned', remove it again
+     * using unsubscribe_velocity_ned().
+     *
+     * @return Handle of the subscription.
+     */
+    SubscriptionHandle subscribe_velocity_ned(
+        VelocityNedCallback callback, SubscriptionOptions options);
+
+    /**
+     * @brief Remove a subscriber added using subscribe_velocity_ned() with options.
+     */
+    void unsubscribe_velocity_ned(SubscriptionHandle handle);
+
+    using Telemetry::subscribe_gps_info;
+
+    /**
+     * @brief Add a subscriber with options, e.g. to limit the rate of callbacks.
+     *
+     * This does not replace other subscribers to 'gps_info', remove it again
+     * using unsubscribe_gps_info().
+     *
+     * @return Handle of the subscription.
+     */
+    SubscriptionHandle subscribe_gps_info(GpsInfoCallback callback, SubscriptionOptions options);
+
+    /**
+     * @brief Remove a subscriber added using subscribe_gps_info() with options.
+     */
+    void unsubscribe_gps_info(SubscriptionHandle handle);
+
+    using Telemetry::subscribe_battery;
+
+    /**
+     * @brief Add a subscriber with options, e.g. to limit the rate of callbacks.
+     *
+     * This does not replace other subscribers to 'battery', remove it again
+     * using unsubscribe_battery().
+     *
+     * @return Handle of the subscription.
+     */
+    SubscriptionHandle subscribe_battery(BatteryCallback callback, SubscriptionOptions options);
+
+    /**
+     * @brief Remove a subscriber added using subscribe_battery() with options.
+     */
+    void unsubscribe_battery(SubscriptionHandle handle);
+
+    using Telemetry::subscribe_flight_mode;
+
+    /**
+     * @brief Add a subscriber with options, e.g. to limit the rate of callbacks.
+     *
+     * This does not replace other subscribers to 'flight_mode', remove it again
+     * using unsubscribe_flight_mode().
+     *
+     * @return Handle of the subscription.
+     */
+    SubscriptionHandle subscribe_flight_mode(
+        FlightModeCallback callback, SubscriptionOptions options);
+
+    /**
+     * @brief Remove a subscriber added using subscribe_flight_mode() with options.
+     */
+    void unsubscribe_flight_mode(SubscriptionHandle handle);
+
+    using Telemetry::subscribe_health;
+
+    /**
+     * @brief Add a subscriber with options, e.g. to limit the rate of callbacks.
+     *
+     * This does not replace other subscribers to 'health', remove it again
+     * using unsubscribe_health().
+     *
+     * @return Handle of the subscription.
+     */
+    SubscriptionHandle subscribe_health(HealthCallback callback, SubscriptionOptions options);
+
+    /**
+     * @brief Remove a subscriber added using subscribe_health() with options.
+     */
+    void unsubscribe_health(SubscriptionHandle handle);
+
+    using Telemetry::subscribe_rc_status;
+
+    /**
+     * @brief Add a subscriber with options, e.g. to limit the rate of callbacks.
+     *
+     * This does not replace other subscribers to 'rc_status', remove it again
+     * using unsubscribe_rc_status().
+     *
+     * @return Handle of the subscription.
+     */
+    SubscriptionHandle subscribe_rc_status(RcStatusCallback callback, SubscriptionOptions options);
+
+    /**
+     * @brief Remove a subscriber added using subscribe_rc_status() with options.
+     */
+    void unsubscribe_rc_status(SubscriptionHandle handle);
+
+    using Telemetry::subscribe_status_text;
+
+    /**
+     * @brief Add a subscriber with options, e.g. to limit the rate of callbacks.
+     *
+     * This does not replace other subscribers to 'status_text', remove it again
+     * using unsubscribe_status_text().
+     *
+     * @return Handle of the subscription.
+     */
+    SubscriptionHandle subscribe_status_text(
+        StatusTextCallback callback, SubscriptionOptions options);
+
+    /**
+     * @brief Remove a subscriber added using subscribe_status_text() with options.
+     */
+    void unsubscribe_status_text(SubscriptionHandle handle);
+
+    using Telemetry::subscribe_actuator_control_target;
+
+    /**
+     * @brief Add a subscriber with options, e.g. to limit the rate of callbacks.
+     *
+     * This does not replace other subscribers to 'actuator_control_target', remove it again
+     * using unsubscribe_actuator_control_target().
+     *
+     * @return Handle of the subscription.
+     */
+    SubscriptionHandle subscribe_actuator_control_target(
+        ActuatorControlTargetCallback callback, SubscriptionOptions options);
+
+    /**
+     * @brief Remove a subscriber added using subscribe_actuator_control_target() with options.
+     */
+    void unsubscribe_actuator_control_target(SubscriptionHandle handle);
+
+    using Telemetry::subscribe_actuator_output_status;
+
+    /**
+     * @brief Add a subscriber with options, e.g. to limit the rate of callbacks.
+     *
+     * This does not replace other subscribers to 'actuator_output_status', remove it again
+     * using unsubscribe_actuator_output_status().
+     *
+     * @return Handle of the subscription.
+     */
+    SubscriptionHandle subscribe_actuator_output_status(
+        ActuatorOutputStatusCallback callback, SubscriptionOptions options);
+
+    /**
+     * @brief Remove a subscriber added using subscribe_actuator_output_status() with options.
+     */
+    void unsubscribe_actuator_output_status(SubscriptionHandle handle);
+
+    /**
+     * @brief Callback type for subscribe_actuator_output_status_batch.
+     */
+    using ActuatorOutputStatusBatchCallback =
+        std::function<void(std::vector<ActuatorOutputStatus>)>;
+
+    /**
+     * @brief Add a subscriber receiving 'actuator_output_status' updates in batches.
+     *
+     * Remove it again using unsubscribe_actuator_output_status_batch().
+     *
+     * @return Handle of the subscription.
+     */
+    SubscriptionHandle subscribe_actuator_output_status_batch(
+        ActuatorOutputStatusBatchCallback callback, BatchOptions options);
+
+    /**
+     * @brief Remove a subscriber added using subscribe_actuator_output_status_batch().
+     *
+     * Samples collected for the next batch are still delivered.
+     */
+    void unsubscribe_actuator_output_status_batch(SubscriptionHandle handle);
+
+    using Telemetry::subscribe_odometry;
+
+    /**
+     * @brief Add a subscriber with options, e.g. to limit the rate of callbacks.
+     *
+     * This does not replace other subscribers to 'odometry', remove it again
+     * using unsubscribe_odometry().
+     *
+     * @return Handle of the subscription.
+     */
+    SubscriptionHandle subscribe_odometry(OdometryCallback callback, SubscriptionOptions options);
+
+    /**
+     * @brief Remove a subscriber added using subscribe_odometry() with options.
+     */
+    void unsubscribe_odometry(SubscriptionHandle handle);
+
+    /**
+     * @brief Callback type for subscribe_odometry_batch.
+     */
+    using OdometryBatchCallback = std::function<void(std::vector<Odometry>)>;
+
+    /**
+     * @brief Add a subscriber receiving 'odometry' updates in batches.
+     *
+     * Remove it again using unsubscribe_odometry_batch().
+     *
+     * @return Handle of the subscription.
+     */
+    SubscriptionHandle subscribe_odometry_batch(
+        OdometryBatchCallback callback, BatchOptions options);
+
+    /**
+     * @brief Remove a subscriber added using subscribe_odometry_batch().
+     *
+     * Samples collected for the next batch are still delivered.
+     */
+    void unsubscribe_odometry_batch(SubscriptionHandle handle);
+
+    using Telemetry::subscribe_position_velocity_ned;
+
+    /**
+     * @brief Add a subscriber with options, e.g. to limit the rate of callbacks.
+     *
+     * This does not replace other subscribers to 'position_velocity_ned', remove it again
+     * using unsubscribe_position_velocity_ned().
+     *
+     * @return Handle of the subscription.
+     */
+    SubscriptionHandle subscribe_position_velocity_ned(
+        PositionVelocityNedCallback callback, SubscriptionOptions options);
+
+    /**
+     * @brief Remove a subscriber added using subscribe_position_velocity_ned() with options.
+     */
+    void unsubscribe_position_velocity_ned(SubscriptionHandle handle);
+
+    using Telemetry::subscribe_ground_truth;
+
+    /**
+     * @brief Add a subscriber with options, e.g. to limit the rate of callbacks.
+     *
+     * This does not replace other subscribers to 'ground_truth', remove it again
+     * using unsubscribe_ground_truth().
+     *
+     * @return Handle of the subscription.
+     */
+    SubscriptionHandle subscribe_ground_truth(
+        GroundTruthCallback callback, SubscriptionOptions options);
+
+    /**
+     * @brief Remove a subscriber added using subscribe_ground_truth() with options.
+     */
+    void unsubscribe_ground_truth(SubscriptionHandle handle);
+
+    using Telemetry::subscribe_fixedwing_metrics;
+
+    /**
+     * @brief Add a subscriber with options, e.g. to limit the rate of callbacks.
+     *
+     * This does not replace other subscribers to 'fixedwing_metrics', remove it again
+     * using unsubscribe_fixedwing_metrics().
+     *
+     * @return Handle of the subscription.
+     */
+    SubscriptionHandle subscribe_fixedwing_metrics(
+        FixedwingMetricsCallback callback, SubscriptionOptions options);
+
+    /**
+     * @brief Remove a subscriber added using subscribe_fixedwing_metrics() with options.
+     */
+    void unsubscribe_fixedwing_metrics(SubscriptionHandle handle);
+
+    using Telemetry::subscribe_imu;
+
+    /**
+     * @brief Add a subscriber with options, e.g. to limit the rate of callbacks.
+     *
+     * This does not replace other subscribers to 'imu', remove it again
+     * using unsubscribe_imu().
+     *
+     * @return Handle of the subscription.
+     */
+    SubscriptionHandle subscribe_imu(ImuCallback callback, SubscriptionOptions options);
+
+    /**
+     * @brief Remove a subscriber added using subscribe_imu() with options.
+     */
+    void unsubscribe_imu(SubscriptionHandle handle);
+
+    /**
+     * @brief Callback type for subscribe_imu_batch.
+     */
+    using ImuBatchCallback = std::function<void(std::vector<Imu>)>;
+
+    /**
+     * @brief Add a subscriber receiving 'imu' updates in batches.
+     *
+     * Remove it again using unsubscribe_imu_batch().
+     *
+     * @return Handle of the subscription.
+     */
+    SubscriptionHandle subscribe_imu_batch(ImuBatchCallback callback, BatchOptions options);
+
+    /**
+     * @brief Remove a subscriber added using subscribe_imu_batch().
+     *
+     * Samples collected for the next batch are still delivered.
+     */
+    void unsubscribe_imu_batch(SubscriptionHandle handle);
+
+    using Telemetry::subscribe_health_all_ok;
+
+    /**
+     * @brief Add a subscriber with options, e.g. to limit the rate of callbacks.
+     *
+     * This does not replace other subscribers to 'health_all_ok', remove it again
+     * using unsubscribe_health_all_ok().
+     *
+     * @return Handle of the subscription.
+     */
+    SubscriptionHandle subscribe_health_all_ok(
+        HealthAllOkCallback callback, SubscriptionOptions options);
+
+    /**
+     * @brief Remove a subscriber added using subscribe_health_all_ok() with options.
+     */
+    void unsubscribe_health_all_ok(SubscriptionHandle handle);
+
+    using Telemetry::subscribe_unix_epoch_time;
+
+    /**
+     * @brief Add a subscriber with options, e.g. to limit the rate of callbacks.
+     *
+     * This does not replace other subscribers to 'unix_epoch_time', remove it again
+     * using unsubscribe_unix_epoch_time().
+     *
+     * @return Handle of the subscription.
+     */
+    SubscriptionHandle subscribe_unix_epoch_time(
+        UnixEpochTimeCallback callback, SubscriptionOptions options);
+
+    /**
+     * @brief Remove a subscriber added using subscribe_unix_epoch_time() with options.
+     */
+    void unsubscribe_unix_epoch_time(SubscriptionHandle handle);
+
+    using Telemetry::subscribe_distance_sensor;
+
+    /**
+     * @brief Add a subscriber with options, e.g. to limit the rate of callbacks.
+     *
+     * This does not replace other subscribers to 'distance_sensor', remove it again
+     * using unsubscribe_distance_sensor().
+     *
+     * @return Handle of the subscription.
+     */
+    SubscriptionHandle subscribe_distance_sensor(
+        DistanceSensorCallback callback, SubscriptionOptions options);
+
+    /**
+     * @brief Remove a subscriber added using subscribe_distance_sensor() with options.
+     */
+    void unsubscribe_distance_sensor(SubscriptionHandle handle);
+
+    /**
+     * @brief Poll for 'Snapshot' (non-blocking).
+     *
+     * Unlike polling the fields one by one, all fields are consistent with
+     * each other.
+     *
+     * @return The current Snapshot.
+     */
+    Snapshot snapshot() const;
+
+    /**
+     * @brief Keep a history of a stream to look up its samples by autopilot time.
+     *
+     * The samples are kept in a fixed size buffer of duration_s * max_rate_hz
+     * samples, so max_rate_hz should not be lower than the rate of the stream.
+     * Samples without an autopilot timestamp (battery) are stamped with the
+     * autopilot time estimated from the other streams.
+     *
+     * A duration_s of 0 disables the history again.
+     */
+    void enable_history(HistoryStream stream, double duration_s, double max_rate_hz);
+
+    /**
+     * @brief Get the 'position' samples of the history between two autopilot timestamps.
+     *
+     * @return The samples from from_us to to_us including both, oldest first.
+     */
+    std::vector<PositionSample> position_history(uint64_t from_us, uint64_t to_us) const;
+
+    /**
+     * @brief Look up the 'position' at an autopilot timestamp in the history.
+     *
+     * Either the sample nearest in time is returned, as long as it is not
+     * further away than the duration of the history, or the samples around
+     * timestamp_us are interpolated.
+     *
+     * @return false and an empty sample if there is no such sample in the history.
+     */
+    std::pair<bool, PositionSample> position_at(uint64_t timestamp_us, bool interpolate) const;
+
+    /**
+     * @brief Get the 'attitude' samples of the history between two autopilot timestamps.
+     *
+     * @return The samples from from_us to to_us including both, oldest first.
+     */
+    std::vector<AttitudeSample> attitude_history(uint64_t from_us, uint64_t to_us) const;
+
+    /**
+     * @brief Look up the 'attitude' at an autopilot timestamp in the history.
+     *
+     * Either the sample nearest in time is returned, as long as it is not
+     * further away than the duration of the history, or the samples around
+     * timestamp_us are interpolated.
+     *
+     * @return false and an empty sample if there is no such sample in the history.
+     */
+    std::pair<bool, AttitudeSample> attitude_at(uint64_t timestamp_us, bool interpolate) const;
+
+    /**
+     * @brief Get the 'velocity_ned' samples of the history between two autopilot timestamps.
+     *
+     * @return The samples from from_us to to_us including both, oldest first.
+     */
+    std::vector<VelocityNedSample> velocity_ned_history(uint64_t from_us, uint64_t to_us) const;
+
+    /**
+     * @brief Look up the 'velocity_ned' at an autopilot timestamp in the history.
+     *
+     * Either the sample nearest in time is returned, as long as it is not
+     * further away than the duration of the history, or the samples around
+     * timestamp_us are interpolated.
+     *
+     * @return false and an empty sample if there is no such sample in the history.
+     */
+    std::pair<bool, VelocityNedSample> velocity_ned_at(
+        uint64_t timestamp_us, bool interpolate) const;
+
+    /**
+     * @brief Get the 'battery' samples of the history between two autopilot timestamps.
+     *
+     * @return The samples from from_us to to_us including both, oldest first.
+     */
+    std::vector<BatterySample> battery_history(uint64_t from_us, uint64_t to_us) const;
+
+    /**
+     * @brief Look up the 'battery' at an autopilot timestamp in the history.
+     *
+     * Either the sample nearest in time is returned, as long as it is not
+     * further away than the duration of the history, or the samples around
+     * timestamp_us are interpolated.
+     *
+     * @return false and an empty sample if there is no such sample in the history.
+     */
+    std::pair<bool, BatterySample> battery_at(uint64_t timestamp_us, bool interpolate) const;
+
+    /**
+     * @brief Copy constructor (object is not copyable).
+     */
+    TelemetryExtended(const TelemetryExtended& other) = delete;
+
+    /**
+     * @brief Equality operator (object is not copyable).
+     */
+    const TelemetryExtended& operator=(const TelemetryExtended&) = delete;
+};
+
+} // namespace mavsdk
@@ -1,46 +1,83 @@
 #include <gmock/gmock.h>
 
 #include "plugins/telemetry/telemetry.h"
+#include "plugins/telemetry/telemetry_extended.h"
 
 namespace mavsdk {
 namespace testing {
 
 class MockTelemetry {
 public:
-    MOCK_CONST_METHOD1(subscribe_position, void(Telemetry::PositionCallback)){};
-    MOCK_CONST_METHOD1(subscribe_health, void(Telemetry::HealthCallback)){};
-    MOCK_CONST_METHOD1(subscribe_home, void(Telemetry::PositionCallback)){};
-    MOCK_CONST_METHOD1(subscribe_in_air, void(Telemetry::InAirCallback)){};
-    MOCK_CONST_METHOD1(subscribe_status_text, void(Telemetry::StatusTextCallback)){};
-    MOCK_CONST_METHOD1(subscribe_armed, void(Telemetry::ArmedCallback)){};
-    MOCK_CONST_METHOD1(subscribe_gps_info, void(Telemetry::GpsInfoCallback)){};
-    MOCK_CONST_METHOD1(subscribe_battery, void(Telemetry::BatteryCallback)){};
-    MOCK_CONST_METHOD1(subscribe_flight_mode, void(Telemetry::FlightModeCallback)){};
-    MOCK_CONST_METHOD1(subscribe_landed_state, void(Telemetry::LandedStateCallback)){};
-    MOCK_CONST_METHOD1(
-        subscribe_attitude_quaternion, void(Telemetry::AttitudeQuaternionCallback)){};
-    MOCK_CONST_METHOD1(
+    using Handle = TelemetryExtended::SubscriptionHandle;
+    using Options = TelemetryExtended::SubscriptionOptions;
+
+    MOCK_METHOD2(subscribe_position, Handle(Telemetry::PositionCallback, Options)){};
+    MOCK_METHOD1(unsubscribe_position, void(Handle)){};
+    MOCK_METHOD2(subscribe_health, Handle(Telemetry::HealthCallback, Options)){};
+    MOCK_METHOD1(unsubscribe_health, void(Handle)){};
+    MOCK_METHOD2(subscribe_home, Handle(Telemetry::PositionCallback, Options)){};
+    MOCK_METHOD1(unsubscribe_home, void(Handle)){};
+    MOCK_METHOD2(subscribe_in_air, Handle(Telemetry::InAirCallback, Options)){};
+    MOCK_METHOD1(unsubscribe_in_air, void(Handle)){};
+    MOCK_METHOD2(subscribe_status_text, Handle(Telemetry::StatusTextCallback, Options)){};
+    MOCK_METHOD1(unsubscribe_status_text, void(Handle)){};
+    MOCK_METHOD2(subscribe_armed, Handle(Telemetry::ArmedCallback, Options)){};
+    MOCK_METHOD1(unsubscribe_armed, void(Handle)){};
+    MOCK_METHOD2(subscribe_gps_info, Handle(Telemetry::GpsInfoCallback, Options)){};
+    MOCK_METHOD1(unsubscribe_gps_info, void(Handle)){};
+    MOCK_METHOD2(subscribe_battery, Handle(Telemetry::BatteryCallback, Options)){};
+    MOCK_METHOD1(unsubscribe_battery, void(Handle)){};
+    MOCK_METHOD2(subscribe_flight_mode, Handle(Telemetry::FlightModeCallback, Options)){};
+    MOCK_METHOD1(unsubscribe_flight_mode, void(Handle)){};
+    MOCK_METHOD2(subscribe_landed_state, Handle(Telemetry::LandedStateCallback, Options)){};
+    MOCK_METHOD1(unsubscribe_landed_state, void(Handle)){};
+    MOCK_METHOD2(
+        subscribe_attitude_quaternion, Handle(Telemetry::AttitudeQuaternionCallback, Options)){};
+    MOCK_METHOD1(unsubscribe_attitude_quaternion, void(Handle)){};
+    MOCK_METHOD2(
         subscribe_attitude_angular_velocity_body,
-        void(Telemetry::AttitudeAngularVelocityBodyCallback)){};
-    MOCK_CONST_METHOD1(subscribe_attitude_euler, void(Telemetry::AttitudeEulerCallback)){};
-    MOCK_CONST_METHOD1(
-        subscribe_camera_attitude_quaternion, void(Telemetry::AttitudeQuaternionCallback)){};
-    MOCK_CONST_METHOD1(subscribe_camera_attitude_euler, void(Telemetry::AttitudeEulerCallback)){};
-    MOCK_CONST_METHOD1(subscribe_velocity_ned, void(Telemetry::VelocityNedCallback)){};
-    MOCK_CONST_METHOD1(subscribe_rc_status, void(Telemetry::RcStatusCallback)){};
-    MOCK_CONST_METHOD1(
-        subscribe_actuator_control_target, void(Telemetry::ActuatorControlTargetCallback)){};
-    MOCK_CONST_METHOD1(
-        subscribe_actuator_output_status, void(Telemetry::ActuatorOutputStatusCallback)){};
-    MOCK_CONST_METHOD1(subscribe_odometry, void(Telemetry::OdometryCallback)){};
-    MOCK_CONST_METHOD1(subscribe_distance_sensor, void(Telemetry::DistanceSensorCallback)){};
-    MOCK_CONST_METHOD1(
-        subscribe_position_velocity_ned, void(Telemetry::PositionVelocityNedCallback)){};
-    MOCK_CONST_METHOD1(subscribe_ground_truth, void(Telemetry::GroundTruthCallback)){};
-    MOCK_CONST_METHOD1(subscribe_fixedwing_metrics, void(Telemetry::FixedwingMetricsCallback)){};
-    MOCK_CONST_METHOD1(subscribe_imu, void(Telemetry::ImuCallback)){};
-    MOCK_CONST_METHOD1(subscribe_health_all_ok, void(Telemetry::HealthAllOkCallback)){};
-    MOCK_CONST_METHOD1(subscribe_unix_epoch_time, void(Telemetry::UnixEpochTimeCallback)){};
+        Handle(Telemetry::AttitudeAngularVelocityBodyCallback, Options)){};
+    MOCK_METHOD1(unsubscribe_attitude_angular_velocity_body, void(Handle)){};
+    MOCK_METHOD2(subscribe_attitude_euler, Handle(Telemetry::AttitudeEulerCallback, Options)){};
+    MOCK_METHOD1(unsubscribe_attitude_euler, void(Handle)){};
+    MOCK_METHOD2(
+        subscribe_camera_attitude_quaternion,
+        Handle(Telemetry::AttitudeQuaternionCallback, Options)){};
+    MOCK_METHOD1(unsubscribe_camera_attitude_quaternion, void(Handle)){};
+    MOCK_METHOD2(
+        subscribe_camera_attitude_euler, Handle(Telemetry::AttitudeEulerCallback, Options)){};
+    MOCK_METHOD1(unsubscribe_camera_attitude_euler, void(Handle)){};
+    MOCK_METHOD2(subscribe_velocity_ned, Handle(Telemetry::VelocityNedCallback, Options)){};
+    MOCK_METHOD1(unsubscribe_velocity_ned, void(Handle)){};
+    MOCK_METHOD2(subscribe_rc_status, Handle(Telemetry::RcStatusCallback, Options)){};
+    MOCK_METHOD1(unsubscribe_rc_status, void(Handle)){};
+    MOCK_METHOD2(
+        subscribe_actuator_control_target,
+        Handle(Telemetry::ActuatorControlTargetCallback, Options)){};
+    MOCK_METHOD1(unsubscribe_actuator_control_target, void(Handle)){};
+    MOCK_METHOD2(
+        subscribe_actuator_output_status,
+        Handle(Telemetry::ActuatorOutputStatusCallback, Options)){};
+    MOCK_METHOD1(unsubscribe_actuator_output_status, void(Handle)){};
+    MOCK_METHOD2(subscribe_odometry, Handle(Telemetry::OdometryCallback, Options)){};
+    MOCK_METHOD1(unsubscribe_odometry, void(Handle)){};
+    MOCK_METHOD2(subscribe_distance_sensor, Handle(Telemetry::DistanceSensorCallback, Options)){};
+    MOCK_METHOD1(unsubscribe_distance_sensor, void(Handle)){};
+    MOCK_METHOD2(
+        subscribe_position_velocity_ned,
+        Handle(Telemetry::PositionVelocityNedCallback, Options)){};
+    MOCK_METHOD1(unsubscribe_position_velocity_ned, void(Handle)){};
+    MOCK_METHOD2(subscribe_ground_truth, Handle(Telemetry::GroundTruthCallback, Options)){};
+    MOCK_METHOD1(unsubscribe_ground_truth, void(Handle)){};
+    MOCK_METHOD2(
+        subscribe_fixedwing_metrics, Handle(Telemetry::FixedwingMetricsCallback, Options)){};
+    MOCK_METHOD1(unsubscribe_fixedwing_metrics, void(Handle)){};
+    MOCK_METHOD2(subscribe_imu, Handle(Telemetry::ImuCallback, Options)){};
+    MOCK_METHOD1(unsubscribe_imu, void(Handle)){};
+    MOCK_METHOD2(subscribe_health_all_ok, Handle(Telemetry::HealthAllOkCallback, Options)){};
+    MOCK_METHOD1(unsubscribe_health_all_ok, void(Handle)){};
+    MOCK_METHOD2(subscribe_unix_epoch_time, Handle(Telemetry::UnixEpochTimeCallback, Options)){};
+    MOCK_METHOD1(unsubscribe_unix_epoch_time, void(Handle)){};
 
     MOCK_METHOD1(set_rate_position, Telemetry::Result(double)){};
     MOCK_METHOD1(set_rate_home, Telemetry::Result(double)){};
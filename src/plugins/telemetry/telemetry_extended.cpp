@@ -0,0 +1,588 @@
+#include <cmath>
+#include <iomanip>
+
+#include "telemetry_impl.h"
+#include "plugins/telemetry/telemetry_extended.h"
+
+namespace mavsdk {
+
+TelemetryExtended::TelemetryExtended(System& system) : Telemetry(system) {}
+
+TelemetryExtended::TelemetryExtended(std::shared_ptr<System> system) :
+    Telemetry(std::move(system))
+{}
+
+TelemetryExtended::~TelemetryExtended() {}
+
+TelemetryExtended::SubscriptionHandle
+TelemetryExtended::subscribe_position(PositionCallback callback, SubscriptionOptions options)
+{
+    return _impl->subscribe_position(callback, options);
+}
+
+void TelemetryExtended::unsubscribe_position(SubscriptionHandle handle)
+{
+    _impl->unsubscribe_position(handle);
+}
+
+TelemetryExtended::SubscriptionHandle
+TelemetryExtended::subscribe_home(HomeCallback callback, SubscriptionOptions options)
+{
+    return _impl->subscribe_home(callback, options);
+}
+
+void TelemetryExtended::unsubscribe_home(SubscriptionHandle handle)
+{
+    _impl->unsubscribe_home(handle);
+}
+
+TelemetryExtended::SubscriptionHandle
+TelemetryExtended::subscribe_in_air(InAirCallback callback, SubscriptionOptions options)
+{
+    return _impl->subscribe_in_air(callback, options);
+}
+
+void TelemetryExtended::unsubscribe_in_air(SubscriptionHandle handle)
+{
+    _impl->unsubscribe_in_air(handle);
+}
+
+TelemetryExtended::SubscriptionHandle
+TelemetryExtended::subscribe_landed_state(LandedStateCallback callback, SubscriptionOptions options)
+{
+    return _impl->subscribe_landed_state(callback, options);
+}
+
+void TelemetryExtended::unsubscribe_landed_state(SubscriptionHandle handle)
+{
+    _impl->unsubscribe_landed_state(handle);
+}
+
+TelemetryExtended::SubscriptionHandle
+TelemetryExtended::subscribe_armed(ArmedCallback callback, SubscriptionOptions options)
+{
+    return _impl->subscribe_armed(callback, options);
+}
+
+void TelemetryExtended::unsubscribe_armed(SubscriptionHandle handle)
+{
+    _impl->unsubscribe_armed(handle);
+}
+
+TelemetryExtended::SubscriptionHandle TelemetryExtended::subscribe_attitude_quaternion(
+    AttitudeQuaternionCallback callback, SubscriptionOptions options)
+{
+    return _impl->subscribe_attitude_quaternion(callback, options);
+}
+
+void TelemetryExtended::unsubscribe_attitude_quaternion(SubscriptionHandle handle)
+{
+    _impl->unsubscribe_attitude_quaternion(handle);
+}
+
+TelemetryExtended::SubscriptionHandle TelemetryExtended::subscribe_attitude_euler(
+    AttitudeEulerCallback callback, SubscriptionOptions options)
+{
+    return _impl->subscribe_attitude_euler(callback, options);
+}
+
+void TelemetryExtended::unsubscribe_attitude_euler(SubscriptionHandle handle)
+{
+    _impl->unsubscribe_attitude_euler(handle);
+}
+
+TelemetryExtended::SubscriptionHandle TelemetryExtended::subscribe_attitude_angular_velocity_body(
+    AttitudeAngularVelocityBodyCallback callback, SubscriptionOptions options)
+{
+    return _impl->subscribe_attitude_angular_velocity_body(callback, options);
+}
+
+void TelemetryExtended::unsubscribe_attitude_angular_velocity_body(SubscriptionHandle handle)
+{
+    _impl->unsubscribe_attitude_angular_velocity_body(handle);
+}
+
+TelemetryExtended::SubscriptionHandle TelemetryExtended::subscribe_camera_attitude_quaternion(
+    CameraAttitudeQuaternionCallback callback, SubscriptionOptions options)
+{
+    return _impl->subscribe_camera_attitude_quaternion(callback, options);
+}
+
+void TelemetryExtended::unsubscribe_camera_attitude_quaternion(SubscriptionHandle handle)
+{
+    _impl->unsubscribe_camera_attitude_quaternion(handle);
+}
+
+TelemetryExtended::SubscriptionHandle TelemetryExtended::subscribe_camera_attitude_euler(
+    CameraAttitudeEulerCallback callback, SubscriptionOptions options)
+{
+    return _impl->subscribe_camera_attitude_euler(callback, options);
+}
+
+void TelemetryExtended::unsubscribe_camera_attitude_euler(SubscriptionHandle handle)
+{
+    _impl->unsubscribe_camera_attitude_euler(handle);
+}
+
+TelemetryExtended::SubscriptionHandle
+TelemetryExtended::subscribe_velocity_ned(VelocityNedCallback callback, SubscriptionOptions options)
+{
+    return _impl->subscribe_velocity_ned(callback, options);
+}
+
+void TelemetryExtended::unsubscribe_velocity_ned(SubscriptionHandle handle)
+{
+    _impl->unsubscribe_velocity_ned(handle);
+}
+
+TelemetryExtended::SubscriptionHandle
+TelemetryExtended::subscribe_gps_info(GpsInfoCallback callback, SubscriptionOptions options)
+{
+    return _impl->subscribe_gps_info(callback, options);
+}
+
+void TelemetryExtended::unsubscribe_gps_info(SubscriptionHandle handle)
+{
+    _impl->unsubscribe_gps_info(handle);
+}
+
+TelemetryExtended::SubscriptionHandle
+TelemetryExtended::subscribe_battery(BatteryCallback callback, SubscriptionOptions options)
+{
+    return _impl->subscribe_battery(callback, options);
+}
+
+void TelemetryExtended::unsubscribe_battery(SubscriptionHandle handle)
+{
+    _impl->unsubscribe_battery(handle);
+}
+
+TelemetryExtended::SubscriptionHandle
+TelemetryExtended::subscribe_flight_mode(FlightModeCallback callback, SubscriptionOptions options)
+{
+    return _impl->subscribe_flight_mode(callback, options);
+}
+
+void TelemetryExtended::unsubscribe_flight_mode(SubscriptionHandle handle)
+{
+    _impl->unsubscribe_flight_mode(handle);
+}
+
+TelemetryExtended::SubscriptionHandle
+TelemetryExtended::subscribe_health(HealthCallback callback, SubscriptionOptions options)
+{
+    return _impl->subscribe_health(callback, options);
+}
+
+void TelemetryExtended::unsubscribe_health(SubscriptionHandle handle)
+{
+    _impl->unsubscribe_health(handle);
+}
+
+TelemetryExtended::SubscriptionHandle
+TelemetryExtended::subscribe_rc_status(RcStatusCallback callback, SubscriptionOptions options)
+{
+    return _impl->subscribe_rc_status(callback, options);
+}
+
+void TelemetryExtended::unsubscribe_rc_status(SubscriptionHandle handle)
+{
+    _impl->unsubscribe_rc_status(handle);
+}
+
+TelemetryExtended::SubscriptionHandle
+TelemetryExtended::subscribe_status_text(StatusTextCallback callback, SubscriptionOptions options)
+{
+    return _impl->subscribe_status_text(callback, options);
+}
+
+void TelemetryExtended::unsubscribe_status_text(SubscriptionHandle handle)
+{
+    _impl->unsubscribe_status_text(handle);
+}
+
+TelemetryExtended::SubscriptionHandle TelemetryExtended::subscribe_actuator_control_target(
+    ActuatorControlTargetCallback callback, SubscriptionOptions options)
+{
+    return _impl->subscribe_actuator_control_target(callback, options);
+}
+
+void TelemetryExtended::unsubscribe_actuator_control_target(SubscriptionHandle handle)
+{
+    _impl->unsubscribe_actuator_control_target(handle);
+}
+
+TelemetryExtended::SubscriptionHandle TelemetryExtended::subscribe_actuator_output_status(
+    ActuatorOutputStatusCallback callback, SubscriptionOptions options)
+{
+    return _impl->subscribe_actuator_output_status(callback, options);
+}
+
+void TelemetryExtended::unsubscribe_actuator_output_status(SubscriptionHandle handle)
+{
+    _impl->unsubscribe_actuator_output_status(handle);
+}
+
+TelemetryExtended::SubscriptionHandle TelemetryExtended::subscribe_actuator_output_status_batch(
+    ActuatorOutputStatusBatchCallback callback, BatchOptions options)
+{
+    return _impl->subscribe_actuator_output_status_batch(callback, options);
+}
+
+void TelemetryExtended::unsubscribe_actuator_output_status_batch(SubscriptionHandle handle)
+{
+    _impl->unsubscribe_actuator_output_status_batch(handle);
+}
+
+TelemetryExtended::SubscriptionHandle
+TelemetryExtended::subscribe_odometry(OdometryCallback callback, SubscriptionOptions options)
+{
+    return _impl->subscribe_odometry(callback, options);
+}
+
+void TelemetryExtended::unsubscribe_odometry(SubscriptionHandle handle)
+{
+    _impl->unsubscribe_odometry(handle);
+}
+
+TelemetryExtended::SubscriptionHandle
+TelemetryExtended::subscribe_odometry_batch(OdometryBatchCallback callback, BatchOptions options)
+{
+    return _impl->subscribe_odometry_batch(callback, options);
+}
+
+void TelemetryExtended::unsubscribe_odometry_batch(SubscriptionHandle handle)
+{
+    _impl->unsubscribe_odometry_batch(handle);
+}
+
+TelemetryExtended::SubscriptionHandle TelemetryExtended::subscribe_position_velocity_ned(
+    PositionVelocityNedCallback callback, SubscriptionOptions options)
+{
+    return _impl->subscribe_position_velocity_ned(callback, options);
+}
+
+void TelemetryExtended::unsubscribe_position_velocity_ned(SubscriptionHandle handle)
+{
+    _impl->unsubscribe_position_velocity_ned(handle);
+}
+
+TelemetryExtended::SubscriptionHandle
+TelemetryExtended::subscribe_ground_truth(GroundTruthCallback callback, SubscriptionOptions options)
+{
+    return _impl->subscribe_ground_truth(callback, options);
+}
+
+void TelemetryExtended::unsubscribe_ground_truth(SubscriptionHandle handle)
+{
+    _impl->unsubscribe_ground_truth(handle);
+}
+
+TelemetryExtended::SubscriptionHandle TelemetryExtended::subscribe_fixedwing_metrics(
+    FixedwingMetricsCallback callback, SubscriptionOptions options)
+{
+    return _impl->subscribe_fixedwing_metrics(callback, options);
+}
+
+void TelemetryExtended::unsubscribe_fixedwing_metrics(SubscriptionHandle handle)
+{
+    _impl->unsubscribe_fixedwing_metrics(handle);
+}
+
+TelemetryExtended::SubscriptionHandle
+TelemetryExtended::subscribe_imu(ImuCallback callback, SubscriptionOptions options)
+{
+    return _impl->subscribe_imu(callback, options);
+}
+
+void TelemetryExtended::unsubscribe_imu(SubscriptionHandle handle)
+{
+    _impl->unsubscribe_imu(handle);
+}
+
+TelemetryExtended::SubscriptionHandle
+TelemetryExtended::subscribe_imu_batch(ImuBatchCallback callback, BatchOptions options)
+{
+    return _impl->subscribe_imu_batch(callback, options);
+}
+
+void TelemetryExtended::unsubscribe_imu_batch(SubscriptionHandle handle)
+{
+    _impl->unsubscribe_imu_batch(handle);
+}
+
+TelemetryExtended::SubscriptionHandle TelemetryExtended::subscribe_health_all_ok(
+    HealthAllOkCallback callback, SubscriptionOptions options)
+{
+    return _impl->subscribe_health_all_ok(callback, options);
+}
+
+void TelemetryExtended::unsubscribe_health_all_ok(SubscriptionHandle handle)
+{
+    _impl->unsubscribe_health_all_ok(handle);
+}
+
+TelemetryExtended::SubscriptionHandle TelemetryExtended::subscribe_unix_epoch_time(
+    UnixEpochTimeCallback callback, SubscriptionOptions options)
+{
+    return _impl->subscribe_unix_epoch_time(callback, options);
+}
+
+void TelemetryExtended::unsubscribe_unix_epoch_time(SubscriptionHandle handle)
+{
+    _impl->unsubscribe_unix_epoch_time(handle);
+}
+
+TelemetryExtended::SubscriptionHandle TelemetryExtended::subscribe_distance_sensor(
+    DistanceSensorCallback callback, SubscriptionOptions options)
+{
+    return _impl->subscribe_distance_sensor(callback, options);
+}
+
+void TelemetryExtended::unsubscribe_distance_sensor(SubscriptionHandle handle)
+{
+    _impl->unsubscribe_distance_sensor(handle);
+}
+
+TelemetryExtended::Snapshot TelemetryExtended::snapshot() const
+{
+    return _impl->snapshot();
+}
+
+void TelemetryExtended::enable_history(HistoryStream stream, double duration_s, double max_rate_hz)
+{
+    _impl->enable_history(stream, duration_s, max_rate_hz);
+}
+
+std::vector<TelemetryExtended::PositionSample>
+TelemetryExtended::position_history(uint64_t from_us, uint64_t to_us) const
+{
+    return _impl->position_history(from_us, to_us);
+}
+
+std::pair<bool, TelemetryExtended::PositionSample>
+TelemetryExtended::position_at(uint64_t timestamp_us, bool interpolate) const
+{
+    return _impl->position_at(timestamp_us, interpolate);
+}
+
+std::vector<TelemetryExtended::AttitudeSample>
+TelemetryExtended::attitude_history(uint64_t from_us, uint64_t to_us) const
+{
+    return _impl->attitude_history(from_us, to_us);
+}
+
+std::pair<bool, TelemetryExtended::AttitudeSample>
+TelemetryExtended::attitude_at(uint64_t timestamp_us, bool interpolate) const
+{
+    return _impl->attitude_at(timestamp_us, interpolate);
+}
+
+std::vector<TelemetryExtended::VelocityNedSample>
+TelemetryExtended::velocity_ned_history(uint64_t from_us, uint64_t to_us) const
+{
+    return _impl->velocity_ned_history(from_us, to_us);
+}
+
+std::pair<bool, TelemetryExtended::VelocityNedSample>
+TelemetryExtended::velocity_ned_at(uint64_t timestamp_us, bool interpolate) const
+{
+    return _impl->velocity_ned_at(timestamp_us, interpolate);
+}
+
+std::vector<TelemetryExtended::BatterySample>
+TelemetryExtended::battery_history(uint64_t from_us, uint64_t to_us) const
+{
+    return _impl->battery_history(from_us, to_us);
+}
+
+std::pair<bool, TelemetryExtended::BatterySample>
+TelemetryExtended::battery_at(uint64_t timestamp_us, bool interpolate) const
+{
+    return _impl->battery_at(timestamp_us, interpolate);
+}
+
+bool operator==(const TelemetryExtended::Snapshot& lhs, const TelemetryExtended::Snapshot& rhs)
+{
+    return (rhs.position == lhs.position) && (rhs.home == lhs.home) &&
+           (rhs.in_air == lhs.in_air) && (rhs.armed == lhs.armed) &&
+           (rhs.landed_state == lhs.landed_state) &&
+           (rhs.attitude_quaternion == lhs.attitude_quaternion) &&
+           (rhs.attitude_euler == lhs.attitude_euler) &&
+           (rhs.attitude_angular_velocity_body == lhs.attitude_angular_velocity_body) &&
+           (rhs.velocity_ned == lhs.velocity_ned) &&
+           (rhs.position_velocity_ned == lhs.position_velocity_ned) && (rhs.imu == lhs.imu) &&
+           (rhs.gps_info == lhs.gps_info) && (rhs.battery == lhs.battery) &&
+           (rhs.health == lhs.health) && (rhs.ground_truth == lhs.ground_truth) &&
+           (rhs.fixedwing_metrics == lhs.fixedwing_metrics);
+}
+
+std::ostream& operator<<(std::ostream& str, TelemetryExtended::Snapshot const& snapshot)
+{
+    str << std::setprecision(15);
+    str << "snapshot:" << '\n' << "{\n";
+    str << "    position: " << snapshot.position << '\n';
+    str << "    home: " << snapshot.home << '\n';
+    str << "    in_air: " << snapshot.in_air << '\n';
+    str << "    armed: " << snapshot.armed << '\n';
+    str << "    landed_state: " << snapshot.landed_state << '\n';
+    str << "    attitude_quaternion: " << snapshot.attitude_quaternion << '\n';
+    str << "    attitude_euler: " << snapshot.attitude_euler << '\n';
+    str << "    attitude_angular_velocity_body: " << snapshot.attitude_angular_velocity_body
+        << '\n';
+    str << "    velocity_ned: " << snapshot.velocity_ned << '\n';
+    str << "    position_velocity_ned: " << snapshot.position_velocity_ned << '\n';
+    str << "    imu: " << snapshot.imu << '\n';
+    str << "    gps_info: " << snapshot.gps_info << '\n';
+    str << "    battery: " << snapshot.battery << '\n';
+    str << "    health: " << snapshot.health << '\n';
+    str << "    ground_truth: " << snapshot.ground_truth << '\n';
+    str << "    fixedwing_metrics: " << snapshot.fixedwing_metrics << '\n';
+    str << '}';
+    return str;
+}
+
+bool operator==(
+    const TelemetryExtended::SubscriptionOptions& lhs,
+    const TelemetryExtended::SubscriptionOptions& rhs)
+{
+    return ((std::isnan(rhs.max_rate_hz) && std::isnan(lhs.max_rate_hz)) ||
+            rhs.max_rate_hz == lhs.max_rate_hz) &&
+           (rhs.decimation == lhs.decimation) && (rhs.latest_only == lhs.latest_only) &&
+           (rhs.coalesce == lhs.coalesce);
+}
+
+std::ostream&
+operator<<(std::ostream& str, TelemetryExtended::SubscriptionOptions const& subscription_options)
+{
+    str << std::setprecision(15);
+    str << "subscription_options:" << '\n' << "{\n";
+    str << "    max_rate_hz: " << subscription_options.max_rate_hz << '\n';
+    str << "    decimation: " << subscription_options.decimation << '\n';
+    str << "    latest_only: " << subscription_options.latest_only << '\n';
+    str << "    coalesce: " << subscription_options.coalesce << '\n';
+    str << '}';
+    return str;
+}
+
+bool operator==(
+    const TelemetryExtended::SubscriptionHandle& lhs,
+    const TelemetryExtended::SubscriptionHandle& rhs)
+{
+    return (rhs.id == lhs.id);
+}
+
+std::ostream&
+operator<<(std::ostream& str, TelemetryExtended::SubscriptionHandle const& subscription_handle)
+{
+    str << std::setprecision(15);
+    str << "subscription_handle:" << '\n' << "{\n";
+    str << "    id: " << subscription_handle.id << '\n';
+    str << '}';
+    return str;
+}
+
+bool operator==(
+    const TelemetryExtended::BatchOptions& lhs, const TelemetryExtended::BatchOptions& rhs)
+{
+    return (rhs.max_samples == lhs.max_samples) &&
+           ((std::isnan(rhs.max_interval_s) && std::isnan(lhs.max_interval_s)) ||
+            rhs.max_interval_s == lhs.max_interval_s);
+}
+
+std::ostream& operator<<(std::ostream& str, TelemetryExtended::BatchOptions const& batch_options)
+{
+    str << std::setprecision(15);
+    str << "batch_options:" << '\n' << "{\n";
+    str << "    max_samples: " << batch_options.max_samples << '\n';
+    str << "    max_interval_s: " << batch_options.max_interval_s << '\n';
+    str << '}';
+    return str;
+}
+
+bool operator==(
+    const TelemetryExtended::PositionSample& lhs, const TelemetryExtended::PositionSample& rhs)
+{
+    return (rhs.timestamp_us == lhs.timestamp_us) && (rhs.position == lhs.position);
+}
+
+std::ostream& operator<<(
+    std::ostream& str, TelemetryExtended::PositionSample const& position_sample)
+{
+    str << std::setprecision(15);
+    str << "position_sample:" << '\n' << "{\n";
+    str << "    timestamp_us: " << position_sample.timestamp_us << '\n';
+    str << "    position: " << position_sample.position << '\n';
+    str << '}';
+    return str;
+}
+
+bool operator==(
+    const TelemetryExtended::AttitudeSample& lhs, const TelemetryExtended::AttitudeSample& rhs)
+{
+    return (rhs.timestamp_us == lhs.timestamp_us) &&
+           (rhs.attitude_quaternion == lhs.attitude_quaternion);
+}
+
+std::ostream& operator<<(
+    std::ostream& str, TelemetryExtended::AttitudeSample const& attitude_sample)
+{
+    str << std::setprecision(15);
+    str << "attitude_sample:" << '\n' << "{\n";
+    str << "    timestamp_us: " << attitude_sample.timestamp_us << '\n';
+    str << "    attitude_quaternion: " << attitude_sample.attitude_quaternion << '\n';
+    str << '}';
+    return str;
+}
+
+bool operator==(
+    const TelemetryExtended::VelocityNedSample& lhs,
+    const TelemetryExtended::VelocityNedSample& rhs)
+{
+    return (rhs.timestamp_us == lhs.timestamp_us) && (rhs.velocity_ned == lhs.velocity_ned);
+}
+
+std::ostream& operator<<(
+    std::ostream& str, TelemetryExtended::VelocityNedSample const& velocity_ned_sample)
+{
+    str << std::setprecision(15);
+    str << "velocity_ned_sample:" << '\n' << "{\n";
+    str << "    timestamp_us: " << velocity_ned_sample.timestamp_us << '\n';
+    str << "    velocity_ned: " << velocity_ned_sample.velocity_ned << '\n';
+    str << '}';
+    return str;
+}
+
+bool operator==(
+    const TelemetryExtended::BatterySample& lhs, const TelemetryExtended::BatterySample& rhs)
+{
+    return (rhs.timestamp_us == lhs.timestamp_us) && (rhs.battery == lhs.battery);
+}
+
+std::ostream& operator<<(std::ostream& str, TelemetryExtended::BatterySample const& battery_sample)
+{
+    str << std::setprecision(15);
+    str << "battery_sample:" << '\n' << "{\n";
+    str << "    timestamp_us: " << battery_sample.timestamp_us << '\n';
+    str << "    battery: " << battery_sample.battery << '\n';
+    str << '}';
+    return str;
+}
+
+std::ostream& operator<<(std::ostream& str, TelemetryExtended::HistoryStream const& history_stream)
+{
+    switch (history_stream) {
+        case TelemetryExtended::HistoryStream::Position:
+            return str << "Position";
+        case TelemetryExtended::HistoryStream::Attitude:
+            return str << "Attitude";
+        case TelemetryExtended::HistoryStream::VelocityNed:
+            return str << "Velocity Ned";
+        case TelemetryExtended::HistoryStream::Battery:
+            return str << "Battery";
+        default:
+            return str << "Unknown";
+    }
+}
+
+} // namespace mavsdk
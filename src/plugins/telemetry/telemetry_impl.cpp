@@ -129,6 +129,14 @@ void TelemetryImpl::deinit()
     _parent->unregister_timeout_handler(_rc_channels_timeout_cookie);
     _parent->unregister_timeout_handler(_gps_raw_timeout_cookie);
     _parent->unregister_timeout_handler(_unix_epoch_timeout_cookie);
+    {
+        std::lock_guard<std::mutex> lock(_subscription_mutex);
+        if (_batch_flush_cookie != nullptr) {
+            _parent->remove_call_every(_batch_flush_cookie);
+            _batch_flush_cookie = nullptr;
+            _batch_flush_interval_s = 0.0;
+        }
+    }
     _parent->unregister_param_changed_handler(this);
     _parent->unregister_all_mavlink_message_handlers(this);
 }
@@ -206,6 +214,48 @@ void TelemetryImpl::enable()
 
 void TelemetryImpl::disable() {}
 
+void TelemetryImpl::update_batch_flush()
+{
+    double min_interval_s = 0.0;
+    for (const double interval_s :
+         {_imu_reading_ned_subscription.min_batch_interval_s(),
+          _actuator_output_status_subscription.min_batch_interval_s(),
+          _odometry_subscription.min_batch_interval_s()}) {
+        if (interval_s > 0.0 && (min_interval_s == 0.0 || interval_s < min_interval_s)) {
+            min_interval_s = interval_s;
+        }
+    }
+
+    if (min_interval_s == 0.0) {
+        if (_batch_flush_cookie != nullptr) {
+            _parent->remove_call_every(_batch_flush_cookie);
+            _batch_flush_cookie = nullptr;
+        }
+        _batch_flush_interval_s = 0.0;
+        return;
+    }
+
+    // Checking a few times per interval keeps a batch from being late by more
+    // than a fraction of it.
+    const double flush_interval_s = min_interval_s / 4.0;
+    if (_batch_flush_cookie == nullptr) {
+        _parent->add_call_every(
+            [this]() { flush_due_batches(); }, flush_interval_s, &_batch_flush_cookie);
+    } else if (flush_interval_s != _batch_flush_interval_s) {
+        _parent->change_call_every(flush_interval_s, _batch_flush_cookie);
+    }
+    _batch_flush_interval_s = flush_interval_s;
+}
+
+void TelemetryImpl::flush_due_batches()
+{
+    std::lock_guard<std::mutex> lock(_subscription_mutex);
+    const auto now = _parent->get_time().steady_time();
+    _imu_reading_ned_subscription.flush_due(now, user_callback_queue());
+    _actuator_output_status_subscription.flush_due(now, user_callback_queue());
+    _odometry_subscription.flush_due(now, user_callback_queue());
+}
+
 Telemetry::Result TelemetryImpl::set_rate_position_velocity_ned(double rate_hz)
 {
     return telemetry_result_from_command_result(
@@ -533,9 +583,7 @@ void TelemetryImpl::process_position_velocity_ned(const mavlink_message_t& messa
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     if (_position_velocity_ned_subscription) {
-        auto callback = _position_velocity_ned_subscription;
-        auto arg = position_velocity_ned();
-        _parent->call_user_callback([callback, arg]() { callback(arg); });
+        notify(_position_velocity_ned_subscription, position_velocity_ned());
     }
 
     set_health_local_position(true);
@@ -563,17 +611,24 @@ void TelemetryImpl::process_global_position_int(const mavlink_message_t& message
         set_velocity_ned(velocity);
     }
 
+    {
+        std::lock_guard<std::mutex> lock(_history_mutex);
+        update_autopilot_time(global_position_int.time_boot_ms);
+        if (_position_history.enabled()) {
+            _position_history.push(_autopilot_time_us.second, position());
+        }
+        if (_velocity_ned_history.enabled()) {
+            _velocity_ned_history.push(_autopilot_time_us.second, velocity_ned());
+        }
+    }
+
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     if (_position_subscription) {
-        auto callback = _position_subscription;
-        auto arg = position();
-        _parent->call_user_callback([callback, arg]() { callback(arg); });
+        notify(_position_subscription, position());
     }
 
     if (_velocity_ned_subscription) {
-        auto callback = _velocity_ned_subscription;
-        auto arg = velocity_ned();
-        _parent->call_user_callback([callback, arg]() { callback(arg); });
+        notify(_velocity_ned_subscription, velocity_ned());
     }
 }
 
@@ -593,9 +648,7 @@ void TelemetryImpl::process_home_position(const mavlink_message_t& message)
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     if (_home_position_subscription) {
-        auto callback = _home_position_subscription;
-        auto arg = home();
-        _parent->call_user_callback([callback, arg]() { callback(arg); });
+        notify(_home_position_subscription, home());
     }
 }
 
@@ -618,23 +671,25 @@ void TelemetryImpl::process_attitude(const mavlink_message_t& message)
     auto quaternion = mavsdk::to_quaternion_from_euler_angle(euler_angle);
     set_attitude_quaternion(quaternion);
 
+    {
+        std::lock_guard<std::mutex> lock(_history_mutex);
+        update_autopilot_time(attitude.time_boot_ms);
+        if (_attitude_history.enabled()) {
+            _attitude_history.push(_autopilot_time_us.second, quaternion);
+        }
+    }
+
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     if (_attitude_quaternion_angle_subscription) {
-        auto callback = _attitude_quaternion_angle_subscription;
-        auto arg = attitude_quaternion();
-        _parent->call_user_callback([callback, arg]() { callback(arg); });
+        notify(_attitude_quaternion_angle_subscription, attitude_quaternion());
     }
 
     if (_attitude_euler_angle_subscription) {
-        auto callback = _attitude_euler_angle_subscription;
-        auto arg = attitude_euler();
-        _parent->call_user_callback([callback, arg]() { callback(arg); });
+        notify(_attitude_euler_angle_subscription, attitude_euler());
     }
 
     if (_attitude_angular_velocity_body_subscription) {
-        auto callback = _attitude_angular_velocity_body_subscription;
-        auto arg = attitude_angular_velocity_body();
-        _parent->call_user_callback([callback, arg]() { callback(arg); });
+        notify(_attitude_angular_velocity_body_subscription, attitude_angular_velocity_body());
     }
 }
 
@@ -658,23 +713,25 @@ void TelemetryImpl::process_attitude_quaternion(const mavlink_message_t& message
 
     set_attitude_angular_velocity_body(angular_velocity_body);
 
+    {
+        std::lock_guard<std::mutex> lock(_history_mutex);
+        update_autopilot_time(mavlink_attitude_quaternion.time_boot_ms);
+        if (_attitude_history.enabled()) {
+            _attitude_history.push(_autopilot_time_us.second, quaternion);
+        }
+    }
+
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     if (_attitude_quaternion_angle_subscription) {
-        auto callback = _attitude_quaternion_angle_subscription;
-        auto arg = attitude_quaternion();
-        _parent->call_user_callback([callback, arg]() { callback(arg); });
+        notify(_attitude_quaternion_angle_subscription, attitude_quaternion());
     }
 
     if (_attitude_euler_angle_subscription) {
-        auto callback = _attitude_euler_angle_subscription;
-        auto arg = attitude_euler();
-        _parent->call_user_callback([callback, arg]() { callback(arg); });
+        notify(_attitude_euler_angle_subscription, attitude_euler());
     }
 
     if (_attitude_angular_velocity_body_subscription) {
-        auto callback = _attitude_angular_velocity_body_subscription;
-        auto arg = attitude_angular_velocity_body();
-        _parent->call_user_callback([callback, arg]() { callback(arg); });
+        notify(_attitude_angular_velocity_body_subscription, attitude_angular_velocity_body());
     }
 }
 
@@ -693,15 +750,11 @@ void TelemetryImpl::process_mount_orientation(const mavlink_message_t& message)
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     if (_camera_attitude_quaternion_subscription) {
-        auto callback = _camera_attitude_quaternion_subscription;
-        auto arg = camera_attitude_quaternion();
-        _parent->call_user_callback([callback, arg]() { callback(arg); });
+        notify(_camera_attitude_quaternion_subscription, camera_attitude_quaternion());
     }
 
     if (_camera_attitude_euler_angle_subscription) {
-        auto callback = _camera_attitude_euler_angle_subscription;
-        auto arg = camera_attitude_euler();
-        _parent->call_user_callback([callback, arg]() { callback(arg); });
+        notify(_camera_attitude_euler_angle_subscription, camera_attitude_euler());
     }
 }
 
@@ -725,15 +778,11 @@ void TelemetryImpl::process_gimbal_device_attitude_status(const mavlink_message_
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     if (_camera_attitude_quaternion_subscription) {
-        auto callback = _camera_attitude_quaternion_subscription;
-        auto arg = camera_attitude_quaternion();
-        _parent->call_user_callback([callback, arg]() { callback(arg); });
+        notify(_camera_attitude_quaternion_subscription, camera_attitude_quaternion());
     }
 
     if (_camera_attitude_euler_angle_subscription) {
-        auto callback = _camera_attitude_euler_angle_subscription;
-        auto arg = camera_attitude_euler();
-        _parent->call_user_callback([callback, arg]() { callback(arg); });
+        notify(_camera_attitude_euler_angle_subscription, camera_attitude_euler());
     }
 }
 
@@ -757,9 +806,7 @@ void TelemetryImpl::process_imu_reading_ned(const mavlink_message_t& message)
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     if (_imu_reading_ned_subscription) {
-        auto callback = _imu_reading_ned_subscription;
-        auto arg = imu();
-        _parent->call_user_callback([callback, arg]() { callback(arg); });
+        notify(_imu_reading_ned_subscription, imu());
     }
 }
 
@@ -813,9 +860,7 @@ void TelemetryImpl::process_gps_raw_int(const mavlink_message_t& message)
     {
         std::lock_guard<std::mutex> lock(_subscription_mutex);
         if (_gps_info_subscription) {
-            auto callback = _gps_info_subscription;
-            auto arg = gps_info();
-            _parent->call_user_callback([callback, arg]() { callback(arg); });
+            notify(_gps_info_subscription, gps_info());
         }
     }
 
@@ -836,9 +881,7 @@ void TelemetryImpl::process_ground_truth(const mavlink_message_t& message)
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     if (_ground_truth_subscription) {
-        auto callback = _ground_truth_subscription;
-        auto arg = ground_truth();
-        _parent->call_user_callback([callback, arg]() { callback(arg); });
+        notify(_ground_truth_subscription, ground_truth());
     }
 }
 
@@ -854,9 +897,7 @@ void TelemetryImpl::process_extended_sys_state(const mavlink_message_t& message)
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     if (_landed_state_subscription) {
-        auto callback = _landed_state_subscription;
-        auto arg = landed_state();
-        _parent->call_user_callback([callback, arg]() { callback(arg); });
+        notify(_landed_state_subscription, landed_state());
     }
 
     if (extended_sys_state.landed_state == MAV_LANDED_STATE_IN_AIR ||
@@ -869,9 +910,7 @@ void TelemetryImpl::process_extended_sys_state(const mavlink_message_t& message)
     // If landed_state is undefined, we use what we have received last.
 
     if (_in_air_subscription) {
-        auto callback = _in_air_subscription;
-        auto arg = in_air();
-        _parent->call_user_callback([callback, arg]() { callback(arg); });
+        notify(_in_air_subscription, in_air());
     }
 }
 void TelemetryImpl::process_fixedwing_metrics(const mavlink_message_t& message)
@@ -888,9 +927,7 @@ void TelemetryImpl::process_fixedwing_metrics(const mavlink_message_t& message)
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     if (_fixedwing_metrics_subscription) {
-        auto callback = _fixedwing_metrics_subscription;
-        auto arg = fixedwing_metrics();
-        _parent->call_user_callback([callback, arg]() { callback(arg); });
+        notify(_fixedwing_metrics_subscription, fixedwing_metrics());
     }
 }
 
@@ -906,11 +943,17 @@ void TelemetryImpl::process_sys_status(const mavlink_message_t& message)
 
     set_battery(new_battery);
 
+    {
+        std::lock_guard<std::mutex> lock(_history_mutex);
+        const auto autopilot_time_us = estimated_autopilot_time_us();
+        if (_battery_history.enabled() && autopilot_time_us.first) {
+            _battery_history.push(autopilot_time_us.second, new_battery);
+        }
+    }
+
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     if (_battery_subscription) {
-        auto callback = _battery_subscription;
-        auto arg = battery();
-        _parent->call_user_callback([callback, arg]() { callback(arg); });
+        notify(_battery_subscription, battery());
     }
 }
 
@@ -927,29 +970,23 @@ void TelemetryImpl::process_heartbeat(const mavlink_message_t& message)
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     if (_armed_subscription) {
-        auto callback = _armed_subscription;
-        auto arg = armed();
-        _parent->call_user_callback([callback, arg]() { callback(arg); });
+        notify(_armed_subscription, armed());
     }
 
     if (_flight_mode_subscription) {
-        auto callback = _flight_mode_subscription;
         // The flight mode is already parsed in SystemImpl, so we can take it
         // from there.  This assumes that SystemImpl gets called first because
         // it's earlier in the callback list.
-        auto arg = telemetry_flight_mode_from_flight_mode(_parent->get_flight_mode());
-        _parent->call_user_callback([callback, arg]() { callback(arg); });
+        notify(
+            _flight_mode_subscription,
+            telemetry_flight_mode_from_flight_mode(_parent->get_flight_mode()));
     }
 
     if (_health_subscription) {
-        auto callback = _health_subscription;
-        auto arg = health();
-        _parent->call_user_callback([callback, arg]() { callback(arg); });
+        notify(_health_subscription, health());
     }
     if (_health_all_ok_subscription) {
-        auto callback = _health_all_ok_subscription;
-        auto arg = health_all_ok();
-        _parent->call_user_callback([callback, arg]() { callback(arg); });
+        notify(_health_all_ok_subscription, health_all_ok());
     }
 }
 
@@ -1003,9 +1040,11 @@ void TelemetryImpl::process_statustext(const mavlink_message_t& message)
     set_status_text(new_status_text);
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
-    if (_status_text_subscription) {
-        _status_text_subscription(status_text());
-    }
+    // Status texts are not queued but passed on right away.
+    _status_text_subscription.update(
+        status_text(), _parent->get_time().steady_time(), [](std::function<void()> func) {
+            func();
+        });
 }
 
 void TelemetryImpl::process_rc_channels(const mavlink_message_t& message)
@@ -1018,9 +1057,7 @@ void TelemetryImpl::process_rc_channels(const mavlink_message_t& message)
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     if (_rc_status_subscription) {
-        auto callback = _rc_status_subscription;
-        auto arg = rc_status();
-        _parent->call_user_callback([callback, arg]() { callback(arg); });
+        notify(_rc_status_subscription, rc_status());
     }
 
     _parent->refresh_timeout_handler(_rc_channels_timeout_cookie);
@@ -1035,9 +1072,7 @@ void TelemetryImpl::process_unix_epoch_time(const mavlink_message_t& message)
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     if (_unix_epoch_time_subscription) {
-        auto callback = _unix_epoch_time_subscription;
-        auto arg = unix_epoch_time();
-        _parent->call_user_callback([callback, arg]() { callback(arg); });
+        notify(_unix_epoch_time_subscription, unix_epoch_time());
     }
 
     _parent->refresh_timeout_handler(_unix_epoch_timeout_cookie);
@@ -1061,9 +1096,7 @@ void TelemetryImpl::process_actuator_control_target(const mavlink_message_t& mes
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     if (_actuator_control_target_subscription) {
-        auto callback = _actuator_control_target_subscription;
-        auto arg = actuator_control_target();
-        _parent->call_user_callback([callback, arg]() { callback(arg); });
+        notify(_actuator_control_target_subscription, actuator_control_target());
     }
 }
 
@@ -1085,9 +1118,7 @@ void TelemetryImpl::process_actuator_output_status(const mavlink_message_t& mess
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     if (_actuator_output_status_subscription) {
-        auto callback = _actuator_output_status_subscription;
-        auto arg = actuator_output_status();
-        _parent->call_user_callback([callback, arg]() { callback(arg); });
+        notify(_actuator_output_status_subscription, actuator_output_status());
     }
 }
 
@@ -1138,9 +1169,7 @@ void TelemetryImpl::process_odometry(const mavlink_message_t& message)
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     if (_odometry_subscription) {
-        auto callback = _odometry_subscription;
-        auto arg = odometry();
-        _parent->call_user_callback([callback, arg]() { callback(arg); });
+        notify(_odometry_subscription, odometry());
     }
 }
 
@@ -1159,9 +1188,7 @@ void TelemetryImpl::process_distance_sensor(const mavlink_message_t& message)
 
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     if (_distance_sensor_subscription) {
-        auto callback = _distance_sensor_subscription;
-        auto arg = distance_sensor();
-        _parent->call_user_callback([callback, arg]() { callback(arg); });
+        notify(_distance_sensor_subscription, distance_sensor());
     }
 }
 
@@ -1306,53 +1333,49 @@ void TelemetryImpl::receive_unix_epoch_timeout()
 
 Telemetry::PositionVelocityNed TelemetryImpl::position_velocity_ned() const
 {
-    std::lock_guard<std::mutex> lock(_position_velocity_ned_mutex);
-    return _position_velocity_ned;
+    return _state.load().position_velocity_ned;
 }
 
 void TelemetryImpl::set_position_velocity_ned(Telemetry::PositionVelocityNed position_velocity_ned)
 {
-    std::lock_guard<std::mutex> lock(_position_velocity_ned_mutex);
-    _position_velocity_ned = position_velocity_ned;
+    _state.update([&](TelemetryExtended::Snapshot& state) {
+        state.position_velocity_ned = position_velocity_ned;
+    });
 }
 
 Telemetry::Position TelemetryImpl::position() const
 {
-    std::lock_guard<std::mutex> lock(_position_mutex);
-    return _position;
+    return _state.load().position;
 }
 
 void TelemetryImpl::set_position(Telemetry::Position position)
 {
-    std::lock_guard<std::mutex> lock(_position_mutex);
-    _position = position;
+    _state.update([&](TelemetryExtended::Snapshot& state) { state.position = position; });
 }
 
 Telemetry::Position TelemetryImpl::home() const
 {
-    std::lock_guard<std::mutex> lock(_home_position_mutex);
-    return _home_position;
+    return _state.load().home;
 }
 
 void TelemetryImpl::set_home_position(Telemetry::Position home_position)
 {
-    std::lock_guard<std::mutex> lock(_home_position_mutex);
-    _home_position = home_position;
+    _state.update([&](TelemetryExtended::Snapshot& state) { state.home = home_position; });
 }
 
 bool TelemetryImpl::armed() const
 {
-    return _armed;
+    return _state.load().armed;
 }
 
 bool TelemetryImpl::in_air() const
 {
-    return _in_air;
+    return _state.load().in_air;
 }
 
 void TelemetryImpl::set_in_air(bool in_air_new)
 {
-    _in_air = in_air_new;
+    _state.update([in_air_new](TelemetryExtended::Snapshot& state) { state.in_air = in_air_new; });
 }
 
 void TelemetryImpl::set_status_text(Telemetry::StatusText status_text)
@@ -1369,64 +1392,62 @@ Telemetry::StatusText TelemetryImpl::status_text() const
 
 void TelemetryImpl::set_armed(bool armed_new)
 {
-    _armed = armed_new;
+    _state.update([armed_new](TelemetryExtended::Snapshot& state) { state.armed = armed_new; });
 }
 
 Telemetry::Quaternion TelemetryImpl::attitude_quaternion() const
 {
-    std::lock_guard<std::mutex> lock(_attitude_quaternion_mutex);
-    return _attitude_quaternion;
+    return _state.load().attitude_quaternion;
 }
 
 Telemetry::AngularVelocityBody TelemetryImpl::attitude_angular_velocity_body() const
 {
-    std::lock_guard<std::mutex> lock(_attitude_angular_velocity_body_mutex);
-    return _attitude_angular_velocity_body;
+    return _state.load().attitude_angular_velocity_body;
 }
 
 Telemetry::GroundTruth TelemetryImpl::ground_truth() const
 {
-    std::lock_guard<std::mutex> lock(_ground_truth_mutex);
-    return _ground_truth;
+    return _state.load().ground_truth;
 }
 
 Telemetry::FixedwingMetrics TelemetryImpl::fixedwing_metrics() const
 {
-    std::lock_guard<std::mutex> lock(_fixedwing_metrics_mutex);
-    return _fixedwing_metrics;
+    return _state.load().fixedwing_metrics;
 }
 
 Telemetry::EulerAngle TelemetryImpl::attitude_euler() const
 {
-    std::lock_guard<std::mutex> lock(_attitude_quaternion_mutex);
-    Telemetry::EulerAngle euler = to_euler_angle_from_quaternion(_attitude_quaternion);
-
-    return euler;
+    return _state.load().attitude_euler;
 }
 
 void TelemetryImpl::set_attitude_quaternion(Telemetry::Quaternion quaternion)
 {
-    std::lock_guard<std::mutex> lock(_attitude_quaternion_mutex);
-    _attitude_quaternion = quaternion;
+    // The conversion is done once here instead of for every poll.
+    const auto euler = to_euler_angle_from_quaternion(quaternion);
+    _state.update([&](TelemetryExtended::Snapshot& state) {
+        state.attitude_quaternion = quaternion;
+        state.attitude_euler = euler;
+    });
 }
 
 void TelemetryImpl::set_attitude_angular_velocity_body(
     Telemetry::AngularVelocityBody angular_velocity_body)
 {
-    std::lock_guard<std::mutex> lock(_attitude_quaternion_mutex);
-    _attitude_angular_velocity_body = angular_velocity_body;
+    _state.update([&](TelemetryExtended::Snapshot& state) {
+        state.attitude_angular_velocity_body = angular_velocity_body;
+    });
 }
 
 void TelemetryImpl::set_ground_truth(Telemetry::GroundTruth ground_truth)
 {
-    std::lock_guard<std::mutex> lock(_ground_truth_mutex);
-    _ground_truth = ground_truth;
+    _state.update([&](TelemetryExtended::Snapshot& state) { state.ground_truth = ground_truth; });
 }
 
 void TelemetryImpl::set_fixedwing_metrics(Telemetry::FixedwingMetrics fixedwing_metrics)
 {
-    std::lock_guard<std::mutex> lock(_fixedwing_metrics_mutex);
-    _fixedwing_metrics = fixedwing_metrics;
+    _state.update([&](TelemetryExtended::Snapshot& state) {
+        state.fixedwing_metrics = fixedwing_metrics;
+    });
 }
 
 Telemetry::Quaternion TelemetryImpl::camera_attitude_quaternion() const
@@ -1452,50 +1473,272 @@ void TelemetryImpl::set_camera_attitude_euler_angle(Telemetry::EulerAngle euler_
 
 Telemetry::VelocityNed TelemetryImpl::velocity_ned() const
 {
-    std::lock_guard<std::mutex> lock(_velocity_ned_mutex);
-    return _velocity_ned;
+    return _state.load().velocity_ned;
 }
 
 void TelemetryImpl::set_velocity_ned(Telemetry::VelocityNed velocity_ned)
 {
-    std::lock_guard<std::mutex> lock(_velocity_ned_mutex);
-    _velocity_ned = velocity_ned;
+    _state.update([&](TelemetryExtended::Snapshot& state) { state.velocity_ned = velocity_ned; });
 }
 
 Telemetry::Imu TelemetryImpl::imu() const
 {
-    std::lock_guard<std::mutex> lock(_imu_reading_ned_mutex);
-    return _imu_reading_ned;
+    return _state.load().imu;
 }
 
 void TelemetryImpl::set_imu_reading_ned(Telemetry::Imu imu_reading_ned)
 {
-    std::lock_guard<std::mutex> lock(_imu_reading_ned_mutex);
-    _imu_reading_ned = imu_reading_ned;
+    _state.update([&](TelemetryExtended::Snapshot& state) { state.imu = imu_reading_ned; });
 }
 
 Telemetry::GpsInfo TelemetryImpl::gps_info() const
 {
-    std::lock_guard<std::mutex> lock(_gps_info_mutex);
-    return _gps_info;
+    return _state.load().gps_info;
 }
 
 void TelemetryImpl::set_gps_info(Telemetry::GpsInfo gps_info)
 {
-    std::lock_guard<std::mutex> lock(_gps_info_mutex);
-    _gps_info = gps_info;
+    _state.update([&](TelemetryExtended::Snapshot& state) { state.gps_info = gps_info; });
 }
 
 Telemetry::Battery TelemetryImpl::battery() const
 {
-    std::lock_guard<std::mutex> lock(_battery_mutex);
-    return _battery;
+    return _state.load().battery;
 }
 
 void TelemetryImpl::set_battery(Telemetry::Battery battery)
 {
-    std::lock_guard<std::mutex> lock(_battery_mutex);
-    _battery = battery;
+    _state.update([&](TelemetryExtended::Snapshot& state) { state.battery = battery; });
+}
+
+TelemetryExtended::Snapshot TelemetryImpl::snapshot() const
+{
+    return _state.load();
+}
+
+void TelemetryImpl::enable_history(
+    TelemetryExtended::HistoryStream stream, double duration_s, double max_rate_hz)
+{
+    std::size_t max_samples = 0;
+    uint64_t duration_us = 0;
+    if (duration_s > 0.0 && max_rate_hz > 0.0) {
+        max_samples = static_cast<std::size_t>(std::ceil(duration_s * max_rate_hz)) + 1;
+        duration_us = static_cast<uint64_t>(duration_s * 1e6);
+    }
+
+    std::lock_guard<std::mutex> lock(_history_mutex);
+    switch (stream) {
+        case TelemetryExtended::HistoryStream::Position:
+            _position_history.reset(max_samples, duration_us);
+            break;
+        case TelemetryExtended::HistoryStream::Attitude:
+            _attitude_history.reset(max_samples, duration_us);
+            break;
+        case TelemetryExtended::HistoryStream::VelocityNed:
+            _velocity_ned_history.reset(max_samples, duration_us);
+            break;
+        case TelemetryExtended::HistoryStream::Battery:
+            _battery_history.reset(max_samples, duration_us);
+            break;
+        default:
+            LogErr() << "Unknown history stream: " << stream;
+            break;
+    }
+}
+
+std::vector<TelemetryExtended::PositionSample>
+TelemetryImpl::position_history(uint64_t from_us, uint64_t to_us) const
+{
+    std::lock_guard<std::mutex> lock(_history_mutex);
+    std::vector<TelemetryExtended::PositionSample> samples;
+    for (const auto& sample : _position_history.range(from_us, to_us)) {
+        samples.push_back(TelemetryExtended::PositionSample{sample.timestamp_us, sample.value});
+    }
+    return samples;
+}
+
+std::pair<bool, TelemetryExtended::PositionSample>
+TelemetryImpl::position_at(uint64_t timestamp_us, bool interpolate) const
+{
+    std::lock_guard<std::mutex> lock(_history_mutex);
+    const auto sample = interpolate ?
+                            _position_history.interpolated(timestamp_us, interpolate_position) :
+                            _position_history.nearest(timestamp_us);
+    if (!sample.first) {
+        return {false, {}};
+    }
+    return {true, TelemetryExtended::PositionSample{sample.second.timestamp_us, sample.second.value}};
+}
+
+std::vector<TelemetryExtended::AttitudeSample>
+TelemetryImpl::attitude_history(uint64_t from_us, uint64_t to_us) const
+{
+    std::lock_guard<std::mutex> lock(_history_mutex);
+    std::vector<TelemetryExtended::AttitudeSample> samples;
+    for (const auto& sample : _attitude_history.range(from_us, to_us)) {
+        samples.push_back(TelemetryExtended::AttitudeSample{sample.timestamp_us, sample.value});
+    }
+    return samples;
+}
+
+std::pair<bool, TelemetryExtended::AttitudeSample>
+TelemetryImpl::attitude_at(uint64_t timestamp_us, bool interpolate) const
+{
+    std::lock_guard<std::mutex> lock(_history_mutex);
+    const auto sample = interpolate ?
+                            _attitude_history.interpolated(timestamp_us, interpolate_quaternion) :
+                            _attitude_history.nearest(timestamp_us);
+    if (!sample.first) {
+        return {false, {}};
+    }
+    return {true, TelemetryExtended::AttitudeSample{sample.second.timestamp_us, sample.second.value}};
+}
+
+std::vector<TelemetryExtended::VelocityNedSample>
+TelemetryImpl::velocity_ned_history(uint64_t from_us, uint64_t to_us) const
+{
+    std::lock_guard<std::mutex> lock(_history_mutex);
+    std::vector<TelemetryExtended::VelocityNedSample> samples;
+    for (const auto& sample : _velocity_ned_history.range(from_us, to_us)) {
+        samples.push_back(TelemetryExtended::VelocityNedSample{sample.timestamp_us, sample.value});
+    }
+    return samples;
+}
+
+std::pair<bool, TelemetryExtended::VelocityNedSample>
+TelemetryImpl::velocity_ned_at(uint64_t timestamp_us, bool interpolate) const
+{
+    std::lock_guard<std::mutex> lock(_history_mutex);
+    const auto sample =
+        interpolate ? _velocity_ned_history.interpolated(timestamp_us, interpolate_velocity_ned) :
+                      _velocity_ned_history.nearest(timestamp_us);
+    if (!sample.first) {
+        return {false, {}};
+    }
+    return {true, TelemetryExtended::VelocityNedSample{sample.second.timestamp_us, sample.second.value}};
+}
+
+std::vector<TelemetryExtended::BatterySample>
+TelemetryImpl::battery_history(uint64_t from_us, uint64_t to_us) const
+{
+    std::lock_guard<std::mutex> lock(_history_mutex);
+    std::vector<TelemetryExtended::BatterySample> samples;
+    for (const auto& sample : _battery_history.range(from_us, to_us)) {
+        samples.push_back(TelemetryExtended::BatterySample{sample.timestamp_us, sample.value});
+    }
+    return samples;
+}
+
+std::pair<bool, TelemetryExtended::BatterySample>
+TelemetryImpl::battery_at(uint64_t timestamp_us, bool interpolate) const
+{
+    std::lock_guard<std::mutex> lock(_history_mutex);
+    const auto sample = interpolate ?
+                            _battery_history.interpolated(timestamp_us, interpolate_battery) :
+                            _battery_history.nearest(timestamp_us);
+    if (!sample.first) {
+        return {false, {}};
+    }
+    return {true, TelemetryExtended::BatterySample{sample.second.timestamp_us, sample.second.value}};
+}
+
+void TelemetryImpl::update_autopilot_time(uint32_t time_boot_ms)
+{
+    _autopilot_time_us = {true, static_cast<uint64_t>(time_boot_ms) * 1000};
+    _autopilot_time_received = _parent->get_time().steady_time();
+}
+
+std::pair<bool, uint64_t> TelemetryImpl::estimated_autopilot_time_us() const
+{
+    if (!_autopilot_time_us.first) {
+        return {false, 0};
+    }
+    return {
+        true,
+        _autopilot_time_us.second +
+            static_cast<uint64_t>(
+                _parent->get_time().elapsed_since_s(_autopilot_time_received) * 1e6)};
+}
+
+Telemetry::Position TelemetryImpl::interpolate_position(
+    const Telemetry::Position& before, const Telemetry::Position& after, double fraction)
+{
+    // Take the short way across the antimeridian.
+    double longitude_change_deg = after.longitude_deg - before.longitude_deg;
+    if (longitude_change_deg > 180.0) {
+        longitude_change_deg -= 360.0;
+    } else if (longitude_change_deg < -180.0) {
+        longitude_change_deg += 360.0;
+    }
+
+    Telemetry::Position position;
+    position.latitude_deg =
+        before.latitude_deg + (after.latitude_deg - before.latitude_deg) * fraction;
+    position.longitude_deg = before.longitude_deg + longitude_change_deg * fraction;
+    if (position.longitude_deg > 180.0) {
+        position.longitude_deg -= 360.0;
+    } else if (position.longitude_deg < -180.0) {
+        position.longitude_deg += 360.0;
+    }
+    position.absolute_altitude_m = interpolate_float(
+        before.absolute_altitude_m, after.absolute_altitude_m, fraction);
+    position.relative_altitude_m = interpolate_float(
+        before.relative_altitude_m, after.relative_altitude_m, fraction);
+    return position;
+}
+
+Telemetry::Quaternion TelemetryImpl::interpolate_quaternion(
+    const Telemetry::Quaternion& before, const Telemetry::Quaternion& after, double fraction)
+{
+    // Normalized linear interpolation, which is close enough to slerp for the
+    // small rotations between two samples. q and -q are the same rotation, so
+    // we flip after if needed to take the short way.
+    const float sign =
+        (before.w * after.w + before.x * after.x + before.y * after.y + before.z * after.z) < 0.0f ?
+            -1.0f :
+            1.0f;
+
+    Telemetry::Quaternion quaternion;
+    quaternion.w = interpolate_float(before.w, sign * after.w, fraction);
+    quaternion.x = interpolate_float(before.x, sign * after.x, fraction);
+    quaternion.y = interpolate_float(before.y, sign * after.y, fraction);
+    quaternion.z = interpolate_float(before.z, sign * after.z, fraction);
+
+    const float norm = std::sqrt(
+        quaternion.w * quaternion.w + quaternion.x * quaternion.x + quaternion.y * quaternion.y +
+        quaternion.z * quaternion.z);
+    if (norm > 0.0f) {
+        quaternion.w /= norm;
+        quaternion.x /= norm;
+        quaternion.y /= norm;
+        quaternion.z /= norm;
+    }
+    return quaternion;
+}
+
+Telemetry::VelocityNed TelemetryImpl::interpolate_velocity_ned(
+    const Telemetry::VelocityNed& before, const Telemetry::VelocityNed& after, double fraction)
+{
+    Telemetry::VelocityNed velocity_ned;
+    velocity_ned.north_m_s = interpolate_float(before.north_m_s, after.north_m_s, fraction);
+    velocity_ned.east_m_s = interpolate_float(before.east_m_s, after.east_m_s, fraction);
+    velocity_ned.down_m_s = interpolate_float(before.down_m_s, after.down_m_s, fraction);
+    return velocity_ned;
+}
+
+Telemetry::Battery TelemetryImpl::interpolate_battery(
+    const Telemetry::Battery& before, const Telemetry::Battery& after, double fraction)
+{
+    Telemetry::Battery battery;
+    battery.voltage_v = interpolate_float(before.voltage_v, after.voltage_v, fraction);
+    battery.remaining_percent =
+        interpolate_float(before.remaining_percent, after.remaining_percent, fraction);
+    return battery;
+}
+
+float TelemetryImpl::interpolate_float(float before, float after, double fraction)
+{
+    return before + static_cast<float>((after - before) * fraction);
 }
 
 Telemetry::FlightMode TelemetryImpl::flight_mode() const
@@ -1505,17 +1748,16 @@ Telemetry::FlightMode TelemetryImpl::flight_mode() const
 
 Telemetry::Health TelemetryImpl::health() const
 {
-    std::lock_guard<std::mutex> lock(_health_mutex);
-    return _health;
+    return _state.load().health;
 }
 
 bool TelemetryImpl::health_all_ok() const
 {
-    std::lock_guard<std::mutex> lock(_health_mutex);
-    if (_health.is_gyrometer_calibration_ok && _health.is_accelerometer_calibration_ok &&
-        _health.is_magnetometer_calibration_ok && _health.is_level_calibration_ok &&
-        _health.is_local_position_ok && _health.is_global_position_ok &&
-        _health.is_home_position_ok) {
+    const auto health = _state.load().health;
+    if (health.is_gyrometer_calibration_ok && health.is_accelerometer_calibration_ok &&
+        health.is_magnetometer_calibration_ok && health.is_level_calibration_ok &&
+        health.is_local_position_ok && health.is_global_position_ok &&
+        health.is_home_position_ok) {
         return true;
     } else {
         return false;
@@ -1560,56 +1802,65 @@ Telemetry::DistanceSensor TelemetryImpl::distance_sensor() const
 
 void TelemetryImpl::set_health_local_position(bool ok)
 {
-    std::lock_guard<std::mutex> lock(_health_mutex);
-    _health.is_local_position_ok = ok;
+    _state.update([ok](TelemetryExtended::Snapshot& state) {
+        state.health.is_local_position_ok = ok;
+    });
 }
 
 void TelemetryImpl::set_health_global_position(bool ok)
 {
-    std::lock_guard<std::mutex> lock(_health_mutex);
-    _health.is_global_position_ok = ok;
+    _state.update([ok](TelemetryExtended::Snapshot& state) {
+        state.health.is_global_position_ok = ok;
+    });
 }
 
 void TelemetryImpl::set_health_home_position(bool ok)
 {
-    std::lock_guard<std::mutex> lock(_health_mutex);
-    _health.is_home_position_ok = ok;
+    _state.update([ok](TelemetryExtended::Snapshot& state) {
+        state.health.is_home_position_ok = ok;
+    });
 }
 
 void TelemetryImpl::set_health_gyrometer_calibration(bool ok)
 {
-    std::lock_guard<std::mutex> lock(_health_mutex);
-    _health.is_gyrometer_calibration_ok = (ok || _hitl_enabled);
+    const bool value = (ok || _hitl_enabled);
+    _state.update([value](TelemetryExtended::Snapshot& state) {
+        state.health.is_gyrometer_calibration_ok = value;
+    });
 }
 
 void TelemetryImpl::set_health_accelerometer_calibration(bool ok)
 {
-    std::lock_guard<std::mutex> lock(_health_mutex);
-    _health.is_accelerometer_calibration_ok = (ok || _hitl_enabled);
+    const bool value = (ok || _hitl_enabled);
+    _state.update([value](TelemetryExtended::Snapshot& state) {
+        state.health.is_accelerometer_calibration_ok = value;
+    });
 }
 
 void TelemetryImpl::set_health_magnetometer_calibration(bool ok)
 {
-    std::lock_guard<std::mutex> lock(_health_mutex);
-    _health.is_magnetometer_calibration_ok = (ok || _hitl_enabled);
+    const bool value = (ok || _hitl_enabled);
+    _state.update([value](TelemetryExtended::Snapshot& state) {
+        state.health.is_magnetometer_calibration_ok = value;
+    });
 }
 
 void TelemetryImpl::set_health_level_calibration(bool ok)
 {
-    std::lock_guard<std::mutex> lock(_health_mutex);
-    _health.is_level_calibration_ok = (ok || _hitl_enabled);
+    const bool value = (ok || _hitl_enabled);
+    _state.update([value](TelemetryExtended::Snapshot& state) {
+        state.health.is_level_calibration_ok = value;
+    });
 }
 
 Telemetry::LandedState TelemetryImpl::landed_state() const
 {
-    std::lock_guard<std::mutex> lock(_landed_state_mutex);
-    return _landed_state;
+    return _state.load().landed_state;
 }
 
 void TelemetryImpl::set_landed_state(Telemetry::LandedState landed_state)
 {
-    std::lock_guard<std::mutex> lock(_landed_state_mutex);
-    _landed_state = landed_state;
+    _state.update([&](TelemetryExtended::Snapshot& state) { state.landed_state = landed_state; });
 }
 
 void TelemetryImpl::set_rc_status(bool available, float signal_strength_percent)
@@ -1664,48 +1915,142 @@ void TelemetryImpl::position_velocity_ned_async(Telemetry::PositionVelocityNedCa
     _position_velocity_ned_subscription = callback;
 }
 
+TelemetryExtended::SubscriptionHandle TelemetryImpl::subscribe_position_velocity_ned(
+    const Telemetry::PositionVelocityNedCallback& callback,
+    const TelemetryExtended::SubscriptionOptions& options)
+{
+    return subscribe(_position_velocity_ned_subscription, callback, options);
+}
+
+void TelemetryImpl::unsubscribe_position_velocity_ned(TelemetryExtended::SubscriptionHandle handle)
+{
+    unsubscribe(_position_velocity_ned_subscription, handle);
+}
+
 void TelemetryImpl::position_async(Telemetry::PositionCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _position_subscription = callback;
 }
 
+TelemetryExtended::SubscriptionHandle TelemetryImpl::subscribe_position(
+    const Telemetry::PositionCallback& callback,
+    const TelemetryExtended::SubscriptionOptions& options)
+{
+    return subscribe(_position_subscription, callback, options);
+}
+
+void TelemetryImpl::unsubscribe_position(TelemetryExtended::SubscriptionHandle handle)
+{
+    unsubscribe(_position_subscription, handle);
+}
+
 void TelemetryImpl::home_async(Telemetry::PositionCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _home_position_subscription = callback;
 }
 
+TelemetryExtended::SubscriptionHandle TelemetryImpl::subscribe_home(
+    const Telemetry::PositionCallback& callback,
+    const TelemetryExtended::SubscriptionOptions& options)
+{
+    return subscribe(_home_position_subscription, callback, options);
+}
+
+void TelemetryImpl::unsubscribe_home(TelemetryExtended::SubscriptionHandle handle)
+{
+    unsubscribe(_home_position_subscription, handle);
+}
+
 void TelemetryImpl::in_air_async(Telemetry::InAirCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _in_air_subscription = callback;
 }
 
+TelemetryExtended::SubscriptionHandle TelemetryImpl::subscribe_in_air(
+    const Telemetry::InAirCallback& callback, const TelemetryExtended::SubscriptionOptions& options)
+{
+    return subscribe(_in_air_subscription, callback, options);
+}
+
+void TelemetryImpl::unsubscribe_in_air(TelemetryExtended::SubscriptionHandle handle)
+{
+    unsubscribe(_in_air_subscription, handle);
+}
+
 void TelemetryImpl::status_text_async(Telemetry::StatusTextCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _status_text_subscription = callback;
 }
 
+TelemetryExtended::SubscriptionHandle TelemetryImpl::subscribe_status_text(
+    const Telemetry::StatusTextCallback& callback,
+    const TelemetryExtended::SubscriptionOptions& options)
+{
+    return subscribe(_status_text_subscription, callback, options);
+}
+
+void TelemetryImpl::unsubscribe_status_text(TelemetryExtended::SubscriptionHandle handle)
+{
+    unsubscribe(_status_text_subscription, handle);
+}
+
 void TelemetryImpl::armed_async(Telemetry::ArmedCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _armed_subscription = callback;
 }
 
+TelemetryExtended::SubscriptionHandle TelemetryImpl::subscribe_armed(
+    const Telemetry::ArmedCallback& callback, const TelemetryExtended::SubscriptionOptions& options)
+{
+    return subscribe(_armed_subscription, callback, options);
+}
+
+void TelemetryImpl::unsubscribe_armed(TelemetryExtended::SubscriptionHandle handle)
+{
+    unsubscribe(_armed_subscription, handle);
+}
+
 void TelemetryImpl::attitude_quaternion_async(Telemetry::AttitudeQuaternionCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _attitude_quaternion_angle_subscription = callback;
 }
 
+TelemetryExtended::SubscriptionHandle TelemetryImpl::subscribe_attitude_quaternion(
+    const Telemetry::AttitudeQuaternionCallback& callback,
+    const TelemetryExtended::SubscriptionOptions& options)
+{
+    return subscribe(_attitude_quaternion_angle_subscription, callback, options);
+}
+
+void TelemetryImpl::unsubscribe_attitude_quaternion(TelemetryExtended::SubscriptionHandle handle)
+{
+    unsubscribe(_attitude_quaternion_angle_subscription, handle);
+}
+
 void TelemetryImpl::attitude_euler_async(Telemetry::AttitudeEulerCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _attitude_euler_angle_subscription = callback;
 }
 
+TelemetryExtended::SubscriptionHandle TelemetryImpl::subscribe_attitude_euler(
+    const Telemetry::AttitudeEulerCallback& callback,
+    const TelemetryExtended::SubscriptionOptions& options)
+{
+    return subscribe(_attitude_euler_angle_subscription, callback, options);
+}
+
+void TelemetryImpl::unsubscribe_attitude_euler(TelemetryExtended::SubscriptionHandle handle)
+{
+    unsubscribe(_attitude_euler_angle_subscription, handle);
+}
+
 void TelemetryImpl::attitude_angular_velocity_body_async(
     Telemetry::AttitudeAngularVelocityBodyCallback& callback)
 {
@@ -1713,18 +2058,55 @@ void TelemetryImpl::attitude_angular_velocity_body_async(
     _attitude_angular_velocity_body_subscription = callback;
 }
 
+TelemetryExtended::SubscriptionHandle TelemetryImpl::subscribe_attitude_angular_velocity_body(
+    const Telemetry::AttitudeAngularVelocityBodyCallback& callback,
+    const TelemetryExtended::SubscriptionOptions& options)
+{
+    return subscribe(_attitude_angular_velocity_body_subscription, callback, options);
+}
+
+void TelemetryImpl::unsubscribe_attitude_angular_velocity_body(
+    TelemetryExtended::SubscriptionHandle handle)
+{
+    unsubscribe(_attitude_angular_velocity_body_subscription, handle);
+}
+
 void TelemetryImpl::fixedwing_metrics_async(Telemetry::FixedwingMetricsCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _fixedwing_metrics_subscription = callback;
 }
 
+TelemetryExtended::SubscriptionHandle TelemetryImpl::subscribe_fixedwing_metrics(
+    const Telemetry::FixedwingMetricsCallback& callback,
+    const TelemetryExtended::SubscriptionOptions& options)
+{
+    return subscribe(_fixedwing_metrics_subscription, callback, options);
+}
+
+void TelemetryImpl::unsubscribe_fixedwing_metrics(TelemetryExtended::SubscriptionHandle handle)
+{
+    unsubscribe(_fixedwing_metrics_subscription, handle);
+}
+
 void TelemetryImpl::ground_truth_async(Telemetry::GroundTruthCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _ground_truth_subscription = callback;
 }
 
+TelemetryExtended::SubscriptionHandle TelemetryImpl::subscribe_ground_truth(
+    const Telemetry::GroundTruthCallback& callback,
+    const TelemetryExtended::SubscriptionOptions& options)
+{
+    return subscribe(_ground_truth_subscription, callback, options);
+}
+
+void TelemetryImpl::unsubscribe_ground_truth(TelemetryExtended::SubscriptionHandle handle)
+{
+    unsubscribe(_ground_truth_subscription, handle);
+}
+
 void TelemetryImpl::camera_attitude_quaternion_async(
     Telemetry::AttitudeQuaternionCallback& callback)
 {
@@ -1732,72 +2114,228 @@ void TelemetryImpl::camera_attitude_quaternion_async(
     _camera_attitude_quaternion_subscription = callback;
 }
 
+TelemetryExtended::SubscriptionHandle TelemetryImpl::subscribe_camera_attitude_quaternion(
+    const Telemetry::AttitudeQuaternionCallback& callback,
+    const TelemetryExtended::SubscriptionOptions& options)
+{
+    return subscribe(_camera_attitude_quaternion_subscription, callback, options);
+}
+
+void TelemetryImpl::unsubscribe_camera_attitude_quaternion(
+    TelemetryExtended::SubscriptionHandle handle)
+{
+    unsubscribe(_camera_attitude_quaternion_subscription, handle);
+}
+
 void TelemetryImpl::camera_attitude_euler_async(Telemetry::AttitudeEulerCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _camera_attitude_euler_angle_subscription = callback;
 }
 
+TelemetryExtended::SubscriptionHandle TelemetryImpl::subscribe_camera_attitude_euler(
+    const Telemetry::AttitudeEulerCallback& callback,
+    const TelemetryExtended::SubscriptionOptions& options)
+{
+    return subscribe(_camera_attitude_euler_angle_subscription, callback, options);
+}
+
+void TelemetryImpl::unsubscribe_camera_attitude_euler(TelemetryExtended::SubscriptionHandle handle)
+{
+    unsubscribe(_camera_attitude_euler_angle_subscription, handle);
+}
+
 void TelemetryImpl::velocity_ned_async(Telemetry::VelocityNedCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _velocity_ned_subscription = callback;
 }
 
+TelemetryExtended::SubscriptionHandle TelemetryImpl::subscribe_velocity_ned(
+    const Telemetry::VelocityNedCallback& callback,
+    const TelemetryExtended::SubscriptionOptions& options)
+{
+    return subscribe(_velocity_ned_subscription, callback, options);
+}
+
+void TelemetryImpl::unsubscribe_velocity_ned(TelemetryExtended::SubscriptionHandle handle)
+{
+    unsubscribe(_velocity_ned_subscription, handle);
+}
+
 void TelemetryImpl::imu_async(Telemetry::ImuCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _imu_reading_ned_subscription = callback;
 }
 
+TelemetryExtended::SubscriptionHandle TelemetryImpl::subscribe_imu(
+    const Telemetry::ImuCallback& callback, const TelemetryExtended::SubscriptionOptions& options)
+{
+    return subscribe(_imu_reading_ned_subscription, callback, options);
+}
+
+void TelemetryImpl::unsubscribe_imu(TelemetryExtended::SubscriptionHandle handle)
+{
+    unsubscribe(_imu_reading_ned_subscription, handle);
+}
+
+TelemetryExtended::SubscriptionHandle TelemetryImpl::subscribe_imu_batch(
+    const TelemetryExtended::ImuBatchCallback& callback,
+    const TelemetryExtended::BatchOptions& options)
+{
+    return subscribe_batch(_imu_reading_ned_subscription, callback, options);
+}
+
+void TelemetryImpl::unsubscribe_imu_batch(TelemetryExtended::SubscriptionHandle handle)
+{
+    unsubscribe_batch(_imu_reading_ned_subscription, handle);
+}
+
 void TelemetryImpl::gps_info_async(Telemetry::GpsInfoCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _gps_info_subscription = callback;
 }
 
+TelemetryExtended::SubscriptionHandle TelemetryImpl::subscribe_gps_info(
+    const Telemetry::GpsInfoCallback& callback,
+    const TelemetryExtended::SubscriptionOptions& options)
+{
+    return subscribe(_gps_info_subscription, callback, options);
+}
+
+void TelemetryImpl::unsubscribe_gps_info(TelemetryExtended::SubscriptionHandle handle)
+{
+    unsubscribe(_gps_info_subscription, handle);
+}
+
 void TelemetryImpl::battery_async(Telemetry::BatteryCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _battery_subscription = callback;
 }
 
+TelemetryExtended::SubscriptionHandle TelemetryImpl::subscribe_battery(
+    const Telemetry::BatteryCallback& callback,
+    const TelemetryExtended::SubscriptionOptions& options)
+{
+    return subscribe(_battery_subscription, callback, options);
+}
+
+void TelemetryImpl::unsubscribe_battery(TelemetryExtended::SubscriptionHandle handle)
+{
+    unsubscribe(_battery_subscription, handle);
+}
+
 void TelemetryImpl::flight_mode_async(Telemetry::FlightModeCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _flight_mode_subscription = callback;
 }
 
+TelemetryExtended::SubscriptionHandle TelemetryImpl::subscribe_flight_mode(
+    const Telemetry::FlightModeCallback& callback,
+    const TelemetryExtended::SubscriptionOptions& options)
+{
+    return subscribe(_flight_mode_subscription, callback, options);
+}
+
+void TelemetryImpl::unsubscribe_flight_mode(TelemetryExtended::SubscriptionHandle handle)
+{
+    unsubscribe(_flight_mode_subscription, handle);
+}
+
 void TelemetryImpl::health_async(Telemetry::HealthCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _health_subscription = callback;
 }
 
+TelemetryExtended::SubscriptionHandle TelemetryImpl::subscribe_health(
+    const Telemetry::HealthCallback& callback,
+    const TelemetryExtended::SubscriptionOptions& options)
+{
+    return subscribe(_health_subscription, callback, options);
+}
+
+void TelemetryImpl::unsubscribe_health(TelemetryExtended::SubscriptionHandle handle)
+{
+    unsubscribe(_health_subscription, handle);
+}
+
 void TelemetryImpl::health_all_ok_async(Telemetry::HealthAllOkCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _health_all_ok_subscription = callback;
 }
 
+TelemetryExtended::SubscriptionHandle TelemetryImpl::subscribe_health_all_ok(
+    const Telemetry::HealthAllOkCallback& callback,
+    const TelemetryExtended::SubscriptionOptions& options)
+{
+    return subscribe(_health_all_ok_subscription, callback, options);
+}
+
+void TelemetryImpl::unsubscribe_health_all_ok(TelemetryExtended::SubscriptionHandle handle)
+{
+    unsubscribe(_health_all_ok_subscription, handle);
+}
+
 void TelemetryImpl::landed_state_async(Telemetry::LandedStateCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _landed_state_subscription = callback;
 }
 
+TelemetryExtended::SubscriptionHandle TelemetryImpl::subscribe_landed_state(
+    const Telemetry::LandedStateCallback& callback,
+    const TelemetryExtended::SubscriptionOptions& options)
+{
+    return subscribe(_landed_state_subscription, callback, options);
+}
+
+void TelemetryImpl::unsubscribe_landed_state(TelemetryExtended::SubscriptionHandle handle)
+{
+    unsubscribe(_landed_state_subscription, handle);
+}
+
 void TelemetryImpl::rc_status_async(Telemetry::RcStatusCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _rc_status_subscription = callback;
 }
 
+TelemetryExtended::SubscriptionHandle TelemetryImpl::subscribe_rc_status(
+    const Telemetry::RcStatusCallback& callback,
+    const TelemetryExtended::SubscriptionOptions& options)
+{
+    return subscribe(_rc_status_subscription, callback, options);
+}
+
+void TelemetryImpl::unsubscribe_rc_status(TelemetryExtended::SubscriptionHandle handle)
+{
+    unsubscribe(_rc_status_subscription, handle);
+}
+
 void TelemetryImpl::unix_epoch_time_async(Telemetry::UnixEpochTimeCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _unix_epoch_time_subscription = callback;
 }
 
+TelemetryExtended::SubscriptionHandle TelemetryImpl::subscribe_unix_epoch_time(
+    const Telemetry::UnixEpochTimeCallback& callback,
+    const TelemetryExtended::SubscriptionOptions& options)
+{
+    return subscribe(_unix_epoch_time_subscription, callback, options);
+}
+
+void TelemetryImpl::unsubscribe_unix_epoch_time(TelemetryExtended::SubscriptionHandle handle)
+{
+    unsubscribe(_unix_epoch_time_subscription, handle);
+}
+
 void TelemetryImpl::actuator_control_target_async(
     Telemetry::ActuatorControlTargetCallback& callback)
 {
@@ -1805,24 +2343,97 @@ void TelemetryImpl::actuator_control_target_async(
     _actuator_control_target_subscription = callback;
 }
 
+TelemetryExtended::SubscriptionHandle TelemetryImpl::subscribe_actuator_control_target(
+    const Telemetry::ActuatorControlTargetCallback& callback,
+    const TelemetryExtended::SubscriptionOptions& options)
+{
+    return subscribe(_actuator_control_target_subscription, callback, options);
+}
+
+void TelemetryImpl::unsubscribe_actuator_control_target(
+    TelemetryExtended::SubscriptionHandle handle)
+{
+    unsubscribe(_actuator_control_target_subscription, handle);
+}
+
 void TelemetryImpl::actuator_output_status_async(Telemetry::ActuatorOutputStatusCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _actuator_output_status_subscription = callback;
 }
 
+TelemetryExtended::SubscriptionHandle TelemetryImpl::subscribe_actuator_output_status(
+    const Telemetry::ActuatorOutputStatusCallback& callback,
+    const TelemetryExtended::SubscriptionOptions& options)
+{
+    return subscribe(_actuator_output_status_subscription, callback, options);
+}
+
+void TelemetryImpl::unsubscribe_actuator_output_status(TelemetryExtended::SubscriptionHandle handle)
+{
+    unsubscribe(_actuator_output_status_subscription, handle);
+}
+
+TelemetryExtended::SubscriptionHandle TelemetryImpl::subscribe_actuator_output_status_batch(
+    const TelemetryExtended::ActuatorOutputStatusBatchCallback& callback,
+    const TelemetryExtended::BatchOptions& options)
+{
+    return subscribe_batch(_actuator_output_status_subscription, callback, options);
+}
+
+void TelemetryImpl::unsubscribe_actuator_output_status_batch(TelemetryExtended::SubscriptionHandle handle)
+{
+    unsubscribe_batch(_actuator_output_status_subscription, handle);
+}
+
 void TelemetryImpl::odometry_async(Telemetry::OdometryCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _odometry_subscription = callback;
 }
 
+TelemetryExtended::SubscriptionHandle TelemetryImpl::subscribe_odometry(
+    const Telemetry::OdometryCallback& callback,
+    const TelemetryExtended::SubscriptionOptions& options)
+{
+    return subscribe(_odometry_subscription, callback, options);
+}
+
+void TelemetryImpl::unsubscribe_odometry(TelemetryExtended::SubscriptionHandle handle)
+{
+    unsubscribe(_odometry_subscription, handle);
+}
+
+TelemetryExtended::SubscriptionHandle TelemetryImpl::subscribe_odometry_batch(
+    const TelemetryExtended::OdometryBatchCallback& callback,
+    const TelemetryExtended::BatchOptions& options)
+{
+    return subscribe_batch(_odometry_subscription, callback, options);
+}
+
+void TelemetryImpl::unsubscribe_odometry_batch(TelemetryExtended::SubscriptionHandle handle)
+{
+    unsubscribe_batch(_odometry_subscription, handle);
+}
+
 void TelemetryImpl::distance_sensor_async(Telemetry::DistanceSensorCallback& callback)
 {
     std::lock_guard<std::mutex> lock(_subscription_mutex);
     _distance_sensor_subscription = callback;
 }
 
+TelemetryExtended::SubscriptionHandle TelemetryImpl::subscribe_distance_sensor(
+    const Telemetry::DistanceSensorCallback& callback,
+    const TelemetryExtended::SubscriptionOptions& options)
+{
+    return subscribe(_distance_sensor_subscription, callback, options);
+}
+
+void TelemetryImpl::unsubscribe_distance_sensor(TelemetryExtended::SubscriptionHandle handle)
+{
+    unsubscribe(_distance_sensor_subscription, handle);
+}
+
 void TelemetryImpl::get_gps_global_origin_async(
     const Telemetry::GetGpsGlobalOriginCallback callback)
 {
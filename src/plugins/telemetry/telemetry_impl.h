@@ -3,9 +3,12 @@
 #include <atomic>
 #include <mutex>
 
-#include "plugins/telemetry/telemetry.h"
+#include "plugins/telemetry/telemetry_extended.h"
+#include "history_buffer.h"
 #include "mavlink_include.h"
 #include "plugin_impl_base.h"
+#include "seqlock.h"
+#include "subscription_callback.h"
 #include "system.h"
 
 // Since not all vehicles support/require level calibration, this
@@ -98,6 +101,26 @@ public:
     Telemetry::Odometry odometry() const;
     Telemetry::DistanceSensor distance_sensor() const;
     uint64_t unix_epoch_time() const;
+    TelemetryExtended::Snapshot snapshot() const;
+
+    void enable_history(
+        TelemetryExtended::HistoryStream stream, double duration_s, double max_rate_hz);
+    std::vector<TelemetryExtended::PositionSample> position_history(
+        uint64_t from_us, uint64_t to_us) const;
+    std::pair<bool, TelemetryExtended::PositionSample>
+    position_at(uint64_t timestamp_us, bool interpolate) const;
+    std::vector<TelemetryExtended::AttitudeSample> attitude_history(
+        uint64_t from_us, uint64_t to_us) const;
+    std::pair<bool, TelemetryExtended::AttitudeSample>
+    attitude_at(uint64_t timestamp_us, bool interpolate) const;
+    std::vector<TelemetryExtended::VelocityNedSample>
+    velocity_ned_history(uint64_t from_us, uint64_t to_us) const;
+    std::pair<bool, TelemetryExtended::VelocityNedSample>
+    velocity_ned_at(uint64_t timestamp_us, bool interpolate) const;
+    std::vector<TelemetryExtended::BatterySample> battery_history(
+        uint64_t from_us, uint64_t to_us) const;
+    std::pair<bool, TelemetryExtended::BatterySample>
+    battery_at(uint64_t timestamp_us, bool interpolate) const;
 
     void position_velocity_ned_async(Telemetry::PositionVelocityNedCallback& callback);
     void position_async(Telemetry::PositionCallback& callback);
@@ -128,6 +151,127 @@ public:
     void odometry_async(Telemetry::OdometryCallback& callback);
     void distance_sensor_async(Telemetry::DistanceSensorCallback& callback);
 
+    TelemetryExtended::SubscriptionHandle subscribe_position(
+        const Telemetry::PositionCallback& callback,
+        const TelemetryExtended::SubscriptionOptions& options);
+    void unsubscribe_position(TelemetryExtended::SubscriptionHandle handle);
+    TelemetryExtended::SubscriptionHandle subscribe_home(
+        const Telemetry::PositionCallback& callback,
+        const TelemetryExtended::SubscriptionOptions& options);
+    void unsubscribe_home(TelemetryExtended::SubscriptionHandle handle);
+    TelemetryExtended::SubscriptionHandle subscribe_in_air(
+        const Telemetry::InAirCallback& callback,
+        const TelemetryExtended::SubscriptionOptions& options);
+    void unsubscribe_in_air(TelemetryExtended::SubscriptionHandle handle);
+    TelemetryExtended::SubscriptionHandle subscribe_landed_state(
+        const Telemetry::LandedStateCallback& callback,
+        const TelemetryExtended::SubscriptionOptions& options);
+    void unsubscribe_landed_state(TelemetryExtended::SubscriptionHandle handle);
+    TelemetryExtended::SubscriptionHandle subscribe_armed(
+        const Telemetry::ArmedCallback& callback,
+        const TelemetryExtended::SubscriptionOptions& options);
+    void unsubscribe_armed(TelemetryExtended::SubscriptionHandle handle);
+    TelemetryExtended::SubscriptionHandle subscribe_attitude_quaternion(
+        const Telemetry::AttitudeQuaternionCallback& callback,
+        const TelemetryExtended::SubscriptionOptions& options);
+    void unsubscribe_attitude_quaternion(TelemetryExtended::SubscriptionHandle handle);
+    TelemetryExtended::SubscriptionHandle subscribe_attitude_euler(
+        const Telemetry::AttitudeEulerCallback& callback,
+        const TelemetryExtended::SubscriptionOptions& options);
+    void unsubscribe_attitude_euler(TelemetryExtended::SubscriptionHandle handle);
+    TelemetryExtended::SubscriptionHandle subscribe_attitude_angular_velocity_body(
+        const Telemetry::AttitudeAngularVelocityBodyCallback& callback,
+        const TelemetryExtended::SubscriptionOptions& options);
+    void unsubscribe_attitude_angular_velocity_body(TelemetryExtended::SubscriptionHandle handle);
+    TelemetryExtended::SubscriptionHandle subscribe_camera_attitude_quaternion(
+        const Telemetry::AttitudeQuaternionCallback& callback,
+        const TelemetryExtended::SubscriptionOptions& options);
+    void unsubscribe_camera_attitude_quaternion(TelemetryExtended::SubscriptionHandle handle);
+    TelemetryExtended::SubscriptionHandle subscribe_camera_attitude_euler(
+        const Telemetry::AttitudeEulerCallback& callback,
+        const TelemetryExtended::SubscriptionOptions& options);
+    void unsubscribe_camera_attitude_euler(TelemetryExtended::SubscriptionHandle handle);
+    TelemetryExtended::SubscriptionHandle subscribe_velocity_ned(
+        const Telemetry::VelocityNedCallback& callback,
+        const TelemetryExtended::SubscriptionOptions& options);
+    void unsubscribe_velocity_ned(TelemetryExtended::SubscriptionHandle handle);
+    TelemetryExtended::SubscriptionHandle subscribe_gps_info(
+        const Telemetry::GpsInfoCallback& callback,
+        const TelemetryExtended::SubscriptionOptions& options);
+    void unsubscribe_gps_info(TelemetryExtended::SubscriptionHandle handle);
+    TelemetryExtended::SubscriptionHandle subscribe_battery(
+        const Telemetry::BatteryCallback& callback,
+        const TelemetryExtended::SubscriptionOptions& options);
+    void unsubscribe_battery(TelemetryExtended::SubscriptionHandle handle);
+    TelemetryExtended::SubscriptionHandle subscribe_flight_mode(
+        const Telemetry::FlightModeCallback& callback,
+        const TelemetryExtended::SubscriptionOptions& options);
+    void unsubscribe_flight_mode(TelemetryExtended::SubscriptionHandle handle);
+    TelemetryExtended::SubscriptionHandle subscribe_health(
+        const Telemetry::HealthCallback& callback,
+        const TelemetryExtended::SubscriptionOptions& options);
+    void unsubscribe_health(TelemetryExtended::SubscriptionHandle handle);
+    TelemetryExtended::SubscriptionHandle subscribe_rc_status(
+        const Telemetry::RcStatusCallback& callback,
+        const TelemetryExtended::SubscriptionOptions& options);
+    void unsubscribe_rc_status(TelemetryExtended::SubscriptionHandle handle);
+    TelemetryExtended::SubscriptionHandle subscribe_status_text(
+        const Telemetry::StatusTextCallback& callback,
+        const TelemetryExtended::SubscriptionOptions& options);
+    void unsubscribe_status_text(TelemetryExtended::SubscriptionHandle handle);
+    TelemetryExtended::SubscriptionHandle subscribe_actuator_control_target(
+        const Telemetry::ActuatorControlTargetCallback& callback,
+        const TelemetryExtended::SubscriptionOptions& options);
+    void unsubscribe_actuator_control_target(TelemetryExtended::SubscriptionHandle handle);
+    TelemetryExtended::SubscriptionHandle subscribe_actuator_output_status(
+        const Telemetry::ActuatorOutputStatusCallback& callback,
+        const TelemetryExtended::SubscriptionOptions& options);
+    void unsubscribe_actuator_output_status(TelemetryExtended::SubscriptionHandle handle);
+    TelemetryExtended::SubscriptionHandle subscribe_actuator_output_status_batch(
+        const TelemetryExtended::ActuatorOutputStatusBatchCallback& callback,
+        const TelemetryExtended::BatchOptions& options);
+    void unsubscribe_actuator_output_status_batch(TelemetryExtended::SubscriptionHandle handle);
+    TelemetryExtended::SubscriptionHandle subscribe_odometry(
+        const Telemetry::OdometryCallback& callback,
+        const TelemetryExtended::SubscriptionOptions& options);
+    void unsubscribe_odometry(TelemetryExtended::SubscriptionHandle handle);
+    TelemetryExtended::SubscriptionHandle subscribe_odometry_batch(
+        const TelemetryExtended::OdometryBatchCallback& callback,
+        const TelemetryExtended::BatchOptions& options);
+    void unsubscribe_odometry_batch(TelemetryExtended::SubscriptionHandle handle);
+    TelemetryExtended::SubscriptionHandle subscribe_position_velocity_ned(
+        const Telemetry::PositionVelocityNedCallback& callback,
+        const TelemetryExtended::SubscriptionOptions& options);
+    void unsubscribe_position_velocity_ned(TelemetryExtended::SubscriptionHandle handle);
+    TelemetryExtended::SubscriptionHandle subscribe_ground_truth(
+        const Telemetry::GroundTruthCallback& callback,
+        const TelemetryExtended::SubscriptionOptions& options);
+    void unsubscribe_ground_truth(TelemetryExtended::SubscriptionHandle handle);
+    TelemetryExtended::SubscriptionHandle subscribe_fixedwing_metrics(
+        const Telemetry::FixedwingMetricsCallback& callback,
+        const TelemetryExtended::SubscriptionOptions& options);
+    void unsubscribe_fixedwing_metrics(TelemetryExtended::SubscriptionHandle handle);
+    TelemetryExtended::SubscriptionHandle subscribe_imu(
+        const Telemetry::ImuCallback& callback,
+        const TelemetryExtended::SubscriptionOptions& options);
+    void unsubscribe_imu(TelemetryExtended::SubscriptionHandle handle);
+    TelemetryExtended::SubscriptionHandle subscribe_imu_batch(
+        const TelemetryExtended::ImuBatchCallback& callback,
+        const TelemetryExtended::BatchOptions& options);
+    void unsubscribe_imu_batch(TelemetryExtended::SubscriptionHandle handle);
+    TelemetryExtended::SubscriptionHandle subscribe_health_all_ok(
+        const Telemetry::HealthAllOkCallback& callback,
+        const TelemetryExtended::SubscriptionOptions& options);
+    void unsubscribe_health_all_ok(TelemetryExtended::SubscriptionHandle handle);
+    TelemetryExtended::SubscriptionHandle subscribe_unix_epoch_time(
+        const Telemetry::UnixEpochTimeCallback& callback,
+        const TelemetryExtended::SubscriptionOptions& options);
+    void unsubscribe_unix_epoch_time(TelemetryExtended::SubscriptionHandle handle);
+    TelemetryExtended::SubscriptionHandle subscribe_distance_sensor(
+        const Telemetry::DistanceSensorCallback& callback,
+        const TelemetryExtended::SubscriptionOptions& options);
+    void unsubscribe_distance_sensor(TelemetryExtended::SubscriptionHandle handle);
+
     TelemetryImpl(const TelemetryImpl&) = delete;
     TelemetryImpl& operator=(const TelemetryImpl&) = delete;
 
@@ -208,58 +352,113 @@ private:
     static Telemetry::FlightMode
     telemetry_flight_mode_from_flight_mode(SystemImpl::FlightMode flight_mode);
 
-    // Make all fields thread-safe using mutexs
+    // Need _history_mutex to be locked.
+    void update_autopilot_time(uint32_t time_boot_ms);
+    std::pair<bool, uint64_t> estimated_autopilot_time_us() const;
+
+    static Telemetry::Position interpolate_position(
+        const Telemetry::Position& before, const Telemetry::Position& after, double fraction);
+    static Telemetry::Quaternion interpolate_quaternion(
+        const Telemetry::Quaternion& before, const Telemetry::Quaternion& after, double fraction);
+    static Telemetry::VelocityNed interpolate_velocity_ned(
+        const Telemetry::VelocityNed& before, const Telemetry::VelocityNed& after, double fraction);
+    static Telemetry::Battery interpolate_battery(
+        const Telemetry::Battery& before, const Telemetry::Battery& after, double fraction);
+    static float interpolate_float(float before, float after, double fraction);
+
+    template<typename T>
+    static typename SubscriptionCallback<T>::Options
+    subscription_options(const TelemetryExtended::SubscriptionOptions& options)
+    {
+        typename SubscriptionCallback<T>::Options result;
+        result.max_rate_hz = options.max_rate_hz;
+        result.decimation = options.decimation;
+        result.latest_only = options.latest_only;
+        result.coalesce = options.coalesce;
+        return result;
+    }
+
+    template<typename T>
+    TelemetryExtended::SubscriptionHandle subscribe(
+        SubscriptionCallbackList<T>& subscriptions,
+        const typename SubscriptionCallbackList<T>::Callback& callback,
+        const TelemetryExtended::SubscriptionOptions& options)
+    {
+        std::lock_guard<std::mutex> lock(_subscription_mutex);
+        TelemetryExtended::SubscriptionHandle handle;
+        handle.id = subscriptions.subscribe(callback, subscription_options<T>(options));
+        return handle;
+    }
+
+    template<typename T>
+    TelemetryExtended::SubscriptionHandle subscribe_batch(
+        SubscriptionCallbackList<T>& subscriptions,
+        const typename SubscriptionCallbackList<T>::BatchCallback& callback,
+        const TelemetryExtended::BatchOptions& options)
+    {
+        typename SubscriptionCallbackList<T>::BatchOptions batch_options;
+        batch_options.max_samples = options.max_samples;
+        batch_options.max_interval_s = options.max_interval_s;
+
+        std::lock_guard<std::mutex> lock(_subscription_mutex);
+        TelemetryExtended::SubscriptionHandle handle;
+        handle.id = subscriptions.subscribe_batch(callback, batch_options);
+        update_batch_flush();
+        return handle;
+    }
+
+    template<typename T>
+    void
+    unsubscribe(
+        SubscriptionCallbackList<T>& subscriptions, TelemetryExtended::SubscriptionHandle handle)
+    {
+        std::lock_guard<std::mutex> lock(_subscription_mutex);
+        subscriptions.unsubscribe(handle.id);
+    }
+
+    template<typename T>
+    void unsubscribe_batch(
+        SubscriptionCallbackList<T>& subscriptions, TelemetryExtended::SubscriptionHandle handle)
+    {
+        std::lock_guard<std::mutex> lock(_subscription_mutex);
+        // Whatever has been collected is still passed on.
+        subscriptions.unsubscribe(handle.id, user_callback_queue());
+        update_batch_flush();
+    }
+
+    // Passes an update on to all subscribers, needs _subscription_mutex to be locked.
+    template<typename T> void notify(SubscriptionCallbackList<T>& subscriptions, const T& value)
+    {
+        subscriptions.update(value, _parent->get_time().steady_time(), user_callback_queue());
+    }
+
+    // Used by the subscriptions to queue their callbacks.
+    std::function<void(std::function<void()>, const void*, bool)> user_callback_queue()
+    {
+        return [this](std::function<void()> func, const void* origin, bool coalesce) {
+            _parent->call_user_callback(func, origin, coalesce);
+        };
+    }
+
+    // Batches also need to be passed on if no more samples arrive, so they are
+    // checked regularly while there are batch subscriptions with max_interval_s.
+    // Both need _subscription_mutex to be locked.
+    void update_batch_flush();
+    void flush_due_batches();
+
+    // The frequently updated state is polled without blocking the receive
+    // thread, and is read in one go for snapshot().
+    Seqlock<TelemetryExtended::Snapshot> _state{};
+
+    // Make the other fields thread-safe using mutexs
     // The mutexs are mutable so that the lock can get aqcuired in
     // methods marked const.
-    mutable std::mutex _position_mutex{};
-    Telemetry::Position _position{};
-
-    mutable std::mutex _position_velocity_ned_mutex{};
-    Telemetry::PositionVelocityNed _position_velocity_ned{};
-
-    mutable std::mutex _home_position_mutex{};
-    Telemetry::Position _home_position{};
-
-    // If possible, just use atomic instead of a mutex.
-    std::atomic_bool _in_air{false};
-    std::atomic_bool _armed{false};
-
     mutable std::mutex _status_text_mutex{};
     Telemetry::StatusText _status_text{};
 
-    mutable std::mutex _attitude_quaternion_mutex{};
-    Telemetry::Quaternion _attitude_quaternion{};
-
     mutable std::mutex _camera_attitude_euler_angle_mutex{};
     Telemetry::EulerAngle _camera_attitude_euler_angle{};
 
-    mutable std::mutex _attitude_angular_velocity_body_mutex{};
-    Telemetry::AngularVelocityBody _attitude_angular_velocity_body{};
-
-    mutable std::mutex _ground_truth_mutex{};
-    Telemetry::GroundTruth _ground_truth{};
-
-    mutable std::mutex _fixedwing_metrics_mutex{};
-    Telemetry::FixedwingMetrics _fixedwing_metrics{};
-
-    mutable std::mutex _velocity_ned_mutex{};
-    Telemetry::VelocityNed _velocity_ned{};
-
-    mutable std::mutex _imu_reading_ned_mutex{};
-    Telemetry::Imu _imu_reading_ned{};
-
-    mutable std::mutex _gps_info_mutex{};
-    Telemetry::GpsInfo _gps_info{};
-
-    mutable std::mutex _battery_mutex{};
-    Telemetry::Battery _battery{};
-
-    mutable std::mutex _health_mutex{};
-    Telemetry::Health _health{};
-
-    mutable std::mutex _landed_state_mutex{};
-    Telemetry::LandedState _landed_state{Telemetry::LandedState::Unknown};
-
     mutable std::mutex _rc_status_mutex{};
     Telemetry::RcStatus _rc_status{};
 
@@ -280,35 +479,48 @@ private:
 
     std::atomic<bool> _hitl_enabled{false};
 
+    // Recent samples of some streams by autopilot time, see enable_history().
+    mutable std::mutex _history_mutex{};
+    HistoryBuffer<Telemetry::Position> _position_history{};
+    HistoryBuffer<Telemetry::Quaternion> _attitude_history{};
+    HistoryBuffer<Telemetry::VelocityNed> _velocity_ned_history{};
+    HistoryBuffer<Telemetry::Battery> _battery_history{};
+    // The last autopilot timestamp received, to estimate the autopilot time
+    // for messages without timestamp.
+    std::pair<bool, uint64_t> _autopilot_time_us{false, 0};
+    dl_time_t _autopilot_time_received{};
+
     std::mutex _subscription_mutex{};
-    Telemetry::PositionVelocityNedCallback _position_velocity_ned_subscription{nullptr};
-    Telemetry::PositionCallback _position_subscription{nullptr};
-    Telemetry::PositionCallback _home_position_subscription{nullptr};
-    Telemetry::InAirCallback _in_air_subscription{nullptr};
-    Telemetry::StatusTextCallback _status_text_subscription{nullptr};
-    Telemetry::ArmedCallback _armed_subscription{nullptr};
-    Telemetry::AttitudeQuaternionCallback _attitude_quaternion_angle_subscription{nullptr};
-    Telemetry::AttitudeAngularVelocityBodyCallback _attitude_angular_velocity_body_subscription{
-        nullptr};
-    Telemetry::GroundTruthCallback _ground_truth_subscription{nullptr};
-    Telemetry::FixedwingMetricsCallback _fixedwing_metrics_subscription{nullptr};
-    Telemetry::AttitudeEulerCallback _attitude_euler_angle_subscription{nullptr};
-    Telemetry::AttitudeQuaternionCallback _camera_attitude_quaternion_subscription{nullptr};
-    Telemetry::AttitudeEulerCallback _camera_attitude_euler_angle_subscription{nullptr};
-    Telemetry::VelocityNedCallback _velocity_ned_subscription{nullptr};
-    Telemetry::ImuCallback _imu_reading_ned_subscription{nullptr};
-    Telemetry::GpsInfoCallback _gps_info_subscription{nullptr};
-    Telemetry::BatteryCallback _battery_subscription{nullptr};
-    Telemetry::FlightModeCallback _flight_mode_subscription{nullptr};
-    Telemetry::HealthCallback _health_subscription{nullptr};
-    Telemetry::HealthAllOkCallback _health_all_ok_subscription{nullptr};
-    Telemetry::LandedStateCallback _landed_state_subscription{nullptr};
-    Telemetry::RcStatusCallback _rc_status_subscription{nullptr};
-    Telemetry::UnixEpochTimeCallback _unix_epoch_time_subscription{nullptr};
-    Telemetry::ActuatorControlTargetCallback _actuator_control_target_subscription{nullptr};
-    Telemetry::ActuatorOutputStatusCallback _actuator_output_status_subscription{nullptr};
-    Telemetry::OdometryCallback _odometry_subscription{nullptr};
-    Telemetry::DistanceSensorCallback _distance_sensor_subscription{nullptr};
+    SubscriptionCallbackList<Telemetry::PositionVelocityNed> _position_velocity_ned_subscription{};
+    SubscriptionCallbackList<Telemetry::Position> _position_subscription{};
+    SubscriptionCallbackList<Telemetry::Position> _home_position_subscription{};
+    SubscriptionCallbackList<bool> _in_air_subscription{};
+    SubscriptionCallbackList<Telemetry::StatusText> _status_text_subscription{};
+    SubscriptionCallbackList<bool> _armed_subscription{};
+    SubscriptionCallbackList<Telemetry::Quaternion> _attitude_quaternion_angle_subscription{};
+    SubscriptionCallbackList<Telemetry::AngularVelocityBody>
+        _attitude_angular_velocity_body_subscription{};
+    SubscriptionCallbackList<Telemetry::GroundTruth> _ground_truth_subscription{};
+    SubscriptionCallbackList<Telemetry::FixedwingMetrics> _fixedwing_metrics_subscription{};
+    SubscriptionCallbackList<Telemetry::EulerAngle> _attitude_euler_angle_subscription{};
+    SubscriptionCallbackList<Telemetry::Quaternion> _camera_attitude_quaternion_subscription{};
+    SubscriptionCallbackList<Telemetry::EulerAngle> _camera_attitude_euler_angle_subscription{};
+    SubscriptionCallbackList<Telemetry::VelocityNed> _velocity_ned_subscription{};
+    SubscriptionCallbackList<Telemetry::Imu> _imu_reading_ned_subscription{};
+    SubscriptionCallbackList<Telemetry::GpsInfo> _gps_info_subscription{};
+    SubscriptionCallbackList<Telemetry::Battery> _battery_subscription{};
+    SubscriptionCallbackList<Telemetry::FlightMode> _flight_mode_subscription{};
+    SubscriptionCallbackList<Telemetry::Health> _health_subscription{};
+    SubscriptionCallbackList<bool> _health_all_ok_subscription{};
+    SubscriptionCallbackList<Telemetry::LandedState> _landed_state_subscription{};
+    SubscriptionCallbackList<Telemetry::RcStatus> _rc_status_subscription{};
+    SubscriptionCallbackList<uint64_t> _unix_epoch_time_subscription{};
+    SubscriptionCallbackList<Telemetry::ActuatorControlTarget>
+        _actuator_control_target_subscription{};
+    SubscriptionCallbackList<Telemetry::ActuatorOutputStatus>
+        _actuator_output_status_subscription{};
+    SubscriptionCallbackList<Telemetry::Odometry> _odometry_subscription{};
+    SubscriptionCallbackList<Telemetry::DistanceSensor> _distance_sensor_subscription{};
 
     // The velocity (former ground speed) and position are coupled to the same message, therefore,
     // we just use the faster between the two.
@@ -318,5 +530,8 @@ private:
     void* _rc_channels_timeout_cookie{nullptr};
     void* _gps_raw_timeout_cookie{nullptr};
     void* _unix_epoch_timeout_cookie{nullptr};
+
+    void* _batch_flush_cookie{nullptr};
+    double _batch_flush_interval_s{0.0};
 };
 } // namespace mavsdk
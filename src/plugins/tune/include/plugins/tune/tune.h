@@ -163,8 +163,8 @@ public:
      */
     const Tune& operator=(const Tune&) = delete;
 
-private:
-    /** @private Underlying implementation, set at instantiation */
+protected:
+    /** @private Underlying implementation, set at instantiation, also used by extensions */
     std::unique_ptr<TuneImpl> _impl;
 };
 